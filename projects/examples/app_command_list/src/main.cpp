@@ -0,0 +1,459 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/assign/list_of.hpp>
+#include <boost/bind.hpp>
+#include <boost/program_options.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/time/high_res_timer.h>
+
+#include <scm/gl_core.h>
+#include <scm/gl_core/render_device/opengl/gl_core.h>
+#include <scm/gl_core/window_management/context.h>
+#include <scm/gl_core/window_management/display.h>
+#include <scm/gl_core/window_management/headless_surface.h>
+
+namespace {
+
+std::string display_name    = "egl";
+unsigned    object_count    = 1000;
+unsigned    material_count  = 16;
+unsigned    program_count   = 2;
+unsigned    texture_count   = 8;
+unsigned    frame_count     = 1000;
+bool        compatibility   = false;
+
+const std::string draw_v_source = "\
+    #version 330 core\n\
+    \n\
+    layout(location = 0) in vec2 in_position;\n\
+    \n\
+    void main()\n\
+    {\n\
+        gl_Position = vec4(in_position, 0.0, 1.0);\n\
+    }\n\
+    ";
+
+const std::string draw_f_source = "\
+    #version 330 core\n\
+    \n\
+    uniform sampler2D color_texture;\n\
+    uniform float     scale;\n\
+    layout(location = 0, index = 0) out vec4 out_color;\n\
+    \n\
+    void main()\n\
+    {\n\
+        out_color = scale * texture(color_texture, vec2(0.5));\n\
+    }\n\
+    ";
+
+struct material {
+    unsigned    _program;
+    unsigned    _texture;
+    unsigned    _blend_state;
+}; // struct material
+
+// objects are sorted by material, consecutive objects share their program, texture and blend state
+struct scene {
+    std::vector<scm::gl::program_ptr>       _programs;
+    std::vector<scm::gl::texture_2d_ptr>    _textures;
+    std::vector<scm::gl::blend_state_ptr>   _blend_states;
+    scm::gl::sampler_state_ptr              _sampler_state;
+    scm::gl::depth_stencil_state_ptr        _depth_stencil_state;
+    scm::gl::vertex_array_ptr               _vertex_array;
+
+    std::vector<material>                   _materials;
+    std::vector<unsigned>                   _object_materials;
+}; // struct scene
+
+// the command list records the draws, direct targets apply their state before each draw
+void
+draw_object(scm::gl::command_list& in_target)
+{
+    in_target.draw_arrays(scm::gl::PRIMITIVE_TRIANGLE_LIST, 0, 3);
+}
+
+template<class target_type>
+void
+draw_object(target_type& in_target)
+{
+    in_target.apply();
+    in_target.draw_arrays(scm::gl::PRIMITIVE_TRIANGLE_LIST, 0, 3);
+}
+
+// the naive frame, every object sets its complete state
+template<class target_type>
+void
+issue_frame(target_type& in_target, const scene& in_scene)
+{
+    using namespace scm::gl;
+
+    in_target.set_default_frame_buffer(FRAMEBUFFER_BACK);
+    in_target.set_viewports(viewport_array(viewport(scm::math::vec2ui(0u), scm::math::vec2ui(1u))));
+    in_target.set_depth_stencil_state(in_scene._depth_stencil_state, 0);
+    in_target.bind_vertex_array(in_scene._vertex_array);
+
+    for (std::size_t o = 0; o < in_scene._object_materials.size(); ++o) {
+        const material& m = in_scene._materials[in_scene._object_materials[o]];
+
+        in_target.bind_program(in_scene._programs[m._program]);
+        in_target.bind_texture(in_scene._textures[m._texture], in_scene._sampler_state, 0);
+        in_target.set_blend_state(in_scene._blend_states[m._blend_state], scm::math::vec4f(1.0f));
+        draw_object(in_target);
+    }
+}
+
+scm::size_t
+frame_call_count(const scene& in_scene)
+{
+    return 4 + 4 * in_scene._object_materials.size();
+}
+
+void
+record_frame(scm::gl::command_list& in_list, const scene& in_scene)
+{
+    in_list.clear();
+    issue_frame(in_list, in_scene);
+}
+
+// calls per command type left after dropping the redundant ones
+std::vector<scm::size_t>
+expected_call_counts(const scene& in_scene)
+{
+    using scm::gl::command_list;
+
+    std::vector<scm::size_t> c(command_list::CMD_COUNT, 0);
+
+    c[command_list::CMD_SET_DEFAULT_FRAME_BUFFER] = 1;
+    c[command_list::CMD_SET_VIEWPORT]             = 1;
+    c[command_list::CMD_SET_DEPTH_STENCIL_STATE]  = 1;
+    c[command_list::CMD_BIND_VERTEX_ARRAY]        = 1;
+    c[command_list::CMD_DRAW_ARRAYS]              = in_scene._object_materials.size();
+
+    const material* prev = 0;
+    for (std::size_t o = 0; o < in_scene._object_materials.size(); ++o) {
+        const material& m = in_scene._materials[in_scene._object_materials[o]];
+        if (!prev || in_scene._programs[prev->_program] != in_scene._programs[m._program]) {
+            ++c[command_list::CMD_BIND_PROGRAM];
+        }
+        if (!prev || in_scene._textures[prev->_texture] != in_scene._textures[m._texture]) {
+            ++c[command_list::CMD_BIND_TEXTURE];
+        }
+        if (!prev || in_scene._blend_states[prev->_blend_state] != in_scene._blend_states[m._blend_state]) {
+            ++c[command_list::CMD_SET_BLEND_STATE];
+        }
+        prev = &m;
+    }
+
+    return c;
+}
+
+bool
+call_counts_match(const scm::gl::null_context& in_context, const std::vector<scm::size_t>& in_counts)
+{
+    using scm::gl::command_list;
+
+    for (int t = 0; t < command_list::CMD_COUNT; ++t) {
+        if (in_context.call_count(static_cast<command_list::command_type>(t)) != in_counts[t]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool
+commands_match(const scm::gl::command_list& in_lhs, const scm::gl::command_list& in_rhs)
+{
+    const scm::gl::command_list::command_array& l = in_lhs.commands();
+    const scm::gl::command_list::command_array& r = in_rhs.commands();
+
+    if (l.size() != r.size()) {
+        return false;
+    }
+    for (std::size_t c = 0; c < l.size(); ++c) {
+        if (   l[c]._type   != r[c]._type
+            || l[c]._unit   != r[c]._unit
+            || l[c]._object != r[c]._object) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+report(const std::string& in_name, bool in_passed, const std::string& in_details)
+{
+    scm::out() << std::left << std::setw(20) << in_name
+               << (in_passed ? "passed  " : "FAILED  ") << in_details << scm::log::end;
+}
+
+} // namespace
+
+static const std::string    scm_application_name = "schism test: command list replay";
+
+static bool initialize_cmd_line(scm::core& c)
+{
+    using boost::program_options::options_description;
+    using boost::program_options::value;
+    using boost::program_options::bool_switch;
+
+    options_description  cmd_options("program options");
+
+    cmd_options.add_options()
+        ("display,d",       value<std::string>(&display_name)->default_value("egl"),    "display ('egl', 'egl:<n>', 'egl:surfaceless' or an x display)")
+        ("objects,o",       value<unsigned>(&object_count)->default_value(1000),        "objects drawn per frame")
+        ("materials,m",     value<unsigned>(&material_count)->default_value(16),        "materials shared by the objects")
+        ("programs,p",      value<unsigned>(&program_count)->default_value(2),          "programs used by the materials")
+        ("textures,t",      value<unsigned>(&texture_count)->default_value(8),          "textures used by the materials")
+        ("frames,f",        value<unsigned>(&frame_count)->default_value(1000),         "frames replayed for the timing")
+        ("compatibility,c", bool_switch(&compatibility),                                "compatibility profile context (e.g. llvmpipe, EXT_direct_state_access)");
+
+    c.add_command_line_options(cmd_options, scm_application_name);
+
+    return (true);
+}
+
+static void init_module()
+{
+    scm::module::initializer::add_pre_core_init_function(initialize_cmd_line);
+}
+
+static scm::module::static_initializer  static_initialize(init_module);
+
+int main(int argc, char **argv)
+{
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+    using boost::assign::list_of;
+
+    shared_ptr<core> scm_core(new core(argc, argv));
+
+    object_count   = max(object_count, 1u);
+    material_count = clamp(material_count, 1u, object_count);
+    program_count  = max(program_count, 1u);
+    texture_count  = max(texture_count, 1u);
+    frame_count    = max(frame_count, 1u);
+
+    bool all_passed = true;
+
+    try {
+        // the command list does not need a context, the context only provides the objects
+        // referenced by the commands and the target for the final execution
+        wm::display_ptr             display(new wm::display(display_name));
+        wm::headless_surface_ptr    surface(new wm::headless_surface(display, wm::surface::format_desc(FORMAT_RGBA_8, FORMAT_D24_S8, false, false),
+                                                                     vec2ui(1u)));
+        wm::context_ptr             context(new wm::context(surface, wm::context::attribute_desc(4, 4, compatibility, false, false)));
+
+        context->make_current(surface);
+
+        render_device_ptr           device(new render_device());
+        render_context_ptr          device_context = device->main_context();
+
+        scene                       s;
+        std::vector<void*>          texel_data;
+        scm::uint32                 texel = 0;
+
+        for (unsigned p = 0; p < program_count; ++p) {
+            s._programs.push_back(device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   draw_v_source))
+                                                                (device->create_shader(STAGE_FRAGMENT_SHADER, draw_f_source))));
+            if (s._programs.back()) {
+                s._programs.back()->uniform("scale", 1.0f / static_cast<float>(p + 1));
+            }
+        }
+        texel_data.push_back(&texel);
+        for (unsigned t = 0; t < texture_count; ++t) {
+            texel = 0xff000000u | (t * 0x00102030u);
+            s._textures.push_back(device->create_texture_2d(vec2ui(1u), FORMAT_RGBA_8, 1, 1, 1, FORMAT_RGBA_8, texel_data));
+        }
+        s._blend_states.push_back(device->create_blend_state(false, FUNC_ONE, FUNC_ZERO, FUNC_ONE, FUNC_ZERO));
+        s._blend_states.push_back(device->create_blend_state(true, FUNC_SRC_ALPHA, FUNC_ONE_MINUS_SRC_ALPHA, FUNC_ONE, FUNC_ZERO));
+        s._sampler_state       = device->create_sampler_state(FILTER_MIN_MAG_NEAREST, WRAP_CLAMP_TO_EDGE);
+        s._depth_stencil_state = device->create_depth_stencil_state(false, false);
+
+        const vec2f                 tri_vertices[] = { vec2f(-1.0f, -1.0f), vec2f(1.0f, -1.0f), vec2f(0.0f, 1.0f) };
+        buffer_ptr                  tri_buffer = device->create_buffer(BIND_VERTEX_BUFFER, USAGE_STATIC_DRAW,
+                                                                       sizeof(tri_vertices), tri_vertices);
+        s._vertex_array = device->create_vertex_array(vertex_format(0, 0, TYPE_VEC2F, sizeof(vec2f)), list_of(tri_buffer));
+
+        for (unsigned m = 0; m < material_count; ++m) {
+            material mat;
+            mat._program     = m % program_count;
+            mat._texture     = (m / 2) % texture_count;
+            mat._blend_state = (m / 4) % 2;
+            s._materials.push_back(mat);
+        }
+        for (unsigned o = 0; o < object_count; ++o) {
+            s._object_materials.push_back(static_cast<unsigned>(static_cast<scm::uint64>(o) * material_count / object_count));
+        }
+
+        for (unsigned p = 0; p < program_count; ++p) {
+            if (!s._programs[p]) {
+                err() << "command list: error creating render resources." << log::end;
+                return (-1);
+            }
+        }
+        for (unsigned t = 0; t < texture_count; ++t) {
+            if (!s._textures[t]) {
+                err() << "command list: error creating render resources." << log::end;
+                return (-1);
+            }
+        }
+        if (   !s._blend_states[0] || !s._blend_states[1] || !s._sampler_state
+            || !s._depth_stencil_state || !s._vertex_array) {
+            err() << "command list: error creating render resources." << log::end;
+            return (-1);
+        }
+
+        out() << "command list: " << object_count << " objects, " << material_count << " materials, "
+              << program_count << " programs, " << texture_count << " textures" << log::end;
+
+        const std::vector<scm::size_t>  expected = expected_call_counts(s);
+        command_list                    frame_list;
+        null_context                    null_ctx;
+
+        record_frame(frame_list, s);
+
+        { // record: every call is either recorded or dropped as redundant
+            const command_list::statistics& stats = frame_list.record_statistics();
+            const bool passed =    stats._recorded + stats._dropped == frame_call_count(s)
+                                && stats._recorded == frame_list.size()
+                                && stats._draws    == object_count;
+
+            std::ostringstream d;
+            d << "(calls: " << frame_call_count(s) << ", recorded: " << stats._recorded
+              << ", dropped: " << stats._dropped << ", draws: " << stats._draws << ")";
+            report("record", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+        { // direct: the naive frame issued to the null context reaches it completely
+            null_ctx.reset_counters();
+            issue_frame(null_ctx, s);
+
+            const bool passed =    null_ctx.call_count()  == frame_call_count(s)
+                                && null_ctx.apply_count() == object_count;
+
+            std::ostringstream d;
+            d << "(calls: " << null_ctx.call_count() << ", applies: " << null_ctx.apply_count() << ")";
+            report("direct", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+        { // replay: the null context receives only the state changes and draws per type
+            null_ctx.reset_counters();
+            frame_list.replay(null_ctx);
+
+            const bool passed =    call_counts_match(null_ctx, expected)
+                                && null_ctx.call_count()  == frame_list.size()
+                                && null_ctx.apply_count() == object_count;
+
+            std::ostringstream d;
+            d << "(calls: " << null_ctx.call_count() << "/" << frame_call_count(s)
+              << ", programs: "  << null_ctx.call_count(command_list::CMD_BIND_PROGRAM)
+              << ", textures: "  << null_ctx.call_count(command_list::CMD_BIND_TEXTURE)
+              << ", blend: "     << null_ctx.call_count(command_list::CMD_SET_BLEND_STATE)
+              << ", draws: "     << null_ctx.draw_count() << ")";
+            report("replay", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+        { // repeat: replaying does not change the list
+            null_ctx.reset_counters();
+            frame_list.replay(null_ctx);
+            frame_list.replay(null_ctx);
+
+            bool passed = true;
+            for (int t = 0; t < command_list::CMD_COUNT; ++t) {
+                passed = passed && null_ctx.call_count(static_cast<command_list::command_type>(t)) == 2 * expected[t];
+            }
+
+            std::ostringstream d;
+            d << "(calls: " << null_ctx.call_count() << " for 2 replays)";
+            report("repeat", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+        { // worker: a list recorded on another thread holds the same commands
+            command_list    worker_list;
+            boost::thread   worker_thread(boost::bind(record_frame, boost::ref(worker_list), boost::cref(s)));
+            worker_thread.join();
+
+            null_ctx.reset_counters();
+            worker_list.replay(null_ctx);
+
+            const bool passed =    commands_match(worker_list, frame_list)
+                                && call_counts_match(null_ctx, expected);
+
+            std::ostringstream d;
+            d << "(commands: " << worker_list.size() << "/" << frame_list.size() << ")";
+            report("worker record", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+        { // execute: the replay on the render context issues valid OpenGL calls
+            const opengl::gl_core& glapi = device->opengl_api();
+
+            while (glapi.glGetError() != GL_NO_ERROR) {}
+            {
+                context_all_guard cg(device_context);
+                frame_list.execute(device_context);
+            }
+            device_context->sync();
+
+            const unsigned  gl_error = glapi.glGetError();
+            const bool      passed   = (gl_error == GL_NO_ERROR);
+
+            std::ostringstream d;
+            d << "(gl error: 0x" << std::hex << gl_error << ")";
+            report("execute", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+        { // timing: naive calls and replay against the null context, the recording per frame
+            time::high_res_timer    direct_timer;
+            time::high_res_timer    replay_timer;
+            time::high_res_timer    record_timer;
+
+            direct_timer.start();
+            for (unsigned f = 0; f < frame_count; ++f) {
+                issue_frame(null_ctx, s);
+            }
+            direct_timer.stop();
+
+            replay_timer.start();
+            for (unsigned f = 0; f < frame_count; ++f) {
+                frame_list.replay(null_ctx);
+            }
+            replay_timer.stop();
+
+            command_list            timing_list;
+            record_timer.start();
+            for (unsigned f = 0; f < frame_count; ++f) {
+                record_frame(timing_list, s);
+            }
+            record_timer.stop();
+
+            const double frames = static_cast<double>(frame_count);
+
+            out() << std::fixed << std::setprecision(4)
+                  << "command list timing (" << frame_count << " frames):" << log::end
+                  << " - direct: " << time::to_milliseconds(direct_timer.get_time()) / frames << "ms/frame" << log::end
+                  << " - replay: " << time::to_milliseconds(replay_timer.get_time()) / frames << "ms/frame" << log::end
+                  << " - record: " << time::to_milliseconds(record_timer.get_time()) / frames << "ms/frame" << log::end;
+        }
+    }
+    catch (std::exception& e) {
+        err() << "command list: " << e.what() << log::end;
+        return (-1);
+    }
+
+    out() << "command list: " << (all_passed ? "all checks passed" : "checks FAILED") << log::end;
+
+    return (all_passed ? 0 : -1);
+}
@@ -0,0 +1,254 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/program_options.hpp>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/math.h>
+#include <scm/core/time/high_res_timer.h>
+
+#include <scm/gl_util/data/analysis/transfer_function/compiled_function_1d.h>
+#include <scm/gl_util/data/analysis/transfer_function/piecewise_function_1d.h>
+
+namespace {
+
+unsigned    stop_count      = 40;
+unsigned    sample_count    = 1 << 20;
+unsigned    random_seed     = 1;
+float       max_error       = 1e-5f;
+
+float
+random_unit()
+{
+    return static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+}
+
+void
+random_value(float& out_value)
+{
+    out_value = random_unit();
+}
+
+template<typename scal_type, const unsigned dim>
+void
+random_value(scm::math::vec<scal_type, dim>& out_value)
+{
+    for (unsigned c = 0; c < dim; ++c) {
+        out_value[c] = static_cast<scal_type>(random_unit());
+    }
+}
+
+float
+result_difference(float in_lhs, float in_rhs)
+{
+    return std::fabs(in_lhs - in_rhs);
+}
+
+template<typename scal_type, const unsigned dim>
+float
+result_difference(const scm::math::vec<scal_type, dim>& in_lhs, const scm::math::vec<scal_type, dim>& in_rhs)
+{
+    float d = 0.0f;
+    for (unsigned c = 0; c < dim; ++c) {
+        d = scm::math::max(d, std::fabs(static_cast<float>(in_lhs[c]) - static_cast<float>(in_rhs[c])));
+    }
+    return d;
+}
+
+// samples cover the stop range extended by a tenth on each side plus the stops themselves
+template<typename val_type, typename res_type>
+std::vector<float>
+generate_samples(const scm::data::piecewise_function_1d<val_type, res_type>& in_function,
+                 float                                                        in_min,
+                 float                                                        in_max,
+                 unsigned                                                     in_count)
+{
+    typedef scm::data::piecewise_function_1d<val_type, res_type> function_type;
+
+    const float         ext = 0.1f * (in_max - in_min);
+    std::vector<float>  samples;
+
+    samples.reserve(in_count + in_function.num_stops());
+    for (unsigned s = 0; s < in_count; ++s) {
+        samples.push_back(in_min - ext + random_unit() * (in_max - in_min + 2.0f * ext));
+    }
+    for (typename function_type::const_stop_iterator it = in_function.stops_begin(); it != in_function.stops_end(); ++it) {
+        samples.push_back(static_cast<float>(it->first));
+    }
+
+    return samples;
+}
+
+struct check_result {
+    check_result() : _single_error(0.0f), _batch_error(0.0f), _interpreted_time(0.0), _compiled_time(0.0), _grid_cells(0) {}
+    float       _single_error;
+    float       _batch_error;
+    double      _interpreted_time;  // ms
+    double      _compiled_time;     // ms, batch evaluation
+    unsigned    _grid_cells;
+}; // struct check_result
+
+// compiled single and batch evaluation against the interpreted function (operator[])
+template<typename val_type, typename res_type>
+check_result
+check_function(const scm::data::piecewise_function_1d<val_type, res_type>& in_function,
+               const std::vector<float>&                                    in_samples)
+{
+    scm::data::compiled_function_1d<val_type, res_type> compiled(in_function);
+
+    const std::size_t       n = in_samples.size();
+    std::vector<res_type>   interpreted(n);
+    std::vector<res_type>   batch(n);
+    scm::time::high_res_timer timer;
+    check_result            r;
+
+    timer.start();
+    for (std::size_t s = 0; s < n; ++s) {
+        interpreted[s] = in_function[in_samples[s]];
+    }
+    timer.stop();
+    r._interpreted_time = scm::time::to_milliseconds(timer.get_time());
+
+    timer.start();
+    if (n > 0) {
+        compiled.evaluate(&in_samples.front(), &batch.front(), n);
+    }
+    timer.stop();
+    r._compiled_time = scm::time::to_milliseconds(timer.get_time());
+
+    for (std::size_t s = 0; s < n; ++s) {
+        r._single_error = scm::math::max(r._single_error, result_difference(compiled[in_samples[s]], interpreted[s]));
+        r._batch_error  = scm::math::max(r._batch_error,  result_difference(batch[s], interpreted[s]));
+    }
+    r._grid_cells = compiled.num_grid_cells();
+
+    return r;
+}
+
+bool
+report(const std::string& in_name, std::size_t in_stops, const check_result& in_result)
+{
+    const bool passed =    in_result._single_error <= max_error
+                        && in_result._batch_error  <= max_error;
+
+    std::ostringstream d;
+    d << std::scientific << std::setprecision(2)
+      << "(stops: " << in_stops << ", cells: " << in_result._grid_cells
+      << ", error single: " << in_result._single_error << ", batch: " << in_result._batch_error
+      << std::fixed << std::setprecision(3)
+      << ", interpreted: " << in_result._interpreted_time << "ms"
+      << ", compiled: " << in_result._compiled_time << "ms)";
+
+    scm::out() << std::left << std::setw(24) << in_name
+               << (passed ? "passed  " : "FAILED  ") << d.str() << scm::log::end;
+
+    return passed;
+}
+
+} // namespace
+
+static const std::string    scm_application_name = "schism test: compiled transfer functions";
+
+static bool initialize_cmd_line(scm::core& c)
+{
+    using boost::program_options::options_description;
+    using boost::program_options::value;
+
+    options_description  cmd_options("program options");
+
+    cmd_options.add_options()
+        ("stops,s",         value<unsigned>(&stop_count)->default_value(40),            "stops per function")
+        ("samples,n",       value<unsigned>(&sample_count)->default_value(1 << 20),     "samples evaluated per function")
+        ("seed",            value<unsigned>(&random_seed)->default_value(1),            "random seed of the stops and samples")
+        ("max-error,e",     value<float>(&max_error)->default_value(1e-5f),             "maximum difference to the interpreted function");
+
+    c.add_command_line_options(cmd_options, scm_application_name);
+
+    return (true);
+}
+
+static void init_module()
+{
+    scm::module::initializer::add_pre_core_init_function(initialize_cmd_line);
+}
+
+static scm::module::static_initializer  static_initialize(init_module);
+
+int main(int argc, char **argv)
+{
+    using namespace scm;
+    using namespace scm::data;
+    using namespace scm::math;
+
+    shared_ptr<core> scm_core(new core(argc, argv));
+
+    std::srand(random_seed);
+
+    bool all_passed = true;
+
+    { // opacity over a float domain
+        piecewise_function_1d<float, float> f;
+        for (unsigned s = 0; s < stop_count; ++s) {
+            float v;
+            random_value(v);
+            f.add_stop(random_unit(), v);
+        }
+        const bool passed = report("float -> float", f.num_stops(), check_function(f, generate_samples(f, 0.0f, 1.0f, sample_count)));
+        all_passed = all_passed && passed;
+    }
+    { // color over a float domain
+        piecewise_function_1d<float, vec3f> f;
+        for (unsigned s = 0; s < stop_count; ++s) {
+            vec3f v;
+            random_value(v);
+            f.add_stop(random_unit(), v);
+        }
+        const bool passed = report("float -> vec3f", f.num_stops(), check_function(f, generate_samples(f, 0.0f, 1.0f, sample_count)));
+        all_passed = all_passed && passed;
+    }
+    { // color and opacity over an 8bit domain, samples outside of it are clamped
+        piecewise_function_1d<unsigned char, vec4f> f;
+        for (unsigned s = 0; s < stop_count; ++s) {
+            vec4f v;
+            random_value(v);
+            f.add_stop(static_cast<unsigned char>(std::rand() % 256), v);
+        }
+        const bool passed = report("uint8 -> vec4f", f.num_stops(), check_function(f, generate_samples(f, 0.0f, 255.0f, sample_count)));
+        all_passed = all_passed && passed;
+    }
+    { // most stops clustered in a narrow range, limited by the grid cell count
+        piecewise_function_1d<float, float> f;
+        for (unsigned s = 0; s < stop_count; ++s) {
+            float v;
+            random_value(v);
+            f.add_stop((s % 4 == 0) ? random_unit() : 0.5f + 0.001f * random_unit(), v);
+        }
+        const bool passed = report("float -> float, dense", f.num_stops(), check_function(f, generate_samples(f, 0.0f, 1.0f, sample_count)));
+        all_passed = all_passed && passed;
+    }
+    { // a single stop only defines the function at its point
+        piecewise_function_1d<float, vec3f> f;
+        f.add_stop(0.25f, vec3f(0.1f, 0.2f, 0.3f));
+        const bool passed = report("single stop", f.num_stops(), check_function(f, generate_samples(f, 0.0f, 1.0f, sample_count / 16)));
+        all_passed = all_passed && passed;
+    }
+    { // empty functions evaluate to zero
+        piecewise_function_1d<float, float> f;
+        const bool passed = report("empty", f.num_stops(), check_function(f, generate_samples(f, 0.0f, 1.0f, sample_count / 16)));
+        all_passed = all_passed && passed;
+    }
+
+    out() << "compiled function: " << (all_passed ? "all checks passed" : "checks FAILED") << log::end;
+
+    return (all_passed ? 0 : -1);
+}
@@ -0,0 +1,319 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <boost/asio.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/chrono.hpp>
+#include <boost/program_options.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <scm/core.h>
+#include <scm/log.h>
+
+#include <scm/input/tracking/art_dtrack.h>
+#include <scm/input/tracking/target.h>
+
+namespace {
+
+unsigned    listening_port      = 5123;
+unsigned    body_count          = 2;
+unsigned    burst_frames        = 500;
+unsigned    stream_rate         = 60;       // frames per second
+unsigned    stream_duration     = 2000;     // ms
+unsigned    update_rate         = 90;       // update() calls per second while streaming
+double      max_update_time     = 10.0;     // ms, well below a receive wait (100ms), allows for preemption
+
+// sends dtrack ascii frames to the local listening port of the receiver
+class dtrack_loopback_sender
+{
+public:
+    dtrack_loopback_sender(unsigned in_port, unsigned in_bodies)
+      : _socket(_io_service)
+      , _endpoint(boost::asio::ip::address_v4::loopback(), static_cast<unsigned short>(in_port))
+      , _bodies(in_bodies)
+      , _last_frame(0)
+    {
+        _socket.open(boost::asio::ip::udp::v4());
+    }
+
+    // body b of frame f is located at (f, b, 0)
+    void send_frame(unsigned long in_frame) {
+        std::string packet;
+        char        line[256];
+
+        sprintf(line, "fr %lu\r\n", in_frame);                                   packet += line;
+        sprintf(line, "ts %.3f\r\n", scm::inp::tracker::clock_time());          packet += line;
+        sprintf(line, "6dcal %u\r\n", _bodies);                                  packet += line;
+        sprintf(line, "6d %u", _bodies);                                         packet += line;
+        for (unsigned b = 0; b < _bodies; ++b) {
+            sprintf(line, " [%u 1.000][%.3f %.3f 0.000 0.000 0.000 0.000][1 0 0 0 1 0 0 0 1]",
+                    b, static_cast<double>(in_frame), static_cast<double>(b));
+            packet += line;
+        }
+        packet += "\r\n";
+
+        _socket.send_to(boost::asio::buffer(packet.c_str(), packet.size() + 1), _endpoint);
+        _last_frame.store(in_frame);
+    }
+
+    // sends in_count frames starting at in_first at in_rate frames per second
+    void stream(unsigned long in_first, unsigned in_count, unsigned in_rate) {
+        const double start = scm::inp::tracker::clock_time();
+        for (unsigned f = 0; f < in_count; ++f) {
+            const double next = start + static_cast<double>(f) / in_rate;
+            const double now  = scm::inp::tracker::clock_time();
+            if (next > now) {
+                boost::this_thread::sleep_for(boost::chrono::microseconds(static_cast<long>((next - now) * 1e6)));
+            }
+            send_frame(in_first + f);
+        }
+    }
+
+    unsigned long last_frame() const {
+        return _last_frame.load();
+    }
+
+private:
+    boost::asio::io_service             _io_service;
+    boost::asio::ip::udp::socket        _socket;
+    boost::asio::ip::udp::endpoint      _endpoint;
+    unsigned                            _bodies;
+    boost::atomic<unsigned long>        _last_frame;
+
+}; // class dtrack_loopback_sender
+
+struct update_stats {
+    update_stats() : _calls(0), _total(0.0), _max(0.0) {}
+
+    void add(double in_ms) {
+        ++_calls;
+        _total += in_ms;
+        _max    = (in_ms > _max) ? in_ms : _max;
+    }
+
+    unsigned    _calls;
+    double      _total;
+    double      _max;
+}; // struct update_stats
+
+// timed update() call (ms)
+double
+timed_update(scm::inp::art_dtrack& in_tracker, scm::inp::tracker::target_container& in_targets)
+{
+    const double start = scm::inp::tracker::clock_time();
+    in_tracker.update(in_targets);
+    return (scm::inp::tracker::clock_time() - start) * 1000.0;
+}
+
+// the targets hold the bodies of the expected frame (see dtrack_loopback_sender::send_frame())
+bool
+targets_match_frame(const scm::inp::tracker::target_container& in_targets, unsigned long in_frame)
+{
+    scm::inp::tracker::target_container::const_iterator t;
+    for (t = in_targets.begin(); t != in_targets.end(); ++t) {
+        const scm::math::mat4f& m = t->second.transform();
+        if (   std::fabs(m.m12 - static_cast<float>(in_frame)) > 0.01f
+            || std::fabs(m.m13 - static_cast<float>(t->first - 1)) > 0.01f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+report(const std::string& in_name, bool in_passed, const std::string& in_details)
+{
+    scm::out() << std::left << std::setw(20) << in_name
+               << (in_passed ? "passed  " : "FAILED  ") << in_details << scm::log::end;
+}
+
+std::string
+update_details(const update_stats& in_stats)
+{
+    std::ostringstream s;
+    s << std::fixed << std::setprecision(4)
+      << "(update() calls: " << in_stats._calls
+      << ", avg: " << ((in_stats._calls > 0) ? in_stats._total / in_stats._calls : 0.0) << "ms"
+      << ", max: " << in_stats._max << "ms)";
+    return s.str();
+}
+
+} // namespace
+
+static const std::string    scm_application_name = "schism test: art dtrack loopback";
+
+static bool initialize_cmd_line(scm::core& c)
+{
+    using boost::program_options::options_description;
+    using boost::program_options::value;
+
+    options_description  cmd_options("program options");
+
+    cmd_options.add_options()
+        ("port,p",          value<unsigned>(&listening_port)->default_value(5123),      "udp port of the receiver")
+        ("bodies,b",        value<unsigned>(&body_count)->default_value(2),             "bodies per frame")
+        ("burst,n",         value<unsigned>(&burst_frames)->default_value(500),         "frames sent back to back")
+        ("rate,r",          value<unsigned>(&stream_rate)->default_value(60),           "streamed frames per second")
+        ("duration,d",      value<unsigned>(&stream_duration)->default_value(2000),     "stream duration (ms)")
+        ("update-rate,u",   value<unsigned>(&update_rate)->default_value(90),           "update() calls per second while streaming")
+        ("max-update,m",    value<double>(&max_update_time)->default_value(10.0),       "maximum time of a single update() call (ms)");
+
+    c.add_command_line_options(cmd_options, scm_application_name);
+
+    return (true);
+}
+
+static void init_module()
+{
+    scm::module::initializer::add_pre_core_init_function(initialize_cmd_line);
+}
+
+static scm::module::static_initializer  static_initialize(init_module);
+
+int main(int argc, char **argv)
+{
+    using namespace scm;
+    using namespace scm::inp;
+
+    shared_ptr<core> scm_core(new core(argc, argv));
+
+    body_count  = math::clamp(body_count, 1u, art_dtrack::max_bodies);
+    stream_rate = math::max(stream_rate, 1u);
+    update_rate = math::max(update_rate, 1u);
+
+    bool all_passed = true;
+
+    try {
+        // a receive timeout above the 100ms cap, shutdown() must not wait for it
+        art_dtrack                  dtrack(listening_port, 1000000);
+        tracker::target_container   targets;
+
+        for (unsigned b = 0; b < body_count; ++b) {
+            targets.insert(tracker::target_container::value_type(b + 1, target(b + 1)));
+        }
+
+        if (!dtrack.initialize()) {
+            err() << "dtrack loopback: unable to initialize the receiver (port: " << listening_port << ")." << log::end;
+            return (-1);
+        }
+
+        dtrack_loopback_sender  sender(dtrack.listening_port(), body_count);
+        unsigned long           next_frame = 1;
+
+        out() << "dtrack loopback: port " << dtrack.listening_port() << ", " << body_count << " bodies" << log::end;
+
+        { // idle: no packets, update() returns at once and keeps the targets
+            update_stats    stats;
+            const double    end = tracker::clock_time() + 0.25;
+
+            while (tracker::clock_time() < end) {
+                stats.add(timed_update(dtrack, targets));
+                boost::this_thread::sleep_for(boost::chrono::microseconds(100));
+            }
+            const bool passed =    stats._max < max_update_time
+                                && dtrack.received_sample_count() == 0
+                                && dtrack.current_sample()._frame == 0;
+            report("idle update", passed, update_details(stats));
+            all_passed = all_passed && passed;
+        }
+        { // burst: frames back to back (the socket may drop some), update() skips to the latest
+            update_stats    stats;
+
+            for (unsigned f = 0; f < burst_frames; ++f) {
+                sender.send_frame(next_frame++);
+                stats.add(timed_update(dtrack, targets));
+            }
+            // a final frame after the socket buffer drained has to arrive
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+            sender.send_frame(next_frame++);
+
+            const unsigned long last     = sender.last_frame();
+            const double        deadline = tracker::clock_time() + 2.0;
+            while (dtrack.current_sample()._frame != last && tracker::clock_time() < deadline) {
+                stats.add(timed_update(dtrack, targets));
+                boost::this_thread::sleep_for(boost::chrono::microseconds(100));
+            }
+
+            const bool passed =    stats._max < max_update_time
+                                && dtrack.current_sample()._frame == last
+                                && targets_match_frame(targets, last);
+
+            std::ostringstream d;
+            d << "(sent: " << burst_frames + 1 << ", received: " << dtrack.received_sample_count()
+              << ", latest: " << dtrack.current_sample()._frame << "/" << last << ") " << update_details(stats);
+            report("burst", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+        { // stream: update() at its own rate only ever moves forward to the latest frame
+            update_stats        stats;
+            const std::size_t   received_before = dtrack.received_sample_count();
+            const unsigned      frames          = math::max(1u, stream_rate * stream_duration / 1000);
+            boost::thread       stream_thread(boost::bind(&dtrack_loopback_sender::stream, &sender,
+                                                          next_frame, frames, stream_rate));
+            bool                monotonic  = true;
+            bool                consistent = true;
+            unsigned long       max_lag    = 0;
+            unsigned long       prev_frame = dtrack.current_sample()._frame;
+            const double        deadline   = tracker::clock_time() + stream_duration / 1000.0 + 2.0;
+            const unsigned long last       = next_frame + frames - 1;
+
+            next_frame += frames;
+
+            while (dtrack.current_sample()._frame != last && tracker::clock_time() < deadline) {
+                const unsigned long sent = sender.last_frame();
+
+                stats.add(timed_update(dtrack, targets));
+
+                const unsigned long cur = dtrack.current_sample()._frame;
+                monotonic  = monotonic  && cur >= prev_frame;
+                consistent = consistent && targets_match_frame(targets, cur);
+                max_lag    = math::max(max_lag, (sent > cur) ? sent - cur : 0ul);
+                prev_frame = cur;
+
+                boost::this_thread::sleep_for(boost::chrono::microseconds(1000000 / update_rate));
+            }
+            stream_thread.join();
+
+            const bool passed =    stats._max < max_update_time
+                                && monotonic && consistent
+                                && dtrack.current_sample()._frame == last;
+
+            std::ostringstream d;
+            d << "(sent: " << frames << ", received: " << dtrack.received_sample_count() - received_before
+              << ", max lag: " << max_lag << " frames) " << update_details(stats);
+            report("stream", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+        { // shutdown: the receive thread waits at most 100ms per receive, not the 1s timeout
+            boost::this_thread::sleep_for(boost::chrono::milliseconds(50));
+
+            const double start    = tracker::clock_time();
+            const bool   shutdown = dtrack.shutdown();
+            const double duration = (tracker::clock_time() - start) * 1000.0;
+            const bool   passed   = shutdown && duration < 150.0;
+
+            std::ostringstream d;
+            d << std::fixed << std::setprecision(2)
+              << "(timeout: " << dtrack.timeout() / 1000 << "ms, shutdown: " << duration << "ms)";
+            report("shutdown", passed, d.str());
+            all_passed = all_passed && passed;
+        }
+    }
+    catch (std::exception& e) {
+        err() << "dtrack loopback: " << e.what() << log::end;
+        return (-1);
+    }
+
+    out() << "dtrack loopback: " << (all_passed ? "all checks passed" : "checks FAILED") << log::end;
+
+    return (all_passed ? 0 : -1);
+}
@@ -0,0 +1,290 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/assign/list_of.hpp>
+#include <boost/bind.hpp>
+#include <boost/program_options.hpp>
+
+#include <scm/core.h>
+#include <scm/log.h>
+#include <scm/core/time/high_res_timer.h>
+
+#include <scm/gl_core.h>
+#include <scm/gl_core/window_management/context.h>
+#include <scm/gl_core/window_management/display.h>
+#include <scm/gl_core/window_management/headless_surface.h>
+
+namespace {
+
+std::string display_name    = "egl";
+unsigned    image_width     = 1920;
+unsigned    image_height    = 1080;
+unsigned    frame_count     = 200;
+bool        surfaceless     = false;
+bool        compatibility   = false;
+bool        list_devices    = false;
+unsigned    upload_size     = 0;
+unsigned    upload_contexts = 1;
+
+const std::string fill_v_source = "\
+    #version 330 core\n\
+    \n\
+    layout(location = 0) in vec2 in_position;\n\
+    out vec2 uv;\n\
+    \n\
+    void main()\n\
+    {\n\
+        uv          = in_position * 0.5 + 0.5;\n\
+        gl_Position = vec4(in_position, 0.0, 1.0);\n\
+    }\n\
+    ";
+
+const std::string fill_f_source = "\
+    #version 330 core\n\
+    \n\
+    in vec2 uv;\n\
+    uniform float frame;\n\
+    layout(location = 0, index = 0) out vec4 out_color;\n\
+    \n\
+    void main()\n\
+    {\n\
+        float w   = sin(40.0 * length(uv - 0.5) - 0.1 * frame);\n\
+        out_color = vec4(uv, 0.5 + 0.5 * w, 1.0);\n\
+    }\n\
+    ";
+
+void
+draw_frame(const scm::gl::render_context_ptr& context,
+           const scm::gl::frame_buffer_ptr&   frame_buffer,
+           const scm::math::vec2ui&           image_size,
+           const scm::gl::program_ptr&        fill_program,
+           const scm::gl::vertex_array_ptr&   quad_array,
+           unsigned                           frame)
+{
+    using namespace scm::gl;
+
+    context_framebuffer_guard   fbg(context);
+    context_program_guard       pg(context);
+    context_vertex_input_guard  vig(context);
+
+    fill_program->uniform("frame", static_cast<float>(frame));
+
+    context->set_frame_buffer(frame_buffer);
+    context->set_viewport(viewport(scm::math::vec2ui(0), image_size));
+    context->clear_depth_stencil_buffer(frame_buffer);
+    context->bind_program(fill_program);
+    context->bind_vertex_array(quad_array);
+    context->apply();
+    context->draw_arrays(PRIMITIVE_TRIANGLE_STRIP, 0, 4);
+}
+
+// runs on an upload context (or the main context without upload contexts)
+bool
+upload_volume(scm::gl::render_device&         device,
+              unsigned                        edge,
+              const std::vector<scm::uint8>&  data,
+              scm::gl::texture_3d_ptr&        volume,
+              scm::gl::render_context&        /*context*/)
+{
+    using namespace scm::gl;
+
+    std::vector<void*> mip_data(1, const_cast<scm::uint8*>(&data.front()));
+    volume = device.create_texture_3d(scm::math::vec3ui(edge), FORMAT_R_8, 1, FORMAT_R_8, mip_data);
+
+    return (0 != volume);
+}
+
+} // namespace
+
+static const std::string    scm_application_name = "schism benchmark: headless rendering";
+
+static bool initialize_cmd_line(scm::core& c)
+{
+    using boost::program_options::options_description;
+    using boost::program_options::value;
+    using boost::program_options::bool_switch;
+
+    options_description  cmd_options("program options");
+
+    cmd_options.add_options()
+        ("display,d",       value<std::string>(&display_name)->default_value("egl"),    "display ('egl', 'egl:<n>', 'egl:surfaceless' or an x display)")
+        ("width,x",         value<unsigned>(&image_width)->default_value(1920),         "image width")
+        ("height,y",        value<unsigned>(&image_height)->default_value(1080),        "image height")
+        ("frames,f",        value<unsigned>(&frame_count)->default_value(200),          "frames to render and read back")
+        ("surfaceless,s",   bool_switch(&surfaceless),                                  "no pbuffer, render to framebuffer objects only")
+        ("compatibility,c", bool_switch(&compatibility),                                "compatibility profile context (e.g. llvmpipe, EXT_direct_state_access)")
+        ("list,l",          bool_switch(&list_devices),                                 "list the egl devices")
+        ("upload,u",        value<unsigned>(&upload_size)->default_value(0),            "edge length of a volume uploaded while drawing frames (0: off)")
+        ("upload-contexts", value<unsigned>(&upload_contexts)->default_value(1),        "upload contexts (0: upload on the render context)");
+
+    c.add_command_line_options(cmd_options, scm_application_name);
+
+    return (true);
+}
+
+static void init_module()
+{
+    scm::module::initializer::add_pre_core_init_function(initialize_cmd_line);
+}
+
+static scm::module::static_initializer  static_initialize(init_module);
+
+int main(int argc, char **argv)
+{
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+    using boost::assign::list_of;
+
+    shared_ptr<core> scm_core(new core(argc, argv));
+
+    if (list_devices) {
+        const std::vector<std::string> devices = wm::display::egl_devices();
+        out() << "egl devices:" << log::end;
+        for (std::size_t d = 0; d < devices.size(); ++d) {
+            out() << " - " << devices[d] << log::end;
+        }
+        return (0);
+    }
+
+    try {
+        const vec2ui                 image_size(image_width, image_height);
+        const wm::surface::format_desc surface_format(FORMAT_RGBA_8, FORMAT_D24_S8, false, false);
+        const wm::context::attribute_desc context_attribs(4, 4, compatibility, false, false);
+
+        wm::display_ptr             display(new wm::display(display_name));
+        wm::headless_surface_ptr    surface(new wm::headless_surface(display, surface_format,
+                                                                     surfaceless ? vec2ui(0u) : vec2ui(1u)));
+        wm::context_ptr             context(new wm::context(surface, context_attribs));
+
+        context->make_current(surface);
+
+        render_device_ptr           device(new render_device());
+        render_context_ptr          device_context = device->main_context();
+
+        out() << "display: " << display_name << (display->headless() ? " (headless)" : "") << log::end;
+        out() << *device << log::end;
+
+        render_buffer_ptr           color_buffer = device->create_render_buffer(image_size, FORMAT_RGBA_8);
+        render_buffer_ptr           depth_buffer = device->create_render_buffer(image_size, FORMAT_D24_S8);
+        frame_buffer_ptr            frame_buffer = device->create_frame_buffer();
+        frame_buffer->attach_color_buffer(0, color_buffer);
+        frame_buffer->attach_depth_stencil_buffer(depth_buffer);
+
+        const scm::size_t           image_bytes  = image_size.x * image_size.y * size_of_format(FORMAT_RGBA_8);
+        buffer_ptr                  read_buffer  = device->create_buffer(BIND_PIXEL_PACK_BUFFER, USAGE_STREAM_READ, image_bytes);
+
+        const vec2f                 quad_vertices[] = { vec2f(-1.0f, -1.0f), vec2f( 1.0f, -1.0f),
+                                                        vec2f(-1.0f,  1.0f), vec2f( 1.0f,  1.0f) };
+        buffer_ptr                  quad_buffer  = device->create_buffer(BIND_VERTEX_BUFFER, USAGE_STATIC_DRAW,
+                                                                         sizeof(quad_vertices), quad_vertices);
+        vertex_array_ptr            quad_array   = device->create_vertex_array(vertex_format(0, 0, TYPE_VEC2F, sizeof(vec2f)),
+                                                                               list_of(quad_buffer));
+        program_ptr                 fill_program = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   fill_v_source))
+                                                                                 (device->create_shader(STAGE_FRAGMENT_SHADER, fill_f_source)));
+
+        if (   !color_buffer || !depth_buffer || !frame_buffer || !read_buffer
+            || !quad_array || !fill_program) {
+            err() << "headless benchmark: error creating render resources." << log::end;
+            return (-1);
+        }
+
+        // the first readback includes the shader compilation and driver warm up
+        time::high_res_timer    render_timer;
+        time::high_res_timer    readback_timer;
+        double                  render_time   = 0.0;
+        double                  readback_time = 0.0;
+        scm::uint64             checksum      = 0;
+
+        for (unsigned f = 0; f <= frame_count; ++f) {
+            render_timer.start();
+            draw_frame(device_context, frame_buffer, image_size, fill_program, quad_array, f);
+            device_context->sync();
+            render_timer.stop();
+
+            readback_timer.start();
+            {
+                device_context->capture_color_buffer(frame_buffer, 0, texture_region(vec3ui(0), vec3ui(image_size, 1)),
+                                                     FORMAT_RGBA_8, read_buffer);
+                const scm::uint8* data = static_cast<const scm::uint8*>(device_context->map_buffer(read_buffer, ACCESS_READ_ONLY));
+                if (data) {
+                    checksum += data[image_bytes / 2 + 2]; // blue channel changes every frame
+                }
+                device_context->unmap_buffer(read_buffer);
+            }
+            readback_timer.stop();
+
+            if (f > 0) {
+                render_time   += time::to_milliseconds(render_timer.get_time());
+                readback_time += time::to_milliseconds(readback_timer.get_time());
+            }
+        }
+
+        const double frames = static_cast<double>(frame_count > 0 ? frame_count : 1);
+
+        out() << std::fixed << std::setprecision(3)
+              << "headless benchmark (" << image_size.x << "x" << image_size.y << ", "
+              << frame_count << " frames, " << (surfaceless ? "surfaceless" : "pbuffer") << "):" << log::end
+              << " - render:   " << render_time / frames   << "ms/frame, "
+                                 << (render_time > 0.0 ? 1000.0 * frames / render_time : 0.0) << " frames/s" << log::end
+              << " - readback: " << readback_time / frames << "ms/frame, "
+                                 << (readback_time > 0.0 ? (frames * image_bytes / (1024.0 * 1024.0)) / (readback_time / 1000.0) : 0.0) << "MiB/s" << log::end
+              << " - checksum: " << checksum << log::end;
+
+        if (upload_size > 0) {
+            if (upload_contexts > 0 && !device->enable_upload_contexts(context, upload_contexts)) {
+                err() << "headless benchmark: unable to start upload contexts." << log::end;
+                return (-1);
+            }
+
+            std::vector<scm::uint8> volume_data(static_cast<scm::size_t>(upload_size) * upload_size * upload_size);
+            for (scm::size_t i = 0; i < volume_data.size(); ++i) {
+                volume_data[i] = static_cast<scm::uint8>(i * 7);
+            }
+
+            texture_3d_ptr          volume;
+            time::high_res_timer    upload_timer;
+            time::high_res_timer    frame_timer;
+            unsigned                upload_frames = 0;
+            double                  longest_frame = 0.0;
+
+            // without upload contexts the job runs in submit_upload() and no frame is drawn
+            upload_timer.start();
+            upload_task_ptr upload = device->submit_upload(boost::bind(upload_volume, boost::ref(*device), upload_size,
+                                                                       boost::cref(volume_data), boost::ref(volume), _1));
+            while (!upload->acquire(*device_context, false)) {
+                frame_timer.start();
+                draw_frame(device_context, frame_buffer, image_size, fill_program, quad_array, upload_frames);
+                device_context->sync();
+                frame_timer.stop();
+                longest_frame = max(longest_frame, time::to_milliseconds(frame_timer.get_time()));
+                ++upload_frames;
+            }
+            device_context->sync();
+            upload_timer.stop();
+
+            out() << std::fixed << std::setprecision(3)
+                  << "volume upload (" << upload_size << "^3, "
+                  << (upload_contexts > 0 ? "upload contexts" : "render context") << ", "
+                  << (upload->succeeded() ? "ok" : "failed") << "):" << log::end
+                  << " - upload:   " << time::to_milliseconds(upload_timer.get_time()) << "ms" << log::end
+                  << " - frames:   " << upload_frames << " drawn during the upload, longest " << longest_frame << "ms" << log::end;
+
+            volume.reset();
+            device->disable_upload_contexts();
+        }
+    }
+    catch (std::exception& e) {
+        err() << "headless benchmark: " << e.what() << log::end;
+        return (-1);
+    }
+
+    return (0);
+}
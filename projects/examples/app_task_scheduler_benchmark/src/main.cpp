@@ -0,0 +1,275 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/program_options.hpp>
+
+#include <scm/core.h>
+#include <scm/concurrency.h>
+#include <scm/core/time/high_res_timer.h>
+
+namespace {
+
+unsigned    runs            = 5;
+unsigned    array_size      = 1 << 22;
+unsigned    volume_size     = 256;
+unsigned    recursion_depth = 16;
+
+} // namespace
+
+static const std::string    scm_application_name = "schism benchmark: task scheduler";
+
+static bool initialize_cmd_line(scm::core& c)
+{
+    using boost::program_options::options_description;
+    using boost::program_options::value;
+
+    options_description  cmd_options("program options");
+
+    cmd_options.add_options()
+        ("runs,r",          value<unsigned>(&runs)->default_value(5),               "runs per benchmark (best is reported)")
+        ("array,a",         value<unsigned>(&array_size)->default_value(1 << 22),   "element count of the 1d benchmarks")
+        ("volume,v",        value<unsigned>(&volume_size)->default_value(256),      "edge length of the 3d benchmark volume")
+        ("depth,d",         value<unsigned>(&recursion_depth)->default_value(16),   "depth of the task tree benchmark");
+
+    c.add_command_line_options(cmd_options, scm_application_name);
+
+    return (true);
+}
+
+static void init_module()
+{
+    scm::module::initializer::add_pre_core_init_function(initialize_cmd_line);
+}
+
+static scm::module::static_initializer  static_initialize(init_module);
+
+namespace {
+
+using namespace scm::concurrency;
+
+// best time of some runs in milliseconds
+double
+time_best(const boost::function<void ()>& f)
+{
+    scm::time::high_res_timer timer;
+    double                    best = 0.0;
+
+    for (unsigned r = 0; r < runs; ++r) {
+        timer.start();
+        f();
+        timer.stop();
+        const double t = scm::time::to_milliseconds(timer.get_time());
+        best = (r == 0 || t < best) ? t : best;
+    }
+
+    return best;
+}
+
+void
+report(const std::string& name, double serial_ms, double parallel_ms, bool valid)
+{
+    std::cout << std::left  << std::setw(32) << name
+              << std::right << std::fixed << std::setprecision(3)
+              << "serial "    << std::setw(10) << serial_ms   << "msec, "
+              << "parallel "  << std::setw(10) << parallel_ms << "msec, "
+              << "speedup "   << std::setprecision(2) << serial_ms / parallel_ms
+              << (valid ? "" : "  <results differ>") << std::endl;
+}
+
+// 1d: per element math --------------------------------------------------------------------
+struct transform_body
+{
+    transform_body(const std::vector<float>& i, std::vector<float>& o) : _in(i), _out(o) {}
+
+    void operator()(const range_1d& r) const {
+        for (std::size_t i = r._begin; i < r._end; ++i) {
+            const float x = _in[i];
+            _out[i] = std::sqrt(x) * std::sin(x) + std::cos(x * 0.5f);
+        }
+    }
+
+    const std::vector<float>&   _in;
+    std::vector<float>&         _out;
+};
+
+// 1d: uneven cost per element ---------------------------------------------------------------
+struct uneven_body
+{
+    uneven_body(std::vector<double>& o) : _out(o) {}
+
+    void operator()(const range_1d& r) const {
+        for (std::size_t i = r._begin; i < r._end; ++i) {
+            // the cost grows with the index, static partitions would be unbalanced
+            const std::size_t n = 1 + (i * 64) / _out.size();
+            double            s = 0.0;
+            for (std::size_t k = 0; k < n; ++k) {
+                s += 1.0 / static_cast<double>(i + k + 1);
+            }
+            _out[i] = s;
+        }
+    }
+
+    std::vector<double>&        _out;
+};
+
+// 3d: 2x2x2 box downsampling (mip level) -----------------------------------------------------
+struct downsample_body
+{
+    downsample_body(const std::vector<float>& i, std::vector<float>& o, unsigned s) : _in(i), _out(o), _size(s) {}
+
+    void operator()(const range_3d& r) const {
+        const unsigned os = _size / 2;
+        for (unsigned z = r._begin.z; z < r._end.z; ++z) {
+            for (unsigned y = r._begin.y; y < r._end.y; ++y) {
+                for (unsigned x = r._begin.x; x < r._end.x; ++x) {
+                    float s = 0.0f;
+                    for (unsigned d = 0; d < 8; ++d) {
+                        const std::size_t sx = 2 * x + (d & 1);
+                        const std::size_t sy = 2 * y + ((d >> 1) & 1);
+                        const std::size_t sz = 2 * z + (d >> 2);
+                        s += _in[(sz * _size + sy) * _size + sx];
+                    }
+                    _out[(static_cast<std::size_t>(z) * os + y) * os + x] = s * 0.125f;
+                }
+            }
+        }
+    }
+
+    const std::vector<float>&   _in;
+    std::vector<float>&         _out;
+    unsigned                    _size;
+};
+
+// task tree: binary recursion with continuations -------------------------------------------
+void
+count_leaves(task_group& g, unsigned depth, boost::atomic<unsigned>& leaves)
+{
+    if (depth == 0) {
+        leaves.fetch_add(1, boost::memory_order_relaxed);
+        return;
+    }
+    g.run(boost::bind(&count_leaves, boost::ref(g), depth - 1, boost::ref(leaves)));
+    count_leaves(g, depth - 1, leaves);
+}
+
+void
+count_leaves_serial(unsigned depth, unsigned& leaves)
+{
+    if (depth == 0) {
+        ++leaves;
+        return;
+    }
+    count_leaves_serial(depth - 1, leaves);
+    count_leaves_serial(depth - 1, leaves);
+}
+
+void
+mark_done(bool& done)
+{
+    done = true;
+}
+
+template<typename body_type, typename range_type>
+void
+run_parallel(task_scheduler& s, const range_type& r, const body_type& b)
+{
+    parallel_for(s, r, b);
+}
+
+template<typename body_type, typename range_type>
+void
+run_serial(const range_type& r, const body_type& b)
+{
+    b(r);
+}
+
+void
+run_task_tree(task_scheduler& s, unsigned depth, unsigned& leaves, bool& continued)
+{
+    boost::atomic<unsigned> l(0);
+    continued = false;
+    {
+        task_group g(s);
+        g.run(boost::bind(&count_leaves, boost::ref(g), depth, boost::ref(l)));
+        g.then(boost::bind(&mark_done, boost::ref(continued)));
+        g.wait();
+    }
+    leaves = l.load();
+}
+
+void
+run_task_tree_serial(unsigned depth, unsigned& leaves)
+{
+    leaves = 0;
+    count_leaves_serial(depth, leaves);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    scm::shared_ptr<scm::core>      scm_core(new scm::core(argc, argv));
+
+    task_scheduler& scheduler = *scm_core->scheduler();
+
+    std::cout << "task scheduler benchmark (" << scheduler.thread_count() << " worker threads, "
+              << runs << " runs, best reported)" << std::endl;
+
+    { // 1d transform
+        std::vector<float> in(array_size);
+        std::vector<float> out_s(array_size);
+        std::vector<float> out_p(array_size);
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            in[i] = static_cast<float>(i % 1000) * 0.01f;
+        }
+        const range_1d r(0, in.size());
+
+        const double ts = time_best(boost::bind(&run_serial<transform_body, range_1d>, r, transform_body(in, out_s)));
+        const double tp = time_best(boost::bind(&run_parallel<transform_body, range_1d>, boost::ref(scheduler), r, transform_body(in, out_p)));
+        report("parallel_for 1d (transform)", ts, tp, out_s == out_p);
+    }
+    { // 1d uneven
+        std::vector<double> out_s(array_size / 4);
+        std::vector<double> out_p(array_size / 4);
+        const range_1d r(0, out_s.size());
+
+        const double ts = time_best(boost::bind(&run_serial<uneven_body, range_1d>, r, uneven_body(out_s)));
+        const double tp = time_best(boost::bind(&run_parallel<uneven_body, range_1d>, boost::ref(scheduler), r, uneven_body(out_p)));
+        report("parallel_for 1d (uneven cost)", ts, tp, out_s == out_p);
+    }
+    { // 3d downsample
+        const unsigned      os = volume_size / 2;
+        std::vector<float>  in(static_cast<std::size_t>(volume_size) * volume_size * volume_size);
+        std::vector<float>  out_s(static_cast<std::size_t>(os) * os * os);
+        std::vector<float>  out_p(out_s.size());
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            in[i] = static_cast<float>(i % 251);
+        }
+        const range_3d r(scm::math::vec3ui(0u), scm::math::vec3ui(os));
+
+        const double ts = time_best(boost::bind(&run_serial<downsample_body, range_3d>, r, downsample_body(in, out_s, volume_size)));
+        const double tp = time_best(boost::bind(&run_parallel<downsample_body, range_3d>, boost::ref(scheduler), r, downsample_body(in, out_p, volume_size)));
+        report("parallel_for 3d (downsample)", ts, tp, out_s == out_p);
+    }
+    { // task tree with continuation
+        unsigned leaves_s  = 0;
+        unsigned leaves_p  = 0;
+        bool     continued = false;
+
+        const double ts = time_best(boost::bind(&run_task_tree_serial, recursion_depth, boost::ref(leaves_s)));
+        const double tp = time_best(boost::bind(&run_task_tree, boost::ref(scheduler), recursion_depth, boost::ref(leaves_p), boost::ref(continued)));
+        report("task_group tree (spawn cost)", ts, tp, leaves_s == leaves_p && continued);
+    }
+
+    return (0);
+}
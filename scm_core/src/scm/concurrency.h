@@ -0,0 +1,16 @@
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_CORE_CONCURRENCY_H_INCLUDED
+#define SCM_CORE_CONCURRENCY_H_INCLUDED
+
+#include <scm/core/concurrency/task_scheduler.h>
+#include <scm/core/concurrency/task_group.h>
+#include <scm/core/concurrency/parallel_for.h>
+
+namespace scm {
+namespace concurrency {
+} // namespace concurrency
+} // namespace scm
+
+#endif // SCM_CORE_CONCURRENCY_H_INCLUDED
@@ -0,0 +1,79 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_CORE_CONCURRENCY_PARALLEL_FOR_H_INCLUDED
+#define SCM_CORE_CONCURRENCY_PARALLEL_FOR_H_INCLUDED
+
+#include <cstddef>
+
+#include <scm/core/math/math.h>
+
+#include <scm/core/concurrency/task_group.h>
+#include <scm/core/concurrency/task_scheduler.h>
+
+namespace scm {
+namespace concurrency {
+
+// [begin, end) index range, split into pieces of at most grain indices
+//  - grain 0 chooses a grain giving a few pieces per worker thread
+struct range_1d
+{
+    range_1d(std::size_t b, std::size_t e, std::size_t grain = 0)
+      : _begin(b), _end(e), _grain(grain) {}
+
+    std::size_t             size() const        { return _end > _begin ? _end - _begin : 0; }
+    bool                    empty() const       { return _end <= _begin; }
+    bool                    splittable() const  { return size() > _grain; }
+    range_1d                split();            // keeps the lower half, returns the upper
+
+    std::size_t             _begin;
+    std::size_t             _end;
+    std::size_t             _grain;
+}; // struct range_1d
+
+// [begin, end) box of grid cells (e.g. voxels or bricks), split along the axis with the
+// most grain sized pieces left
+//  - grain (0, 0, 0) chooses a grain giving a few pieces per worker thread
+struct range_3d
+{
+    range_3d(const math::vec3ui& b, const math::vec3ui& e, const math::vec3ui& grain = math::vec3ui(0u))
+      : _begin(b), _end(e), _grain(grain) {}
+
+    math::vec3ui            extent() const;
+    scm::uint64             volume() const;
+    bool                    empty() const       { return volume() == 0; }
+    bool                    splittable() const;
+    range_3d                split();            // keeps the lower half, returns the upper
+
+    math::vec3ui            _begin;
+    math::vec3ui            _end;
+    math::vec3ui            _grain;
+}; // struct range_3d
+
+// the scheduler owned by scm::core, 0 without a core instance
+__scm_export(core) task_scheduler*  default_scheduler();
+
+// parallel_for
+//  - calls body(sub_range) for disjoint pieces of the range covering it completely, the
+//    pieces run concurrently on the scheduler (recursive halving, idle workers steal the
+//    larger halves) and the call returns when all pieces are done
+//  - body is shared by all pieces and has to be safe for concurrent calls
+//  - without a scheduler (or a range too small to split) the body runs serially for the
+//    whole range on the calling thread
+template<typename body_type>
+void parallel_for(task_scheduler& scheduler, const range_1d& range, const body_type& body);
+template<typename body_type>
+void parallel_for(task_scheduler& scheduler, const range_3d& range, const body_type& body);
+
+template<typename body_type>
+void parallel_for(const range_1d& range, const body_type& body);
+template<typename body_type>
+void parallel_for(const range_3d& range, const body_type& body);
+
+} // namespace concurrency
+} // namespace scm
+
+#include "parallel_for.inl"
+
+#endif // SCM_CORE_CONCURRENCY_PARALLEL_FOR_H_INCLUDED
@@ -0,0 +1,197 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+
+namespace scm {
+namespace concurrency {
+
+inline
+range_1d
+range_1d::split()
+{
+    const std::size_t mid = _begin + size() / 2;
+    range_1d          upper(mid, _end, _grain);
+
+    _end = mid;
+
+    return upper;
+}
+
+inline
+math::vec3ui
+range_3d::extent() const
+{
+    return math::vec3ui(_end.x > _begin.x ? _end.x - _begin.x : 0u,
+                        _end.y > _begin.y ? _end.y - _begin.y : 0u,
+                        _end.z > _begin.z ? _end.z - _begin.z : 0u);
+}
+
+inline
+scm::uint64
+range_3d::volume() const
+{
+    const math::vec3ui e = extent();
+    return static_cast<scm::uint64>(e.x) * e.y * e.z;
+}
+
+inline
+bool
+range_3d::splittable() const
+{
+    const math::vec3ui e = extent();
+    return    e.x > (std::max)(_grain.x, 1u)
+           || e.y > (std::max)(_grain.y, 1u)
+           || e.z > (std::max)(_grain.z, 1u);
+}
+
+inline
+range_3d
+range_3d::split()
+{
+    const math::vec3ui e = extent();
+
+    // axis with the most grain sized pieces
+    unsigned axis   = 0;
+    float    pieces = 0.0f;
+    for (unsigned a = 0; a < 3; ++a) {
+        const unsigned g = (std::max)(_grain[a], 1u);
+        if (e[a] > g && static_cast<float>(e[a]) / g > pieces) {
+            pieces = static_cast<float>(e[a]) / g;
+            axis   = a;
+        }
+    }
+
+    const unsigned mid = _begin[axis] + e[axis] / 2;
+    range_3d       upper(*this);
+
+    upper._begin[axis] = mid;
+    _end[axis]         = mid;
+
+    return upper;
+}
+
+namespace detail {
+
+// pieces per thread for automatic grains, leaves room for balancing uneven work
+const unsigned auto_grain_pieces_per_thread = 4;
+
+inline
+range_1d
+resolve_grain(const range_1d& r, unsigned thread_count)
+{
+    range_1d ret(r);
+
+    if (ret._grain == 0) {
+        const std::size_t pieces = auto_grain_pieces_per_thread * (thread_count + 1);
+        ret._grain = (std::max)((r.size() + pieces - 1) / pieces, static_cast<std::size_t>(1));
+    }
+
+    return ret;
+}
+
+inline
+range_3d
+resolve_grain(const range_3d& r, unsigned thread_count)
+{
+    range_3d ret(r);
+
+    if (ret._grain == math::vec3ui(0u)) {
+        const scm::uint64 pieces = auto_grain_pieces_per_thread * (thread_count + 1);
+        const scm::uint64 target = (std::max)(r.volume() / pieces, static_cast<scm::uint64>(1));
+
+        // halve the longest side until a piece is small enough
+        ret._grain = math::max(r.extent(), math::vec3ui(1u));
+        while (static_cast<scm::uint64>(ret._grain.x) * ret._grain.y * ret._grain.z > target) {
+            unsigned a = 0;
+            if (ret._grain.y > ret._grain[a]) a = 1;
+            if (ret._grain.z > ret._grain[a]) a = 2;
+            if (ret._grain[a] <= 1) {
+                break;
+            }
+            ret._grain[a] = (ret._grain[a] + 1) / 2;
+        }
+    }
+
+    return ret;
+}
+
+template<typename range_type,
+         typename body_type>
+void
+run_range(task_group& group, range_type range, const body_type& body)
+{
+    // hand the upper halves to the group, idle workers steal the large ones first
+    while (range.splittable()) {
+        group.run(boost::bind(&run_range<range_type, body_type>, boost::ref(group), range.split(), boost::cref(body)));
+    }
+    body(range);
+}
+
+template<typename range_type,
+         typename body_type>
+void
+parallel_for_range(task_scheduler& scheduler, const range_type& range, const body_type& body)
+{
+    if (range.empty()) {
+        return;
+    }
+
+    const range_type r = resolve_grain(range, scheduler.thread_count());
+
+    if (!r.splittable()) {
+        body(r);
+        return;
+    }
+
+    task_group group(scheduler);
+    run_range(group, r, body);
+    group.wait();
+}
+
+} // namespace detail
+
+template<typename body_type>
+void
+parallel_for(task_scheduler& scheduler, const range_1d& range, const body_type& body)
+{
+    detail::parallel_for_range(scheduler, range, body);
+}
+
+template<typename body_type>
+void
+parallel_for(task_scheduler& scheduler, const range_3d& range, const body_type& body)
+{
+    detail::parallel_for_range(scheduler, range, body);
+}
+
+template<typename body_type>
+void
+parallel_for(const range_1d& range, const body_type& body)
+{
+    if (task_scheduler* s = default_scheduler()) {
+        detail::parallel_for_range(*s, range, body);
+    }
+    else if (!range.empty()) {
+        body(range);
+    }
+}
+
+template<typename body_type>
+void
+parallel_for(const range_3d& range, const body_type& body)
+{
+    if (task_scheduler* s = default_scheduler()) {
+        detail::parallel_for_range(*s, range, body);
+    }
+    else if (!range.empty()) {
+        body(range);
+    }
+}
+
+} // namespace concurrency
+} // namespace scm
@@ -0,0 +1,99 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "task_group.h"
+
+#include <boost/thread/thread.hpp>
+
+namespace scm {
+namespace concurrency {
+
+task_group::task_group(task_scheduler& scheduler)
+  : _scheduler(scheduler)
+  , _pending_tasks(0)
+  , _finishing_tasks(0)
+{
+}
+
+task_group::~task_group()
+{
+    wait();
+}
+
+void
+task_group::run(const task_function& f)
+{
+    _pending_tasks.fetch_add(1);
+    _scheduler.spawn(task_scheduler::task(f, this));
+}
+
+void
+task_group::then(const task_function& f)
+{
+    {
+        boost::lock_guard<boost::mutex> lock(_continuations_mutex);
+        if (_pending_tasks.load() > 0) {
+            _continuations.push_back(f);
+            return;
+        }
+    }
+    run(f);
+}
+
+void
+task_group::wait()
+{
+    task_scheduler::worker* w = _scheduler.current_worker();
+
+    while (!done()) {
+        task_scheduler::task t;
+        if (_scheduler.acquire_task(w, t)) {
+            _scheduler.execute(t);
+        }
+        else {
+            boost::this_thread::yield();
+        }
+    }
+}
+
+bool
+task_group::done() const
+{
+    // a task announces its completion before dropping the pending count and withdraws it
+    // after the continuations were launched (raising the count again), reading the pending
+    // count around the finishing count catches completions in between
+    return    _pending_tasks.load()   == 0
+           && _finishing_tasks.load() == 0
+           && _pending_tasks.load()   == 0;
+}
+
+task_scheduler&
+task_group::scheduler() const
+{
+    return _scheduler;
+}
+
+void
+task_group::task_finished()
+{
+    _finishing_tasks.fetch_add(1);
+
+    if (_pending_tasks.fetch_sub(1) == 1) {
+        std::vector<task_function> continuations;
+        {
+            boost::lock_guard<boost::mutex> lock(_continuations_mutex);
+            if (_pending_tasks.load() == 0) {
+                continuations.swap(_continuations);
+            }
+        }
+        for (std::vector<task_function>::const_iterator c = continuations.begin(); c != continuations.end(); ++c) {
+            run(*c);
+        }
+    }
+
+    _finishing_tasks.fetch_sub(1);
+}
+
+} // namespace concurrency
+} // namespace scm
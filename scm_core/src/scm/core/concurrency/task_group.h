@@ -0,0 +1,68 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_CORE_CONCURRENCY_TASK_GROUP_H_INCLUDED
+#define SCM_CORE_CONCURRENCY_TASK_GROUP_H_INCLUDED
+
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <scm/core/concurrency/task_scheduler.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace concurrency {
+
+// task_group
+//  - runs tasks on a task_scheduler and waits for their completion
+//  - tasks may run further tasks in the same group (recursive decomposition)
+//  - then() registers a continuation that is run in the group as soon as all tasks of the
+//    group finished, right away if there are none pending
+//  - wait() executes tasks on the calling thread until all tasks and continuations of the
+//    group completed, the destructor waits as well
+//  - exceptions escaping a task are reported to the error log and swallowed
+class __scm_export(core) task_group : boost::noncopyable
+{
+public:
+    typedef task_scheduler::task_function   task_function;
+
+public:
+    task_group(task_scheduler& scheduler);
+    virtual ~task_group();
+
+    void                        run(const task_function& f);
+    void                        then(const task_function& f);
+
+    void                        wait();
+    bool                        done() const;
+
+    task_scheduler&             scheduler() const;
+
+protected:
+    void                        task_finished();
+
+protected:
+    task_scheduler&             _scheduler;
+
+    boost::atomic<int>          _pending_tasks;
+    boost::atomic<int>          _finishing_tasks;   // between completion and continuation launch
+
+    boost::mutex                _continuations_mutex;
+    std::vector<task_function>  _continuations;
+
+    friend class task_scheduler;
+
+}; // class task_group
+
+} // namespace concurrency
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_CORE_CONCURRENCY_TASK_GROUP_H_INCLUDED
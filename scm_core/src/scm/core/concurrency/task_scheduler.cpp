@@ -0,0 +1,246 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "task_scheduler.h"
+
+#include <algorithm>
+#include <exception>
+
+#include <boost/bind.hpp>
+
+#include <scm/log.h>
+#include <scm/core/core.h>
+#include <scm/core/concurrency/parallel_for.h>
+#include <scm/core/concurrency/task_group.h>
+
+namespace {
+
+// yields of an idle worker before it goes to sleep
+const unsigned max_idle_spins = 64;
+
+} // namespace
+
+namespace scm {
+namespace concurrency {
+
+boost::thread_specific_ptr<task_scheduler::worker> task_scheduler::_current_worker(&task_scheduler::release_worker);
+
+task_scheduler::task_scheduler(unsigned thread_count)
+  : _queued_tasks(0)
+  , _sleeping_workers(0)
+  , _running(true)
+{
+    const unsigned worker_count = (thread_count > 0) ? thread_count : default_thread_count();
+
+    _workers.reserve(worker_count);
+    for (unsigned i = 0; i < worker_count; ++i) {
+        shared_ptr<worker> w(new worker);
+        w->_scheduler    = this;
+        w->_index        = i;
+        w->_random_state = 2463534242u + 7919u * i;
+        _workers.push_back(w);
+    }
+    for (unsigned i = 0; i < worker_count; ++i) {
+        _threads.create_thread(boost::bind(&task_scheduler::worker_loop, this, _workers[i].get()));
+    }
+}
+
+task_scheduler::~task_scheduler()
+{
+    {
+        boost::lock_guard<boost::mutex> lock(_sleep_mutex);
+        _running.store(false);
+    }
+    _sleep_condition.notify_all();
+    _threads.join_all();
+}
+
+unsigned
+task_scheduler::thread_count() const
+{
+    return static_cast<unsigned>(_workers.size());
+}
+
+bool
+task_scheduler::is_worker_thread() const
+{
+    return current_worker() != 0;
+}
+
+unsigned
+task_scheduler::default_thread_count()
+{
+    const unsigned hw_threads = boost::thread::hardware_concurrency();
+    return (hw_threads > 1) ? hw_threads - 1 : 1u;
+}
+
+void
+task_scheduler::spawn(const task& t)
+{
+    worker* w = current_worker();
+
+    if (w) {
+        boost::lock_guard<boost::mutex> lock(w->_tasks_mutex);
+        w->_tasks.push_back(t);
+    }
+    else {
+        boost::lock_guard<boost::mutex> lock(_injected_mutex);
+        _injected_tasks.push_back(t);
+    }
+
+    // the queued count is raised before looking for sleepers, a worker about to sleep
+    // checks it after announcing itself, so no wake up is lost
+    _queued_tasks.fetch_add(1);
+    if (_sleeping_workers.load() > 0) {
+        boost::lock_guard<boost::mutex> lock(_sleep_mutex);
+        _sleep_condition.notify_one();
+    }
+}
+
+bool
+task_scheduler::acquire_task(worker* w, task& t)
+{
+    if (_queued_tasks.load() <= 0) {
+        return false;
+    }
+    return    (w && pop_local(w, t))
+           || pop_injected(t)
+           || steal(w, t);
+}
+
+void
+task_scheduler::execute(task& t)
+{
+    try {
+        t._function();
+    }
+    catch (std::exception& e) {
+        scm::err() << log::error
+                   << "task_scheduler::execute(): uncaught exception in task (" << e.what() << ")." << log::end;
+    }
+    catch (...) {
+        scm::err() << log::error
+                   << "task_scheduler::execute(): uncaught unknown exception in task." << log::end;
+    }
+
+    // release the bound state before the group is notified
+    t._function.clear();
+    if (t._group) {
+        t._group->task_finished();
+    }
+}
+
+bool
+task_scheduler::pop_local(worker* w, task& t)
+{
+    boost::lock_guard<boost::mutex> lock(w->_tasks_mutex);
+    if (w->_tasks.empty()) {
+        return false;
+    }
+    t = w->_tasks.back();
+    w->_tasks.pop_back();
+    _queued_tasks.fetch_sub(1);
+    return true;
+}
+
+bool
+task_scheduler::pop_injected(task& t)
+{
+    boost::lock_guard<boost::mutex> lock(_injected_mutex);
+    if (_injected_tasks.empty()) {
+        return false;
+    }
+    t = _injected_tasks.front();
+    _injected_tasks.pop_front();
+    _queued_tasks.fetch_sub(1);
+    return true;
+}
+
+bool
+task_scheduler::steal(worker* w, task& t)
+{
+    const unsigned worker_count = static_cast<unsigned>(_workers.size());
+    unsigned       victim       = 0;
+
+    if (w) {
+        // xorshift, random victims spread the stealing over the workers
+        w->_random_state ^= w->_random_state << 13;
+        w->_random_state ^= w->_random_state >> 17;
+        w->_random_state ^= w->_random_state << 5;
+        victim = w->_random_state % worker_count;
+    }
+
+    for (unsigned i = 0; i < worker_count; ++i, victim = (victim + 1) % worker_count) {
+        worker* v = _workers[victim].get();
+        if (v == w) {
+            continue;
+        }
+        boost::lock_guard<boost::mutex> lock(v->_tasks_mutex);
+        if (!v->_tasks.empty()) {
+            t = v->_tasks.front();
+            v->_tasks.pop_front();
+            _queued_tasks.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+task_scheduler::worker*
+task_scheduler::current_worker() const
+{
+    worker* w = _current_worker.get();
+    return (w && w->_scheduler == this) ? w : 0;
+}
+
+void
+task_scheduler::worker_loop(worker* w)
+{
+    _current_worker.reset(w);
+
+    unsigned idle_spins = 0;
+
+    for (;;) {
+        task t;
+
+        if (acquire_task(w, t)) {
+            execute(t);
+            idle_spins = 0;
+            continue;
+        }
+        if (!_running.load()) {
+            break;
+        }
+        if (++idle_spins < max_idle_spins) {
+            boost::this_thread::yield();
+            continue;
+        }
+
+        boost::unique_lock<boost::mutex> lock(_sleep_mutex);
+        _sleeping_workers.fetch_add(1);
+        while (_queued_tasks.load() <= 0 && _running.load()) {
+            _sleep_condition.wait(lock);
+        }
+        _sleeping_workers.fetch_sub(1);
+        idle_spins = 0;
+    }
+
+    _current_worker.reset();
+}
+
+void
+task_scheduler::release_worker(worker* /*w*/)
+{
+    // the workers are owned by the scheduler
+}
+
+task_scheduler*
+default_scheduler()
+{
+    return core::check_instance() ? core::instance().scheduler() : 0;
+}
+
+} // namespace concurrency
+} // namespace scm
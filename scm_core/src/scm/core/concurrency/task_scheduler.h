@@ -0,0 +1,115 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_CORE_CONCURRENCY_TASK_SCHEDULER_H_INCLUDED
+#define SCM_CORE_CONCURRENCY_TASK_SCHEDULER_H_INCLUDED
+
+#include <deque>
+#include <vector>
+
+#include <boost/atomic.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <scm/core/memory.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace concurrency {
+
+class task_group;
+
+// task_scheduler
+//  - a fixed set of worker threads executing small tasks, scm::core owns the default
+//    scheduler (core::scheduler(), '--task-threads' command line option)
+//  - every worker owns a task deque: tasks spawned on a worker are pushed to and popped
+//    from the back of its own deque (depth first, cache warm), idle workers steal from the
+//    front of the deques of other workers (breadth first, the largest pieces of work)
+//  - tasks spawned from other threads go to a shared injection queue
+//  - workers without work spin briefly and then sleep until new tasks arrive
+//  - threads waiting for a task_group execute tasks themselves until the group completes,
+//    so the default worker count leaves one hardware thread to the waiting thread
+//  - tasks are only submitted through task_group (see also parallel_for)
+class __scm_export(core) task_scheduler : boost::noncopyable
+{
+public:
+    typedef boost::function<void ()>    task_function;
+
+public:
+    // thread_count 0: one worker less than hardware threads (at least one)
+    task_scheduler(unsigned thread_count = 0);
+    virtual ~task_scheduler();
+
+    unsigned                    thread_count() const;
+
+    // true if called from one of the workers of this scheduler
+    bool                        is_worker_thread() const;
+
+    static unsigned             default_thread_count();
+
+protected:
+    struct task {
+        task() : _group(0) {}
+        task(const task_function& f, task_group* g) : _function(f), _group(g) {}
+
+        task_function           _function;
+        task_group*             _group;
+    }; // struct task
+
+    struct worker {
+        worker() : _scheduler(0), _index(0), _random_state(0) {}
+
+        task_scheduler*         _scheduler;
+        unsigned                _index;
+        unsigned                _random_state;  // victim selection
+
+        boost::mutex            _tasks_mutex;
+        std::deque<task>        _tasks;
+    }; // struct worker
+
+    void                        spawn(const task& t);
+    bool                        acquire_task(worker* w, task& t);
+    void                        execute(task& t);
+
+    bool                        pop_local(worker* w, task& t);
+    bool                        pop_injected(task& t);
+    bool                        steal(worker* w, task& t);
+
+    worker*                     current_worker() const;
+
+    void                        worker_loop(worker* w);
+    static void                 release_worker(worker* w);
+
+protected:
+    std::vector<shared_ptr<worker> >    _workers;
+    boost::thread_group                 _threads;
+
+    boost::mutex                        _injected_mutex;
+    std::deque<task>                    _injected_tasks;
+
+    boost::atomic<int>                  _queued_tasks;      // in all queues
+    boost::atomic<int>                  _sleeping_workers;
+    boost::atomic<bool>                 _running;
+
+    boost::mutex                        _sleep_mutex;
+    boost::condition_variable           _sleep_condition;
+
+    static boost::thread_specific_ptr<worker>   _current_worker;
+
+    friend class task_group;
+
+}; // class task_scheduler
+
+} // namespace concurrency
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_CORE_CONCURRENCY_TASK_SCHEDULER_H_INCLUDED
@@ -14,6 +14,8 @@
 #include <scm/log.h>
 #include <scm/time.h>
 #include <scm/core/version.h>
+#include <scm/core/concurrency/task_scheduler.h>
+#include <scm/core/platform/system_info.h>
 #include <scm/core/log/logger_state.h>
 #include <scm/core/log/listener_file.h>
 #include <scm/core/log/listener_ostream.h>
@@ -154,6 +156,12 @@ core::command_line_positions()
     return (_command_line_positions);
 }
 
+concurrency::task_scheduler*
+core::scheduler() const
+{
+    return (_scheduler.get());
+}
+
 bool
 core::initialize(int argc, char **argv)
 {
@@ -171,7 +179,11 @@ core::initialize(int argc, char **argv)
     _system_state = ss_init;
 
     _command_line_options.add_options()
-            ("help", "show this help message");
+            ("help", "show this help message")
+            ("task-threads", boost::program_options::value<unsigned>()->default_value(0),
+                             "worker threads of the task scheduler (0: hardware threads - 1)")
+            ("simd-level",   boost::program_options::value<std::string>(),
+                             "highest simd kernels used (generic, sse2, sse4.2, avx, avx2, avx512)");
 
     scm::out() << log::info
                << " - parsing command line options" << log::end;
@@ -181,6 +193,30 @@ core::initialize(int argc, char **argv)
         return (false);
     }
 
+    if (_command_line.count("simd-level")) {
+        simd_level l = simd_generic;
+        if (!simd_level_from_name(_command_line["simd-level"].as<std::string>(), l)) {
+            scm::err() << log::fatal
+                       << "core::initialize(): unknown simd level ("
+                       << _command_line["simd-level"].as<std::string>() << ")" << log::end;
+            return (false);
+        }
+        system_info::limit_simd_level(l);
+    }
+    scm::out() << log::info
+               << " - host system: " << system_info::host() << log::end;
+
+    try {
+        _scheduler.reset(new concurrency::task_scheduler(_command_line["task-threads"].as<unsigned>()));
+    }
+    catch (std::exception& e) {
+        scm::err() << log::fatal
+                   << "core::initialize(): unable to start task scheduler (" << e.what() << ")" << log::end;
+        return (false);
+    }
+    scm::out() << log::info
+               << " - started task scheduler (" << _scheduler->thread_count() << " worker threads)" << log::end;
+
     scm::out() << log::info
                << " - running post core init functions" << log::end;
 
@@ -210,6 +246,9 @@ core::shutdown()
     }
 
     // shutdown core
+    scm::out() << log::info
+               << " - stopping task scheduler" << log::end;
+    _scheduler.reset();
 
     scm::out() << log::info
                << " - running post core shutdown functions" << log::end;
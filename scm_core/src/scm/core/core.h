@@ -24,6 +24,10 @@
 
 namespace scm {
 
+namespace concurrency {
+class task_scheduler;
+} // namespace concurrency
+
 class __scm_export(core) core : boost::noncopyable
 {
 public:
@@ -58,6 +62,9 @@ public:
                                                                      const std::string& module);
     command_line_position_desc&             command_line_positions();
 
+    // the task scheduler of the application, worker count from the '--task-threads' option
+    concurrency::task_scheduler*            scheduler() const;
+
 protected:
     bool                                    initialize(int argc, char **argv);
     bool                                    shutdown();
@@ -75,6 +82,8 @@ protected:
     command_line_desc_container             _module_options;
     command_line_result                     _command_line;
 
+    scoped_ptr<concurrency::task_scheduler> _scheduler;
+
 private:
     static core*                            _instance;
 
@@ -0,0 +1,74 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_CORE_CPU_DISPATCH_H_INCLUDED
+#define SCM_CORE_CPU_DISPATCH_H_INCLUDED
+
+#include <cassert>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/platform/system_info.h>
+
+namespace scm {
+
+// cpu_dispatch
+//  - table of variants of a kernel for the simd levels, get() returns the variant for the
+//    highest level not above system_info::host().simd(), so one binary carries e.g. generic
+//    and avx2 code paths of a hot loop
+//  - the variants live in one translation unit, the simd ones compiled through
+//    scm_target("avx2") (gcc) while the rest of the file keeps the baseline flags
+//  - the lookup is a few compares, resolve once per batch of work and not per element
+//
+//    typedef void (convert_func)(float*, const float*, scm::size_t);
+//    const cpu_dispatch<convert_func> convert = cpu_dispatch<convert_func>(convert_generic)
+//                                                   .add(simd_sse2, convert_sse2)
+//                                                   .add(simd_avx2, convert_avx2);
+//    convert.get()(d, s, c);
+template<typename function_type>
+class cpu_dispatch
+{
+public:
+    typedef function_type*      function_ptr;
+
+public:
+    explicit cpu_dispatch(function_ptr generic) {
+        assert(generic != 0);
+        for (int l = 0; l < simd_level_count; ++l) {
+            _variants[l] = 0;
+        }
+        _variants[simd_generic] = generic;
+    }
+
+    cpu_dispatch&               add(simd_level l, function_ptr f) {
+        assert(l < simd_level_count);
+        _variants[l] = f;
+        return *this;
+    }
+
+    function_ptr                get() const {
+        return get(system_info::host().simd());
+    }
+    function_ptr                get(simd_level l) const {
+        return _variants[selected_level(l)];
+    }
+
+    simd_level                  selected_level() const {
+        return selected_level(system_info::host().simd());
+    }
+    simd_level                  selected_level(simd_level l) const {
+        int s = (l < simd_level_count) ? l : simd_level_count - 1;
+        while (s > simd_generic && _variants[s] == 0) {
+            --s;
+        }
+        return static_cast<simd_level>(s);
+    }
+
+private:
+    function_ptr                _variants[simd_level_count];
+
+}; // class cpu_dispatch
+
+} // namespace scm
+
+#endif // SCM_CORE_CPU_DISPATCH_H_INCLUDED
@@ -27,6 +27,7 @@
 #   define SCM_COMPILER_VER        _MSC_VER
 #   define scm_force_inline         __force_inline
 #   define scm_align(border)        __declspec(align(border))
+#   define scm_target(isa)
 #elif defined(__GNUC__)
 #   define SCM_COMPILER            SCM_COMPILER_GNUC
 #   define SCM_COMPILER_VER        (((__GNUC__)*100) + \
@@ -34,6 +35,7 @@
                                     __GNUC_PATCHLEVEL__)
 #   define scm_force_inline         __attribute__ ((always_inline))
 #   define scm_align(border)        __attribute__ ((aligned(border)))
+#   define scm_target(isa)          __attribute__ ((target(isa)))
 #else
 #   error "unknown compiler"
 #endif
@@ -54,6 +56,14 @@
 #   define SCM_ARCHITECTURE_TYPE   SCM_ARCHITECTURE_32
 #endif
 
+// instruction set (x86 simd kernels are selected at runtime, see cpu_dispatch.h)
+#if    defined(__x86_64__) || defined(_M_X64) \
+    || defined(__i386__)   || defined(_M_IX86)
+#   define SCM_ARCHITECTURE_X86    1
+#else
+#   define SCM_ARCHITECTURE_X86    0
+#endif
+
 // compiler messages
 #define TO_STR(x)                   BOOST_PP_STRINGIZE(x)
 #define todo(msg)                   message(__FILE__ "(" TO_STR(__LINE__) "): " "todo: " #msg)
@@ -0,0 +1,523 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "system_info.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ostream>
+#include <set>
+#include <utility>
+
+#include <boost/thread/thread.hpp>
+
+#if SCM_ARCHITECTURE_X86
+#   if SCM_COMPILER == SCM_COMPILER_MSVC
+#       include <intrin.h>
+#   else
+#       include <cpuid.h>
+#   endif
+#endif // SCM_ARCHITECTURE_X86
+
+#if SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+#   include <vector>
+#   include <scm/core/platform/windows.h>
+#elif SCM_PLATFORM == SCM_PLATFORM_APPLE
+#   include <sys/types.h>
+#   include <sys/sysctl.h>
+#else
+#   include <fstream>
+#   include <sstream>
+#endif
+
+namespace {
+
+const char* simd_level_names[] = {
+    "generic",
+    "sse2",
+    "sse4.2",
+    "avx",
+    "avx2",
+    "avx512"
+};
+
+const char* cpu_feature_names[] = {
+    "sse2",
+    "sse3",
+    "ssse3",
+    "sse4.1",
+    "sse4.2",
+    "popcnt",
+    "avx",
+    "f16c",
+    "fma",
+    "avx2",
+    "bmi2",
+    "avx512f",
+    "avx512dq",
+    "avx512bw",
+    "avx512vl"
+};
+
+#if SCM_ARCHITECTURE_X86
+
+void
+cpuid(scm::uint32 leaf, scm::uint32 subleaf, scm::uint32 regs[4])
+{
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<scm::uint32>(r[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// register state enabled by the operating system (xcr0), only valid with osxsave
+scm::uint64
+xgetbv0()
+{
+#if SCM_COMPILER == SCM_COMPILER_MSVC
+    return _xgetbv(0);
+#else
+    scm::uint32 lo;
+    scm::uint32 hi;
+    __asm__ __volatile__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<scm::uint64>(hi) << 32) | lo;
+#endif
+}
+
+bool
+bit(scm::uint32 r, unsigned b)
+{
+    return (r & (1u << b)) != 0;
+}
+
+#endif // SCM_ARCHITECTURE_X86
+
+#if SCM_PLATFORM == SCM_PLATFORM_LINUX
+
+bool
+read_sysfs(const std::string& path, std::string& value)
+{
+    std::ifstream f(path.c_str());
+    return static_cast<bool>(std::getline(f, value));
+}
+
+// sizes like '48K' or '32M'
+scm::size_t
+parse_size(const std::string& s)
+{
+    std::istringstream  is(s);
+    scm::size_t         v = 0;
+    char                unit = 0;
+
+    if (!(is >> v)) {
+        return 0;
+    }
+    if (is >> unit) {
+        switch (unit) {
+            case 'K': v <<= 10; break;
+            case 'M': v <<= 20; break;
+            case 'G': v <<= 30; break;
+        }
+    }
+    return v;
+}
+
+// cpu lists like '0-3,8,10-11'
+unsigned
+count_list_entries(const std::string& s)
+{
+    std::istringstream  is(s);
+    std::string         range;
+    unsigned            count = 0;
+
+    while (std::getline(is, range, ',')) {
+        unsigned b = 0;
+        unsigned e = 0;
+        char     dash = 0;
+        std::istringstream rs(range);
+        if (rs >> b) {
+            e = (rs >> dash >> e) ? e : b;
+            count += (e >= b) ? e - b + 1 : 0;
+        }
+    }
+    return count;
+}
+
+#endif // SCM_PLATFORM == SCM_PLATFORM_LINUX
+
+#if SCM_PLATFORM == SCM_PLATFORM_APPLE
+
+template<typename T>
+T
+sysctl_value(const char* name)
+{
+    T           v = 0;
+    std::size_t s = sizeof(T);
+    return (sysctlbyname(name, &v, &s, 0, 0) == 0) ? v : 0;
+}
+
+#endif // SCM_PLATFORM == SCM_PLATFORM_APPLE
+
+} // namespace
+
+namespace scm {
+
+const char*
+simd_level_name(simd_level l)
+{
+    return (l < simd_level_count) ? simd_level_names[l] : "unknown";
+}
+
+bool
+simd_level_from_name(const std::string& n, simd_level& l)
+{
+    for (int i = 0; i < simd_level_count; ++i) {
+        if (n == simd_level_names[i]) {
+            l = static_cast<simd_level>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+simd_level system_info::_simd_limit = simd_avx512;
+
+system_info::system_info()
+  : _features(0)
+  , _simd_support(simd_generic)
+  , _logical_cores(0)
+  , _physical_cores(0)
+  , _numa_nodes(1)
+  , _l1_data_cache_size(0)
+  , _l2_cache_size(0)
+  , _l3_cache_size(0)
+  , _cache_line_size(0)
+{
+    detect_cpu();
+    detect_topology();
+}
+
+const system_info&
+system_info::host()
+{
+    static system_info  host_info;
+    return host_info;
+}
+
+void
+system_info::limit_simd_level(simd_level l)
+{
+    _simd_limit = l;
+}
+
+simd_level
+system_info::simd_level_limit()
+{
+    return _simd_limit;
+}
+
+const std::string&
+system_info::cpu_vendor() const
+{
+    return _cpu_vendor;
+}
+
+const std::string&
+system_info::cpu_brand() const
+{
+    return _cpu_brand;
+}
+
+bool
+system_info::has(cpu_feature f) const
+{
+    return (_features & (1u << f)) != 0;
+}
+
+simd_level
+system_info::simd() const
+{
+    return (std::min)(_simd_support, _simd_limit);
+}
+
+simd_level
+system_info::simd_support() const
+{
+    return _simd_support;
+}
+
+unsigned
+system_info::logical_cores() const
+{
+    return _logical_cores;
+}
+
+unsigned
+system_info::physical_cores() const
+{
+    return _physical_cores;
+}
+
+unsigned
+system_info::numa_nodes() const
+{
+    return _numa_nodes;
+}
+
+scm::size_t
+system_info::l1_data_cache_size() const
+{
+    return _l1_data_cache_size;
+}
+
+scm::size_t
+system_info::l2_cache_size() const
+{
+    return _l2_cache_size;
+}
+
+scm::size_t
+system_info::l3_cache_size() const
+{
+    return _l3_cache_size;
+}
+
+scm::size_t
+system_info::cache_line_size() const
+{
+    return _cache_line_size;
+}
+
+void
+system_info::detect_cpu()
+{
+#if SCM_ARCHITECTURE_X86
+    scm::uint32 r[4];
+
+    cpuid(0, 0, r);
+    const scm::uint32 max_leaf = r[0];
+    char vendor[13];
+    std::memcpy(vendor + 0, &r[1], 4);
+    std::memcpy(vendor + 4, &r[3], 4);
+    std::memcpy(vendor + 8, &r[2], 4);
+    vendor[12] = 0;
+    _cpu_vendor = vendor;
+
+    cpuid(0x80000000, 0, r);
+    if (r[0] >= 0x80000004) {
+        char brand[49];
+        for (scm::uint32 l = 0; l < 3; ++l) {
+            cpuid(0x80000002 + l, 0, r);
+            std::memcpy(brand + 16 * l, r, 16);
+        }
+        brand[48] = 0;
+        _cpu_brand = brand;
+        _cpu_brand.erase(0, _cpu_brand.find_first_not_of(' '));
+    }
+
+    if (max_leaf < 1) {
+        return;
+    }
+
+    cpuid(1, 0, r);
+    const scm::uint32 ecx1 = r[2];
+    const scm::uint32 edx1 = r[3];
+    scm::uint32       ebx7 = 0;
+    if (max_leaf >= 7) {
+        cpuid(7, 0, r);
+        ebx7 = r[1];
+    }
+
+    // the avx register state has to be saved by the operating system
+    const scm::uint64 xcr0      = bit(ecx1, 27) ? xgetbv0() : 0;
+    const bool        os_avx    = (xcr0 & 0x06) == 0x06;    // xmm, ymm
+    const bool        os_avx512 = (xcr0 & 0xe6) == 0xe6;    // + opmask, zmm
+
+    const bool f[cpu_feature_count] = {
+        bit(edx1, 26),                  // sse2
+        bit(ecx1,  0),                  // sse3
+        bit(ecx1,  9),                  // ssse3
+        bit(ecx1, 19),                  // sse4.1
+        bit(ecx1, 20),                  // sse4.2
+        bit(ecx1, 23),                  // popcnt
+        bit(ecx1, 28) && os_avx,        // avx
+        bit(ecx1, 29) && os_avx,        // f16c
+        bit(ecx1, 12) && os_avx,        // fma
+        bit(ebx7,  5) && os_avx,        // avx2
+        bit(ebx7,  8),                  // bmi2
+        bit(ebx7, 16) && os_avx512,     // avx512f
+        bit(ebx7, 17) && os_avx512,     // avx512dq
+        bit(ebx7, 30) && os_avx512,     // avx512bw
+        bit(ebx7, 31) && os_avx512      // avx512vl
+    };
+    for (int i = 0; i < cpu_feature_count; ++i) {
+        _features |= f[i] ? (1u << i) : 0u;
+    }
+
+    if (has(cpu_sse2)) {
+        _simd_support = simd_sse2;
+    }
+    if (   _simd_support == simd_sse2
+        && has(cpu_sse3) && has(cpu_ssse3) && has(cpu_sse4_1) && has(cpu_sse4_2) && has(cpu_popcnt)) {
+        _simd_support = simd_sse4_2;
+    }
+    if (_simd_support == simd_sse4_2 && has(cpu_avx)) {
+        _simd_support = simd_avx;
+    }
+    if (_simd_support == simd_avx && has(cpu_avx2) && has(cpu_fma)) {
+        _simd_support = simd_avx2;
+    }
+    if (   _simd_support == simd_avx2
+        && has(cpu_avx512f) && has(cpu_avx512dq) && has(cpu_avx512bw) && has(cpu_avx512vl)) {
+        _simd_support = simd_avx512;
+    }
+#endif // SCM_ARCHITECTURE_X86
+}
+
+void
+system_info::detect_topology()
+{
+#if SCM_PLATFORM == SCM_PLATFORM_WINDOWS
+    DWORD length = 0;
+    GetLogicalProcessorInformation(0, &length);
+
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> lpi(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!lpi.empty() && GetLogicalProcessorInformation(&lpi.front(), &length)) {
+        unsigned numa_nodes = 0;
+        for (std::size_t i = 0; i < lpi.size(); ++i) {
+            const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& p = lpi[i];
+            switch (p.Relationship) {
+                case RelationProcessorCore:
+                    ++_physical_cores;
+                    for (ULONG_PTR m = p.ProcessorMask; m; m &= m - 1) {
+                        ++_logical_cores;
+                    }
+                    break;
+                case RelationNumaNode:
+                    ++numa_nodes;
+                    break;
+                case RelationCache:
+                    if (p.Cache.Level == 1 && p.Cache.Type == CacheData) {
+                        _l1_data_cache_size = p.Cache.Size;
+                        _cache_line_size    = p.Cache.LineSize;
+                    }
+                    else if (p.Cache.Level == 2) {
+                        _l2_cache_size = p.Cache.Size;
+                    }
+                    else if (p.Cache.Level == 3) {
+                        _l3_cache_size = p.Cache.Size;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        _numa_nodes = (std::max)(numa_nodes, 1u);
+    }
+#elif SCM_PLATFORM == SCM_PLATFORM_APPLE
+    _logical_cores      = sysctl_value<int>("hw.logicalcpu");
+    _physical_cores     = sysctl_value<int>("hw.physicalcpu");
+    _l1_data_cache_size = sysctl_value<scm::int64>("hw.l1dcachesize");
+    _l2_cache_size      = sysctl_value<scm::int64>("hw.l2cachesize");
+    _l3_cache_size      = sysctl_value<scm::int64>("hw.l3cachesize");
+    _cache_line_size    = sysctl_value<scm::int64>("hw.cachelinesize");
+#else
+    const std::string cpu_dir = "/sys/devices/system/cpu/";
+    std::string       value;
+
+    if (read_sysfs(cpu_dir + "online", value)) {
+        _logical_cores = count_list_entries(value);
+    }
+
+    // a physical core is a distinct (package, core) pair
+    std::set<std::pair<int, int> > cores;
+    for (unsigned c = 0; c < _logical_cores; ++c) {
+        std::ostringstream  topo;
+        std::string         package_id;
+        std::string         core_id;
+        topo << cpu_dir << "cpu" << c << "/topology/";
+        if (   read_sysfs(topo.str() + "physical_package_id", package_id)
+            && read_sysfs(topo.str() + "core_id", core_id)) {
+            cores.insert(std::make_pair(std::atoi(package_id.c_str()), std::atoi(core_id.c_str())));
+        }
+    }
+    _physical_cores = static_cast<unsigned>(cores.size());
+
+    for (unsigned i = 0; ; ++i) {
+        std::ostringstream  index;
+        std::string         level;
+        std::string         type;
+        std::string         size;
+        index << cpu_dir << "cpu0/cache/index" << i << "/";
+        if (   !read_sysfs(index.str() + "level", level)
+            || !read_sysfs(index.str() + "type",  type)
+            || !read_sysfs(index.str() + "size",  size)) {
+            break;
+        }
+        if (level == "1" && type == "Data") {
+            _l1_data_cache_size = parse_size(size);
+            if (read_sysfs(index.str() + "coherency_line_size", value)) {
+                _cache_line_size = parse_size(value);
+            }
+        }
+        else if (level == "2") {
+            _l2_cache_size = parse_size(size);
+        }
+        else if (level == "3") {
+            _l3_cache_size = parse_size(size);
+        }
+    }
+
+    if (read_sysfs("/sys/devices/system/node/online", value)) {
+        _numa_nodes = (std::max)(count_list_entries(value), 1u);
+    }
+#endif
+
+    if (_logical_cores == 0) {
+        _logical_cores = (std::max)(boost::thread::hardware_concurrency(), 1u);
+    }
+    if (_physical_cores == 0) {
+        _physical_cores = _logical_cores;
+    }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const system_info& i)
+{
+    std::ostream::sentry const  out_sentry(os);
+
+    if (out_sentry) {
+        os << (i.cpu_brand().empty() ? std::string("unknown cpu") : i.cpu_brand());
+        if (!i.cpu_vendor().empty()) {
+            os << " (" << i.cpu_vendor() << ")";
+        }
+        os << ", " << i.physical_cores() << " cores, " << i.logical_cores() << " threads"
+           << ", " << i.numa_nodes() << " numa node" << (i.numa_nodes() > 1 ? "s" : "") << std::endl
+           << "caches: l1d " << (i.l1_data_cache_size() >> 10) << "KiB"
+           << ", l2 "        << (i.l2_cache_size() >> 10) << "KiB"
+           << ", l3 "        << (i.l3_cache_size() >> 10) << "KiB"
+           << ", line "      << i.cache_line_size() << "B" << std::endl
+           << "features:";
+        for (int f = 0; f < system_info::cpu_feature_count; ++f) {
+            if (i.has(static_cast<system_info::cpu_feature>(f))) {
+                os << " " << cpu_feature_names[f];
+            }
+        }
+        os << std::endl
+           << "simd level: " << simd_level_name(i.simd());
+        if (i.simd() != i.simd_support()) {
+            os << " (limited, supported " << simd_level_name(i.simd_support()) << ")";
+        }
+    }
+
+    return os;
+}
+
+} // namespace scm
@@ -5,6 +5,13 @@
 #ifndef SCM_CORE_SYSTEM_INFO_H_INCLUDED
 #define SCM_CORE_SYSTEM_INFO_H_INCLUDED
 
+#include <iosfwd>
+#include <string>
+
+#include <scm/core/numeric_types.h>
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
 namespace scm {
 
 bool is_host_little_endian();
@@ -12,8 +19,104 @@ bool is_host_little_endian();
 template<typename T>
 void swap_endian(T& val);
 
+// simd instruction set levels, every level includes the ones below
+enum simd_level {
+    simd_generic    = 0x00,
+    simd_sse2,
+    simd_sse4_2,    // + sse3, ssse3, sse4.1, popcnt
+    simd_avx,
+    simd_avx2,      // + fma
+    simd_avx512,    // avx512 f, bw, dq and vl (skylake server level)
+
+    simd_level_count
+}; // enum simd_level
+
+__scm_export(core) const char*  simd_level_name(simd_level l);
+__scm_export(core) bool         simd_level_from_name(const std::string& n, simd_level& l);
+
+// system_info
+//  - cpu features, core counts, cache sizes and numa nodes of the host, detected once on
+//    the first call to host()
+//  - the simd level is the highest instruction set supported by cpu and operating system,
+//    it can be limited (scm::core option '--simd-level') to compare or rule out kernels
+//  - sizes in bytes, 0 when unknown
+class __scm_export(core) system_info
+{
+public:
+    enum cpu_feature {
+        cpu_sse2        = 0,
+        cpu_sse3,
+        cpu_ssse3,
+        cpu_sse4_1,
+        cpu_sse4_2,
+        cpu_popcnt,
+        cpu_avx,
+        cpu_f16c,
+        cpu_fma,
+        cpu_avx2,
+        cpu_bmi2,
+        cpu_avx512f,
+        cpu_avx512dq,
+        cpu_avx512bw,
+        cpu_avx512vl,
+
+        cpu_feature_count
+    }; // enum cpu_feature
+
+public:
+    static const system_info&   host();
+
+    // at most this level is reported by simd(), set before the first kernels run
+    static void                 limit_simd_level(simd_level l);
+    static simd_level           simd_level_limit();
+
+    const std::string&          cpu_vendor() const;
+    const std::string&          cpu_brand() const;
+    bool                        has(cpu_feature f) const;
+
+    simd_level                  simd() const;           // supported and not above the limit
+    simd_level                  simd_support() const;   // supported
+
+    unsigned                    logical_cores() const;
+    unsigned                    physical_cores() const;
+    unsigned                    numa_nodes() const;
+
+    scm::size_t                 l1_data_cache_size() const;
+    scm::size_t                 l2_cache_size() const;
+    scm::size_t                 l3_cache_size() const;
+    scm::size_t                 cache_line_size() const;
+
+private:
+    system_info();
+
+    void                        detect_cpu();
+    void                        detect_topology();
+
+private:
+    std::string                 _cpu_vendor;
+    std::string                 _cpu_brand;
+    scm::uint32                 _features;
+    simd_level                  _simd_support;
+
+    unsigned                    _logical_cores;
+    unsigned                    _physical_cores;
+    unsigned                    _numa_nodes;
+
+    scm::size_t                 _l1_data_cache_size;
+    scm::size_t                 _l2_cache_size;
+    scm::size_t                 _l3_cache_size;
+    scm::size_t                 _cache_line_size;
+
+    static simd_level           _simd_limit;
+
+}; // class system_info
+
+__scm_export(core) std::ostream& operator<<(std::ostream& os, const system_info& i);
+
 } // namespace scm
 
+#include <scm/core/utilities/platform_warning_enable.h>
+
 #include "system_info.inl"
 
 #endif // SCM_CORE_SYSTEM_INFO_H_INCLUDED
@@ -31,6 +31,7 @@ buffer::buffer(render_device&     ren_dev,
   , _mapped(false)
   , _mapped_interval_offset(0)
   , _mapped_interval_length(0)
+  , _persistent_mapping(0)
   , _native_handle(0ull)
   , _native_handle_resident(false)
 {
@@ -172,6 +173,12 @@ buffer::map_range(const render_context& in_context,
         return 0;
     }
 
+    if (_persistent_mapping) {
+        // persistently mapped buffers hand out their mapping, the
+        // invalidate and unsynchronized access modes do not apply
+        return static_cast<char*>(_persistent_mapping) + in_offset;
+    }
+
     if (SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS) {
         return_value = glapi.glMapNamedBufferRangeEXT(object_id(), in_offset, in_size, access_flags);
     }
@@ -245,6 +252,16 @@ buffer::buffer_data(const render_device& ren_dev,
         return false;
     }
 
+    if (_descriptor._storage != STORAGE_MUTABLE) {
+        // immutable storage can not be reallocated or orphaned
+        state().set(object_state::OS_ERROR_INVALID_OPERATION);
+        return false;
+    }
+
+    if (in_desc._storage != STORAGE_MUTABLE) {
+        return buffer_storage(ren_dev, in_desc, initial_data);
+    }
+
     if (SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS) {
         glcore.glNamedBufferDataEXT(object_id(),
                                     in_desc._size,
@@ -272,6 +289,52 @@ buffer::buffer_data(const render_device& ren_dev,
     }
 }
 
+bool
+buffer::buffer_storage(const render_device& ren_dev,
+                       const buffer_desc&   in_desc,
+                       const void*          initial_data)
+{
+    const opengl::gl_core& glcore = ren_dev.opengl_api();
+
+    gl_assert(glcore, entering buffer::buffer_storage());
+
+    util::gl_error          glerror(glcore);
+
+    if (!glcore.version_4_4_available) {
+        glerr() << log::error
+                << "buffer::buffer_storage(): persistent buffer storage requires OpenGL 4.4." << log::end;
+        state().set(object_state::OS_ERROR_INVALID_OPERATION);
+        return false;
+    }
+
+    const unsigned storage_flags = util::gl_buffer_storage_flags(in_desc._storage);
+
+    {
+        util::buffer_binding_guard save_guard(glcore, object_target(), object_binding());
+
+        glcore.glBindBuffer(object_target(), object_id());
+        glcore.glBufferStorage(object_target(), in_desc._size, initial_data, storage_flags);
+
+        if (!glerror) {
+            // the dynamic storage bit is no mapping flag
+            _persistent_mapping = glcore.glMapBufferRange(object_target(), 0, in_desc._size,
+                                                          storage_flags & ~GL_DYNAMIC_STORAGE_BIT);
+        }
+    }
+
+    if (glerror || 0 == _persistent_mapping) {
+        _persistent_mapping = 0;
+        _descriptor         = buffer_desc();
+        state().set(glerror ? glerror.to_object_state() : object_state::OS_ERROR_UNKNOWN);
+        return false;
+    }
+    else {
+        _descriptor = in_desc;
+        gl_assert(glcore, leaving buffer::buffer_storage());
+        return true;
+    }
+}
+
 bool
 buffer::buffer_sub_data(const render_device& ren_dev,
                         scm::size_t          offset,
@@ -305,6 +368,14 @@ buffer::buffer_sub_data(const render_device& ren_dev,
         return false;
     }
 
+    if (_descriptor._storage == STORAGE_PERSISTENT_READ) {
+        // read back storage is created without the dynamic storage bit
+        glerr() << log::error
+                << "buffer::buffer_sub_data(): buffer_sub_data not supported on persistent read storage." << log::end;
+        state().set(object_state::OS_ERROR_INVALID_OPERATION);
+        return false;
+    }
+
     if (SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS) {
         glcore.glNamedBufferSubDataEXT(object_id(), offset, size, data);
     }
@@ -616,6 +687,12 @@ buffer::descriptor() const
     return _descriptor;
 }
 
+void*
+buffer::persistent_mapping() const
+{
+    return _persistent_mapping;
+}
+
 void
 buffer::print(std::ostream& os) const
 {
@@ -24,12 +24,14 @@ class render_device;
 class render_context;
 
 struct __scm_export(gl_core) buffer_desc {
-    buffer_desc() : _bindings(BIND_UNKNOWN), _usage(USAGE_STATIC_DRAW), _size(0) {}
-    buffer_desc(buffer_binding b, buffer_usage u, scm::size_t s) : _bindings(b), _usage(u), _size(s) {}
+    buffer_desc() : _bindings(BIND_UNKNOWN), _usage(USAGE_STATIC_DRAW), _size(0), _storage(STORAGE_MUTABLE) {}
+    buffer_desc(buffer_binding b, buffer_usage u, scm::size_t s, buffer_storage st = STORAGE_MUTABLE)
+      : _bindings(b), _usage(u), _size(s), _storage(st) {}
 
     buffer_binding  _bindings;
     buffer_usage    _usage;
     scm::size_t     _size;
+    buffer_storage  _storage;   // persistent storage requires OpenGL 4.4 and can not be resized
 }; // struct buffer_desc
 
 class __scm_export(gl_core) buffer : public context_bindable_object, public render_device_resource
@@ -43,6 +45,9 @@ public:
     const buffer_desc&          descriptor() const;
     void                        print(std::ostream& os) const;
 
+    // persistent storage only, valid for the lifetime of the buffer
+    void*                       persistent_mapping() const;
+
 protected:
     buffer(render_device&       ren_dev,
            const buffer_desc&   in_desc,
@@ -72,6 +77,9 @@ protected:
     bool                        buffer_data(const render_device& ren_dev,
                                             const buffer_desc&   in_desc,
                                             const void*          initial_data);
+    bool                        buffer_storage(const render_device& ren_dev,
+                                               const buffer_desc&   in_desc,
+                                               const void*          initial_data);
     bool                        buffer_sub_data(const render_device& ren_dev,
                                                 scm::size_t          offset,
                                                 scm::size_t          size,
@@ -109,6 +117,8 @@ protected:
     scm::size_t                 _mapped_interval_offset;
     scm::size_t                 _mapped_interval_length;
 
+    void*                       _persistent_mapping;
+
     uint64                      _native_handle;
     bool                        _native_handle_resident;
 
@@ -12,12 +12,15 @@ namespace gl {
 
 class buffer;
 class stream_output_setup;
+class streaming_buffer;
 class transform_feedback;
 class vertex_format;
 class vertex_array;
 
 typedef shared_ptr<buffer>                      buffer_ptr;
 typedef shared_ptr<const buffer>                buffer_cptr;
+typedef shared_ptr<streaming_buffer>            streaming_buffer_ptr;
+typedef shared_ptr<const streaming_buffer>      streaming_buffer_cptr;
 typedef shared_ptr<transform_feedback>          transform_feedback_ptr;
 typedef shared_ptr<const transform_feedback>    transform_feedback_cptr;
 typedef shared_ptr<vertex_format>               vertex_format_ptr;
@@ -0,0 +1,225 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "streaming_buffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <scm/gl_core/log.h>
+#include <scm/gl_core/buffer_objects/buffer.h>
+#include <scm/gl_core/render_device/context.h>
+#include <scm/gl_core/render_device/device.h>
+#include <scm/gl_core/render_device/opengl/gl_core.h>
+#include <scm/gl_core/sync_objects/fence_sync.h>
+
+namespace {
+
+scm::uint64
+round_up(const scm::uint64 v, const scm::uint64 a)
+{
+    return ((v + a - 1) / a) * a;
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+streaming_buffer::streaming_buffer(const render_device_ptr& in_device,
+                                   buffer_binding           in_bindings,
+                                   scm::size_t              in_capacity)
+  : _data(0)
+  , _capacity(0)
+  , _default_alignment(16)
+  , _head(0)
+  , _tail(0)
+  , _frame_begin(0)
+  , _wait_count(0)
+{
+    const render_device::device_capabilities& caps = in_device->capabilities();
+
+    if (in_bindings & BIND_UNIFORM_BUFFER) {
+        _default_alignment = (std::max)(_default_alignment, static_cast<scm::size_t>(caps._uniform_buffer_offset_alignment));
+    }
+    if (in_bindings & BIND_STORAGE_BUFFER) {
+        _default_alignment = (std::max)(_default_alignment, static_cast<scm::size_t>(caps._shader_storage_buffer_offset_alignment));
+    }
+
+    if (!in_device->opengl_api().version_4_4_available) {
+        glout() << log::warning
+                << "streaming_buffer::streaming_buffer(): persistent buffer storage unsupported (OpenGL 4.4 required)." << log::end;
+        return;
+    }
+
+    _buffer = in_device->create_buffer(buffer_desc(in_bindings, USAGE_STREAM_DRAW, in_capacity, STORAGE_PERSISTENT_WRITE));
+    if (_buffer) {
+        _data     = static_cast<scm::uint8*>(_buffer->persistent_mapping());
+        _capacity = in_capacity;
+    }
+    else {
+        glerr() << log::error
+                << "streaming_buffer::streaming_buffer(): unable to create persistent buffer "
+                << "(size: " << in_capacity << "byte)." << log::end;
+    }
+}
+
+streaming_buffer::~streaming_buffer()
+{
+    // the buffer stays alive as long as draws or bindings referencing it
+    _pending_frames.clear();
+    _data = 0;
+    _buffer.reset();
+}
+
+bool
+streaming_buffer::ok() const
+{
+    return 0 != _data;
+}
+
+streaming_buffer::allocation
+streaming_buffer::allocate(const render_context_ptr& in_context,
+                           scm::size_t               in_size,
+                           scm::size_t               in_alignment)
+{
+    assert(in_context);
+
+    const scm::uint64 alignment = (0 < in_alignment) ? in_alignment : _default_alignment;
+
+    if (!ok() || 0 == in_size) {
+        return allocation();
+    }
+
+    // aligned begin of the range, wrapped to the start of the buffer if it does not fit
+    scm::uint64 begin = round_up(_head, alignment);
+    if ((begin % _capacity) + in_size > _capacity) {
+        begin = round_up(_head, _capacity);
+    }
+    const scm::uint64 end = begin + in_size;
+
+    if (end - _frame_begin > _capacity) {
+        glerr() << log::error
+                << "streaming_buffer::allocate(): allocation exceeds the space left for the current frame "
+                << "(size: " << in_size << "byte, frame size: " << frame_size() << "byte, capacity: " << _capacity << "byte)." << log::end;
+        return allocation();
+    }
+
+    if (end - _tail > _capacity) {
+        release_frames(in_context);
+
+        if (end - _tail > _capacity) {
+            // the ring is full, wait for the oldest frames still overlapping the range
+            ++_wait_count;
+            while (end - _tail > _capacity) {
+                assert(!_pending_frames.empty());
+                in_context->sync_client_wait(_pending_frames.front()._fence);
+                _tail = _pending_frames.front()._end;
+                _pending_frames.pop_front();
+            }
+        }
+    }
+
+    _head = end;
+
+    allocation a;
+    a._buffer = _buffer;
+    a._offset = static_cast<scm::size_t>(begin % _capacity);
+    a._size   = in_size;
+    a._data   = _data + a._offset;
+
+    return a;
+}
+
+streaming_buffer::allocation
+streaming_buffer::upload(const render_context_ptr& in_context,
+                         const void*               in_data,
+                         scm::size_t               in_size,
+                         scm::size_t               in_alignment)
+{
+    allocation a = allocate(in_context, in_size, in_alignment);
+
+    if (a.valid()) {
+        memcpy(a._data, in_data, in_size);
+    }
+
+    return a;
+}
+
+void
+streaming_buffer::end_frame(const render_context_ptr& in_context)
+{
+    assert(in_context);
+
+    if (_head != _frame_begin) {
+        pending_frame f;
+        f._fence = in_context->insert_fence_sync();
+        f._end   = _head;
+
+        _pending_frames.push_back(f);
+        _frame_begin = _head;
+    }
+
+    release_frames(in_context);
+}
+
+const buffer_ptr&
+streaming_buffer::stream_buffer() const
+{
+    return _buffer;
+}
+
+scm::size_t
+streaming_buffer::capacity() const
+{
+    return _capacity;
+}
+
+scm::size_t
+streaming_buffer::default_alignment() const
+{
+    return _default_alignment;
+}
+
+scm::size_t
+streaming_buffer::used_size() const
+{
+    return static_cast<scm::size_t>(_head - _tail);
+}
+
+scm::size_t
+streaming_buffer::frame_size() const
+{
+    return static_cast<scm::size_t>(_head - _frame_begin);
+}
+
+unsigned
+streaming_buffer::frames_in_flight() const
+{
+    return static_cast<unsigned>(_pending_frames.size());
+}
+
+scm::uint64
+streaming_buffer::wait_count() const
+{
+    return _wait_count;
+}
+
+void
+streaming_buffer::release_frames(const render_context_ptr& in_context)
+{
+    // fences signal in submission order, stop at the first pending one
+    while (   !_pending_frames.empty()
+           && in_context->sync_signal_status(_pending_frames.front()._fence) == SYNC_SIGNALED) {
+        _tail = _pending_frames.front()._end;
+        _pending_frames.pop_front();
+    }
+    if (_pending_frames.empty()) {
+        _tail = _frame_begin;
+    }
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,107 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_STREAMING_BUFFER_H_INCLUDED
+#define SCM_GL_CORE_STREAMING_BUFFER_H_INCLUDED
+
+#include <deque>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/constants.h>
+#include <scm/gl_core/gl_core_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// streaming_buffer
+//  - ring allocator for transient per-frame data (uniform blocks, storage ranges, dynamic
+//    vertices) over a persistently and coherently mapped buffer (STORAGE_PERSISTENT_WRITE)
+//  - allocate() hands out aligned ranges of the mapped buffer, the data is written through
+//    the returned pointer and the range is bound using the allocation buffer, offset and
+//    size (e.g. render_context::bind_uniform_buffer()), no map/unmap or orphaning involved
+//  - end_frame() fences the allocations of the frame, ranges are reused after their fence
+//    signaled, allocate() only blocks when the ring is full of frames still in flight
+//  - the capacity should cover the data of all frames in flight, an allocation exceeding
+//    the space not used by the current frame fails
+//  - requires OpenGL 4.4, check ok() and fall back to mapped or orphaned buffers otherwise
+class __scm_export(gl_core) streaming_buffer : boost::noncopyable
+{
+public:
+    struct allocation {
+        allocation() : _offset(0), _size(0), _data(0) {}
+        bool            valid() const { return 0 != _data; }
+
+        buffer_ptr      _buffer;
+        scm::size_t     _offset;
+        scm::size_t     _size;
+        void*           _data;
+    }; // struct allocation
+
+protected:
+    struct pending_frame {
+        fence_sync_ptr  _fence;
+        scm::uint64     _end;           // ring position after the last allocation of the frame
+    }; // struct pending_frame
+
+    typedef std::deque<pending_frame>   pending_frame_queue;
+
+public:
+    streaming_buffer(const render_device_ptr& in_device,
+                     buffer_binding           in_bindings,
+                     scm::size_t              in_capacity);
+    virtual ~streaming_buffer();
+
+    bool                        ok() const;
+
+    // alignment 0 uses the default alignment of the buffer bindings
+    allocation                  allocate(const render_context_ptr& in_context,
+                                         scm::size_t               in_size,
+                                         scm::size_t               in_alignment = 0);
+    allocation                  upload(const render_context_ptr& in_context,
+                                       const void*               in_data,
+                                       scm::size_t               in_size,
+                                       scm::size_t               in_alignment = 0);
+
+    void                        end_frame(const render_context_ptr& in_context);
+
+    const buffer_ptr&           stream_buffer() const;
+    scm::size_t                 capacity() const;
+    scm::size_t                 default_alignment() const;
+    scm::size_t                 used_size() const;          // bytes in flight and of the current frame
+    scm::size_t                 frame_size() const;         // bytes of the current frame
+    unsigned                    frames_in_flight() const;
+    scm::uint64                 wait_count() const;         // allocations blocked by full rings
+
+protected:
+    void                        release_frames(const render_context_ptr& in_context);
+
+protected:
+    buffer_ptr                  _buffer;
+    scm::uint8*                 _data;
+    scm::size_t                 _capacity;
+    scm::size_t                 _default_alignment;
+
+    // monotonic ring positions, the buffer offset is position % capacity
+    scm::uint64                 _head;
+    scm::uint64                 _tail;
+    scm::uint64                 _frame_begin;
+    pending_frame_queue         _pending_frames;
+
+    scm::uint64                 _wait_count;
+
+}; // class streaming_buffer
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_STREAMING_BUFFER_H_INCLUDED
@@ -5,9 +5,14 @@
 #ifndef SCM_GL_CORE_UNIFORM_BUFFER_ADAPTOR_H_INCLUDED
 #define SCM_GL_CORE_UNIFORM_BUFFER_ADAPTOR_H_INCLUDED
 
+#include <vector>
+
+#include <scm/core/math.h>
 #include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
 
 #include <scm/gl_core/buffer_objects/buffer_objects_fwd.h>
+#include <scm/gl_core/buffer_objects/streaming_buffer.h>
 #include <scm/gl_core/render_device/render_device_fwd.h>
 
 namespace scm {
@@ -102,6 +107,67 @@ uniform_block_array<host_block_type>
 make_uniform_block_array(const render_device_ptr& in_device, const scm::size_t in_array_size);
 // end uniform_block_array ////////////////////////////////////////////////////////////////////////
 
+// uniform_block_std140 ///////////////////////////////////////////////////////////////////////////
+//  - uniform block packed following the std140 layout rules, the members are declared in
+//    the order of the GLSL block declaration, no manually padded host structures required
+//  - values are only copied if they changed, commit_block() uploads the modified range
+//  - stream_block() copies the whole block into a streaming_buffer range instead, for blocks
+//    changing every frame, the returned range is bound in place of block_buffer()
+template <typename T>
+struct std140_member_traits {
+};
+
+class uniform_block_std140
+{
+public:
+    typedef shared_ptr<uniform_block_std140>        ptr;
+    typedef shared_ptr<uniform_block_std140 const>  cptr;
+
+protected:
+    struct member_layout {
+        scm::size_t     _offset;
+        scm::size_t     _stride;        // array element or matrix column stride
+        unsigned        _columns;
+        scm::size_t     _column_size;
+        unsigned        _elements;
+    }; // struct member_layout
+
+public:
+    uniform_block_std140();
+    ~uniform_block_std140();
+
+    // declaration, returns the member handle
+    template <typename T>
+    int                         declare_member(const unsigned in_elements = 1);
+    bool                        create_block(const render_device_ptr& in_device);
+    void                        reset();
+
+    template <typename T>
+    void                        set_member(const int in_member, const T& in_value);
+    template <typename T>
+    void                        set_member(const int in_member, const unsigned in_element, const T& in_value);
+
+    void                        commit_block(const render_context_ptr& in_context);
+    bool                        commit_required() const;
+    streaming_buffer::allocation
+                                stream_block(const render_context_ptr& in_context,
+                                             streaming_buffer&         in_stream) const;
+
+    scm::size_t                 block_size() const;
+    scm::size_t                 member_offset(const int in_member) const;
+    const buffer_ptr&           block_buffer() const;
+
+protected:
+    std::vector<member_layout>  _members;
+    std::vector<char>           _host_block;
+    scm::size_t                 _block_size;
+    scm::size_t                 _dirty_begin;
+    scm::size_t                 _dirty_end;
+    buffer_ptr                  _device_block;
+
+}; // class uniform_block_std140
+// end uniform_block_std140 ///////////////////////////////////////////////////////////////////////
+
 } // namespace gl
 } // namespace scm
 
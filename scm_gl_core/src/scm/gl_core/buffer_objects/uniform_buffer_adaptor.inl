@@ -2,6 +2,7 @@
 // Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
 // Distributed under the Modified BSD License, see license.txt.
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <cstring>
@@ -255,5 +256,250 @@ make_uniform_block_array(const render_device_ptr& in_device, const scm::size_t i
 }
 // end uniform_block_array ////////////////////////////////////////////////////////////////////////
 
+// uniform_block_std140 ///////////////////////////////////////////////////////////////////////////
+#define SCM_STD140_SCALAR_TRAITS(type_raw)                                                       \
+    template <> struct std140_member_traits<type_raw> {                                         \
+        typedef type_raw scalar_type;                                                           \
+        static const unsigned components = 1;                                                   \
+        static const unsigned columns    = 1;                                                   \
+        static const scalar_type* data(const type_raw& v) { return &v; }                       \
+    };
+#define SCM_STD140_VECTOR_TRAITS(type_raw, scal_type, comps, cols)                               \
+    template <> struct std140_member_traits<type_raw> {                                         \
+        typedef scal_type scalar_type;                                                          \
+        static const unsigned components = comps;                                               \
+        static const unsigned columns    = cols;                                                \
+        static const scalar_type* data(const type_raw& v) { return v.data_array; }             \
+    };
+
+SCM_STD140_SCALAR_TRAITS(float)
+SCM_STD140_SCALAR_TRAITS(int)
+SCM_STD140_SCALAR_TRAITS(unsigned)
+SCM_STD140_SCALAR_TRAITS(double)
+
+SCM_STD140_VECTOR_TRAITS(scm::math::vec2f,  float,    2, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec3f,  float,    3, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec4f,  float,    4, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec2i,  int,      2, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec3i,  int,      3, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec4i,  int,      4, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec2ui, unsigned, 2, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec3ui, unsigned, 3, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec4ui, unsigned, 4, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec2d,  double,   2, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec3d,  double,   3, 1)
+SCM_STD140_VECTOR_TRAITS(scm::math::vec4d,  double,   4, 1)
+
+// matrices are stored column major as arrays of column vectors
+SCM_STD140_VECTOR_TRAITS(scm::math::mat2f,  float,    2, 2)
+SCM_STD140_VECTOR_TRAITS(scm::math::mat3f,  float,    3, 3)
+SCM_STD140_VECTOR_TRAITS(scm::math::mat4f,  float,    4, 4)
+SCM_STD140_VECTOR_TRAITS(scm::math::mat2d,  double,   2, 2)
+SCM_STD140_VECTOR_TRAITS(scm::math::mat3d,  double,   3, 3)
+SCM_STD140_VECTOR_TRAITS(scm::math::mat4d,  double,   4, 4)
+
+#undef SCM_STD140_SCALAR_TRAITS
+#undef SCM_STD140_VECTOR_TRAITS
+
+namespace detail {
+
+inline
+scm::size_t
+std140_round_up(const scm::size_t v, const scm::size_t a)
+{
+    return ((v + a - 1) / a) * a;
+}
+
+} // namespace detail
+
+inline
+uniform_block_std140::uniform_block_std140()
+  : _block_size(0)
+  , _dirty_begin(0)
+  , _dirty_end(0)
+{
+}
+
+inline
+uniform_block_std140::~uniform_block_std140()
+{
+    reset();
+}
+
+template <typename T>
+int
+uniform_block_std140::declare_member(const unsigned in_elements)
+{
+    typedef std140_member_traits<T> traits;
+
+    assert(!_device_block);
+    assert(in_elements > 0);
+
+    const scm::size_t scalar_size  = sizeof(typename traits::scalar_type);
+    const scm::size_t column_size  = traits::components * scalar_size;
+    const scm::size_t column_align = (traits::components == 1) ? scalar_size
+                                   : (traits::components == 2) ? 2 * scalar_size
+                                                               : 4 * scalar_size;
+    member_layout   m;
+    scm::size_t     member_align;
+    scm::size_t     member_size;
+
+    m._columns     = traits::columns;
+    m._column_size = column_size;
+    m._elements    = in_elements;
+
+    if (in_elements > 1 || traits::columns > 1) {
+        // arrays and matrix columns are aligned to vec4 boundaries
+        m._stride    = detail::std140_round_up(column_align, 16);
+        member_align = m._stride;
+        member_size  = m._stride * traits::columns * in_elements;
+    }
+    else {
+        m._stride    = column_size;
+        member_align = column_align;
+        member_size  = column_size;
+    }
+    m._offset   = detail::std140_round_up(_block_size, member_align);
+    _block_size = m._offset + member_size;
+
+    _members.push_back(m);
+
+    return static_cast<int>(_members.size() - 1);
+}
+
+inline
+bool
+uniform_block_std140::create_block(const render_device_ptr& in_device)
+{
+    assert(!_members.empty());
+
+    const scm::size_t buffer_size = detail::std140_round_up((std::max)(_block_size, scm::size_t(16)), 16);
+
+    _host_block.assign(buffer_size, 0);
+    _device_block = in_device->create_buffer(BIND_UNIFORM_BUFFER, USAGE_STREAM_DRAW, buffer_size, &_host_block.front());
+    _dirty_begin  = 0;
+    _dirty_end    = 0;
+
+    return _device_block ? true : false;
+}
+
+inline
+void
+uniform_block_std140::reset()
+{
+    _device_block.reset();
+    _host_block.clear();
+}
+
+template <typename T>
+void
+uniform_block_std140::set_member(const int in_member, const T& in_value)
+{
+    set_member(in_member, 0, in_value);
+}
+
+template <typename T>
+void
+uniform_block_std140::set_member(const int in_member, const unsigned in_element, const T& in_value)
+{
+    typedef std140_member_traits<T> traits;
+
+    assert(!_host_block.empty());
+    assert(0 <= in_member && in_member < static_cast<int>(_members.size()));
+
+    const member_layout& m = _members[in_member];
+
+    assert(in_element < m._elements);
+    assert(m._columns     == traits::columns);
+    assert(m._column_size == traits::components * sizeof(typename traits::scalar_type));
+
+    const char* src = reinterpret_cast<const char*>(traits::data(in_value));
+
+    for (unsigned c = 0; c < m._columns; ++c) {
+        const scm::size_t dst_offset = m._offset + (in_element * m._columns + c) * m._stride;
+        char*             dst        = &_host_block[dst_offset];
+        const char*       col        = src + c * m._column_size;
+
+        if (0 != memcmp(dst, col, m._column_size)) {
+            memcpy(dst, col, m._column_size);
+            if (_dirty_begin < _dirty_end) {
+                _dirty_begin = (std::min)(_dirty_begin, dst_offset);
+                _dirty_end   = (std::max)(_dirty_end,   dst_offset + m._column_size);
+            }
+            else {
+                _dirty_begin = dst_offset;
+                _dirty_end   = dst_offset + m._column_size;
+            }
+        }
+    }
+}
+
+inline
+void
+uniform_block_std140::commit_block(const render_context_ptr& in_context)
+{
+    using namespace scm::gl;
+
+    assert(_device_block);
+
+    if (!commit_required()) {
+        return;
+    }
+
+    const scm::size_t   commit_size = _dirty_end - _dirty_begin;
+    void*               gpu_block   = in_context->map_buffer_range(_device_block, _dirty_begin, commit_size, ACCESS_WRITE_INVALIDATE_RANGE);
+
+    if (0 != gpu_block) {
+        memcpy(gpu_block, &_host_block[_dirty_begin], commit_size);
+        in_context->unmap_buffer(_device_block);
+    }
+    else {
+        std::cerr << "uniform_block_std140::commit_block(): error mapping gpu memory." << std::endl; 
+    }
+
+    _dirty_begin = 0;
+    _dirty_end   = 0;
+}
+
+inline
+streaming_buffer::allocation
+uniform_block_std140::stream_block(const render_context_ptr& in_context,
+                                   streaming_buffer&         in_stream) const
+{
+    assert(!_host_block.empty());
+
+    return in_stream.upload(in_context, &_host_block.front(), _host_block.size());
+}
+
+inline
+bool
+uniform_block_std140::commit_required() const
+{
+    return _dirty_begin < _dirty_end;
+}
+
+inline
+scm::size_t
+uniform_block_std140::block_size() const
+{
+    return _host_block.size();
+}
+
+inline
+scm::size_t
+uniform_block_std140::member_offset(const int in_member) const
+{
+    assert(0 <= in_member && in_member < static_cast<int>(_members.size()));
+    return _members[in_member]._offset;
+}
+
+inline
+const buffer_ptr&
+uniform_block_std140::block_buffer() const
+{
+    return _device_block;
+}
+// end uniform_block_std140 ///////////////////////////////////////////////////////////////////////
+
 } // namespace gl
 } // namespace scm
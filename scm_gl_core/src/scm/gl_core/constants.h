@@ -50,6 +50,15 @@ enum buffer_usage
     USAGE_COUNT
 }; // enum buffer_usage
 
+enum buffer_storage
+{
+    STORAGE_MUTABLE = 0x00,         // buffer_data, can be reallocated and orphaned
+    STORAGE_PERSISTENT_WRITE,       // immutable, persistently and coherently mapped, CPU w (also buffer_sub_data)
+    STORAGE_PERSISTENT_READ,        // immutable, persistently and coherently mapped, CPU r (no buffer_sub_data)
+
+    BUFFER_STORAGE_COUNT
+}; // enum buffer_storage
+
 enum access_mode
 {
     ACCESS_READ_ONLY = 0x00,
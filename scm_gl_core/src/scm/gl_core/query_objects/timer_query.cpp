@@ -19,9 +19,9 @@ timer_query::timer_query(render_device& in_device)
     _result(0)
 {
     _gl_query_type = GL_TIME_ELAPSED;
-    // start and stop the query to actually generate the query object
-    begin(*in_device.main_context());
-    end(*in_device.main_context());
+    // the query object is created on its first use, either by begin_query (GL_TIME_ELAPSED)
+    // or query_time_stamp (GL_TIMESTAMP), a query object created for one target must not
+    // be used with the other
 }
 
 timer_query::~timer_query()
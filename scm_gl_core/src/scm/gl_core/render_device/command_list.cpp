@@ -0,0 +1,373 @@
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "command_list.h"
+
+#include <cassert>
+#include <limits>
+
+#include <scm/gl_core/render_device/context.h>
+
+namespace scm {
+namespace gl {
+
+namespace {
+
+template<typename value_type>
+scm::uint32
+push_object(std::vector<value_type>& pool, const value_type& v)
+{
+    assert(pool.size() < (std::numeric_limits<scm::uint32>::max)());
+    pool.push_back(v);
+    return static_cast<scm::uint32>(pool.size() - 1);
+}
+
+template<typename value_type>
+value_type&
+recorded_slot(std::vector<value_type>& slots, const unsigned index)
+{
+    if (index >= slots.size()) {
+        slots.resize(index + 1);
+    }
+    return slots[index];
+}
+
+} // namespace
+
+void
+command_list::recorded_state::invalidate()
+{
+    _program.invalidate();
+    _vertex_array.invalidate();
+    _index_buffer.invalidate();
+    _uniform_buffers.clear();
+    _storage_buffers.clear();
+    _texture_units.clear();
+    _depth_stencil.invalidate();
+    _rasterizer.invalidate();
+    _blend.invalidate();
+    _frame_buffer.invalidate();
+    _default_frame_buffer.invalidate();
+    _viewports.invalidate();
+}
+
+command_list::command_list()
+{
+}
+
+command_list::~command_list()
+{
+    clear();
+}
+
+void
+command_list::clear()
+{
+    _commands.clear();
+
+    _programs.clear();
+    _vertex_arrays.clear();
+    _index_buffer_bindings.clear();
+    _buffer_bindings.clear();
+    _texture_bindings.clear();
+    _depth_stencil_states.clear();
+    _rasterizer_states.clear();
+    _blend_states.clear();
+    _frame_buffers.clear();
+    _viewport_arrays.clear();
+
+    _recorded_state.invalidate();
+    _statistics = statistics();
+}
+
+bool
+command_list::empty() const
+{
+    return _commands.empty();
+}
+
+scm::size_t
+command_list::size() const
+{
+    return _commands.size();
+}
+
+const command_list::command_array&
+command_list::commands() const
+{
+    return _commands;
+}
+
+const command_list::statistics&
+command_list::record_statistics() const
+{
+    return _statistics;
+}
+
+command_list::command&
+command_list::push_command(command_type in_type, unsigned in_unit, scm::uint32 in_object)
+{
+    assert(in_unit <= (std::numeric_limits<scm::uint16>::max)());
+
+    command c;
+    c._type    = static_cast<scm::uint16>(in_type);
+    c._unit    = static_cast<scm::uint16>(in_unit);
+    c._object  = in_object;
+    c._args._i[0] = c._args._i[1] = c._args._i[2] = c._args._i[3] = 0;
+
+    _commands.push_back(c);
+    ++_statistics._recorded;
+
+    return _commands.back();
+}
+
+// recording api //////////////////////////////////////////////////////////////////////////////////
+void
+command_list::bind_program(const program_ptr& in_program)
+{
+    if (_recorded_state._program.matches(in_program)) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._program.set(in_program);
+    push_command(CMD_BIND_PROGRAM, 0, push_object(_programs, in_program));
+}
+
+void
+command_list::bind_vertex_array(const vertex_array_ptr& in_vertex_array)
+{
+    if (_recorded_state._vertex_array.matches(in_vertex_array)) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._vertex_array.set(in_vertex_array);
+    push_command(CMD_BIND_VERTEX_ARRAY, 0, push_object(_vertex_arrays, in_vertex_array));
+}
+
+void
+command_list::bind_index_buffer(const buffer_ptr& in_buffer, const primitive_topology in_topology, const data_type in_index_type, const scm::size_t in_offset)
+{
+    render_context::index_buffer_binding ib;
+    ib._index_buffer       = in_buffer;
+    ib._primitive_topology = in_topology;
+    ib._index_data_type    = in_index_type;
+    ib._index_data_offset  = in_offset;
+
+    if (_recorded_state._index_buffer.matches(ib)) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._index_buffer.set(ib);
+    push_command(CMD_BIND_INDEX_BUFFER, 0, push_object(_index_buffer_bindings, ib));
+}
+
+void
+command_list::bind_uniform_buffer(const buffer_ptr& in_buffer,
+                                  const unsigned    in_bind_point,
+                                  const scm::size_t in_offset,
+                                  const scm::size_t in_size)
+{
+    render_context::buffer_binding bb;
+    bb._buffer = in_buffer;
+    bb._offset = in_offset;
+    bb._size   = in_size;
+
+    recorded_value<render_context::buffer_binding>& rb = recorded_slot(_recorded_state._uniform_buffers, in_bind_point);
+    if (rb.matches(bb)) {
+        ++_statistics._dropped;
+        return;
+    }
+    rb.set(bb);
+    push_command(CMD_BIND_UNIFORM_BUFFER, in_bind_point, push_object(_buffer_bindings, bb));
+}
+
+void
+command_list::bind_storage_buffer(const buffer_ptr& in_buffer,
+                                  const unsigned    in_bind_point,
+                                  const scm::size_t in_offset,
+                                  const scm::size_t in_size)
+{
+    render_context::buffer_binding bb;
+    bb._buffer = in_buffer;
+    bb._offset = in_offset;
+    bb._size   = in_size;
+
+    recorded_value<render_context::buffer_binding>& rb = recorded_slot(_recorded_state._storage_buffers, in_bind_point);
+    if (rb.matches(bb)) {
+        ++_statistics._dropped;
+        return;
+    }
+    rb.set(bb);
+    push_command(CMD_BIND_STORAGE_BUFFER, in_bind_point, push_object(_buffer_bindings, bb));
+}
+
+void
+command_list::bind_texture(const texture_ptr&       in_texture_image,
+                           const sampler_state_ptr& in_sampler_state,
+                           const unsigned           in_unit)
+{
+    texture_unit_record tu;
+    tu._texture = in_texture_image;
+    tu._sampler = in_sampler_state;
+
+    recorded_value<texture_unit_record>& rt = recorded_slot(_recorded_state._texture_units, in_unit);
+    if (rt.matches(tu)) {
+        ++_statistics._dropped;
+        return;
+    }
+    rt.set(tu);
+    push_command(CMD_BIND_TEXTURE, in_unit, push_object(_texture_bindings, tu));
+}
+
+void
+command_list::set_depth_stencil_state(const depth_stencil_state_ptr& in_ds_state, unsigned in_stencil_ref)
+{
+    depth_stencil_record ds;
+    ds._state = in_ds_state;
+    ds._ref   = in_stencil_ref;
+
+    if (_recorded_state._depth_stencil.matches(ds)) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._depth_stencil.set(ds);
+    command& c = push_command(CMD_SET_DEPTH_STENCIL_STATE, 0, push_object(_depth_stencil_states, in_ds_state));
+    c._args._i[0] = static_cast<int>(in_stencil_ref);
+}
+
+void
+command_list::set_rasterizer_state(const rasterizer_state_ptr& in_rs_state, float in_line_width, float in_point_size)
+{
+    rasterizer_record rs;
+    rs._state      = in_rs_state;
+    rs._line_width = in_line_width;
+    rs._point_size = in_point_size;
+
+    if (_recorded_state._rasterizer.matches(rs)) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._rasterizer.set(rs);
+    command& c = push_command(CMD_SET_RASTERIZER_STATE, 0, push_object(_rasterizer_states, in_rs_state));
+    c._args._f[0] = in_line_width;
+    c._args._f[1] = in_point_size;
+}
+
+void
+command_list::set_blend_state(const blend_state_ptr& in_bl_state, const math::vec4f& in_blend_color)
+{
+    blend_record bl;
+    bl._state = in_bl_state;
+    bl._color = in_blend_color;
+
+    if (_recorded_state._blend.matches(bl)) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._blend.set(bl);
+    command& c = push_command(CMD_SET_BLEND_STATE, 0, push_object(_blend_states, in_bl_state));
+    c._args._f[0] = in_blend_color.x;
+    c._args._f[1] = in_blend_color.y;
+    c._args._f[2] = in_blend_color.z;
+    c._args._f[3] = in_blend_color.w;
+}
+
+void
+command_list::set_frame_buffer(const frame_buffer_ptr& in_frame_buffer)
+{
+    if (_recorded_state._frame_buffer.matches(in_frame_buffer)) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._frame_buffer.set(in_frame_buffer);
+    push_command(CMD_SET_FRAME_BUFFER, 0, push_object(_frame_buffers, in_frame_buffer));
+}
+
+void
+command_list::set_default_frame_buffer(const frame_buffer_target in_target)
+{
+    // the default frame buffer is selected by unbinding any frame buffer object
+    if (   _recorded_state._frame_buffer.matches(frame_buffer_ptr())
+        && _recorded_state._default_frame_buffer.matches(in_target)) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._frame_buffer.set(frame_buffer_ptr());
+    _recorded_state._default_frame_buffer.set(in_target);
+    command& c = push_command(CMD_SET_DEFAULT_FRAME_BUFFER);
+    c._args._i[0] = static_cast<int>(in_target);
+}
+
+void
+command_list::set_viewport(const viewport& in_vp)
+{
+    set_viewports(viewport_array(in_vp));
+}
+
+void
+command_list::set_viewports(const viewport_array& in_vp)
+{
+    if (_recorded_state._viewports.matches(in_vp.viewports())) {
+        ++_statistics._dropped;
+        return;
+    }
+    _recorded_state._viewports.set(in_vp.viewports());
+    push_command(CMD_SET_VIEWPORT, 0, push_object(_viewport_arrays, in_vp));
+}
+
+void
+command_list::draw_arrays(const primitive_topology in_topology, const int in_first_index, const int in_count)
+{
+    command& c = push_command(CMD_DRAW_ARRAYS, in_topology);
+    c._args._i[0] = in_first_index;
+    c._args._i[1] = in_count;
+    ++_statistics._draws;
+}
+
+void
+command_list::draw_arrays_instanced(const primitive_topology in_topology, const int in_first_index, const int in_count, const int in_instance_count)
+{
+    command& c = push_command(CMD_DRAW_ARRAYS_INSTANCED, in_topology);
+    c._args._i[0] = in_first_index;
+    c._args._i[1] = in_count;
+    c._args._i[2] = in_instance_count;
+    ++_statistics._draws;
+}
+
+void
+command_list::draw_elements(const int in_count, const int in_start_index, const int in_base_vertex)
+{
+    command& c = push_command(CMD_DRAW_ELEMENTS);
+    c._args._i[0] = in_count;
+    c._args._i[1] = in_start_index;
+    c._args._i[2] = in_base_vertex;
+    ++_statistics._draws;
+}
+
+void
+command_list::draw_elements_instanced(const int in_count, const int in_start_index, const int in_instance_count, const int in_base_vertex)
+{
+    command& c = push_command(CMD_DRAW_ELEMENTS_INSTANCED);
+    c._args._i[0] = in_count;
+    c._args._i[1] = in_start_index;
+    c._args._i[2] = in_instance_count;
+    c._args._i[3] = in_base_vertex;
+    ++_statistics._draws;
+}
+
+// replay api /////////////////////////////////////////////////////////////////////////////////////
+void
+command_list::execute(render_context& in_context) const
+{
+    replay(in_context);
+}
+
+void
+command_list::execute(const render_context_ptr& in_context) const
+{
+    assert(in_context);
+    replay(*in_context);
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,218 @@
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_COMMAND_LIST_H_INCLUDED
+#define SCM_GL_CORE_COMMAND_LIST_H_INCLUDED
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+
+#include <scm/gl_core/constants.h>
+#include <scm/gl_core/data_types.h>
+#include <scm/gl_core/gl_core_fwd.h>
+#include <scm/gl_core/frame_buffer_objects/viewport.h>
+#include <scm/gl_core/render_device/context.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// command_list
+//  - records render_context binding, state and draw calls into a linear command buffer
+//  - redundant binding and state changes are dropped at record time
+//  - recording does not touch the OpenGL api, a command list can be recorded on any
+//    thread and later be executed on the thread owning the render_context
+//  - a command list must not be recorded to and executed concurrently
+class __scm_export(gl_core) command_list : boost::noncopyable
+{
+////// types //////////////////////////////////////////////////////////////////////////////////////
+public:
+    enum command_type {
+        CMD_BIND_PROGRAM        = 0x00,
+        CMD_BIND_VERTEX_ARRAY,
+        CMD_BIND_INDEX_BUFFER,
+        CMD_BIND_UNIFORM_BUFFER,
+        CMD_BIND_STORAGE_BUFFER,
+        CMD_BIND_TEXTURE,
+        CMD_SET_DEPTH_STENCIL_STATE,
+        CMD_SET_RASTERIZER_STATE,
+        CMD_SET_BLEND_STATE,
+        CMD_SET_FRAME_BUFFER,
+        CMD_SET_DEFAULT_FRAME_BUFFER,
+        CMD_SET_VIEWPORT,
+        CMD_DRAW_ARRAYS,
+        CMD_DRAW_ARRAYS_INSTANCED,
+        CMD_DRAW_ELEMENTS,
+        CMD_DRAW_ELEMENTS_INSTANCED,
+
+        CMD_COUNT
+    }; // enum command_type
+
+    // compact fixed size command record, referenced objects live in typed
+    // pools of the command list and are addressed through _object
+    struct command {
+        scm::uint16         _type;
+        scm::uint16         _unit;
+        scm::uint32         _object;
+        union {
+            int             _i[4];
+            float           _f[4];
+        }                   _args;
+    }; // struct command
+
+    typedef std::vector<command>    command_array;
+
+    struct statistics {
+        statistics() : _recorded(0), _dropped(0), _draws(0) {}
+        scm::size_t     _recorded;
+        scm::size_t     _dropped;
+        scm::size_t     _draws;
+    }; // struct statistics
+
+protected:
+    template<typename value_type>
+    struct recorded_value {
+        recorded_value() : _valid(false) {}
+        bool                    matches(const value_type& v) const { return _valid && (_value == v); }
+        void                    set(const value_type& v)           { _value = v; _valid = true; }
+        void                    invalidate()                       { _valid = false; }
+        value_type              _value;
+        bool                    _valid;
+    }; // struct recorded_value
+
+    struct depth_stencil_record {
+        depth_stencil_record() : _ref(0) {}
+        bool operator==(const depth_stencil_record& rhs) const { return _state == rhs._state && _ref == rhs._ref; }
+        depth_stencil_state_ptr _state;
+        unsigned                _ref;
+    }; // struct depth_stencil_record
+    struct rasterizer_record {
+        rasterizer_record() : _line_width(1.0f), _point_size(1.0f) {}
+        bool operator==(const rasterizer_record& rhs) const { return    _state == rhs._state
+                                                                     && _line_width == rhs._line_width
+                                                                     && _point_size == rhs._point_size; }
+        rasterizer_state_ptr    _state;
+        float                   _line_width;
+        float                   _point_size;
+    }; // struct rasterizer_record
+    struct blend_record {
+        bool operator==(const blend_record& rhs) const { return _state == rhs._state && _color == rhs._color; }
+        blend_state_ptr         _state;
+        math::vec4f             _color;
+    }; // struct blend_record
+    struct texture_unit_record {
+        bool operator==(const texture_unit_record& rhs) const { return    _texture == rhs._texture
+                                                                       && _sampler == rhs._sampler; }
+        texture_ptr             _texture;
+        sampler_state_ptr       _sampler;
+    }; // struct texture_unit_record
+
+    struct recorded_state {
+        void                    invalidate();
+
+        recorded_value<program_ptr>                             _program;
+        recorded_value<vertex_array_ptr>                        _vertex_array;
+        recorded_value<render_context::index_buffer_binding>    _index_buffer;
+        std::vector<recorded_value<render_context::buffer_binding> > _uniform_buffers;
+        std::vector<recorded_value<render_context::buffer_binding> > _storage_buffers;
+        std::vector<recorded_value<texture_unit_record> >       _texture_units;
+        recorded_value<depth_stencil_record>                    _depth_stencil;
+        recorded_value<rasterizer_record>                       _rasterizer;
+        recorded_value<blend_record>                            _blend;
+        recorded_value<frame_buffer_ptr>                        _frame_buffer;
+        recorded_value<frame_buffer_target>                     _default_frame_buffer;
+        recorded_value<viewport_array::viewport_vector>         _viewports;
+    }; // struct recorded_state
+
+////// methods ////////////////////////////////////////////////////////////////////////////////////
+public:
+    command_list();
+    virtual ~command_list();
+
+    void                        clear();
+
+    bool                        empty() const;
+    scm::size_t                 size() const;
+    const command_array&        commands() const;
+    const statistics&           record_statistics() const;
+
+    // recording api //////////////////////////////////////////////////////////////////////////////
+    void                        bind_program(const program_ptr& in_program);
+
+    void                        bind_vertex_array(const vertex_array_ptr& in_vertex_array);
+    void                        bind_index_buffer(const buffer_ptr& in_buffer, const primitive_topology in_topology, const data_type in_index_type, const scm::size_t in_offset = 0);
+    void                        bind_uniform_buffer(const buffer_ptr& in_buffer,
+                                                    const unsigned    in_bind_point,
+                                                    const scm::size_t in_offset = 0,
+                                                    const scm::size_t in_size = 0);
+    void                        bind_storage_buffer(const buffer_ptr& in_buffer,
+                                                    const unsigned    in_bind_point,
+                                                    const scm::size_t in_offset = 0,
+                                                    const scm::size_t in_size = 0);
+
+    void                        bind_texture(const texture_ptr&       in_texture_image,
+                                             const sampler_state_ptr& in_sampler_state,
+                                             const unsigned           in_unit);
+
+    void                        set_depth_stencil_state(const depth_stencil_state_ptr& in_ds_state, unsigned in_stencil_ref = 0);
+    void                        set_rasterizer_state(const rasterizer_state_ptr& in_rs_state, float in_line_width = 1.0f, float in_point_size = 1.0f);
+    void                        set_blend_state(const blend_state_ptr& in_bl_state, const math::vec4f& in_blend_color = math::vec4f(1.0f, 1.0f, 1.0f, 1.0f));
+
+    void                        set_frame_buffer(const frame_buffer_ptr& in_frame_buffer);
+    void                        set_default_frame_buffer(const frame_buffer_target in_target = FRAMEBUFFER_BACK);
+    void                        set_viewport(const viewport& in_vp);
+    void                        set_viewports(const viewport_array& in_vp);
+
+    void                        draw_arrays(const primitive_topology in_topology, const int in_first_index, const int in_count);
+    void                        draw_arrays_instanced(const primitive_topology in_topology, const int in_first_index, const int in_count, const int in_instance_count = 1);
+    void                        draw_elements(const int in_count, const int in_start_index = 0, const int in_base_vertex = 0);
+    void                        draw_elements_instanced(const int in_count, const int in_start_index = 0, const int in_instance_count = 1, const int in_base_vertex = 0);
+
+    // replay api /////////////////////////////////////////////////////////////////////////////////
+    // - the recorded state is applied on top of the current context state, draw commands
+    //   apply the context state before issuing the draw call
+    void                        execute(render_context& in_context) const;
+    void                        execute(const render_context_ptr& in_context) const;
+
+    // generic replay for any target offering the render_context binding and draw interface
+    // (e.g. the counting null_context)
+    template<class context_type>
+    void                        replay(context_type& in_context) const;
+
+protected:
+    command&                    push_command(command_type in_type, unsigned in_unit = 0, scm::uint32 in_object = 0);
+
+private:
+    command_array                                       _commands;
+
+    // object pools referenced by the commands
+    std::vector<program_ptr>                            _programs;
+    std::vector<vertex_array_ptr>                       _vertex_arrays;
+    std::vector<render_context::index_buffer_binding>   _index_buffer_bindings;
+    std::vector<render_context::buffer_binding>         _buffer_bindings;
+    std::vector<texture_unit_record>                    _texture_bindings;
+    std::vector<depth_stencil_state_ptr>                _depth_stencil_states;
+    std::vector<rasterizer_state_ptr>                   _rasterizer_states;
+    std::vector<blend_state_ptr>                        _blend_states;
+    std::vector<frame_buffer_ptr>                       _frame_buffers;
+    std::vector<viewport_array>                         _viewport_arrays;
+
+    recorded_state                                      _recorded_state;
+    statistics                                          _statistics;
+
+}; // class command_list
+
+} // namespace gl
+} // namespace scm
+
+#include "command_list.inl"
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_COMMAND_LIST_H_INCLUDED
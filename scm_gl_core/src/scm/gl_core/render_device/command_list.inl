@@ -0,0 +1,88 @@
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <cassert>
+
+namespace scm {
+namespace gl {
+
+template<class context_type>
+void
+command_list::replay(context_type& in_context) const
+{
+    const command*const cmd_begin = _commands.empty() ? 0 : &_commands.front();
+    const command*const cmd_end   = cmd_begin + _commands.size();
+
+    for (const command* cmd = cmd_begin; cmd != cmd_end; ++cmd) {
+        switch (cmd->_type) {
+            case CMD_BIND_PROGRAM:
+                in_context.bind_program(_programs[cmd->_object]);
+                break;
+            case CMD_BIND_VERTEX_ARRAY:
+                in_context.bind_vertex_array(_vertex_arrays[cmd->_object]);
+                break;
+            case CMD_BIND_INDEX_BUFFER:
+                in_context.set_index_buffer_binding(_index_buffer_bindings[cmd->_object]);
+                break;
+            case CMD_BIND_UNIFORM_BUFFER: {
+                    const render_context::buffer_binding& b = _buffer_bindings[cmd->_object];
+                    in_context.bind_uniform_buffer(b._buffer, cmd->_unit, b._offset, b._size);
+                } break;
+            case CMD_BIND_STORAGE_BUFFER: {
+                    const render_context::buffer_binding& b = _buffer_bindings[cmd->_object];
+                    in_context.bind_storage_buffer(b._buffer, cmd->_unit, b._offset, b._size);
+                } break;
+            case CMD_BIND_TEXTURE: {
+                    const texture_unit_record& t = _texture_bindings[cmd->_object];
+                    in_context.bind_texture(t._texture, t._sampler, cmd->_unit);
+                } break;
+            case CMD_SET_DEPTH_STENCIL_STATE:
+                in_context.set_depth_stencil_state(_depth_stencil_states[cmd->_object],
+                                                   static_cast<unsigned>(cmd->_args._i[0]));
+                break;
+            case CMD_SET_RASTERIZER_STATE:
+                in_context.set_rasterizer_state(_rasterizer_states[cmd->_object],
+                                                cmd->_args._f[0], cmd->_args._f[1]);
+                break;
+            case CMD_SET_BLEND_STATE:
+                in_context.set_blend_state(_blend_states[cmd->_object],
+                                           math::vec4f(cmd->_args._f[0], cmd->_args._f[1],
+                                                       cmd->_args._f[2], cmd->_args._f[3]));
+                break;
+            case CMD_SET_FRAME_BUFFER:
+                in_context.set_frame_buffer(_frame_buffers[cmd->_object]);
+                break;
+            case CMD_SET_DEFAULT_FRAME_BUFFER:
+                in_context.set_default_frame_buffer(static_cast<frame_buffer_target>(cmd->_args._i[0]));
+                break;
+            case CMD_SET_VIEWPORT:
+                in_context.set_viewports(_viewport_arrays[cmd->_object]);
+                break;
+            case CMD_DRAW_ARRAYS:
+                in_context.apply();
+                in_context.draw_arrays(static_cast<primitive_topology>(cmd->_unit),
+                                       cmd->_args._i[0], cmd->_args._i[1]);
+                break;
+            case CMD_DRAW_ARRAYS_INSTANCED:
+                in_context.apply();
+                in_context.draw_arrays_instanced(static_cast<primitive_topology>(cmd->_unit),
+                                                 cmd->_args._i[0], cmd->_args._i[1], cmd->_args._i[2]);
+                break;
+            case CMD_DRAW_ELEMENTS:
+                in_context.apply();
+                in_context.draw_elements(cmd->_args._i[0], cmd->_args._i[1], cmd->_args._i[2]);
+                break;
+            case CMD_DRAW_ELEMENTS_INSTANCED:
+                in_context.apply();
+                in_context.draw_elements_instanced(cmd->_args._i[0], cmd->_args._i[1],
+                                                   cmd->_args._i[2], cmd->_args._i[3]);
+                break;
+            default:
+                assert(0);
+                break;
+        }
+    }
+}
+
+} // namespace gl
+} // namespace scm
@@ -1216,6 +1216,10 @@ render_context::apply_program()
         //state().set(object_state::OS_ERROR_INVALID_VALUE);
         return;
     }
+    if (_current_state._program->build_pending()) {
+        // asynchronously built programs are completed when first used
+        _current_state._program->await_build();
+    }
     if (!_current_state._program->ok()) {
         state().set(object_state::OS_ERROR_INVALID_OPERATION);
         return;
@@ -1355,6 +1359,36 @@ render_context::update_sub_texture(const texture_image_ptr& in_texture,
     return true;
 }
 
+bool
+render_context::commit_texture_pages(const texture_3d_ptr& in_texture,
+                                     const texture_region& in_region,
+                                     const unsigned        in_level)
+{
+    if (!in_texture->commit_pages(*this, in_region, in_level, true)) {
+        glerr() << log::error
+                << "render_context::commit_texture_pages(): "
+                << "error committing texture pages (check sparse texture and page aligned region)."
+                << log::end;
+        return false;
+    }
+    return true;
+}
+
+bool
+render_context::decommit_texture_pages(const texture_3d_ptr& in_texture,
+                                       const texture_region& in_region,
+                                       const unsigned        in_level)
+{
+    if (!in_texture->commit_pages(*this, in_region, in_level, false)) {
+        glerr() << log::error
+                << "render_context::decommit_texture_pages(): "
+                << "error decommitting texture pages (check sparse texture and page aligned region)."
+                << log::end;
+        return false;
+    }
+    return true;
+}
+
 bool
 render_context::retrieve_texture_data(const texture_image_ptr& in_texture,
                                       const unsigned           in_level,
@@ -2378,6 +2412,19 @@ render_context::query_time_stamp(const timer_query_ptr& in_timer) const
     gl_assert(opengl_api(), leaving render_context::query_time_stamp());
 }
 
+scm::uint64
+render_context::current_time_stamp() const
+{
+    const opengl::gl_core& glapi = opengl_api();
+
+    scm::int64 gpu_time = 0;
+    glapi.glGetInteger64v(GL_TIMESTAMP, &gpu_time);
+
+    gl_assert(glapi, leaving render_context::current_time_stamp());
+
+    return static_cast<scm::uint64>(gpu_time);
+}
+
 // sync api ///////////////////////////////////////////////////////////////////////////////////////
 fence_sync_ptr
 render_context::insert_fence_sync()
@@ -296,6 +296,13 @@ public:
                                                    const unsigned           in_level,
                                                    const data_format        in_data_format,
                                                    const void*const         in_data);
+    // sparse textures, the regions are multiples of the page size (except at the level border)
+    bool                        commit_texture_pages(const texture_3d_ptr& in_texture,
+                                                     const texture_region& in_region,
+                                                     const unsigned        in_level = 0);
+    bool                        decommit_texture_pages(const texture_3d_ptr& in_texture,
+                                                       const texture_region& in_region,
+                                                       const unsigned        in_level = 0);
     bool                        retrieve_texture_data(const texture_image_ptr& in_texture,
                                                       const unsigned           in_level,
                                                             void*              in_data);
@@ -401,6 +408,9 @@ public:
     bool                            query_result_available(const query_ptr& in_query) const;
     void                            collect_query_results(const query_ptr& in_query) const;
     void                            query_time_stamp(const timer_query_ptr& in_timer) const;
+    // gpu time (ns) once the previously issued commands reached the gpu, same time base as
+    // query_time_stamp results, does not wait for the commands to complete
+    scm::uint64                     current_time_stamp() const;
 
     // sync api ///////////////////////////////////////////////////////////////////////////////////
 public:
@@ -28,8 +28,11 @@
 #include <scm/gl_core/render_device/context.h>
 #include <scm/gl_core/render_device/opengl/gl_core.h>
 #include <scm/gl_core/render_device/opengl/util/assert.h>
+#include <scm/gl_core/render_device/opengl/util/data_format_helper.h>
 #include <scm/gl_core/render_device/opengl/util/error_helper.h>
+#include <scm/gl_core/render_device/upload_pool.h>
 #include <scm/gl_core/shader_objects/program.h>
+#include <scm/gl_core/shader_objects/program_binary_cache.h>
 #include <scm/gl_core/shader_objects/shader.h>
 #include <scm/gl_core/shader_objects/stream_capture.h>
 #include <scm/gl_core/state_objects/depth_stencil_state.h>
@@ -50,8 +53,43 @@ struct render_device::mutex_impl
     boost::mutex    _mutex;
 };
 
+namespace {
+
+template<class cache_type>
+typename cache_type::mapped_type::element_type*
+find_cached_state(cache_type& in_cache, const typename cache_type::key_type& in_desc,
+                  shared_ptr<typename cache_type::mapped_type::element_type>& out_state)
+{
+    typename cache_type::iterator s = in_cache.find(in_desc);
+    if (s != in_cache.end()) {
+        out_state = s->second.lock();
+    }
+    return out_state.get();
+}
+
+template<class cache_type>
+void
+insert_cached_state(cache_type& in_cache, const typename cache_type::key_type& in_desc,
+                    const shared_ptr<typename cache_type::mapped_type::element_type>& in_state)
+{
+    // drop entries of state objects released since the last insertion
+    typename cache_type::iterator s = in_cache.begin();
+    while (s != in_cache.end()) {
+        if (s->second.expired()) {
+            s = in_cache.erase(s);
+        }
+        else {
+            ++s;
+        }
+    }
+    in_cache[in_desc] = in_state;
+}
+
+} // namespace
+
 render_device::render_device()
   : _mutex_impl(new mutex_impl)
+  , _async_program_builds(false)
 {
     _opengl_api_core.reset(new opengl::gl_core());
 
@@ -114,6 +152,8 @@ render_device::render_device()
 
 render_device::~render_device()
 {
+    _upload_pool.reset();
+    _program_binary_cache.reset();
     _main_context.reset();
 
     assert(0 == _registered_resources.size());
@@ -137,6 +177,61 @@ render_device::create_context()
     return render_context_ptr(new render_context(*this));
 }
 
+bool
+render_device::enable_upload_contexts(const wm::context_cptr& in_context,
+                                      unsigned                in_worker_count)
+{
+    disable_upload_contexts();
+
+    if (!in_context || in_worker_count < 1) {
+        glerr() << log::error << "render_device::enable_upload_contexts(): "
+                << "invalid share context or worker count." << log::end;
+        return false;
+    }
+
+    upload_pool_ptr pool(new upload_pool(*this, in_context, in_worker_count));
+    if (!pool->ok()) {
+        glerr() << log::error << "render_device::enable_upload_contexts(): "
+                << "unable to start upload contexts." << log::end;
+        return false;
+    }
+
+    _upload_pool = pool;
+
+    glout() << log::info << "render_device::enable_upload_contexts(): "
+            << "started " << in_worker_count << " upload context(s)." << log::end;
+
+    return true;
+}
+
+void
+render_device::disable_upload_contexts()
+{
+    // pending uploads are finished by the workers
+    _upload_pool.reset();
+}
+
+bool
+render_device::upload_contexts_enabled() const
+{
+    return 0 != _upload_pool;
+}
+
+upload_task_ptr
+render_device::submit_upload(const boost::function<bool (render_context&)>& in_upload)
+{
+    upload_task_ptr task(new upload_task(in_upload));
+
+    if (_upload_pool) {
+        _upload_pool->submit(task);
+    }
+    else {
+        task->run(*main_context());
+    }
+
+    return task;
+}
+
 const render_device::device_capabilities&
 render_device::capabilities() const
 {
@@ -628,6 +723,8 @@ render_device::add_include_string_internal(const std::string& in_path,
             }
         }
 
+        _include_string_hashes[in_path] = program_binary_cache::hash(in_source_string);
+
         size_t      parent_path_end = in_path.find_last_of('/');
         std::string parent_path     = in_path.substr(0, parent_path_end);
 
@@ -735,12 +832,21 @@ render_device::create_shader(shader_stage                    in_stage,
         }
     }
 
+    bool defer_compile = false;
+
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        defer_compile = (0 != _program_binary_cache) || _async_program_builds;
+    }
+
     shader_ptr new_shader(new shader(*this,
                                      in_stage,
                                      in_source,
                                      in_source_name,
                                      macro_array,
-                                     include_paths));
+                                     include_paths,
+                                     defer_compile));
     if (new_shader->fail()) {
         if (new_shader->bad()) {
             glerr() << "render_device::create_shader(): unable to create shader object ("
@@ -827,7 +933,32 @@ render_device::create_program(const shader_list&          in_shaders,
                               bool                        in_rasterization_discard,
                               const std::string&          in_program_name)
 {
-    program_ptr new_program(new program(*this, in_shaders, in_capture, in_rasterization_discard));
+    program_binary_cache_ptr    binary_cache;
+    scm::uint64                 binary_cache_seed = 0;
+    bool                        async_build       = false;
+
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        async_build = _async_program_builds;
+
+        if (_program_binary_cache) {
+            binary_cache      = _program_binary_cache;
+            binary_cache_seed = binary_cache->driver_key();
+
+            // the contents of the include strings are not part of the preprocessed sources
+            string_hash_map::const_iterator ib = _include_string_hashes.begin();
+            string_hash_map::const_iterator ie = _include_string_hashes.end();
+            for (; ib != ie; ++ib) {
+                binary_cache_seed = program_binary_cache::hash(ib->first,  binary_cache_seed);
+                binary_cache_seed = program_binary_cache::hash(ib->second, binary_cache_seed);
+            }
+        }
+    }
+
+    program_ptr new_program(new program(*this, in_shaders, in_capture, in_rasterization_discard,
+                                        program::named_location_list(), program::named_location_list(),
+                                        binary_cache, binary_cache_seed, async_build));
     if (new_program->fail()) {
         if (new_program->bad()) {
             glerr() << "render_device::create_program(): unable to create shader object ("
@@ -852,6 +983,95 @@ render_device::create_program(const shader_list&          in_shaders,
     }
 }
 
+bool
+render_device::enable_program_binary_cache(const std::string& in_cache_path)
+{
+    if (   !opengl_api().version_supported(4, 1)
+        || _capabilities._num_program_binary_formats < 1) {
+        glout() << log::warning << "render_device::enable_program_binary_cache(): "
+                << "program binaries not supported by device (no program binary formats available)." << log::end;
+        return false;
+    }
+
+    std::ostringstream driver_string;
+    driver_string << device_vendor()          << "|"
+                  << device_renderer()        << "|"
+                  << device_context_version() << "|"
+                  << device_shader_compiler();
+
+    program_binary_cache_ptr new_cache(new program_binary_cache(in_cache_path, driver_string.str()));
+
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        _program_binary_cache = new_cache;
+    }
+
+    glout() << log::info << "render_device::enable_program_binary_cache(): "
+            << "program binary cache enabled (path: " << in_cache_path << ")." << log::end;
+
+    return true;
+}
+
+void
+render_device::disable_program_binary_cache()
+{
+    program_binary_cache_ptr old_cache;
+
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        old_cache.swap(_program_binary_cache);
+    }
+}
+
+program_binary_cache_cptr
+render_device::program_cache() const
+{
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    return _program_binary_cache;
+}
+
+void
+render_device::enable_async_program_builds(unsigned in_max_compiler_threads)
+{
+    const opengl::gl_core& glapi = opengl_api();
+
+    if (glapi.extension_KHR_parallel_shader_compile) {
+        glapi.glMaxShaderCompilerThreadsKHR(in_max_compiler_threads);
+        gl_assert(glapi, render_device::enable_async_program_builds() after glMaxShaderCompilerThreadsKHR);
+    }
+    else {
+        glout() << log::info << "render_device::enable_async_program_builds(): "
+                << "GL_KHR_parallel_shader_compile unsupported, driver might still compile asynchronously." << log::end;
+    }
+
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        _async_program_builds = true;
+    }
+}
+
+void
+render_device::disable_async_program_builds()
+{
+    { // protect this function from multiple thread access
+        boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+        _async_program_builds = false;
+    }
+}
+
+bool
+render_device::async_program_builds() const
+{
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    return _async_program_builds;
+}
+
 // texture api ////////////////////////////////////////////////////////////////////////////////////
 texture_1d_ptr
 render_device::create_texture_1d(const texture_1d_desc&   in_desc)
@@ -1095,6 +1315,34 @@ render_device::create_texture_3d(const texture_3d_ptr&     in_orig_texture,
     }
 }
 
+math::vec3ui
+render_device::texture_3d_sparse_page_size(const data_format in_format) const
+{
+    const opengl::gl_core& glapi = opengl_api();
+
+    if (!glapi.extension_ARB_sparse_texture) {
+        return math::vec3ui(0u);
+    }
+
+    const unsigned gl_internal_format = util::gl_internal_format(in_format);
+    int            page_size_count    = 0;
+
+    glapi.glGetInternalformativ(GL_TEXTURE_3D, gl_internal_format, GL_NUM_VIRTUAL_PAGE_SIZES_ARB, 1, &page_size_count);
+    if (page_size_count < 1) {
+        return math::vec3ui(0u);
+    }
+
+    // the first page size is used for all sparse textures (VIRTUAL_PAGE_SIZE_INDEX_ARB 0)
+    math::vec3i page_size(0);
+    glapi.glGetInternalformativ(GL_TEXTURE_3D, gl_internal_format, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &page_size.x);
+    glapi.glGetInternalformativ(GL_TEXTURE_3D, gl_internal_format, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &page_size.y);
+    glapi.glGetInternalformativ(GL_TEXTURE_3D, gl_internal_format, GL_VIRTUAL_PAGE_SIZE_Z_ARB, 1, &page_size.z);
+
+    gl_assert(glapi, leaving render_device::texture_3d_sparse_page_size());
+
+    return math::vec3ui(page_size);
+}
+
 texture_cube_ptr
 render_device::create_texture_cube(const texture_cube_desc&   in_desc)
 {
@@ -1240,7 +1488,14 @@ render_device::create_resident_handle(const texture_ptr&       in_texture,
 sampler_state_ptr
 render_device::create_sampler_state(const sampler_state_desc& in_desc)
 {
-    sampler_state_ptr  new_sstate(new sampler_state(*this, in_desc));
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    sampler_state_ptr  new_sstate;
+    if (find_cached_state(_sampler_state_cache, in_desc, new_sstate)) {
+        return new_sstate;
+    }
+
+    new_sstate.reset(new sampler_state(*this, in_desc));
     if (new_sstate->fail()) {
         if (new_sstate->bad()) {
             glerr() << log::error << "render_device::create_sampler_state(): unable to create sampler state object ("
@@ -1249,6 +1504,7 @@ render_device::create_sampler_state(const sampler_state_desc& in_desc)
         return sampler_state_ptr();
     }
     else {
+        insert_cached_state(_sampler_state_cache, in_desc, new_sstate);
         return new_sstate;
     }
 }
@@ -1327,7 +1583,13 @@ render_device::create_frame_buffer()
 depth_stencil_state_ptr
 render_device::create_depth_stencil_state(const depth_stencil_state_desc& in_desc)
 {
-    depth_stencil_state_ptr new_ds_state(new depth_stencil_state(*this, in_desc));
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    depth_stencil_state_ptr new_ds_state;
+    if (!find_cached_state(_depth_stencil_state_cache, in_desc, new_ds_state)) {
+        new_ds_state.reset(new depth_stencil_state(*this, in_desc));
+        insert_cached_state(_depth_stencil_state_cache, in_desc, new_ds_state);
+    }
     return new_ds_state;
 }
 
@@ -1354,7 +1616,13 @@ render_device::create_depth_stencil_state(bool in_depth_test, bool in_depth_mask
 rasterizer_state_ptr
 render_device::create_rasterizer_state(const rasterizer_state_desc& in_desc)
 {
-    rasterizer_state_ptr new_r_state(new rasterizer_state(*this, in_desc));
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    rasterizer_state_ptr new_r_state;
+    if (!find_cached_state(_rasterizer_state_cache, in_desc, new_r_state)) {
+        new_r_state.reset(new rasterizer_state(*this, in_desc));
+        insert_cached_state(_rasterizer_state_cache, in_desc, new_r_state);
+    }
     return new_r_state;
 }
 
@@ -1371,7 +1639,13 @@ render_device::create_rasterizer_state(fill_mode in_fmode, cull_mode in_cmode, p
 blend_state_ptr
 render_device::create_blend_state(const blend_state_desc& in_desc)
 {
-    blend_state_ptr new_bl_state(new blend_state(*this, in_desc));
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    blend_state_ptr new_bl_state;
+    if (!find_cached_state(_blend_state_cache, in_desc, new_bl_state)) {
+        new_bl_state.reset(new blend_state(*this, in_desc));
+        insert_cached_state(_blend_state_cache, in_desc, new_bl_state);
+    }
     return new_bl_state;
 }
 
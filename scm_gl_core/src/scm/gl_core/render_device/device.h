@@ -8,10 +8,12 @@
 #include <iosfwd>
 #include <limits>
 #include <list>
+#include <map>
 #include <set>
 #include <utility>
 #include <vector>
 
+#include <boost/function.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/unordered_set.hpp>
 #include <boost/unordered_map.hpp>
@@ -28,6 +30,8 @@
 #include <scm/gl_core/state_objects/blend_state.h>
 #include <scm/gl_core/state_objects/depth_stencil_state.h>
 #include <scm/gl_core/state_objects/rasterizer_state.h>
+#include <scm/gl_core/state_objects/sampler_state.h>
+#include <scm/gl_core/window_management/wm_fwd.h>
 
 #include <scm/core/platform/platform.h>
 #include <scm/core/utilities/platform_warning_disable.h>
@@ -118,11 +122,19 @@ protected:
 
     typedef boost::unordered_map<std::string, shader_macro> shader_macro_map;
     typedef std::set<std::string>                           string_set;
+    typedef std::map<std::string, scm::uint64>              string_hash_map;
 
     typedef std::list<shader_ptr>                           shader_list;
 
     typedef std::vector<buffer_ptr>                         buffer_array;
 
+    // state objects are shared between identical descriptors, the caches only
+    // hold weak references so unused state objects are still released
+    typedef boost::unordered_map<depth_stencil_state_desc, weak_ptr<depth_stencil_state> >  depth_stencil_state_cache;
+    typedef boost::unordered_map<rasterizer_state_desc, weak_ptr<rasterizer_state> >        rasterizer_state_cache;
+    typedef boost::unordered_map<blend_state_desc, weak_ptr<blend_state> >                  blend_state_cache;
+    typedef boost::unordered_map<sampler_state_desc, weak_ptr<sampler_state> >              sampler_state_cache;
+
 ////// methods ////////////////////////////////////////////////////////////////////////////////////
 public:
     render_device();
@@ -140,6 +152,19 @@ public:
     const std::string               device_shader_compiler() const;
     const std::string               device_context_version() const;
 
+    // upload contexts
+    //  - in_worker_count threads with gl contexts shared with in_context, created with
+    //    headless surfaces on the display of in_context, call from the thread owning it
+    //  - submit_upload() runs the job on an idle worker with its render_context current, the
+    //    job creates and fills buffers and textures while the render thread draws frames,
+    //    upload_task::acquire() hands the results over to a render context through a fence
+    //  - without upload contexts the job runs right away on the main context
+    bool                            enable_upload_contexts(const wm::context_cptr& in_context,
+                                                           unsigned                in_worker_count = 1);
+    void                            disable_upload_contexts();
+    bool                            upload_contexts_enabled() const;
+    upload_task_ptr                 submit_upload(const boost::function<bool (render_context&)>& in_upload);
+
 protected:
     void                            init_capabilities();
 
@@ -212,6 +237,25 @@ public:
                                                    bool                        in_rasterization_discard = false,
                                                    const std::string&          in_program_name = "");
 
+    // program binary cache
+    //  - linked programs are stored in and restored from in_cache_path
+    //  - while enabled shader compilation is deferred to the program creation, compile
+    //    errors are reported when creating the program
+    bool                            enable_program_binary_cache(const std::string& in_cache_path);
+    void                            disable_program_binary_cache();
+    program_binary_cache_cptr       program_cache() const;
+
+    // asynchronous program builds
+    //  - shader compilation is deferred to the program creation, create_program submits
+    //    compile and link operations without querying their results
+    //  - results are queried when the program is first applied to a context, its
+    //    uniforms are accessed or on program::await_build()
+    //  - with KHR_parallel_shader_compile the driver builds on up to in_max_compiler_threads
+    //    threads (0xffffffff lets the driver decide) and program::build_completed() can be polled
+    void                            enable_async_program_builds(unsigned in_max_compiler_threads = 0xffffffffu);
+    void                            disable_async_program_builds();
+    bool                            async_program_builds() const;
+
 protected:
     bool                            add_include_string_internal(const std::string& in_path,
                                                                 const std::string& in_source_string,
@@ -274,6 +318,8 @@ public:
     texture_3d_ptr                  create_texture_3d(const texture_3d_ptr&     in_orig_texture,
                                                       const data_format         in_format,
                                                       const math::vec2ui&       in_mip_range);
+    // virtual page size of sparse 3d textures of the format, zero if unsupported
+    math::vec3ui                    texture_3d_sparse_page_size(const data_format in_format) const;
 
     texture_cube_ptr                create_texture_cube(const texture_cube_desc& in_desc);
     texture_cube_ptr                create_texture_cube(const texture_cube_desc& in_desc,
@@ -390,14 +436,24 @@ protected:
     // device /////////////////////////////////////////////////////////////////////////////////////
     shared_ptr<opengl::gl_core>     _opengl_api_core;
     render_context_ptr              _main_context;
+    upload_pool_ptr                 _upload_pool;
 
     // shader api /////////////////////////////////////////////////////////////////////////////////
     shader_macro_map                _default_macro_defines;
     string_set                      _default_include_paths;
+    string_hash_map                 _include_string_hashes;
+    program_binary_cache_ptr        _program_binary_cache;
+    bool                            _async_program_builds;
 
     device_capabilities             _capabilities;
     resource_ptr_set                _registered_resources;
 
+    // state api //////////////////////////////////////////////////////////////////////////////////
+    depth_stencil_state_cache       _depth_stencil_state_cache;
+    rasterizer_state_cache          _rasterizer_state_cache;
+    blend_state_cache               _blend_state_cache;
+    sampler_state_cache             _sampler_state_cache;
+
 #if SCM_ENABLE_CUDA_CL_SUPPORT
     // compute interop ////////////////////////////////////////////////////////////////////////////
     cl::opencl_device_ptr           _opencl_device;
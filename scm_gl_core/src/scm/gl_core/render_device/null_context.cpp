@@ -0,0 +1,179 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "null_context.h"
+
+#include <cassert>
+
+namespace scm {
+namespace gl {
+
+null_context::null_context()
+  : _call_counts(command_list::CMD_COUNT, 0)
+  , _apply_count(0)
+{
+}
+
+null_context::~null_context()
+{
+}
+
+void
+null_context::reset_counters()
+{
+    _call_counts.assign(command_list::CMD_COUNT, 0);
+    _apply_count = 0;
+}
+
+scm::size_t
+null_context::call_count(const command_list::command_type in_type) const
+{
+    assert(0 <= in_type && in_type < command_list::CMD_COUNT);
+    return _call_counts[in_type];
+}
+
+scm::size_t
+null_context::call_count() const
+{
+    scm::size_t c = 0;
+    for (std::vector<scm::size_t>::const_iterator n = _call_counts.begin(); n != _call_counts.end(); ++n) {
+        c += *n;
+    }
+    return c;
+}
+
+scm::size_t
+null_context::draw_count() const
+{
+    return   _call_counts[command_list::CMD_DRAW_ARRAYS]
+           + _call_counts[command_list::CMD_DRAW_ARRAYS_INSTANCED]
+           + _call_counts[command_list::CMD_DRAW_ELEMENTS]
+           + _call_counts[command_list::CMD_DRAW_ELEMENTS_INSTANCED];
+}
+
+scm::size_t
+null_context::apply_count() const
+{
+    return _apply_count;
+}
+
+void
+null_context::count(const command_list::command_type in_type)
+{
+    ++_call_counts[in_type];
+}
+
+// render_context interface ///////////////////////////////////////////////////////////////////////
+void
+null_context::bind_program(const program_ptr& /*in_program*/)
+{
+    count(command_list::CMD_BIND_PROGRAM);
+}
+
+void
+null_context::bind_vertex_array(const vertex_array_ptr& /*in_vertex_array*/)
+{
+    count(command_list::CMD_BIND_VERTEX_ARRAY);
+}
+
+void
+null_context::set_index_buffer_binding(const render_context::index_buffer_binding& /*in_index_buffer_binding*/)
+{
+    count(command_list::CMD_BIND_INDEX_BUFFER);
+}
+
+void
+null_context::bind_uniform_buffer(const buffer_ptr& /*in_buffer*/,
+                                  const unsigned    /*in_bind_point*/,
+                                  const scm::size_t /*in_offset*/,
+                                  const scm::size_t /*in_size*/)
+{
+    count(command_list::CMD_BIND_UNIFORM_BUFFER);
+}
+
+void
+null_context::bind_storage_buffer(const buffer_ptr& /*in_buffer*/,
+                                  const unsigned    /*in_bind_point*/,
+                                  const scm::size_t /*in_offset*/,
+                                  const scm::size_t /*in_size*/)
+{
+    count(command_list::CMD_BIND_STORAGE_BUFFER);
+}
+
+void
+null_context::bind_texture(const texture_ptr&       /*in_texture_image*/,
+                           const sampler_state_ptr& /*in_sampler_state*/,
+                           const unsigned           /*in_unit*/)
+{
+    count(command_list::CMD_BIND_TEXTURE);
+}
+
+void
+null_context::set_depth_stencil_state(const depth_stencil_state_ptr& /*in_ds_state*/, unsigned /*in_stencil_ref*/)
+{
+    count(command_list::CMD_SET_DEPTH_STENCIL_STATE);
+}
+
+void
+null_context::set_rasterizer_state(const rasterizer_state_ptr& /*in_rs_state*/, float /*in_line_width*/, float /*in_point_size*/)
+{
+    count(command_list::CMD_SET_RASTERIZER_STATE);
+}
+
+void
+null_context::set_blend_state(const blend_state_ptr& /*in_bl_state*/, const math::vec4f& /*in_blend_color*/)
+{
+    count(command_list::CMD_SET_BLEND_STATE);
+}
+
+void
+null_context::set_frame_buffer(const frame_buffer_ptr& /*in_frame_buffer*/)
+{
+    count(command_list::CMD_SET_FRAME_BUFFER);
+}
+
+void
+null_context::set_default_frame_buffer(const frame_buffer_target /*in_target*/)
+{
+    count(command_list::CMD_SET_DEFAULT_FRAME_BUFFER);
+}
+
+void
+null_context::set_viewports(const viewport_array& /*in_vp*/)
+{
+    count(command_list::CMD_SET_VIEWPORT);
+}
+
+void
+null_context::apply()
+{
+    ++_apply_count;
+}
+
+void
+null_context::draw_arrays(const primitive_topology /*in_topology*/, const int /*in_first_index*/, const int /*in_count*/)
+{
+    count(command_list::CMD_DRAW_ARRAYS);
+}
+
+void
+null_context::draw_arrays_instanced(const primitive_topology /*in_topology*/, const int /*in_first_index*/, const int /*in_count*/, const int /*in_instance_count*/)
+{
+    count(command_list::CMD_DRAW_ARRAYS_INSTANCED);
+}
+
+void
+null_context::draw_elements(const int /*in_count*/, const int /*in_start_index*/, const int /*in_base_vertex*/)
+{
+    count(command_list::CMD_DRAW_ELEMENTS);
+}
+
+void
+null_context::draw_elements_instanced(const int /*in_count*/, const int /*in_start_index*/, const int /*in_instance_count*/, const int /*in_base_vertex*/)
+{
+    count(command_list::CMD_DRAW_ELEMENTS_INSTANCED);
+}
+
+} // namespace gl
+} // namespace scm
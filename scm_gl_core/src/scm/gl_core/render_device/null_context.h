@@ -0,0 +1,90 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_NULL_CONTEXT_H_INCLUDED
+#define SCM_GL_CORE_NULL_CONTEXT_H_INCLUDED
+
+#include <vector>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+
+#include <scm/gl_core/constants.h>
+#include <scm/gl_core/data_types.h>
+#include <scm/gl_core/gl_core_fwd.h>
+#include <scm/gl_core/render_device/command_list.h>
+#include <scm/gl_core/render_device/context.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// null_context
+//  - null back end for command lists (command_list::replay(null_context&)), offers the
+//    binding, state and draw interface of render_context without touching the OpenGL api
+//  - counts the calls per command type and the state applications before the draws,
+//    no state is filtered, every call reaching the null context is counted
+class __scm_export(gl_core) null_context
+{
+public:
+    null_context();
+    virtual ~null_context();
+
+    void                        reset_counters();
+
+    scm::size_t                 call_count(const command_list::command_type in_type) const;
+    scm::size_t                 call_count() const;     // all binding, state and draw calls
+    scm::size_t                 draw_count() const;
+    scm::size_t                 apply_count() const;
+
+    // render_context interface ///////////////////////////////////////////////////////////////////
+    void                        bind_program(const program_ptr& in_program);
+
+    void                        bind_vertex_array(const vertex_array_ptr& in_vertex_array);
+    void                        set_index_buffer_binding(const render_context::index_buffer_binding& in_index_buffer_binding);
+    void                        bind_uniform_buffer(const buffer_ptr& in_buffer,
+                                                    const unsigned    in_bind_point,
+                                                    const scm::size_t in_offset = 0,
+                                                    const scm::size_t in_size = 0);
+    void                        bind_storage_buffer(const buffer_ptr& in_buffer,
+                                                    const unsigned    in_bind_point,
+                                                    const scm::size_t in_offset = 0,
+                                                    const scm::size_t in_size = 0);
+
+    void                        bind_texture(const texture_ptr&       in_texture_image,
+                                             const sampler_state_ptr& in_sampler_state,
+                                             const unsigned           in_unit);
+
+    void                        set_depth_stencil_state(const depth_stencil_state_ptr& in_ds_state, unsigned in_stencil_ref = 0);
+    void                        set_rasterizer_state(const rasterizer_state_ptr& in_rs_state, float in_line_width = 1.0f, float in_point_size = 1.0f);
+    void                        set_blend_state(const blend_state_ptr& in_bl_state, const math::vec4f& in_blend_color = math::vec4f(1.0f, 1.0f, 1.0f, 1.0f));
+
+    void                        set_frame_buffer(const frame_buffer_ptr& in_frame_buffer);
+    void                        set_default_frame_buffer(const frame_buffer_target in_target = FRAMEBUFFER_BACK);
+    void                        set_viewports(const viewport_array& in_vp);
+
+    void                        apply();
+
+    void                        draw_arrays(const primitive_topology in_topology, const int in_first_index, const int in_count);
+    void                        draw_arrays_instanced(const primitive_topology in_topology, const int in_first_index, const int in_count, const int in_instance_count = 1);
+    void                        draw_elements(const int in_count, const int in_start_index = 0, const int in_base_vertex = 0);
+    void                        draw_elements_instanced(const int in_count, const int in_start_index = 0, const int in_instance_count = 1, const int in_base_vertex = 0);
+
+protected:
+    void                        count(const command_list::command_type in_type);
+
+private:
+    std::vector<scm::size_t>    _call_counts;           // per command type
+    scm::size_t                 _apply_count;
+
+}; // class null_context
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_NULL_CONTEXT_H_INCLUDED
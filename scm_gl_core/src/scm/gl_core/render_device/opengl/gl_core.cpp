@@ -18,6 +18,7 @@
 #   include <scm/core/platform/windows.h>
 #elif SCM_PLATFORM == SCM_PLATFORM_LINUX
 #   include <GL/glx.h>
+#   include <EGL/egl.h>
 #else
 #   error "unsupported platform"
 #endif // SCM_PLATFORM
@@ -42,6 +43,10 @@ sys_get_proc_address(const char *name)
         return (::GetProcAddress(::GetModuleHandle("OpenGL32"), name));
     }
 #elif SCM_PLATFORM == SCM_PLATFORM_LINUX
+    // headless contexts of egl displays (see wm::display)
+    if (EGL_NO_CONTEXT != ::eglGetCurrentContext()) {
+        return (void*) (::eglGetProcAddress(name));
+    }
     return (void*) (*glXGetProcAddressARB((const GLubyte*) name));
 #endif
 }
@@ -145,6 +150,8 @@ gl_core::gl_core()
     extension_NV_fragment_shader_interlock      = false;
     extension_NV_sample_mask_override_coverage  = false;
     extension_NV_fill_rectangle                 = false;
+
+    extension_KHR_parallel_shader_compile       = false;
 }
 
 bool
@@ -296,6 +303,8 @@ gl_core::initialize()
     extension_NV_sample_mask_override_coverage = is_supported("GL_NV_sample_mask_override_coverage");
     extension_NV_fill_rectangle             = is_supported("GL_NV_fill_rectangle");
 
+    extension_KHR_parallel_shader_compile   = extension_KHR_parallel_shader_compile   && is_supported("GL_KHR_parallel_shader_compile");
+
 #ifdef SCM_GL_CORE_USE_DIRECT_STATE_ACCESS
     if (!is_supported("GL_EXT_direct_state_access")) {
         glout() << log::warning
@@ -1327,6 +1336,11 @@ gl_core::init_entry_points()
     SCM_INIT_GL_ENTRY(PFNGLSUBPIXELPRECISIONBIASNVPROC, glSubpixelPrecisionBiasNV, "NV_conservative_raster", init_success);
     extension_NV_conservative_raster = init_success;
 
+    // KHR_parallel_shader_compile
+    init_success = true;
+    SCM_INIT_GL_ENTRY(PFNGLMAXSHADERCOMPILERTHREADSKHRPROC, glMaxShaderCompilerThreadsKHR, "KHR_parallel_shader_compile", init_success);
+    extension_KHR_parallel_shader_compile = init_success;
+
     glout() << log::outdent;
     glout() << log::info << "finished initializing function entry points..." << log::end;
 
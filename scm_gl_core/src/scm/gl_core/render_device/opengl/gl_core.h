@@ -119,6 +119,8 @@ public:
     bool extension_NV_sample_mask_override_coverage;
     bool extension_NV_fill_rectangle;
 
+    bool extension_KHR_parallel_shader_compile;
+
     // version 1.0 ////////////////////////////////////////////////////////////////////////////////
     PFNGLCULLFACEPROC                               glCullFace;
     PFNGLFRONTFACEPROC                              glFrontFace;
@@ -1023,6 +1025,9 @@ public:
     // NV_conservative_raster
     PFNGLSUBPIXELPRECISIONBIASNVPROC                glSubpixelPrecisionBiasNV;
 
+    // KHR_parallel_shader_compile
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC            glMaxShaderCompilerThreadsKHR;
+
 }; // class gl_core
 
 } // namespace opengl
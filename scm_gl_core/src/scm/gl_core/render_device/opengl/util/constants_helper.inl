@@ -94,6 +94,19 @@ gl_buffer_access_mode(const access_mode a)
     }
 }
 
+inline
+unsigned
+gl_buffer_storage_flags(const buffer_storage s)
+{
+    assert(STORAGE_MUTABLE <= s && s < BUFFER_STORAGE_COUNT);
+
+    switch (s) {
+        case STORAGE_PERSISTENT_WRITE:          return GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_DYNAMIC_STORAGE_BIT;
+        case STORAGE_PERSISTENT_READ:           return GL_MAP_READ_BIT  | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        default:                                return 0;
+    }
+}
+
 inline
 unsigned
 gl_image_access_mode(const access_mode a)
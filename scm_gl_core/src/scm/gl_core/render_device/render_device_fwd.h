@@ -14,6 +14,10 @@ class render_device;
 class render_context;
 class render_device_child;
 class render_device_resource;
+class command_list;
+class null_context;
+class upload_task;
+class upload_pool;
 
 typedef shared_ptr<render_device>           render_device_ptr;
 typedef shared_ptr<const render_device>     render_device_cptr;
@@ -21,6 +25,11 @@ typedef weak_ptr<render_device>             render_device_wptr;
 typedef shared_ptr<render_context>          render_context_ptr;
 typedef shared_ptr<const render_context>    render_context_cptr;
 typedef weak_ptr<render_context>            render_context_wptr;
+typedef shared_ptr<command_list>            command_list_ptr;
+typedef shared_ptr<const command_list>      command_list_cptr;
+typedef shared_ptr<upload_task>             upload_task_ptr;
+typedef shared_ptr<const upload_task>       upload_task_cptr;
+typedef shared_ptr<upload_pool>             upload_pool_ptr;
 
 class context_program_guard;
 class context_vertex_input_guard;
@@ -0,0 +1,231 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "upload_pool.h"
+
+#include <exception>
+
+#include <boost/bind.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <scm/core/math.h>
+
+#include <scm/gl_core/log.h>
+#include <scm/gl_core/render_device/context.h>
+#include <scm/gl_core/render_device/device.h>
+#include <scm/gl_core/sync_objects/fence_sync.h>
+#include <scm/gl_core/window_management/context.h>
+#include <scm/gl_core/window_management/headless_surface.h>
+
+namespace scm {
+namespace gl {
+
+// upload_task ////////////////////////////////////////////////////////////////////////////////////
+upload_task::upload_task(const upload_function& in_upload)
+  : _upload(in_upload)
+  , _finished(false)
+  , _succeeded(false)
+{
+}
+
+upload_task::~upload_task()
+{
+    _fence.reset();
+}
+
+bool
+upload_task::finished() const
+{
+    boost::lock_guard<boost::mutex> lock(_mutex);
+    return _finished;
+}
+
+bool
+upload_task::succeeded() const
+{
+    boost::lock_guard<boost::mutex> lock(_mutex);
+    return _finished && _succeeded;
+}
+
+void
+upload_task::wait() const
+{
+    boost::unique_lock<boost::mutex> lock(_mutex);
+    while (!_finished) {
+        _finished_condition.wait(lock);
+    }
+}
+
+bool
+upload_task::acquire(render_context& in_context,
+                     bool            in_block) const
+{
+    if (!in_block && !finished()) {
+        return false;
+    }
+    wait();
+
+    const fence_sync_ptr f = fence();
+    if (!f) {
+        return false;
+    }
+    in_context.sync_server_wait(f);
+
+    return succeeded();
+}
+
+fence_sync_ptr
+upload_task::fence() const
+{
+    boost::lock_guard<boost::mutex> lock(_mutex);
+    return _fence;
+}
+
+void
+upload_task::run(render_context& in_context)
+{
+    bool upload_ok = false;
+
+    try {
+        upload_ok = _upload ? _upload(in_context) : true;
+    }
+    catch (std::exception& e) {
+        glerr() << log::error << "upload_task::run(): upload job failed (" << e.what() << ")." << log::end;
+    }
+
+    // the fence has to reach the gpu before other contexts can wait for it
+    const fence_sync_ptr f = in_context.insert_fence_sync();
+    in_context.flush();
+
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _fence     = f;
+        _succeeded = upload_ok && f;
+        _finished  = true;
+    }
+    _finished_condition.notify_all();
+}
+
+// upload_pool ////////////////////////////////////////////////////////////////////////////////////
+upload_pool::upload_pool(render_device&          in_device,
+                         const wm::context_cptr& in_share_context,
+                         unsigned                in_worker_count)
+  : _device(in_device)
+  , _running(true)
+  , _started_workers(0)
+  , _failed_workers(0)
+{
+    try {
+        for (unsigned w = 0; w < in_worker_count; ++w) {
+            worker_context wc;
+            wc._surface.reset(new wm::headless_surface(in_share_context->associated_display(),
+                                                       in_share_context->surface_format(),
+                                                       math::vec2ui(1u)));
+            wc._context.reset(new wm::context(wc._surface,
+                                              in_share_context->context_attributes(),
+                                              in_share_context));
+            _worker_contexts.push_back(wc);
+        }
+    }
+    catch (std::exception& e) {
+        glerr() << log::error << "upload_pool::upload_pool(): unable to create shared worker context (" << e.what() << ")." << log::end;
+        _worker_contexts.clear();
+        _failed_workers = in_worker_count;
+        return;
+    }
+
+    for (unsigned w = 0; w < worker_count(); ++w) {
+        _worker_threads.create_thread(boost::bind(&upload_pool::run_worker, this, w));
+    }
+
+    boost::unique_lock<boost::mutex> lock(_mutex);
+    while (_started_workers < worker_count()) {
+        _startup_condition.wait(lock);
+    }
+}
+
+upload_pool::~upload_pool()
+{
+    shutdown();
+    _worker_contexts.clear();
+}
+
+bool
+upload_pool::ok() const
+{
+    return !_worker_contexts.empty() && (0 == _failed_workers);
+}
+
+unsigned
+upload_pool::worker_count() const
+{
+    return static_cast<unsigned>(_worker_contexts.size());
+}
+
+void
+upload_pool::submit(const upload_task_ptr& in_task)
+{
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _tasks.push_back(in_task);
+    }
+    _task_condition.notify_one();
+}
+
+void
+upload_pool::run_worker(unsigned in_worker)
+{
+    const worker_context&   wc = _worker_contexts[in_worker];
+    render_context_ptr      worker_render_context;
+
+    if (wc._context->make_current(wc._surface)) {
+        worker_render_context = _device.create_context();
+    }
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        ++_started_workers;
+        if (!worker_render_context) {
+            ++_failed_workers;
+        }
+    }
+    _startup_condition.notify_all();
+
+    if (!worker_render_context) {
+        glerr() << log::error << "upload_pool::run_worker(): unable to make worker context current." << log::end;
+        return;
+    }
+
+    for (;;) {
+        upload_task_ptr task;
+        {
+            boost::unique_lock<boost::mutex> lock(_mutex);
+            while (_running && _tasks.empty()) {
+                _task_condition.wait(lock);
+            }
+            if (_tasks.empty()) {
+                break;
+            }
+            task = _tasks.front();
+            _tasks.pop_front();
+        }
+        task->run(*worker_render_context);
+    }
+
+    worker_render_context.reset();
+    wc._context->make_current(wc._surface, false);
+}
+
+void
+upload_pool::shutdown()
+{
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _running = false;
+    }
+    _task_condition.notify_all();
+    _worker_threads.join_all();
+}
+
+} // namespace gl
+} // namespace scm
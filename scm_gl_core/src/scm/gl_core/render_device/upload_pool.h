@@ -0,0 +1,124 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_UPLOAD_POOL_H_INCLUDED
+#define SCM_GL_CORE_UPLOAD_POOL_H_INCLUDED
+
+#include <deque>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/render_device/render_device_fwd.h>
+#include <scm/gl_core/sync_objects/sync_objects_fwd.h>
+#include <scm/gl_core/window_management/wm_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// upload_task
+//  - an upload job submitted to render_device::submit_upload(), the job runs on a worker
+//    thread with a render_context on a shared gl context current
+//  - the worker inserts a fence after the job, acquire() makes a render context wait for
+//    it on the gpu (sync_server_wait) before the uploaded resources are used
+class __scm_export(gl_core) upload_task : boost::noncopyable
+{
+public:
+    // returns false if the upload failed
+    typedef boost::function<bool (render_context&)> upload_function;
+
+public:
+    explicit upload_task(const upload_function& in_upload);
+    virtual ~upload_task();
+
+    bool                        finished() const;
+    bool                        succeeded() const;
+    void                        wait() const;
+
+    // server side wait of in_context for the upload, without in_block returns false
+    // while the job has not run yet, acquire once per render context
+    bool                        acquire(render_context& in_context,
+                                        bool            in_block = true) const;
+
+    fence_sync_ptr              fence() const;
+
+protected:
+    void                        run(render_context& in_context);
+
+protected:
+    upload_function             _upload;
+
+    mutable boost::mutex        _mutex;
+    mutable boost::condition_variable _finished_condition;
+    bool                        _finished;
+    bool                        _succeeded;
+    fence_sync_ptr              _fence;
+
+private:
+    friend class render_device;
+    friend class upload_pool;
+
+}; // class upload_task
+
+// upload_pool
+//  - worker threads owning gl contexts shared with a wm::context, each with a headless
+//    surface on the display of that context
+//  - upload tasks are run in submission order by the first idle worker, pending tasks
+//    still run when the pool is shut down
+class __scm_export(gl_core) upload_pool : boost::noncopyable
+{
+protected:
+    struct worker_context {
+        wm::headless_surface_ptr    _surface;
+        wm::context_ptr             _context;
+    }; // struct worker_context
+
+    typedef std::vector<worker_context>     worker_context_array;
+    typedef std::deque<upload_task_ptr>     task_queue;
+
+public:
+    upload_pool(render_device&          in_device,
+                const wm::context_cptr& in_share_context,
+                unsigned                in_worker_count);
+    virtual ~upload_pool();
+
+    bool                        ok() const;
+    unsigned                    worker_count() const;
+
+    void                        submit(const upload_task_ptr& in_task);
+
+protected:
+    void                        run_worker(unsigned in_worker);
+    void                        shutdown();
+
+protected:
+    render_device&              _device;
+    worker_context_array        _worker_contexts;
+    boost::thread_group         _worker_threads;
+
+    boost::mutex                _mutex;
+    boost::condition_variable   _task_condition;
+    boost::condition_variable   _startup_condition;
+    task_queue                  _tasks;
+    bool                        _running;
+    unsigned                    _started_workers;
+    unsigned                    _failed_workers;
+
+}; // class upload_pool
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_UPLOAD_POOL_H_INCLUDED
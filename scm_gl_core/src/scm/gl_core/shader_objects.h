@@ -10,5 +10,6 @@
 #include <scm/gl_core/shader_objects/shader.h>
 #include <scm/gl_core/shader_objects/stream_capture.h>
 #include <scm/gl_core/shader_objects/program.h>
+#include <scm/gl_core/shader_objects/program_binary_cache.h>
 
 #endif // SCM_GL_CORE_SHADER_OBJECTS_H_INCLUDED
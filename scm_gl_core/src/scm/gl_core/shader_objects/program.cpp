@@ -26,6 +26,7 @@
 #include <scm/gl_core/render_device/opengl/util/constants_helper.h>
 #include <scm/gl_core/render_device/opengl/util/data_type_helper.h>
 #include <scm/gl_core/render_device/opengl/util/error_helper.h>
+#include <scm/gl_core/shader_objects/program_binary_cache.h>
 #include <scm/gl_core/shader_objects/shader.h>
 #include <scm/gl_core/shader_objects/stream_capture.h>
 
@@ -39,9 +40,14 @@ program::program(render_device&              in_device,
                  const stream_capture_array& in_capture,
                  bool                        in_rasterization_discard,
                  const named_location_list&  in_attribute_locations,
-                 const named_location_list&  in_fragment_locations)
+                 const named_location_list&  in_fragment_locations,
+                 const program_binary_cache_ptr& in_binary_cache,
+                 scm::uint64                 in_binary_cache_seed,
+                 bool                        in_async_build)
   : render_device_child(in_device)
   , _rasterization_discard(in_rasterization_discard)
+  , _build_pending(false)
+  , _binary_cache_key(0)
 {
     const opengl::gl_core& glapi = in_device.opengl_api();
     util::gl_error          glerror(glapi);
@@ -51,44 +57,99 @@ program::program(render_device&              in_device,
         state().set(object_state::OS_BAD);
     }
     else {
-        // attach all shaders
-        foreach(const shader_ptr& s, in_shaders) {
-            if (s) {
-                glapi.glAttachShader(_gl_program_obj, s->_gl_shader_obj);
-                if (!glerror) {
+        scm::uint64 binary_key    = 0;
+        bool        binary_loaded = false;
+
+        // try to restore the program from the binary cache
+        if (in_binary_cache) {
+            binary_key    = binary_cache_key(in_binary_cache_seed, in_shaders, in_capture, in_attribute_locations, in_fragment_locations);
+            binary_loaded = load_binary(in_device, *in_binary_cache, binary_key);
+        }
+
+        if (binary_loaded) {
+            foreach(const shader_ptr& s, in_shaders) {
+                if (s) {
                     _shaders.push_back(s);
                 }
                 else {
                     state().set(object_state::OS_ERROR_INVALID_VALUE);
                 }
             }
-            else {
-                state().set(object_state::OS_ERROR_INVALID_VALUE);
-            }
         }
-        gl_assert(glapi, program::program() attaching shader objects);
-        // set the captured transform feedback varyings
-        if (!in_capture.empty()) {
-            if (!apply_transform_feedback_varyings(in_device, in_capture)) {
-                // error code set in function itself
-                return;
+        else {
+            // submit all shaders with deferred compilation before querying any result,
+            // drivers supporting parallel compilation build them concurrently
+            foreach(const shader_ptr& s, in_shaders) {
+                if (s) {
+                    s->submit_compile(in_device);
+                }
+            }
+            if (!in_async_build) {
+                foreach(const shader_ptr& s, in_shaders) {
+                    if (s && !s->finish_compile(in_device)) {
+                        state().set(object_state::OS_ERROR_SHADER_COMPILE);
+                        _info_log +=   std::string("program::program(): error compiling ")
+                                     + std::string(shader_stage_string(s->type()))
+                                     + std::string(" shader:\n")
+                                     + s->info_log();
+                    }
+                }
+                if (fail()) {
+                    return;
+                }
+            }
+            // attach all shaders
+            foreach(const shader_ptr& s, in_shaders) {
+                if (s) {
+                    glapi.glAttachShader(_gl_program_obj, s->_gl_shader_obj);
+                    if (!glerror) {
+                        _shaders.push_back(s);
+                    }
+                    else {
+                        state().set(object_state::OS_ERROR_INVALID_VALUE);
+                    }
+                }
+                else {
+                    state().set(object_state::OS_ERROR_INVALID_VALUE);
+                }
+            }
+            gl_assert(glapi, program::program() attaching shader objects);
+            // set the captured transform feedback varyings
+            if (!in_capture.empty()) {
+                if (!apply_transform_feedback_varyings(in_device, in_capture)) {
+                    // error code set in function itself
+                    return;
+                }
+            }
+            // set default attribute locations
+            foreach(const named_location& l, in_attribute_locations) {
+                glapi.glBindAttribLocation(_gl_program_obj, l.second, l.first.c_str());
+                gl_assert(glapi, program::program() binding attribute location);
+            }
+            // set default fragdata locations
+            foreach(const named_location& l, in_fragment_locations) {
+                glapi.glBindFragDataLocation(_gl_program_obj, l.second, l.first.c_str());
+                gl_assert(glapi, program::program() binding fragdata location);
+            }
+            if (in_binary_cache) {
+                glapi.glProgramParameteri(_gl_program_obj, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+                gl_assert(glapi, program::program() setting binary retrievable hint);
+            }
+            // link program
+            if (in_async_build) {
+                // results are queried in await_build()
+                glapi.glLinkProgram(_gl_program_obj);
+                _build_pending    = true;
+                _binary_cache     = in_binary_cache;
+                _binary_cache_key = binary_key;
+            }
+            else if (link(in_device) && in_binary_cache) {
+                store_binary(in_device, *in_binary_cache, binary_key);
             }
         }
-        // set default attribute locations
-        foreach(const named_location& l, in_attribute_locations) {
-            glapi.glBindAttribLocation(_gl_program_obj, l.second, l.first.c_str());
-            gl_assert(glapi, program::program() binding attribute location);
-        }
-        // set default fragdata locations
-        foreach(const named_location& l, in_fragment_locations) {
-            glapi.glBindFragDataLocation(_gl_program_obj, l.second, l.first.c_str());
-            gl_assert(glapi, program::program() binding fragdata location);
-        }
-        // link program
-        link(in_device);
 
         // retrieve information
-        if (ok()) {
+        if (ok() && !_build_pending) {
             util::program_binding_guard save_guard(glapi);
             glapi.glUseProgram(_gl_program_obj);
             retrieve_attribute_information(in_device);
@@ -104,6 +165,11 @@ program::~program()
 {
     const opengl::gl_core& glapi = parent_device().opengl_api();
 
+    // uniform objects might outlive the program
+    foreach(const uniform_ptr& u, _uniform_array) {
+        u->_update_queue = 0;
+    }
+
     // TODO detach all shaders and remove them from _shaders;
 
     assert(0 != _gl_program_obj);
@@ -129,12 +195,23 @@ program::link(render_device& ren_dev)
 {
     assert(_gl_program_obj != 0);
 
+    const opengl::gl_core& glapi = ren_dev.opengl_api();
+
+    glapi.glLinkProgram(_gl_program_obj);
+
+    return query_link_status(ren_dev);
+}
+
+bool
+program::query_link_status(render_device& ren_dev)
+{
+    assert(_gl_program_obj != 0);
+
     const opengl::gl_core& glapi = ren_dev.opengl_api();
     util::gl_error          glerror(glapi);
 
     int link_state  = 0;
 
-    glapi.glLinkProgram(_gl_program_obj);
     glapi.glGetProgramiv(_gl_program_obj, GL_LINK_STATUS, &link_state);
 
     if (GL_TRUE != link_state) {
@@ -150,11 +227,96 @@ program::link(render_device& ren_dev)
         glapi.glGetProgramInfoLog(_gl_program_obj, info_len, NULL, &_info_log[0]);
     }
 
-    gl_assert(glapi, leaving program:link());
+    gl_assert(glapi, leaving program:query_link_status());
 
     return (GL_TRUE == link_state);
 }
 
+bool
+program::build_pending() const
+{
+    return _build_pending;
+}
+
+bool
+program::build_completed() const
+{
+    if (!_build_pending) {
+        return true;
+    }
+
+    const opengl::gl_core& glapi = parent_device().opengl_api();
+
+    // without KHR_parallel_shader_compile there is no non-blocking query,
+    // the build is reported as completed and await_build() might block
+    if (!glapi.extension_KHR_parallel_shader_compile) {
+        return true;
+    }
+
+    int completion_state = GL_TRUE;
+    glapi.glGetProgramiv(_gl_program_obj, GL_COMPLETION_STATUS_KHR, &completion_state);
+
+    return GL_TRUE == completion_state;
+}
+
+bool
+program::await_build()
+{
+    if (!_build_pending) {
+        return ok();
+    }
+    _build_pending = false;
+
+    render_device&          device = parent_device();
+    const opengl::gl_core&  glapi  = device.opengl_api();
+
+    foreach(const shader_ptr& s, _shaders) {
+        if (!s->finish_compile(device)) {
+            state().set(object_state::OS_ERROR_SHADER_COMPILE);
+            _info_log +=   std::string("program::await_build(): error compiling ")
+                         + std::string(shader_stage_string(s->type()))
+                         + std::string(" shader:\n")
+                         + s->info_log();
+        }
+    }
+
+    if (ok() && query_link_status(device)) {
+        if (_binary_cache) {
+            store_binary(device, *_binary_cache, _binary_cache_key);
+        }
+
+        util::program_binding_guard save_guard(glapi);
+        glapi.glUseProgram(_gl_program_obj);
+        retrieve_attribute_information(device);
+        retrieve_fragdata_information(device);
+        retrieve_uniform_information(device);
+    }
+    _binary_cache.reset();
+
+    if (fail()) {
+        glerr() << log::error << "program::await_build(): error during asynchronous program build ("
+                << state().state_string() << "):" << log::nline
+                << _info_log << log::end;
+    }
+    else if (!_info_log.empty()) {
+        glout() << log::info << "program::await_build(): linker info" << log::nline
+                << _info_log << log::end;
+    }
+
+    gl_assert(glapi, leaving program::await_build());
+
+    return ok();
+}
+
+void
+program::complete_pending_build() const
+{
+    // the program information is only available after the build completed
+    if (_build_pending) {
+        const_cast<program*>(this)->await_build();
+    }
+}
+
 bool
 program::validate(render_context& ren_ctx)
 {
@@ -183,27 +345,13 @@ program::bind_uniforms(render_context& ren_ctx) const
 
     const opengl::gl_core& glapi = ren_ctx.opengl_api();
 
-    { // uniforms
-        name_uniform_map::const_iterator u = _uniforms.begin();
-        name_uniform_map::const_iterator e = _uniforms.end();
-        for (; u != e; ++u) {
-            //std::cout << u->first << std::endl;
-            if (u->second->update_required()) {
-                u->second->apply_value(ren_ctx, *this);
-                u->second->_status._update_required = false;
-            }
-            //if (u->second._update_required) {
-                //std::cout << u->second._name << std::endl;
-//#if SCM_GL_CORE_USE_DIRECT_STATE_ACCESS
-//                boost::apply_visitor(detail::uniform_bind_dsa(glapi, _gl_program_obj, u->second), u->second._data);
-//#else
-//                boost::apply_visitor(detail::uniform_bind(glapi, u->second), u->second._data);
-//#endif // SCM_GL_CORE_USE_DIRECT_STATE_ACCESS
-            //    gl_assert(glapi, program::bind_uniforms() after apply uniform);
-
-            //    u->second._update_required = false;
-            //}
+    { // uniforms, only the ones changed since the last apply
+        for (uniform_update_queue::size_type i = 0; i < _uniform_update_queue.size(); ++i) {
+            uniform_base* u = _uniform_update_queue[i];
+            u->apply_value(ren_ctx, *this);
+            u->_status._update_required = false;
         }
+        _uniform_update_queue.clear();
     }
     { // uniform buffers
         name_uniform_block_map::const_iterator b = _uniform_blocks.begin();
@@ -361,6 +509,111 @@ program::apply_transform_feedback_varyings(render_device& in_device, const strea
     return true;
 }
 
+scm::uint64
+program::binary_cache_key(scm::uint64                 in_seed,
+                          const shader_list&          in_shaders,
+                          const stream_capture_array& in_capture,
+                          const named_location_list&  in_attribute_locations,
+                          const named_location_list&  in_fragment_locations) const
+{
+    typedef program_binary_cache pbc;
+
+    scm::uint64 key = pbc::hash(in_seed);
+
+    foreach(const shader_ptr& s, in_shaders) {
+        key = pbc::hash(s ? s->source_hash() : 0, key);
+    }
+    // transform feedback varyings and bound locations are part of the linked binary
+    key = pbc::hash(static_cast<scm::uint64>(in_capture.used_streams()), key);
+    key = pbc::hash(static_cast<scm::uint64>(in_capture.interleaved_streams()), key);
+    for (int stream = 0; stream < in_capture.used_streams(); ++stream) {
+        const stream_capture::captures_list& captures = in_capture.stream_captures(stream).captures();
+        foreach(const stream_capture::capture_element& cap, captures) {
+            if (boost::get<std::string>(&cap)) {
+                key = pbc::hash(boost::get<std::string>(cap), key);
+            }
+            else if (boost::get<stream_capture::skip_components_type>(&cap)) {
+                key = pbc::hash(static_cast<scm::uint64>(boost::get<stream_capture::skip_components_type>(cap)), key);
+            }
+        }
+        key = pbc::hash(static_cast<scm::uint64>(stream), key);
+    }
+    foreach(const named_location& l, in_attribute_locations) {
+        key = pbc::hash(l.first, pbc::hash(static_cast<scm::uint64>(l.second), key));
+    }
+    key = pbc::hash(static_cast<scm::uint64>(in_attribute_locations.size()), key);
+    foreach(const named_location& l, in_fragment_locations) {
+        key = pbc::hash(l.first, pbc::hash(static_cast<scm::uint64>(l.second), key));
+    }
+
+    return key;
+}
+
+bool
+program::load_binary(render_device& in_device, program_binary_cache& in_cache, scm::uint64 in_key)
+{
+    assert(_gl_program_obj != 0);
+
+    const opengl::gl_core& glapi = in_device.opengl_api();
+    util::gl_error          glerror(glapi);
+
+    unsigned                            binary_format = 0;
+    program_binary_cache::binary_data   binary;
+
+    if (!in_cache.retrieve(in_key, binary_format, binary)) {
+        return false;
+    }
+
+    glapi.glProgramBinary(_gl_program_obj, binary_format, &binary.front(), static_cast<int>(binary.size()));
+
+    int link_state = 0;
+    glapi.glGetProgramiv(_gl_program_obj, GL_LINK_STATUS, &link_state);
+
+    // the driver rejects binaries of other driver versions or unsupported formats,
+    // the program object stays usable for the regular compile and link path
+    if (glerror || GL_TRUE != link_state) {
+        glout() << log::info << "program::load_binary(): "
+                << "cached program binary rejected by driver, rebuilding from source." << log::end;
+        in_cache.invalidate(in_key);
+        return false;
+    }
+
+    in_cache.accept();
+
+    gl_assert(glapi, leaving program::load_binary());
+
+    return true;
+}
+
+bool
+program::store_binary(render_device& in_device, program_binary_cache& in_cache, scm::uint64 in_key)
+{
+    assert(_gl_program_obj != 0);
+
+    const opengl::gl_core& glapi = in_device.opengl_api();
+    util::gl_error          glerror(glapi);
+
+    int binary_length = 0;
+    glapi.glGetProgramiv(_gl_program_obj, GL_PROGRAM_BINARY_LENGTH, &binary_length);
+    if (glerror || binary_length <= 0) {
+        return false;
+    }
+
+    unsigned                            binary_format  = 0;
+    int                                 binary_written = 0;
+    program_binary_cache::binary_data   binary(binary_length);
+
+    glapi.glGetProgramBinary(_gl_program_obj, binary_length, &binary_written, &binary_format, &binary.front());
+    if (glerror || binary_written <= 0) {
+        return false;
+    }
+    binary.resize(binary_written);
+
+    gl_assert(glapi, leaving program::store_binary());
+
+    return in_cache.store(in_key, binary_format, binary);
+}
+
 void
 program::retrieve_attribute_information(render_device& in_device)
 {
@@ -408,6 +661,8 @@ program::retrieve_attribute_information(render_device& in_device)
 int
 program::attribute_location(const std::string& name) const
 {
+    complete_pending_build();
+
     name_variable_map::const_iterator a = _attributes.find(name);
     if (a != _attributes.end()) {
         return (a->second._location);
@@ -567,7 +822,10 @@ program::retrieve_uniform_information(render_device& in_device)
                 }
 
                 if (current_uniform) {
-                    _uniforms[actual_uniform_name] = current_uniform;
+                    current_uniform->_update_queue = &_uniform_update_queue;
+                    _uniforms[actual_uniform_name]        = current_uniform;
+                    _uniform_handles[actual_uniform_name] = static_cast<int>(_uniform_array.size());
+                    _uniform_array.push_back(current_uniform);
                 }
             }
         }
@@ -692,6 +950,8 @@ program::retrieve_uniform_information(render_device& in_device)
 uniform_ptr
 program::uniform_raw(const std::string& name) const
 {
+    complete_pending_build();
+
     name_uniform_map::const_iterator  u = _uniforms.find(name);
     if (u != _uniforms.end()) {
         return (u->second);
@@ -701,6 +961,31 @@ program::uniform_raw(const std::string& name) const
     }
 }
 
+int
+program::uniform_handle(const std::string& name) const
+{
+    complete_pending_build();
+
+    name_location_map::const_iterator  h = _uniform_handles.find(name);
+    if (h != _uniform_handles.end()) {
+        return (h->second);
+    }
+    else {
+        return (-1);
+    }
+}
+
+uniform_ptr
+program::uniform_raw(const int handle) const
+{
+    if (0 <= handle && handle < static_cast<int>(_uniform_array.size())) {
+        return (_uniform_array[handle]);
+    }
+    else {
+        return (uniform_ptr());
+    }
+}
+
 void
 program::uniform_sampler(const std::string& name, scm::int32 u)
 {
@@ -748,6 +1033,8 @@ program::uniform_image_handle(const std::string& name, scm::uint64 h)
 void
 program::uniform_buffer(const std::string& name, const unsigned binding)
 {
+    complete_pending_build();
+
     name_uniform_block_map::iterator  u = _uniform_blocks.find(name);
 
     if (u != _uniform_blocks.end()) {
@@ -764,6 +1051,8 @@ program::uniform_buffer(const std::string& name, const unsigned binding)
 void
 program::uniform_subroutine(const shader_stage stage, const std::string& name, const std::string& routine)
 {
+    complete_pending_build();
+
 #if 1
     name_subroutine_uniform_map::iterator subr = _subroutine_uniforms[stage].find(name);
     name_subroutine_map::iterator         rout = _subroutines[stage].find(routine);
@@ -785,6 +1074,8 @@ program::uniform_subroutine(const shader_stage stage, const std::string& name, c
 void
 program::storage_buffer(const std::string& name, const unsigned binding)
 {
+    complete_pending_build();
+
     name_storage_buffer_map::iterator  u = _storage_buffers.find(name);
 
     if (u != _storage_buffers.end()) {
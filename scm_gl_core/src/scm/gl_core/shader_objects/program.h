@@ -88,6 +88,9 @@ public:
     typedef boost::unordered_map<std::string, subroutine_type>          name_subroutine_map;
     typedef boost::unordered_map<std::string, storage_buffer_type>      name_storage_buffer_map;
 
+    typedef std::vector<uniform_ptr>                                    uniform_array;
+    typedef std::vector<uniform_base*>                                  uniform_update_queue;
+
 public:
     virtual ~program();
 
@@ -97,7 +100,15 @@ public:
     template<typename T> void   uniform(const std::string& name, const T& v) const;
     template<typename T> void   uniform(const std::string& name, int i, const T& v) const;
 
+    // uniform handles
+    //  - resolve the name once, setting values through the handle avoids the string lookup
+    //  - handles stay valid for the lifetime of the program, -1 denotes an unknown uniform
+    int                         uniform_handle(const std::string& name) const;
+    template<typename T> void   uniform(const int handle, const T& v) const;
+    template<typename T> void   uniform(const int handle, int i, const T& v) const;
+
     uniform_ptr                 uniform_raw(const std::string& name) const;
+    uniform_ptr                 uniform_raw(const int handle) const;
 
     uniform_sampler_ptr         uniform_sampler(const std::string& name) const;
     uniform_image_ptr           uniform_image(const std::string& name) const;
@@ -145,15 +156,27 @@ public:
 
     bool                        rasterization_discard() const;
 
+    // asynchronous builds (see render_device::enable_async_program_builds())
+    //  - build_completed() polls the driver without blocking
+    //  - await_build() queries the compile and link results, blocking if required
+    bool                        build_pending() const;
+    bool                        build_completed() const;
+    bool                        await_build();
+
 protected:
     program(render_device&              in_device,
             const shader_list&          in_shaders,
             const stream_capture_array& in_capture,
             bool                        in_rasterization_discard = false,
             const named_location_list&  in_attribute_locations = named_location_list(),
-            const named_location_list&  in_fragment_locations  = named_location_list());
+            const named_location_list&  in_fragment_locations  = named_location_list(),
+            const program_binary_cache_ptr& in_binary_cache    = program_binary_cache_ptr(),
+            scm::uint64                 in_binary_cache_seed   = 0,
+            bool                        in_async_build         = false);
 
     bool                        link(render_device& ren_dev);
+    bool                        query_link_status(render_device& ren_dev);
+    void                        complete_pending_build() const;
     bool                        validate(render_context& ren_ctx);
     
     void                        bind(render_context& ren_ctx) const;
@@ -161,6 +184,14 @@ protected:
 
     bool                        apply_transform_feedback_varyings(render_device& in_device, const stream_capture_array& in_capture); 
 
+    scm::uint64                 binary_cache_key(scm::uint64                 in_seed,
+                                                 const shader_list&          in_shaders,
+                                                 const stream_capture_array& in_capture,
+                                                 const named_location_list&  in_attribute_locations,
+                                                 const named_location_list&  in_fragment_locations) const;
+    bool                        load_binary(render_device& in_device, program_binary_cache& in_cache, scm::uint64 in_key);
+    bool                        store_binary(render_device& in_device, program_binary_cache& in_cache, scm::uint64 in_key);
+
     void                        retrieve_attribute_information(render_device& in_device);
     void                        retrieve_fragdata_information(render_device& in_device);
     void                        retrieve_uniform_information(render_device& in_device);
@@ -171,6 +202,9 @@ protected:
     bool                        _rasterization_discard;
 
     name_uniform_map            _uniforms;
+    uniform_array               _uniform_array;
+    name_location_map           _uniform_handles;
+    mutable uniform_update_queue _uniform_update_queue;
     name_uniform_block_map      _uniform_blocks;
     name_variable_map           _attributes;
     name_location_map           _samplers;
@@ -181,6 +215,10 @@ protected:
     unsigned                    _gl_program_obj;
     std::string                 _info_log;
 
+    bool                        _build_pending;
+    program_binary_cache_ptr    _binary_cache;
+    scm::uint64                 _binary_cache_key;
+
     friend class scm::gl::render_device;
     friend class scm::gl::render_context;
 }; // class program
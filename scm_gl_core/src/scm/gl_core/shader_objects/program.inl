@@ -42,6 +42,32 @@ program::uniform(const std::string& name, int i, const T& v) const {
     }
 }
 
+template<typename T>
+inline
+void
+program::uniform(const int handle, const T& v) const {
+    uniform(handle, 0, v);
+}
+
+template<typename T>
+inline
+void
+program::uniform(const int handle, int i, const T& v) const {
+    if (0 <= handle && handle < static_cast<int>(_uniform_array.size())) {
+        typedef typename scm::gl::uniform_type<T>::type cur_uniform_type;
+        if (cur_uniform_type* ut = dynamic_cast<cur_uniform_type*>(_uniform_array[handle].get())) {
+            ut->set_value(i, v);
+        }
+        else {
+            SCM_GL_DGB("program::uniform(): found non matching uniform type '" << type_string(uniform_data_type<T>::type)
+                                                                               << "' ('uniform handle: " << handle << ", " << type_string(_uniform_array[handle]->type()) << ").");
+        }
+    }
+    else {
+        SCM_GL_DGB("program::uniform(): invalid uniform handle ('" << handle << "').");
+    }
+}
+
 inline uniform_sampler_ptr
 program::uniform_sampler(const std::string& name) const {
     return (dynamic_pointer_cast<scm::gl::uniform_sampler>(uniform_raw(name)));
@@ -0,0 +1,306 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "program_binary_cache.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#include <boost/filesystem.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <scm/gl_core/log.h>
+
+namespace scm {
+namespace gl {
+
+namespace {
+
+const char          cache_file_magic[8] = {'S', 'C', 'M', 'P', 'B', 'I', 'N', '\0'};
+const scm::uint32   cache_file_version  = 2;
+const char          cache_file_ext[]    = ".glbin";
+
+struct cache_file_header
+{
+    char            _magic[8];
+    scm::uint32     _version;
+    scm::uint32     _format;
+    scm::uint64     _key;
+    scm::uint64     _driver_key;
+    scm::uint64     _size;
+}; // struct cache_file_header
+
+} // namespace
+
+struct program_binary_cache::mutex_impl
+{
+    boost::mutex    _mutex;
+};
+
+program_binary_cache::program_binary_cache(const std::string& in_cache_path,
+                                           const std::string& in_driver_string)
+  : _mutex_impl(new mutex_impl)
+  , _cache_path(in_cache_path)
+  , _driver_key(hash(in_driver_string))
+{
+    namespace bfs = boost::filesystem;
+
+    boost::system::error_code ec;
+    if (!bfs::exists(bfs::path(_cache_path), ec)) {
+        bfs::create_directories(bfs::path(_cache_path), ec);
+        if (ec) {
+            glerr() << log::error << "program_binary_cache::program_binary_cache(): "
+                    << "unable to create cache directory (" << _cache_path << ", " << ec.message() << ")." << log::end;
+        }
+    }
+    else {
+        remove_stale_entries();
+    }
+}
+
+program_binary_cache::~program_binary_cache()
+{
+    log_statistics();
+}
+
+const std::string&
+program_binary_cache::cache_path() const
+{
+    return _cache_path;
+}
+
+program_binary_cache::key_type
+program_binary_cache::driver_key() const
+{
+    return _driver_key;
+}
+
+const program_binary_cache::statistics
+program_binary_cache::cache_statistics() const
+{
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+    return _statistics;
+}
+
+bool
+program_binary_cache::retrieve(key_type in_key, unsigned& out_format, binary_data& out_binary)
+{
+    namespace bfs = boost::filesystem;
+
+    const std::string   file_name = entry_file_name(in_key);
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    std::ifstream   cache_file(file_name.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!cache_file) {
+        ++_statistics._misses;
+        return false;
+    }
+
+    cache_file.seekg(0, std::ios_base::end);
+    const scm::uint64   file_length = static_cast<scm::uint64>(cache_file.tellg());
+    cache_file.seekg(0, std::ios_base::beg);
+
+    cache_file_header   header;
+    bool                valid_entry = false;
+    if (   file_length > sizeof(cache_file_header)
+        && cache_file.read(reinterpret_cast<char*>(&header), sizeof(cache_file_header))) {
+        // the binary size has to match the file, never allocate for a truncated or corrupt header
+        valid_entry =    0 == std::memcmp(header._magic, cache_file_magic, sizeof(cache_file_magic))
+                      && header._version    == cache_file_version
+                      && header._key        == in_key
+                      && header._driver_key == _driver_key
+                      && header._size       >  0
+                      && header._size       == file_length - sizeof(cache_file_header);
+    }
+    if (valid_entry) {
+        out_binary.resize(static_cast<scm::size_t>(header._size));
+        valid_entry = !cache_file.read(&out_binary.front(), static_cast<std::streamsize>(header._size)).fail();
+    }
+    cache_file.close();
+
+    if (!valid_entry) {
+        glout() << log::warning << "program_binary_cache::retrieve(): "
+                << "removing corrupt cache entry (" << file_name << ")." << log::end;
+        boost::system::error_code ec;
+        bfs::remove(bfs::path(file_name), ec);
+        ++_statistics._invalidations;
+        ++_statistics._misses;
+        out_binary.clear();
+        return false;
+    }
+
+    out_format = header._format;
+
+    return true;
+}
+
+bool
+program_binary_cache::store(key_type in_key, unsigned in_format, const binary_data& in_binary)
+{
+    namespace bfs = boost::filesystem;
+
+    if (in_binary.empty()) {
+        return false;
+    }
+
+    const std::string   file_name = entry_file_name(in_key);
+    const std::string   temp_name = file_name + ".tmp";
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    cache_file_header   header;
+    std::memcpy(header._magic, cache_file_magic, sizeof(cache_file_magic));
+    header._version = cache_file_version;
+    header._format  = in_format;
+    header._key        = in_key;
+    header._driver_key = _driver_key;
+    header._size       = static_cast<scm::uint64>(in_binary.size());
+
+    { // write to a temporary file first, a concurrently running application never sees partial entries
+        std::ofstream   cache_file(temp_name.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        if (   !cache_file
+            || !cache_file.write(reinterpret_cast<const char*>(&header), sizeof(cache_file_header))
+            || !cache_file.write(&in_binary.front(), static_cast<std::streamsize>(in_binary.size()))) {
+            glerr() << log::error << "program_binary_cache::store(): "
+                    << "unable to write cache entry (" << temp_name << ")." << log::end;
+            cache_file.close();
+            boost::system::error_code ec;
+            bfs::remove(bfs::path(temp_name), ec);
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    bfs::rename(bfs::path(temp_name), bfs::path(file_name), ec);
+    if (ec) {
+        glerr() << log::error << "program_binary_cache::store(): "
+                << "unable to write cache entry (" << file_name << ", " << ec.message() << ")." << log::end;
+        bfs::remove(bfs::path(temp_name), ec);
+        return false;
+    }
+
+    ++_statistics._stores;
+
+    return true;
+}
+
+void
+program_binary_cache::accept()
+{
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+    ++_statistics._hits;
+}
+
+void
+program_binary_cache::invalidate(key_type in_key)
+{
+    namespace bfs = boost::filesystem;
+
+    const std::string   file_name = entry_file_name(in_key);
+    boost::mutex::scoped_lock lock(_mutex_impl->_mutex);
+
+    boost::system::error_code ec;
+    bfs::remove(bfs::path(file_name), ec);
+
+    ++_statistics._invalidations;
+    ++_statistics._misses;
+}
+
+void
+program_binary_cache::log_statistics() const
+{
+    const statistics s = cache_statistics();
+
+    glout() << log::info << "program_binary_cache: "
+            << "(path: " << _cache_path << ", "
+            << "hits: " << s._hits << ", "
+            << "misses: " << s._misses << ", "
+            << "invalidations: " << s._invalidations << ", "
+            << "stores: " << s._stores << ")." << log::end;
+}
+
+program_binary_cache::key_type
+program_binary_cache::hash(const void* in_data, scm::size_t in_size, key_type in_seed)
+{
+    const unsigned char* d = static_cast<const unsigned char*>(in_data);
+    key_type             h = in_seed;
+
+    for (scm::size_t i = 0; i < in_size; ++i) {
+        h ^= static_cast<key_type>(d[i]);
+        h *= 0x100000001b3ull;
+    }
+
+    return h;
+}
+
+program_binary_cache::key_type
+program_binary_cache::hash(const std::string& in_string, key_type in_seed)
+{
+    // include the length so adjacent strings can not alias
+    return hash(in_string.data(), in_string.size(), hash(static_cast<key_type>(in_string.size()), in_seed));
+}
+
+program_binary_cache::key_type
+program_binary_cache::hash(key_type in_value, key_type in_seed)
+{
+    unsigned char v[sizeof(key_type)];
+    for (unsigned i = 0; i < sizeof(key_type); ++i) {
+        v[i] = static_cast<unsigned char>((in_value >> (8 * i)) & 0xff);
+    }
+    return hash(v, sizeof(key_type), in_seed);
+}
+
+std::string
+program_binary_cache::entry_file_name(key_type in_key) const
+{
+    namespace bfs = boost::filesystem;
+
+    std::ostringstream  s;
+    s << std::hex << std::setw(16) << std::setfill('0') << in_key << cache_file_ext;
+
+    return (bfs::path(_cache_path) / s.str()).string();
+}
+
+void
+program_binary_cache::remove_stale_entries()
+{
+    namespace bfs = boost::filesystem;
+
+    // the keys of entries from another driver (or an older cache format) are never
+    // requested again, the entries would otherwise stay in the cache directory forever
+    boost::system::error_code   ec;
+    bfs::directory_iterator     entry(bfs::path(_cache_path), ec);
+    std::vector<bfs::path>      stale_entries;
+
+    for (; !ec && entry != bfs::directory_iterator(); entry.increment(ec)) {
+        const bfs::path& entry_path = entry->path();
+        if (entry_path.extension().string() != cache_file_ext) {
+            continue;
+        }
+        std::ifstream       cache_file(entry_path.string().c_str(), std::ios_base::in | std::ios_base::binary);
+        cache_file_header   header;
+        if (   cache_file.read(reinterpret_cast<char*>(&header), sizeof(cache_file_header))
+            && 0 == std::memcmp(header._magic, cache_file_magic, sizeof(cache_file_magic))
+            && header._version    == cache_file_version
+            && header._driver_key == _driver_key) {
+            continue;
+        }
+        stale_entries.push_back(entry_path);
+    }
+
+    for (std::vector<bfs::path>::const_iterator p = stale_entries.begin(); p != stale_entries.end(); ++p) {
+        bfs::remove(*p, ec);
+    }
+    if (!stale_entries.empty()) {
+        glout() << log::info << "program_binary_cache::remove_stale_entries(): "
+                << "removed " << stale_entries.size() << " entries of other drivers or cache versions "
+                << "(" << _cache_path << ")." << log::end;
+    }
+
+    _statistics._invalidations += stale_entries.size();
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,90 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_PROGRAM_BINARY_CACHE_H_INCLUDED
+#define SCM_GL_CORE_PROGRAM_BINARY_CACHE_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// program_binary_cache
+//  - on-disk cache of linked program binaries (ARB_get_program_binary)
+//  - entries are keyed by a 64bit hash of the preprocessed shader sources (including the
+//    macro definitions), the registered include strings and the driver identification
+//  - entries failing to load are removed from the cache, the program is then
+//    compiled and linked from source and stored again
+//  - every entry records the driver identification (vendor, renderer, context version
+//    and shader compiler), entries written by another driver are removed when the
+//    cache is opened, a cache directory serves a single driver
+class __scm_export(gl_core) program_binary_cache : boost::noncopyable
+{
+public:
+    typedef scm::uint64     key_type;
+
+    struct statistics {
+        statistics() : _hits(0), _misses(0), _invalidations(0), _stores(0) {}
+        scm::size_t     _hits;
+        scm::size_t     _misses;
+        scm::size_t     _invalidations;
+        scm::size_t     _stores;
+    }; // struct statistics
+
+    typedef std::vector<char>   binary_data;
+
+public:
+    program_binary_cache(const std::string& in_cache_path,
+                         const std::string& in_driver_string);
+    virtual ~program_binary_cache();
+
+    const std::string&          cache_path() const;
+    key_type                    driver_key() const;
+    const statistics            cache_statistics() const;
+
+    // retrieve counts missing or corrupt entries as misses, the caller reports
+    // whether the retrieved binary was accepted by the driver
+    bool                        retrieve(key_type in_key, unsigned& out_format, binary_data& out_binary);
+    bool                        store(key_type in_key, unsigned in_format, const binary_data& in_binary);
+    void                        accept();
+    void                        invalidate(key_type in_key);
+
+    void                        log_statistics() const;
+
+    // stable 64bit FNV-1a hash, the keys have to stay valid between runs
+    static key_type             hash(const void* in_data, scm::size_t in_size, key_type in_seed = hash_seed);
+    static key_type             hash(const std::string& in_string, key_type in_seed = hash_seed);
+    static key_type             hash(key_type in_value, key_type in_seed = hash_seed);
+
+    static const key_type       hash_seed = 0xcbf29ce484222325ull;
+
+protected:
+    std::string                 entry_file_name(key_type in_key) const;
+    void                        remove_stale_entries();
+
+protected:
+    struct mutex_impl;
+    shared_ptr<mutex_impl>      _mutex_impl;
+
+    std::string                 _cache_path;
+    key_type                    _driver_key;
+    statistics                  _statistics;
+
+}; // class program_binary_cache
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_CORE_PROGRAM_BINARY_CACHE_H_INCLUDED
@@ -20,6 +20,7 @@
 #include <scm/gl_core/render_device/opengl/util/assert.h>
 #include <scm/gl_core/render_device/opengl/util/constants_helper.h>
 #include <scm/gl_core/render_device/opengl/util/error_helper.h>
+#include <scm/gl_core/shader_objects/program_binary_cache.h>
 
 namespace  {
 
@@ -67,10 +68,14 @@ shader::shader(render_device&                  ren_dev,
                const std::string&              in_src,
                const std::string&              in_src_name,
                const shader_macro_array&       in_macros,
-               const shader_include_path_list& in_inc_paths)
+               const shader_include_path_list& in_inc_paths,
+               bool                            in_defer_compile)
   : render_device_child(ren_dev),
     _type(in_type),
-    _gl_shader_obj(0)
+    _gl_shader_obj(0),
+    _compiled(false),
+    _compile_pending(false),
+    _source_hash(0)
 {
     const opengl::gl_core& glapi = ren_dev.opengl_api();
     util::gl_error          glerror(glapi);
@@ -82,7 +87,19 @@ shader::shader(render_device&                  ren_dev,
     else {
         std::string preprocessed_source;
         if (preprocess_source_string(ren_dev, in_src, in_src_name, in_macros, preprocessed_source)) {
-            compile_source_string(ren_dev, preprocessed_source, in_inc_paths);
+            _source_hash = program_binary_cache::hash(static_cast<scm::uint64>(in_type));
+            _source_hash = program_binary_cache::hash(preprocessed_source, _source_hash);
+            foreach(const std::string& p, in_inc_paths) {
+                _source_hash = program_binary_cache::hash(p, _source_hash);
+            }
+            if (in_defer_compile) {
+                _source.swap(preprocessed_source);
+                _include_paths = in_inc_paths;
+            }
+            else {
+                compile_source_string(ren_dev, preprocessed_source, in_inc_paths);
+                _compiled = true;
+            }
         }
         else {
             state().set(object_state::OS_ERROR_SHADER_COMPILE);
@@ -102,6 +119,64 @@ shader::~shader()
     gl_assert(glapi, leaving shader::~shader());
 }
 
+bool
+shader::compile(render_device& ren_dev)
+{
+    submit_compile(ren_dev);
+    return finish_compile(ren_dev);
+}
+
+void
+shader::submit_compile(render_device& ren_dev)
+{
+    if (!_compiled && ok()) {
+        submit_source_string(ren_dev, _source, _include_paths);
+        _compiled        = true;
+        _compile_pending = true;
+
+        std::string().swap(_source);
+        _include_paths.clear();
+    }
+}
+
+bool
+shader::finish_compile(render_device& ren_dev)
+{
+    if (_compile_pending) {
+        query_compile_status(ren_dev);
+        _compile_pending = false;
+    }
+
+    return ok();
+}
+
+bool
+shader::compile_completed(render_device& ren_dev) const
+{
+    const opengl::gl_core& glapi = ren_dev.opengl_api();
+
+    if (!_compile_pending || !glapi.extension_KHR_parallel_shader_compile) {
+        return true;
+    }
+
+    int completion_state = GL_TRUE;
+    glapi.glGetShaderiv(_gl_shader_obj, GL_COMPLETION_STATUS_KHR, &completion_state);
+
+    return GL_TRUE == completion_state;
+}
+
+bool
+shader::compiled() const
+{
+    return _compiled;
+}
+
+scm::uint64
+shader::source_hash() const
+{
+    return _source_hash;
+}
+
 bool
 shader::preprocess_source_string(      render_device&      ren_dev,
                                  const std::string&        in_src,
@@ -205,12 +280,21 @@ bool
 shader::compile_source_string(      render_device&            ren_dev,
                               const std::string&              in_src,
                               const shader_include_path_list& in_inc_paths)
+{
+    submit_source_string(ren_dev, in_src, in_inc_paths);
+    return query_compile_status(ren_dev);
+}
+
+void
+shader::submit_source_string(      render_device&            ren_dev,
+                             const std::string&              in_src,
+                             const shader_include_path_list& in_inc_paths)
 {
     const opengl::gl_core& glapi = ren_dev.opengl_api();
     util::gl_error          glerror(glapi);
 
-    const char* source_string = in_src.c_str();                                                                         gl_assert(glapi, shader::compile_source_string() before glShaderSource);
-    glapi.glShaderSource(_gl_shader_obj, 1, reinterpret_cast<const GLchar**>(boost::addressof(source_string)), NULL);   gl_assert(glapi, shader::compile_source_string() before glCompileShader);
+    const char* source_string = in_src.c_str();                                                                         gl_assert(glapi, shader::submit_source_string() before glShaderSource);
+    glapi.glShaderSource(_gl_shader_obj, 1, reinterpret_cast<const GLchar**>(boost::addressof(source_string)), NULL);   gl_assert(glapi, shader::submit_source_string() before glCompileShader);
     
     if (glapi.extension_ARB_shading_language_include) {
         if (!in_inc_paths.empty()) {
@@ -226,15 +310,21 @@ shader::compile_source_string(      render_device&            ren_dev,
             glapi.glCompileShaderIncludeARB(_gl_shader_obj,
                                             static_cast<int>(in_inc_paths.size()),
                                             paths.get(),
-                                            path_lengths.get());                                                        gl_assert(glapi, shader::compile_source_string() after glCompileShaderIncludeARB);
+                                            path_lengths.get());                                                        gl_assert(glapi, shader::submit_source_string() after glCompileShaderIncludeARB);
         }
         else {
-            glapi.glCompileShaderIncludeARB(_gl_shader_obj, 0, 0, 0);                                                   gl_assert(glapi, shader::compile_source_string() after glCompileShaderIncludeARB);
+            glapi.glCompileShaderIncludeARB(_gl_shader_obj, 0, 0, 0);                                                   gl_assert(glapi, shader::submit_source_string() after glCompileShaderIncludeARB);
         }
     }
     else {
-        glapi.glCompileShader(_gl_shader_obj);                                                                          gl_assert(glapi, shader::compile_source_string() after glCompileShader);
+        glapi.glCompileShader(_gl_shader_obj);                                                                          gl_assert(glapi, shader::submit_source_string() after glCompileShader);
     }
+}
+
+bool
+shader::query_compile_status(render_device& ren_dev)
+{
+    const opengl::gl_core& glapi = ren_dev.opengl_api();
 
     int compile_state = 0;
     glapi.glGetShaderiv(_gl_shader_obj, GL_COMPILE_STATUS, &compile_state);
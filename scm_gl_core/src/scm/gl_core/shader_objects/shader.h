@@ -36,7 +36,20 @@ protected:
            const std::string&              in_src,
            const std::string&              in_src_name,
            const shader_macro_array&       in_macros,
-           const shader_include_path_list& in_inc_paths);
+           const shader_include_path_list& in_inc_paths,
+           bool                            in_defer_compile = false);
+
+    // compiles a shader created with deferred compilation, the preprocessed
+    // source is released afterwards
+    bool   compile(render_device& ren_dev);
+    bool   compiled() const;
+    // split compilation: submit hands the source to the driver without querying the
+    // result, finish queries the compile status (blocking if the driver is still busy)
+    void   submit_compile(render_device& ren_dev);
+    bool   finish_compile(render_device& ren_dev);
+    bool   compile_completed(render_device& ren_dev) const;
+    // hash of the preprocessed source string and include paths (program binary cache key)
+    scm::uint64 source_hash() const;
 
     bool   preprocess_source_string(      render_device&      ren_dev,
                                     const std::string&        in_src,
@@ -46,12 +59,22 @@ protected:
     bool   compile_source_string(      render_device&            ren_dev,
                                  const std::string&              in_src,
                                  const shader_include_path_list& in_inc_paths);
+    void   submit_source_string(      render_device&            ren_dev,
+                                const std::string&              in_src,
+                                const shader_include_path_list& in_inc_paths);
+    bool   query_compile_status(render_device& ren_dev);
 
 
 protected:
-    shader_stage    _type;
-    unsigned        _gl_shader_obj;
-    std::string     _info_log;
+    shader_stage                _type;
+    unsigned                    _gl_shader_obj;
+    std::string                 _info_log;
+
+    bool                        _compiled;
+    bool                        _compile_pending;
+    std::string                 _source;
+    shader_include_path_list    _include_paths;
+    scm::uint64                 _source_hash;
 
     friend class scm::gl::program;
     friend class scm::gl::render_device;
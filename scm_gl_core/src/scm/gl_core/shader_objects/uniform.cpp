@@ -62,7 +62,7 @@ uniform<T, D>::set_value(int i, value_param_type v)
     assert(i < static_cast<int>(_elements));
     if (!_status._initialized || v != _value[i]) {
         _value[i] = v;
-        _status._update_required = true;
+        mark_update_required();
         _status._initialized     = true;
     }
 }
@@ -123,6 +123,7 @@ uniform_base::uniform_base(const std::string& n, const int l, const unsigned e,
 {
     _status._initialized     = false;
     _status._update_required = false;
+    _update_queue            = 0;
 }
 
 uniform_base::~uniform_base()
@@ -159,6 +160,17 @@ uniform_base::update_required() const
     return _status._update_required;
 }
 
+void
+uniform_base::mark_update_required()
+{
+    if (!_status._update_required) {
+        _status._update_required = true;
+        if (_update_queue) {
+            _update_queue->push_back(this);
+        }
+    }
+}
+
 // class uniform_image_sampler_base ///////////////////////////////////////////////////////////////
 uniform_image_sampler_base::uniform_image_sampler_base(const std::string& n, const int l, const unsigned e, const data_type t)
   : uniform_base(n, l, e, t)
@@ -183,7 +195,7 @@ uniform_image_sampler_base::bound_unit(scm::int32 v)
     if (!_status._initialized || v != _bound_unit) {
         _bound_unit              = v;
         _resident_handle         = 0ull;
-        _status._update_required = true;
+        mark_update_required();
         _status._initialized     = true;
     }
 }
@@ -200,7 +212,7 @@ uniform_image_sampler_base::resident_handle(scm::uint64 v)
     if (!_status._initialized || v != _resident_handle) {
         _bound_unit              = -1;
         _resident_handle         = v;
-        _status._update_required = true;
+        mark_update_required();
         _status._initialized     = true;
     }
 }
@@ -238,7 +250,11 @@ void
 uniform_1f::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform1fv(p.program_id(), _location, _elements, &(_value.front()));
+#else
     glapi.glUniform1fv(_location, _elements, &(_value.front()));
+#endif
     gl_assert(glapi, leaving uniform_1f::apply_value());
 }
 
@@ -247,7 +263,11 @@ void
 uniform_vec2f::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform2fv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform2fv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec2f::apply_value());
 }
 
@@ -256,7 +276,11 @@ void
 uniform_vec3f::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform3fv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform3fv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec3f::apply_value());
 }
 
@@ -265,7 +289,11 @@ void
 uniform_vec4f::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform4fv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform4fv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec4f::apply_value());
 }
 
@@ -274,7 +302,11 @@ void
 uniform_mat2f::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniformMatrix2fv(p.program_id(), _location, _elements, false, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniformMatrix2fv(_location, _elements, false, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_mat2f::apply_value());
 }
 
@@ -283,7 +315,11 @@ void
 uniform_mat3f::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniformMatrix3fv(p.program_id(), _location, _elements, false, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniformMatrix3fv(_location, _elements, false, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_mat3f::apply_value());
 }
 
@@ -292,7 +328,11 @@ void
 uniform_mat4f::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniformMatrix4fv(p.program_id(), _location, _elements, false, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniformMatrix4fv(_location, _elements, false, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_mat4f::apply_value());
 }
 
@@ -303,7 +343,11 @@ void
 uniform_1d::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform1dv(p.program_id(), _location, _elements, &(_value.front()));//&_value);
+#else
     glapi.glUniform1dv(_location, _elements, &(_value.front()));//&_value);
+#endif
     gl_assert(glapi, leaving uniform_1d::apply_value());
 }
 
@@ -312,7 +356,11 @@ void
 uniform_vec2d::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform2dv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform2dv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec2d::apply_value());
 }
 
@@ -321,7 +369,11 @@ void
 uniform_vec3d::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform3dv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform3dv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec3d::apply_value());
 }
 
@@ -330,7 +382,11 @@ void
 uniform_vec4d::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform4dv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform4dv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec4d::apply_value());
 }
 
@@ -339,7 +395,11 @@ void
 uniform_mat2d::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniformMatrix2dv(p.program_id(), _location, _elements, false, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniformMatrix2dv(_location, _elements, false, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_mat2d::apply_value());
 }
 
@@ -348,7 +408,11 @@ void
 uniform_mat3d::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniformMatrix3dv(p.program_id(), _location, _elements, false, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniformMatrix3dv(_location, _elements, false, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_mat3d::apply_value());
 }
 
@@ -357,7 +421,11 @@ void
 uniform_mat4d::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniformMatrix4dv(p.program_id(), _location, _elements, false, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniformMatrix4dv(_location, _elements, false, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_mat4d::apply_value());
 }
 
@@ -369,7 +437,11 @@ void
 uniform_1i::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform1iv(p.program_id(), _location, _elements, &(_value.front()));//&_value);
+#else
     glapi.glUniform1iv(_location, _elements, &(_value.front()));//&_value);
+#endif
     gl_assert(glapi, leaving uniform_1i::apply_value());
 }
 
@@ -378,7 +450,11 @@ void
 uniform_vec2i::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform2iv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform2iv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec2i::apply_value());
 }
 
@@ -387,7 +463,11 @@ void
 uniform_vec3i::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform3iv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform3iv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec3i::apply_value());
 }
 
@@ -396,7 +476,11 @@ void
 uniform_vec4i::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform4iv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform4iv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec4i::apply_value());
 }
 
@@ -406,7 +490,11 @@ void
 uniform_1ui::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform1uiv(p.program_id(), _location, _elements, &(_value.front()));//&_value);
+#else
     glapi.glUniform1uiv(_location, _elements, &(_value.front()));//&_value);
+#endif
     gl_assert(glapi, leaving uniform_1ui::apply_value());
 }
 
@@ -415,7 +503,11 @@ void
 uniform_vec2ui::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform2uiv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform2uiv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec2ui::apply_value());
 }
 
@@ -424,7 +516,11 @@ void
 uniform_vec3ui::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform3uiv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform3uiv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec3ui::apply_value());
 }
 
@@ -433,7 +529,11 @@ void
 uniform_vec4ui::apply_value(const render_context& context, const program& p)
 {
     const opengl::gl_core& glapi = context.opengl_api();
+#if SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    glapi.glProgramUniform4uiv(p.program_id(), _location, _elements, (_value.front().data_array));//_value.data_array);
+#else
     glapi.glUniform4uiv(_location, _elements, (_value.front().data_array));//_value.data_array);
+#endif
     gl_assert(glapi, leaving uniform_vec4ui::apply_value());
 }
 
@@ -36,6 +36,12 @@ public:
     virtual void            apply_value(const render_context& context, const program& p) = 0;
 
 protected:
+    // flags the uniform for the next apply and queues it in the owning program
+    void                    mark_update_required();
+
+protected:
+    typedef std::vector<uniform_base*>  update_queue;
+
     std::string             _name;
     int                     _location;
     unsigned                _elements;
@@ -46,6 +52,8 @@ protected:
         bool                _initialized     : 1;
     }                       _status;
 
+    update_queue*           _update_queue;
+
 private:
     // declared, never defined
     uniform_base(const uniform_base&);
@@ -5,6 +5,7 @@
 #ifndef SCM_GL_CORE_BLEND_STATE_H_INCLUDED
 #define SCM_GL_CORE_BLEND_STATE_H_INCLUDED
 
+#include <cstddef>
 #include <vector>
 
 #include <scm/core/math.h>
@@ -102,10 +103,16 @@ struct __scm_export(gl_core) blend_state_desc {
     blend_state_desc(const blend_ops& in_blend_ops = blend_ops(false), bool in_alpha_to_coverage = false);
     blend_state_desc(const blend_ops_array& in_blend_ops, bool in_alpha_to_coverage = false);
 
+    bool operator==(const blend_state_desc& rhs) const;
+    bool operator!=(const blend_state_desc& rhs) const;
+
     blend_ops_array         _blend_ops;
     bool                    _alpha_to_coverage;
 }; // struct blend_state_desc
 
+__scm_export(gl_core) std::size_t hash_value(const blend_ops& in_ops);
+__scm_export(gl_core) std::size_t hash_value(const blend_state_desc& in_desc);
+
 class __scm_export(gl_core) blend_state : public render_device_child
 {
 public:
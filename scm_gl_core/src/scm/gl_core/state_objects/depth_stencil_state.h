@@ -5,6 +5,8 @@
 #ifndef SCM_GL_CORE_DEPTH_STENCIL_STATE_H_INCLUDED
 #define SCM_GL_CORE_DEPTH_STENCIL_STATE_H_INCLUDED
 
+#include <cstddef>
+
 #include <scm/gl_core/constants.h>
 #include <scm/gl_core/gl_core_fwd.h>
 #include <scm/gl_core/render_device/device_child.h>
@@ -38,6 +40,9 @@ struct __scm_export(gl_core) depth_stencil_state_desc {
                              bool in_stencil_test, unsigned in_stencil_rmask, unsigned in_stencil_wmask,
                              const stencil_ops& in_stencil_front_ops, const stencil_ops& in_stencil_back_ops);
 
+    bool operator==(const depth_stencil_state_desc& rhs) const;
+    bool operator!=(const depth_stencil_state_desc& rhs) const;
+
     bool            _depth_test;
     bool            _depth_mask;
     compare_func    _depth_func;
@@ -49,6 +54,9 @@ struct __scm_export(gl_core) depth_stencil_state_desc {
     stencil_ops     _stencil_back_ops;
 }; // struct depth_stencil_state_desc
 
+__scm_export(gl_core) std::size_t hash_value(const stencil_ops& in_ops);
+__scm_export(gl_core) std::size_t hash_value(const depth_stencil_state_desc& in_desc);
+
 class __scm_export(gl_core) depth_stencil_state : public render_device_child
 {
 public:
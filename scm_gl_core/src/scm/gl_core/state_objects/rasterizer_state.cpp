@@ -6,6 +6,8 @@
 
 #include <cassert>
 
+#include <boost/functional/hash.hpp>
+
 #include <scm/core/math.h>
 
 #include <scm/gl_core/config.h>
@@ -67,6 +69,56 @@ rasterizer_state_desc::rasterizer_state_desc(
 {
 }
 
+bool
+rasterizer_state_desc::operator==(const rasterizer_state_desc& rhs) const
+{
+    return (   (_fill_mode          == rhs._fill_mode)
+            && (_cull_mode          == rhs._cull_mode)
+            && (_front_face         == rhs._front_face)
+            && (_multi_sample       == rhs._multi_sample)
+            && (_sample_shading     == rhs._sample_shading)
+            && (_min_sample_shading == rhs._min_sample_shading)
+            && (_scissor_test       == rhs._scissor_test)
+            && (_smooth_lines       == rhs._smooth_lines)
+            && (_point_state        == rhs._point_state));
+}
+
+bool
+rasterizer_state_desc::operator!=(const rasterizer_state_desc& rhs) const
+{
+    return !(*this == rhs);
+}
+
+std::size_t
+hash_value(const point_raster_state& in_state)
+{
+    std::size_t seed = 0;
+
+    boost::hash_combine(seed, in_state._shader_point_size);
+    boost::hash_combine(seed, static_cast<int>(in_state._point_origin_mode));
+    boost::hash_combine(seed, in_state._point_fade_threshold);
+
+    return seed;
+}
+
+std::size_t
+hash_value(const rasterizer_state_desc& in_desc)
+{
+    std::size_t seed = 0;
+
+    boost::hash_combine(seed, static_cast<int>(in_desc._fill_mode));
+    boost::hash_combine(seed, static_cast<int>(in_desc._cull_mode));
+    boost::hash_combine(seed, static_cast<int>(in_desc._front_face));
+    boost::hash_combine(seed, in_desc._multi_sample);
+    boost::hash_combine(seed, in_desc._sample_shading);
+    boost::hash_combine(seed, in_desc._min_sample_shading);
+    boost::hash_combine(seed, in_desc._scissor_test);
+    boost::hash_combine(seed, in_desc._smooth_lines);
+    boost::hash_combine(seed, in_desc._point_state);
+
+    return seed;
+}
+
 rasterizer_state::rasterizer_state(      render_device&         in_device,
                                    const rasterizer_state_desc& in_desc)
   : render_device_child(in_device)
@@ -5,6 +5,8 @@
 #ifndef SCM_GL_CORE_RASTERIZER_STATE_H_INCLUDED
 #define SCM_GL_CORE_RASTERIZER_STATE_H_INCLUDED
 
+#include <cstddef>
+
 #include <scm/gl_core/constants.h>
 #include <scm/gl_core/gl_core_fwd.h>
 #include <scm/gl_core/render_device/device_child.h>
@@ -40,6 +42,9 @@ struct __scm_export(gl_core) rasterizer_state_desc {
                           bool                      in_smlines = false,
                           const point_raster_state& in_point_state = point_raster_state());
 
+    bool operator==(const rasterizer_state_desc& rhs) const;
+    bool operator!=(const rasterizer_state_desc& rhs) const;
+
     fill_mode               _fill_mode;
     cull_mode               _cull_mode;
 
@@ -55,6 +60,9 @@ struct __scm_export(gl_core) rasterizer_state_desc {
     point_raster_state      _point_state;
 }; // struct depth_stencil_state_desc
 
+__scm_export(gl_core) std::size_t hash_value(const point_raster_state& in_state);
+__scm_export(gl_core) std::size_t hash_value(const rasterizer_state_desc& in_desc);
+
 class __scm_export(gl_core) rasterizer_state : public render_device_child
 {
 public:
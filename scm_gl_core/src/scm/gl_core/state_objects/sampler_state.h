@@ -5,6 +5,7 @@
 #ifndef SCM_GL_CORE_SAMPLER_STATE_H_INCLUDED
 #define SCM_GL_CORE_SAMPLER_STATE_H_INCLUDED
 
+#include <cstddef>
 #include <limits>
 
 #include <scm/gl_core/constants.h>
@@ -30,6 +31,9 @@ struct __scm_export(gl_core) sampler_state_desc
                        compare_func         in_compare_func = COMPARISON_LESS_EQUAL,
                        texture_compare_mode in_compare_mode = TEXCOMPARE_NONE);
 
+    bool operator==(const sampler_state_desc& rhs) const;
+    bool operator!=(const sampler_state_desc& rhs) const;
+
     texture_filter_mode     _filter;
     unsigned                _max_anisotropy;
     texture_wrap_mode       _wrap_s;
@@ -43,6 +47,8 @@ struct __scm_export(gl_core) sampler_state_desc
     texture_compare_mode    _compare_mode;
 }; // struct sampler_state_desc
 
+__scm_export(gl_core) std::size_t hash_value(const sampler_state_desc& in_desc);
+
 class __scm_export(gl_core) sampler_state : public render_device_child
 {
 public:
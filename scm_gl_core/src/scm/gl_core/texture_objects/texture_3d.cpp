@@ -18,10 +18,12 @@ namespace gl {
 
 texture_3d_desc::texture_3d_desc(const math::vec3ui& in_size,
                                  const data_format   in_format,
-                                 const unsigned      in_mip_levels)
+                                 const unsigned      in_mip_levels,
+                                 const bool          in_sparse)
   : _size(in_size)
   , _format(in_format)
   , _mip_levels(in_mip_levels)
+  , _sparse(in_sparse)
 {
 }
 
@@ -30,7 +32,8 @@ texture_3d_desc::operator==(const texture_3d_desc& rhs) const
 {
     return (   (_size         == rhs._size)
             && (_format       == rhs._format)
-            && (_mip_levels   == rhs._mip_levels));
+            && (_mip_levels   == rhs._mip_levels)
+            && (_sparse       == rhs._sparse));
 }
 
 bool
@@ -38,13 +41,17 @@ texture_3d_desc::operator!=(const texture_3d_desc& rhs) const
 {
     return (   (_size         != rhs._size)
             || (_format       != rhs._format)
-            || (_mip_levels   != rhs._mip_levels));
+            || (_mip_levels   != rhs._mip_levels)
+            || (_sparse       != rhs._sparse));
 }
 
 texture_3d::texture_3d(render_device&           in_device,
                        const texture_3d_desc&   in_desc)
   : texture_image(in_device)
   , _descriptor(in_desc)
+  , _allocated_mip_levels(0)
+  , _sparse_page_size(0u)
+  , _sparse_levels(0)
 {
     const opengl::gl_core& glapi = in_device.opengl_api();
 
@@ -64,6 +71,9 @@ texture_3d::texture_3d(render_device&            in_device,
                        const std::vector<void*>& in_initial_mip_level_data)
   : texture_image(in_device)
   , _descriptor(in_desc)
+  , _allocated_mip_levels(0)
+  , _sparse_page_size(0u)
+  , _sparse_levels(0)
 {
     const opengl::gl_core& glapi = in_device.opengl_api();
     
@@ -74,7 +84,13 @@ texture_3d::texture_3d(render_device&            in_device,
         allocate_storage(in_device, in_desc);
     }
     if (state().ok()) {
-        if (in_initial_mip_level_data.size() > 0) {
+        if (in_initial_mip_level_data.size() > 0 && in_desc._sparse) {
+            // no pages committed yet, the data would be discarded
+            glerr() << log::error
+                    << "texture_3d::texture_3d(): initial data not supported for sparse textures." << log::end;
+            state().set(object_state::OS_ERROR_INVALID_VALUE);
+        }
+        else if (in_initial_mip_level_data.size() > 0) {
             upload_initial_data(in_device, in_desc, in_initial_data_format, in_initial_mip_level_data);
         }
     }
@@ -88,6 +104,9 @@ texture_3d::texture_3d(render_device&            in_device,
                        const math::vec2ui&       in_mip_range)
   : texture_image(in_device)
   , _descriptor(in_orig_texture.descriptor())
+  , _allocated_mip_levels(0)
+  , _sparse_page_size(in_orig_texture.sparse_page_size())
+  , _sparse_levels(in_orig_texture.sparse_levels())
 {
     const opengl::gl_core& glapi = in_device.opengl_api();
 
@@ -145,6 +164,42 @@ texture_3d::allocate_storage(const render_device&      in_device,
     util::texture_binding_guard save_guard(glapi, object_target(), object_binding());
     glapi.glBindTexture(object_target(), object_id());
 #endif // !SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS
+    if (in_desc._sparse) {
+        if (   !glapi.extension_ARB_sparse_texture
+            || SCM_GL_CORE_OPENGL_CORE_VERSION < SCM_GL_CORE_OPENGL_CORE_VERSION_420) {
+            glerr() << log::error
+                    << "texture_3d::allocate_storage(): sparse textures not supported (ARB_sparse_texture)." << log::end;
+            state().set(object_state::OS_ERROR_INVALID_OPERATION);
+            return false;
+        }
+
+        _sparse_page_size = in_device.texture_3d_sparse_page_size(in_desc._format);
+        if (_sparse_page_size == math::vec3ui(0u)) {
+            glerr() << log::error
+                    << "texture_3d::allocate_storage(): no sparse page size for texture format ("
+                    << format_string(in_desc._format) << ")." << log::end;
+            state().set(object_state::OS_ERROR_INVALID_VALUE);
+            return false;
+        }
+        if (   (in_desc._size.x % _sparse_page_size.x) != 0
+            || (in_desc._size.y % _sparse_page_size.y) != 0
+            || (in_desc._size.z % _sparse_page_size.z) != 0) {
+            glerr() << log::error
+                    << "texture_3d::allocate_storage(): sparse texture size not a multiple of the page size "
+                    << "(size: " << in_desc._size << ", page size: " << _sparse_page_size << ")." << log::end;
+            state().set(object_state::OS_ERROR_INVALID_VALUE);
+            return false;
+        }
+
+        if (SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS) {
+            glapi.glTextureParameteriEXT(object_id(), object_target(), GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+            glapi.glTextureParameteriEXT(object_id(), object_target(), GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0);
+        }
+        else {
+            glapi.glTexParameteri(object_target(), GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+            glapi.glTexParameteri(object_target(), GL_VIRTUAL_PAGE_SIZE_INDEX_ARB, 0);
+        }
+    }
     if (SCM_GL_CORE_OPENGL_CORE_VERSION >= SCM_GL_CORE_OPENGL_CORE_VERSION_420) {//false) { //BUG r280 
         //glerr() << "storage" << log::end;
         if (SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS) {
@@ -154,6 +209,17 @@ texture_3d::allocate_storage(const render_device&      in_device,
             glapi.glTexStorage3D(object_target(), init_mip_levels, gl_internal_format, in_desc._size.x, in_desc._size.y, in_desc._size.z);
         }
         gl_assert(glapi, texture_3d::image_data() after glTexStorage3D());
+
+        if (in_desc._sparse) {
+            int sparse_levels = 0;
+            if (SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS) {
+                glapi.glGetTextureParameterivEXT(object_id(), object_target(), GL_NUM_SPARSE_LEVELS_ARB, &sparse_levels);
+            }
+            else {
+                glapi.glGetTexParameteriv(object_target(), GL_NUM_SPARSE_LEVELS_ARB, &sparse_levels);
+            }
+            _sparse_levels = static_cast<unsigned>(sparse_levels);
+        }
     }
     else { // SCM_GL_CORE_OPENGL_CORE_VERSION < SCM_GL_CORE_OPENGL_CORE_VERSION_420
         // make sure the unpack buffer is not bound!
@@ -178,6 +244,7 @@ texture_3d::allocate_storage(const render_device&      in_device,
         return false;
     }
     else {
+        _allocated_mip_levels = init_mip_levels;
         return true;
     }
 }
@@ -283,6 +350,79 @@ texture_3d::image_sub_data(const render_context& in_context,
     return true;
 }
 
+bool
+texture_3d::commit_pages(const render_context& in_context,
+                         const texture_region& in_region,
+                         const unsigned        in_level,
+                         const bool            in_commit)
+{
+    assert(state().ok());
+
+    const opengl::gl_core& glapi = in_context.opengl_api();
+    util::gl_error         glerror(glapi);
+
+    if (!_descriptor._sparse) {
+        glerr() << log::error
+                << "texture_3d::commit_pages(): texture not sparse." << log::end;
+        return false;
+    }
+    if (in_level >= _allocated_mip_levels) {
+        glerr() << log::error
+                << "texture_3d::commit_pages(): invalid mip level "
+                << "(level: " << in_level << ", levels: " << _allocated_mip_levels << ")." << log::end;
+        return false;
+    }
+
+    // regions are page aligned, partial pages only at the level border
+    const math::vec3ui lev_size = util::mip_level_dimensions(_descriptor._size, in_level);
+    const math::vec3ui reg_end  = in_region._origin + in_region._dimensions;
+
+    if (in_level < _sparse_levels) {
+        for (int c = 0; c < 3; ++c) {
+            if (   (in_region._origin[c] % _sparse_page_size[c]) != 0
+                || (   (in_region._dimensions[c] % _sparse_page_size[c]) != 0
+                    && reg_end[c] != lev_size[c])) {
+                glerr() << log::error
+                        << "texture_3d::commit_pages(): region not page aligned "
+                        << "(origin: " << in_region._origin << ", dimensions: " << in_region._dimensions
+                        << ", page size: " << _sparse_page_size << ")." << log::end;
+                return false;
+            }
+        }
+    }
+    if (   reg_end.x > lev_size.x
+        || reg_end.y > lev_size.y
+        || reg_end.z > lev_size.z) {
+        glerr() << log::error
+                << "texture_3d::commit_pages(): region exceeds the level dimensions "
+                << "(origin: " << in_region._origin << ", dimensions: " << in_region._dimensions
+                << ", level size: " << lev_size << ")." << log::end;
+        return false;
+    }
+
+    const unsigned char commit = in_commit ? GL_TRUE : GL_FALSE;
+
+    if (SCM_GL_CORE_USE_EXT_DIRECT_STATE_ACCESS) {
+        glapi.glTexturePageCommitmentEXT(object_id(), in_level,
+                                         in_region._origin.x,     in_region._origin.y,     in_region._origin.z,
+                                         in_region._dimensions.x, in_region._dimensions.y, in_region._dimensions.z,
+                                         commit);
+    }
+    else {
+        util::texture_binding_guard save_guard(glapi, object_target(), object_binding());
+        glapi.glBindTexture(object_target(), object_id());
+
+        glapi.glTexPageCommitmentARB(object_target(), in_level,
+                                     in_region._origin.x,     in_region._origin.y,     in_region._origin.z,
+                                     in_region._dimensions.x, in_region._dimensions.y, in_region._dimensions.z,
+                                     commit);
+    }
+
+    gl_assert(glapi, texture_3d::commit_pages() after glTexPageCommitmentARB());
+
+    return !glerror;
+}
+
 bool
 texture_3d::create_texture_view(const render_device&      in_device,
                                 const texture_3d&         in_orig_texture,
@@ -332,6 +472,7 @@ texture_3d::create_texture_view(const render_device&      in_device,
         // setup view descriptor
         _descriptor._format       = in_data_format;
         _descriptor._mip_levels   = nb_mip_levels;
+        _allocated_mip_levels     = nb_mip_levels;
 
         return true;
     }
@@ -366,5 +507,24 @@ texture_3d::samples() const
 {
     return 1;
 }
+
+bool
+texture_3d::sparse() const
+{
+    return _descriptor._sparse;
+}
+
+const math::vec3ui&
+texture_3d::sparse_page_size() const
+{
+    return _sparse_page_size;
+}
+
+unsigned
+texture_3d::sparse_levels() const
+{
+    return _sparse_levels;
+}
+
 } // namespace gl
 } // namespace scm
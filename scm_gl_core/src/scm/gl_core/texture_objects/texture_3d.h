@@ -22,7 +22,8 @@ struct __scm_export(gl_core) texture_3d_desc
 {
     texture_3d_desc(const math::vec3ui& in_size,
                     const data_format   in_format,
-                    const unsigned      in_mip_levels = 1);
+                    const unsigned      in_mip_levels = 1,
+                    const bool          in_sparse     = false);
 
     bool operator==(const texture_3d_desc& rhs) const;
     bool operator!=(const texture_3d_desc& rhs) const;
@@ -30,8 +31,15 @@ struct __scm_export(gl_core) texture_3d_desc
     math::vec3ui    _size;
     data_format     _format;
     unsigned        _mip_levels;
+    bool            _sparse;        // ARB_sparse_texture, size a multiple of the virtual page size
 }; // struct texture_3d_desc
 
+// texture_3d
+//  - sparse textures only reserve the virtual address range of the image, memory is committed
+//    and decommitted in units of the virtual page size (render_context::commit_texture_pages())
+//  - the levels starting at sparse_levels() form the mip tail, which is committed as a whole
+//  - the contents of uncommitted pages read undefined, writes to them are discarded
+
 class __scm_export(gl_core) texture_3d : public texture_image
 {
 public:
@@ -46,6 +54,10 @@ public:
     unsigned                mip_map_layers() const;
     unsigned                samples() const;
 
+    bool                    sparse() const;
+    const math::vec3ui&     sparse_page_size() const;
+    unsigned                sparse_levels() const;
+
 protected:
     texture_3d(render_device&            in_device,
                const texture_3d_desc&    in_desc);
@@ -69,6 +81,10 @@ protected:
                                            const unsigned        in_level,
                                            const data_format     in_data_format,
                                            const void*const      in_data);
+    bool                    commit_pages(const render_context& in_context,
+                                         const texture_region& in_region,
+                                         const unsigned        in_level,
+                                         const bool            in_commit);
     bool                    create_texture_view(const render_device&      in_device,
                                                 const texture_3d&         in_orig_texture,
                                                 const data_format         in_data_format,
@@ -76,6 +92,10 @@ protected:
 
 protected:
     texture_3d_desc         _descriptor;
+    unsigned                _allocated_mip_levels;  // resolved level count (_mip_levels 0: full chain)
+
+    math::vec3ui            _sparse_page_size;
+    unsigned                _sparse_levels;
 
 private:
     friend class render_device;
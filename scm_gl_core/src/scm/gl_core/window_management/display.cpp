@@ -11,6 +11,7 @@
 
 #include <scm/gl_core/window_management/wm_win32/display_impl_win32.h>
 #include <scm/gl_core/window_management/wm_x/display_impl_x.h>
+#include <scm/gl_core/window_management/wm_x/util/egl_extensions.h>
 
 namespace scm {
 namespace gl {
@@ -34,6 +35,23 @@ display::~display()
     _impl.reset();
 }
 
+bool
+display::headless() const
+{
+    return _impl->headless();
+}
+
+/*static*/
+std::vector<std::string>
+display::egl_devices()
+{
+#if SCM_PLATFORM == SCM_PLATFORM_LINUX
+    return util::egl_extensions::device_names();
+#else
+    return std::vector<std::string>();
+#endif
+}
+
 } // namespace wm
 } // namepspace gl
 } // namepspace scm
@@ -5,6 +5,9 @@
 #ifndef SCM_GL_CORE_WM_DISPLAY_H_INCLUDED
 #define SCM_GL_CORE_WM_DISPLAY_H_INCLUDED
 
+#include <string>
+#include <vector>
+
 #include <scm/core/memory.h>
 
 #include <scm/gl_core/window_management/wm_fwd.h>
@@ -16,12 +19,22 @@ namespace scm {
 namespace gl {
 namespace wm {
 
+// display
+//  - window system display by name (x11 e.g. ':0.0', win32 device name)
+//  - on linux the names 'egl', 'egl:<n>' and 'egl:surfaceless' open a headless egl display
+//    without a window system on the default or n-th device (see egl_devices()) or on mesa's
+//    surfaceless platform (llvmpipe), only headless surfaces can be created on these
 class __scm_export(gl_core) display
 {
 public:
     display(const std::string& name);
     virtual ~display();
 
+    bool                        headless() const;
+
+    // descriptions of the egl devices available for 'egl:<n>' displays, ordered by n
+    static std::vector<std::string> egl_devices();
+
 private:
     struct display_impl;
     shared_ptr<display_impl>    _impl;
@@ -33,6 +33,22 @@ headless_surface::headless_surface(const window_cptr& in_parent_wnd)
     }
 }
 
+headless_surface::headless_surface(const display_cptr&    in_display,
+                                   const format_desc&     in_sf,
+                                   const math::vec2ui&    in_size)
+  : surface(in_display, in_sf)
+{
+    try {
+        _impl.reset(new headless_surface_impl(in_display, in_sf, in_size));
+    }
+    catch(const std::exception& e) {
+        err() << log::error
+              << "headless_surface::headless_surface(): "
+              << log::indent << e.what() << log::outdent << log::end;
+        throw (e);
+    }
+}
+
 headless_surface::~headless_surface()
 {
     _impl.reset();
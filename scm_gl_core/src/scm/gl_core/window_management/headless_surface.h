@@ -5,6 +5,7 @@
 #ifndef SCM_GL_CORE_WM_HEADLESS_SURFACE_H_INCLUDED
 #define SCM_GL_CORE_WM_HEADLESS_SURFACE_H_INCLUDED
 
+#include <scm/core/math.h>
 #include <scm/core/memory.h>
 
 #include <scm/gl_core/window_management/wm_fwd.h>
@@ -17,10 +18,18 @@ namespace scm {
 namespace gl {
 namespace wm {
 
+// headless_surface
+//  - pbuffer surface for contexts rendering only to framebuffer objects
+//  - without a parent window the surface is created directly on the display, on egl displays
+//    a size of (0, 0) (or a missing pbuffer config) selects EGL_KHR_surfaceless_context and
+//    contexts are made current without any surface
 class __scm_export(gl_core) headless_surface : public surface
 {
 public:
-    headless_surface(const window_cptr& in_parent_wnd);
+    headless_surface(const window_cptr&     in_parent_wnd);
+    headless_surface(const display_cptr&    in_display,
+                     const format_desc&     in_sf   = default_format(),
+                     const math::vec2ui&    in_size = math::vec2ui(1u));
     virtual ~headless_surface();
 
 protected:
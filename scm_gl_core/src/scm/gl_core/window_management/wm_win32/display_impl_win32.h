@@ -43,6 +43,8 @@ struct display::display_impl
 
     void                        cleanup();
 
+    bool                        headless() const { return false; }
+
     HINSTANCE                   _hinstance;
 
     ATOM                        _window_class;
@@ -39,53 +39,30 @@ headless_surface::headless_surface_impl::headless_surface_impl(const window_cptr
     _wgl_extensions(in_parent_wnd->associated_display()->_impl->_wgl_extensions)
 {
     try {
-        const surface::format_desc&         pfd  = in_parent_wnd->surface_format();
-        const display_cptr&                 disp = in_parent_wnd->associated_display();
-
-        if (!_wgl_extensions) {
-            std::ostringstream s;
-            s << "headless_surface::headless_surface_impl::headless_surface_impl() <win32>: "
-              << "unable to get wgl extensions from parent window.";
-            //err() << log::fatal << s.str() << log::end;
-            throw(std::runtime_error(s.str()));
-        }
-
-        std::stringstream pfd_err;
-        int pfd_num = util::pixel_format_selector::choose(disp->_impl->_device_handle,
-                                                          pfd, util::pixel_format_selector::pbuffer_surface,
-                                                          _wgl_extensions, pfd_err);
-        if (0 == pfd_num) {
-            std::ostringstream s;
-            s << "headless_surface::headless_surface_impl::headless_surface_impl() <win32>: "
-              << "unable select pixel format: "
-              << pfd_err.str();
-            //err() << log::fatal << s.str() << log::end;
-            throw(std::runtime_error(s.str()));
-        }
-
-        _pbuffer_handle = _wgl_extensions->wglCreatePbufferARB(in_parent_wnd->_impl->_device_handle,
-                                                 pfd_num,
-                                                 detail::fixed_pbuffer_width,
-                                                 detail::fixed_pbuffer_height,
-                                                 0);
-        if (!_pbuffer_handle) {
-            std::ostringstream s;
-            s << "headless_surface::headless_surface_impl::headless_surface_impl() <win32>: "
-              << "unable to create pbuffer, wglCreatePbufferARB failed for format number: " << pfd_num;
-            //err() << log::fatal << s.str() << log::end;
-            throw(std::runtime_error(s.str()));
-        }
-
-        _device_handle = _wgl_extensions->wglGetPbufferDCARB(_pbuffer_handle);
+        initialize(in_parent_wnd->_impl->_device_handle,
+                   in_parent_wnd->associated_display(),
+                   in_parent_wnd->surface_format(),
+                   math::vec2ui(detail::fixed_pbuffer_width, detail::fixed_pbuffer_height));
+    }
+    catch(...) {
+        cleanup();
+        throw;
+    }
+}
 
-        if (!_device_handle) {
-            std::ostringstream s;
-            s << "headless_surface::headless_surface_impl::headless_surface_impl() <win32>: "
-              << "unable to retrive pbuffer device context (wglGetPbufferDCARB failed on pbuffer handle: "
-              << std::hex << _pbuffer_handle;
-            //err() << log::fatal << s.str() << log::end;
-            throw(std::runtime_error(s.str()));
-        }
+headless_surface::headless_surface_impl::headless_surface_impl(const display_cptr&   in_display,
+                                                               const format_desc&    in_sf,
+                                                               const math::vec2ui&   in_size)
+  : surface::surface_impl(),
+    _pbuffer_handle(0),
+    _wgl_extensions(in_display->_impl->_wgl_extensions)
+{
+    try {
+        // pbuffers have no surfaceless mode on wgl
+        initialize(in_display->_impl->_device_handle,
+                   in_display,
+                   in_sf,
+                   math::max(in_size, math::vec2ui(1u)));
     }
     catch(...) {
         cleanup();
@@ -93,6 +70,58 @@ headless_surface::headless_surface_impl::headless_surface_impl(const window_cptr
     }
 }
 
+void
+headless_surface::headless_surface_impl::initialize(HDC                  in_device_handle,
+                                                    const display_cptr&  in_display,
+                                                    const format_desc&   in_sf,
+                                                    const math::vec2ui&  in_size)
+{
+    if (!_wgl_extensions) {
+        std::ostringstream s;
+        s << "headless_surface::headless_surface_impl::initialize() <win32>: "
+          << "unable to get wgl extensions from display.";
+        //err() << log::fatal << s.str() << log::end;
+        throw(std::runtime_error(s.str()));
+    }
+
+    std::stringstream pfd_err;
+    int pfd_num = util::pixel_format_selector::choose(in_display->_impl->_device_handle,
+                                                      in_sf, util::pixel_format_selector::pbuffer_surface,
+                                                      _wgl_extensions, pfd_err);
+    if (0 == pfd_num) {
+        std::ostringstream s;
+        s << "headless_surface::headless_surface_impl::initialize() <win32>: "
+          << "unable select pixel format: "
+          << pfd_err.str();
+        //err() << log::fatal << s.str() << log::end;
+        throw(std::runtime_error(s.str()));
+    }
+
+    _pbuffer_handle = _wgl_extensions->wglCreatePbufferARB(in_device_handle,
+                                             pfd_num,
+                                             static_cast<int>(in_size.x),
+                                             static_cast<int>(in_size.y),
+                                             0);
+    if (!_pbuffer_handle) {
+        std::ostringstream s;
+        s << "headless_surface::headless_surface_impl::initialize() <win32>: "
+          << "unable to create pbuffer, wglCreatePbufferARB failed for format number: " << pfd_num;
+        //err() << log::fatal << s.str() << log::end;
+        throw(std::runtime_error(s.str()));
+    }
+
+    _device_handle = _wgl_extensions->wglGetPbufferDCARB(_pbuffer_handle);
+
+    if (!_device_handle) {
+        std::ostringstream s;
+        s << "headless_surface::headless_surface_impl::initialize() <win32>: "
+          << "unable to retrive pbuffer device context (wglGetPbufferDCARB failed on pbuffer handle: "
+          << std::hex << _pbuffer_handle;
+        //err() << log::fatal << s.str() << log::end;
+        throw(std::runtime_error(s.str()));
+    }
+}
+
 headless_surface::headless_surface_impl::~headless_surface_impl()
 {
     cleanup();
@@ -13,6 +13,7 @@
 #include <GL/GL.h>
 #include <scm/gl_core/window_management/GL/wglext.h>
 
+#include <scm/core/math.h>
 #include <scm/core/memory.h>
 
 #include <scm/gl_core/window_management/headless_surface.h>
@@ -31,9 +32,16 @@ class wgl_extensions;
 
 struct headless_surface::headless_surface_impl : public surface::surface_impl
 {
-    headless_surface_impl(const window_cptr& in_parent_wnd);
+    headless_surface_impl(const window_cptr&    in_parent_wnd);
+    headless_surface_impl(const display_cptr&   in_display,
+                          const format_desc&    in_sf,
+                          const math::vec2ui&   in_size);
     virtual ~headless_surface_impl();
 
+    void            initialize(HDC                  in_device_handle,
+                               const display_cptr&  in_display,
+                               const format_desc&   in_sf,
+                               const math::vec2ui&  in_size);
     void            cleanup();
 
     HPBUFFERARB     _pbuffer_handle;
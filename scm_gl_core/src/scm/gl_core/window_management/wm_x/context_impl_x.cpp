@@ -19,6 +19,7 @@
 #include <scm/gl_core/window_management/GL/glxext.h>
 #include <scm/gl_core/window_management/wm_x/display_impl_x.h>
 #include <scm/gl_core/window_management/wm_x/surface_impl_x.h>
+#include <scm/gl_core/window_management/wm_x/util/egl_extensions.h>
 #include <scm/gl_core/window_management/wm_x/util/glx_extensions.h>
 
 #ifndef GLX_ARB_create_context
@@ -45,9 +46,17 @@ context::context_impl::context_impl(const surface_cptr&    in_surface,
                                     const context_cptr&    in_share_ctx)
   : _context_handle(0),
     _display(in_surface->associated_display()->_impl->_display),
-    _glx_extensions(in_surface->associated_display()->_impl->_glx_extensions)
+    _glx_extensions(in_surface->associated_display()->_impl->_glx_extensions),
+    _egl_context(EGL_NO_CONTEXT),
+    _egl_display(in_surface->associated_display()->_impl->_egl_display),
+    _egl_extensions(in_surface->associated_display()->_impl->_egl_extensions)
 {
     try {
+        if (in_surface->associated_display()->_impl->headless()) {
+            initialize_egl(in_surface, in_attributes, in_share_ctx);
+            return;
+        }
+
         if (   !_glx_extensions->is_supported("GLX_ARB_create_context")
             || !_glx_extensions->is_supported("GLX_ARB_create_context_profile")) {
             std::ostringstream s;
@@ -109,9 +118,73 @@ context::context_impl::~context_impl()
 {
     cleanup();
 }
+
+void
+context::context_impl::initialize_egl(const surface_cptr&    in_surface,
+                                      const attribute_desc&  in_attributes,
+                                      const context_cptr&    in_share_ctx)
+{
+    std::vector<EGLint>  ctx_attribs;
+
+    if(in_attributes._version_major > 2) {
+        ctx_attribs.push_back(EGL_CONTEXT_MAJOR_VERSION_KHR);       ctx_attribs.push_back(in_attributes._version_major);
+        ctx_attribs.push_back(EGL_CONTEXT_MINOR_VERSION_KHR);       ctx_attribs.push_back(in_attributes._version_minor);
+        if (_egl_extensions->is_supported("EGL_KHR_create_context")) {
+            EGLint ctx_flags = 0;
+            if (in_attributes._forward_compatible) {
+                ctx_flags |= EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR;
+            }
+            if (in_attributes._debug) {
+                ctx_flags |= EGL_CONTEXT_OPENGL_DEBUG_BIT_KHR;
+            }
+            if (0 != ctx_flags) {
+                ctx_attribs.push_back(EGL_CONTEXT_FLAGS_KHR);       ctx_attribs.push_back(ctx_flags);
+            }
+        }
+        else { // EGL 1.5 core attributes
+            ctx_attribs.push_back(EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE);   ctx_attribs.push_back(in_attributes._forward_compatible ? EGL_TRUE : EGL_FALSE);
+            ctx_attribs.push_back(EGL_CONTEXT_OPENGL_DEBUG);                ctx_attribs.push_back(in_attributes._debug ? EGL_TRUE : EGL_FALSE);
+        }
+        if (in_attributes._compatibility_profile) {
+            ctx_attribs.push_back(EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR); ctx_attribs.push_back(EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT_KHR);
+        }
+        else {
+            ctx_attribs.push_back(EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR); ctx_attribs.push_back(EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR);
+        }
+    }
+    ctx_attribs.push_back(EGL_NONE); // terminate list
+
+    EGLContext share_ctx = EGL_NO_CONTEXT;
+    if (in_share_ctx) {
+        share_ctx = in_share_ctx->_impl->_egl_context;
+    }
+
+    // the client api is bound per thread
+    ::eglBindAPI(EGL_OPENGL_API);
+    _egl_context = ::eglCreateContext(_egl_display,
+                                      in_surface->_impl->_egl_config,
+                                      share_ctx,
+                                      static_cast<const EGLint*>(&(ctx_attribs[0])));
+    if (EGL_NO_CONTEXT == _egl_context) {
+        std::ostringstream s;
+        s << "context::context_impl::initialize_egl() <egl>: "
+          << "unable to create OpenGL context (eglCreateContext failed, error: 0x"
+          << std::hex << ::eglGetError() << std::dec << ").";
+        throw(std::runtime_error(s.str()));
+    }
+}
+
 bool
 context::context_impl::make_current(const surface_cptr& in_surface, bool current) const
 {
+    if (EGL_NO_CONTEXT != _egl_context) {
+        EGLSurface cur_surface = (current ? in_surface->_impl->_egl_surface : EGL_NO_SURFACE);
+
+        ::eglBindAPI(EGL_OPENGL_API);
+        return (EGL_TRUE == ::eglMakeCurrent(_egl_display, cur_surface, cur_surface,
+                                             current ? _egl_context : EGL_NO_CONTEXT));
+    }
+
     GLXDrawable cur_drawable = (current ? in_surface->_impl->_drawable : 0);
 
     return (glXMakeContextCurrent(_display, cur_drawable, cur_drawable, _context_handle));
@@ -123,6 +196,12 @@ context::context_impl::cleanup()
     if (_context_handle) {
         ::glXDestroyContext(_display, _context_handle);
     }
+    if (EGL_NO_CONTEXT != _egl_context) {
+        if (::eglGetCurrentContext() == _egl_context) {
+            ::eglMakeCurrent(_egl_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        }
+        ::eglDestroyContext(_egl_display, _egl_context);
+    }
 }
 
 void
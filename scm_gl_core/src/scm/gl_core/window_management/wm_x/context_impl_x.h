@@ -13,6 +13,7 @@
 
 #include <X11/Xlib.h>
 #include <GL/glx.h>
+#include <EGL/egl.h>
 
 #include <scm/core/memory.h>
 
@@ -24,6 +25,7 @@ namespace wm {
 
 namespace util {
 
+class egl_extensions;
 class glx_extensions;
 
 } // namespace util
@@ -35,6 +37,10 @@ struct context::context_impl
                  const context_cptr&    in_share_ctx);
     virtual ~context_impl();
 
+    void                    initialize_egl(const surface_cptr&    in_surface,
+                                           const attribute_desc&  in_attributes,
+                                           const context_cptr&    in_share_ctx);
+
     bool                    make_current(const surface_cptr& in_surface, bool current) const;
     void                    cleanup();
 
@@ -45,6 +51,11 @@ struct context::context_impl
 
     shared_ptr<util::glx_extensions>  _glx_extensions;
 
+    ::EGLContext            _egl_context;
+    ::EGLDisplay            _egl_display;
+
+    shared_ptr<util::egl_extensions>  _egl_extensions;
+
 }; // class context_impl
 
 } // namespace wm
@@ -11,6 +11,7 @@
 #include <sstream>
 #include <string>
 
+#include <scm/gl_core/window_management/wm_x/util/egl_extensions.h>
 #include <scm/gl_core/window_management/wm_x/util/glx_extensions.h>
 
 namespace scm {
@@ -19,8 +20,29 @@ namespace wm {
 
 display::display_impl::display_impl(const std::string& name)
   : _display(0)
+  , _default_screen(0)
+  , _egl_display(EGL_NO_DISPLAY)
 {
     try {
+        if (util::egl_extensions::is_egl_display_name(name)) {
+            std::stringstream egl_err;
+            _egl_extensions.reset(new util::egl_extensions());
+            if (!_egl_extensions->initialize(name, egl_err)) {
+                std::ostringstream s;
+                s << "display::display_impl::display_impl() <egl>: "
+                  << "unable to initialize EGL display (" << name << "): "
+                  << egl_err.str();
+                throw(std::runtime_error(s.str()));
+            }
+            _egl_display = _egl_extensions->display();
+            return;
+        }
+
+        // contexts on this display may be made current on other threads (upload contexts
+        // of the render_device), xlib has to be thread aware before the first connection
+        static const Status x_threads = ::XInitThreads();
+        (void)x_threads;
+
         _display = ::XOpenDisplay(name.c_str());
         if (0 == _display) {
             std::ostringstream s;
@@ -60,6 +82,13 @@ display::display_impl::cleanup()
     if (_display) {
         XCloseDisplay(_display);
     }
+    _egl_extensions.reset();
+}
+
+bool
+display::display_impl::headless() const
+{
+    return (_egl_display != EGL_NO_DISPLAY);
 }
 
 } // namespace wm
@@ -10,6 +10,7 @@
 #if SCM_PLATFORM == SCM_PLATFORM_LINUX
 
 #include <X11/Xlib.h>
+#include <EGL/egl.h>
 
 #include <scm/core/memory.h>
 
@@ -21,6 +22,7 @@ namespace wm {
 
 namespace util {
 
+class egl_extensions;
 class glx_extensions;
 
 } // namespace util
@@ -32,11 +34,19 @@ struct display::display_impl
 
     void                        cleanup();
 
+    bool                        headless() const;
+
+    // x11 display, 0 for egl displays
     ::Display*      _display;
     int             _default_screen;
 
     shared_ptr<util::glx_extensions>  _glx_extensions;
 
+    // egl display, EGL_NO_DISPLAY for x11 displays
+    ::EGLDisplay    _egl_display;
+
+    shared_ptr<util::egl_extensions>  _egl_extensions;
+
 }; // class display_impl
 
 } // namespace wm
@@ -19,6 +19,7 @@
 #include <scm/gl_core/window_management/window.h>
 #include <scm/gl_core/window_management/wm_x/display_impl_x.h>
 #include <scm/gl_core/window_management/wm_x/window_impl_x.h>
+#include <scm/gl_core/window_management/wm_x/util/egl_extensions.h>
 #include <scm/gl_core/window_management/wm_x/util/framebuffer_config_selection.h>
 #include <scm/gl_core/window_management/wm_x/util/glx_extensions.h>
 
@@ -37,55 +38,37 @@ headless_surface::headless_surface_impl::headless_surface_impl(const window_cptr
   : surface::surface_impl(),
     _pbuffer_handle(0),
     _display(in_parent_wnd->associated_display()->_impl->_display),
-    _glx_extensions(in_parent_wnd->associated_display()->_impl->_glx_extensions)
+    _glx_extensions(in_parent_wnd->associated_display()->_impl->_glx_extensions),
+    _egl_display(EGL_NO_DISPLAY)
 {
     try {
-        const surface::format_desc&         pfd  = in_parent_wnd->surface_format();
-        const display_cptr&                 disp = in_parent_wnd->associated_display();
-
-        if (!_glx_extensions) {
-            std::ostringstream s;
-            s << "headless_surface::headless_surface_impl::headless_surface_impl() <xlib>: "
-              << "unable to get glx extensions from parent window.";
-            //err() << log::fatal << s.str() << log::end;
-            throw(std::runtime_error(s.str()));
-        }
+        initialize(in_parent_wnd->associated_display(),
+                   in_parent_wnd->surface_format(),
+                   math::vec2ui(detail::fixed_pbuffer_width, detail::fixed_pbuffer_height));
+    }
+    catch(...) {
+        cleanup();
+        throw;
+    }
+}
 
-        std::stringstream fbc_err;
-        _fb_config = util::framebuffer_config_selector::choose(disp->_impl->_display, pfd,
-                                                               util::framebuffer_config_selector::pbuffer_surface,
-                                                               _glx_extensions, fbc_err);
-        if (0 == _fb_config) {
-            std::ostringstream s;
-            s << "headless_surface::headless_surface_impl::headless_surface_impl() <xlib>: "
-              << "unable to select framebuffer config: "
-              << fbc_err.str();
-            //err() << log::fatal << s.str() << log::end;
-            throw(std::runtime_error(s.str()));
+headless_surface::headless_surface_impl::headless_surface_impl(const display_cptr&   in_display,
+                                                               const format_desc&    in_sf,
+                                                               const math::vec2ui&   in_size)
+  : surface::surface_impl(),
+    _pbuffer_handle(0),
+    _display(in_display->_impl->_display),
+    _glx_extensions(in_display->_impl->_glx_extensions),
+    _egl_display(in_display->_impl->_egl_display),
+    _egl_extensions(in_display->_impl->_egl_extensions)
+{
+    try {
+        if (in_display->_impl->headless()) {
+            initialize_egl(in_sf, in_size);
         }
-
-        std::vector<int>    pb_attribs;
-
-        pb_attribs.push_back(GLX_PBUFFER_WIDTH);
-        pb_attribs.push_back(detail::fixed_pbuffer_width);
-        pb_attribs.push_back(GLX_PBUFFER_HEIGHT);
-        pb_attribs.push_back(detail::fixed_pbuffer_height);
-        pb_attribs.push_back(0);
-        pb_attribs.push_back(0);
-
-        _pbuffer_handle = glXCreatePbuffer(disp->_impl->_display,
-                                           _fb_config,
-                                           static_cast<const int*>(&(pb_attribs[0])));
-        if (!_pbuffer_handle) {
-            std::ostringstream s;
-            s << "headless_surface::headless_surface_impl::headless_surface_impl() <xlib>: "
-              << "unable to create pbuffer, glXCreateGLXPbuffer failed for format: " << _fb_config;
-            //err() << log::fatal << s.str() << log::end;
-            throw(std::runtime_error(s.str()));
+        else {
+            initialize(in_display, in_sf, math::max(in_size, math::vec2ui(1u)));
         }
-
-        // set the drawable of the surface
-        _drawable = _pbuffer_handle;
     }
     catch(...) {
         cleanup();
@@ -98,12 +81,111 @@ headless_surface::headless_surface_impl::~headless_surface_impl()
     cleanup();
 }
 
+void
+headless_surface::headless_surface_impl::initialize(const display_cptr&  in_display,
+                                                    const format_desc&   in_sf,
+                                                    const math::vec2ui&  in_size)
+{
+    if (!_glx_extensions) {
+        std::ostringstream s;
+        s << "headless_surface::headless_surface_impl::initialize() <xlib>: "
+          << "unable to get glx extensions from display.";
+        //err() << log::fatal << s.str() << log::end;
+        throw(std::runtime_error(s.str()));
+    }
+
+    std::stringstream fbc_err;
+    _fb_config = util::framebuffer_config_selector::choose(in_display->_impl->_display, in_sf,
+                                                           util::framebuffer_config_selector::pbuffer_surface,
+                                                           _glx_extensions, fbc_err);
+    if (0 == _fb_config) {
+        std::ostringstream s;
+        s << "headless_surface::headless_surface_impl::initialize() <xlib>: "
+          << "unable to select framebuffer config: "
+          << fbc_err.str();
+        //err() << log::fatal << s.str() << log::end;
+        throw(std::runtime_error(s.str()));
+    }
+
+    std::vector<int>    pb_attribs;
+
+    pb_attribs.push_back(GLX_PBUFFER_WIDTH);
+    pb_attribs.push_back(static_cast<int>(in_size.x));
+    pb_attribs.push_back(GLX_PBUFFER_HEIGHT);
+    pb_attribs.push_back(static_cast<int>(in_size.y));
+    pb_attribs.push_back(0);
+    pb_attribs.push_back(0);
+
+    _pbuffer_handle = glXCreatePbuffer(in_display->_impl->_display,
+                                       _fb_config,
+                                       static_cast<const int*>(&(pb_attribs[0])));
+    if (!_pbuffer_handle) {
+        std::ostringstream s;
+        s << "headless_surface::headless_surface_impl::initialize() <xlib>: "
+          << "unable to create pbuffer, glXCreateGLXPbuffer failed for format: " << _fb_config;
+        //err() << log::fatal << s.str() << log::end;
+        throw(std::runtime_error(s.str()));
+    }
+
+    // set the drawable of the surface
+    _drawable = _pbuffer_handle;
+}
+
+void
+headless_surface::headless_surface_impl::initialize_egl(const format_desc&   in_sf,
+                                                        const math::vec2ui&  in_size)
+{
+    std::stringstream cfg_err;
+
+    if (in_size.x > 0 && in_size.y > 0) {
+        _egl_config = _egl_extensions->choose_config(in_sf, util::egl_extensions::pbuffer_surface, cfg_err);
+    }
+
+    if (0 == _egl_config) {
+        // no surface at all, the context renders to framebuffer objects only
+        if (!_egl_extensions->is_supported("EGL_KHR_surfaceless_context")) {
+            std::ostringstream s;
+            s << "headless_surface::headless_surface_impl::initialize_egl() <egl>: "
+              << "unable to create pbuffer or surfaceless surface (EGL_KHR_surfaceless_context not supported): "
+              << cfg_err.str();
+            throw(std::runtime_error(s.str()));
+        }
+        _egl_config = _egl_extensions->choose_config(in_sf, util::egl_extensions::no_surface, cfg_err);
+        if (0 == _egl_config) {
+            std::ostringstream s;
+            s << "headless_surface::headless_surface_impl::initialize_egl() <egl>: "
+              << "unable to select framebuffer config: "
+              << cfg_err.str();
+            throw(std::runtime_error(s.str()));
+        }
+    }
+    else {
+        const EGLint pb_attribs[] = {
+            EGL_WIDTH,  static_cast<EGLint>(in_size.x),
+            EGL_HEIGHT, static_cast<EGLint>(in_size.y),
+            EGL_NONE
+        };
+
+        _egl_surface = ::eglCreatePbufferSurface(_egl_display, _egl_config, pb_attribs);
+        if (EGL_NO_SURFACE == _egl_surface) {
+            std::ostringstream s;
+            s << "headless_surface::headless_surface_impl::initialize_egl() <egl>: "
+              << "unable to create pbuffer, eglCreatePbufferSurface failed (error: 0x"
+              << std::hex << ::eglGetError() << std::dec << ").";
+            throw(std::runtime_error(s.str()));
+        }
+    }
+}
+
 void
 headless_surface::headless_surface_impl::cleanup()
 {
     if (_pbuffer_handle) {
         glXDestroyPbuffer(_display, _pbuffer_handle);
     }
+    if (EGL_NO_SURFACE != _egl_surface) {
+        ::eglDestroySurface(_egl_display, _egl_surface);
+    }
 }
 
 } // namespace wm
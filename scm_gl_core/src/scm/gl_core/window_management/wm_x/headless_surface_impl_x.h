@@ -11,7 +11,9 @@
 
 #include <X11/Xlib.h>
 #include <GL/glx.h>
+#include <EGL/egl.h>
 
+#include <scm/core/math.h>
 #include <scm/core/memory.h>
 
 #include <scm/gl_core/window_management/headless_surface.h>
@@ -23,15 +25,24 @@ namespace wm {
 
 namespace util {
 
+class egl_extensions;
 class glx_extensions;
 
 } // namespace util
 
 struct headless_surface::headless_surface_impl : public surface::surface_impl
 {
-    headless_surface_impl(const window_cptr& in_parent_wnd);
+    headless_surface_impl(const window_cptr&    in_parent_wnd);
+    headless_surface_impl(const display_cptr&   in_display,
+                          const format_desc&    in_sf,
+                          const math::vec2ui&   in_size);
     virtual ~headless_surface_impl();
 
+    void            initialize(const display_cptr&  in_display,
+                               const format_desc&   in_sf,
+                               const math::vec2ui&  in_size);
+    void            initialize_egl(const format_desc&   in_sf,
+                                   const math::vec2ui&  in_size);
     void            cleanup();
 
     GLXPbuffer      _pbuffer_handle;
@@ -39,6 +50,10 @@ struct headless_surface::headless_surface_impl : public surface::surface_impl
 
     shared_ptr<util::glx_extensions>  _glx_extensions;
 
+    ::EGLDisplay    _egl_display;
+
+    shared_ptr<util::egl_extensions>  _egl_extensions;
+
 }; // class headless_surface_impl
 
 } // namespace wm
@@ -11,6 +11,7 @@
 
 #include <X11/Xlib.h>
 #include <GL/glx.h>
+#include <EGL/egl.h>
 
 #include <scm/gl_core/window_management/surface.h>
 
@@ -20,10 +21,14 @@ namespace wm {
 
 struct surface::surface_impl
 {
-    surface_impl() : _fb_config(0), _drawable(0) {}
+    surface_impl() : _fb_config(0), _drawable(0), _egl_config(0), _egl_surface(EGL_NO_SURFACE) {}
 
     GLXFBConfig     _fb_config;
     GLXDrawable     _drawable;
+
+    // egl displays, EGL_NO_SURFACE for surfaceless contexts
+    EGLConfig       _egl_config;
+    EGLSurface      _egl_surface;
 }; // class surface_impl
 
 } // namespace wm
@@ -0,0 +1,342 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "egl_extensions.h"
+
+#if SCM_PLATFORM == SCM_PLATFORM_LINUX
+
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include <boost/tokenizer.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <scm/gl_core/data_formats.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA       0x31DD
+#endif
+#ifndef EGL_DRM_RENDER_NODE_FILE_EXT
+#define EGL_DRM_RENDER_NODE_FILE_EXT        0x3377
+#endif
+
+namespace {
+
+const std::string   egl_name_prefix     = "egl";
+const std::string   egl_surfaceless     = "surfaceless";
+const EGLint        max_egl_devices     = 32;
+
+// egl display handles are unique per platform and device, all scm displays on the same
+// handle share one initialization
+boost::mutex                    egl_display_mutex;
+std::map<EGLDisplay, unsigned>  egl_display_references;
+
+void
+insert_extensions(const char* ext_string, std::set<std::string>& ext_set)
+{
+    if (0 == ext_string) {
+        return;
+    }
+    typedef boost::tokenizer<boost::char_separator<char> > tokenizer;
+
+    std::string                 ext(ext_string);
+    boost::char_separator<char> space_separator(" ");
+    tokenizer                   extension_strings(ext, space_separator);
+
+    for (tokenizer::const_iterator i = extension_strings.begin(); i != extension_strings.end(); ++i) {
+        ext_set.insert(std::string(*i));
+    }
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+namespace wm {
+namespace util {
+
+egl_extensions::egl_extensions()
+  : eglQueryDevicesEXT(0)
+  , eglQueryDeviceStringEXT(0)
+  , eglGetPlatformDisplayEXT(0)
+  , _display(EGL_NO_DISPLAY)
+  , _initialized(false)
+{
+}
+
+egl_extensions::~egl_extensions()
+{
+    if (_display != EGL_NO_DISPLAY) {
+        boost::lock_guard<boost::mutex> lock(egl_display_mutex);
+        if (--egl_display_references[_display] == 0) {
+            egl_display_references.erase(_display);
+            ::eglTerminate(_display);
+        }
+    }
+}
+
+/*static*/
+bool
+egl_extensions::is_egl_display_name(const std::string& name)
+{
+    return    name.compare(0, egl_name_prefix.size(), egl_name_prefix) == 0
+           && (name.size() == egl_name_prefix.size() || name[egl_name_prefix.size()] == ':');
+}
+
+/*static*/
+std::vector<std::string>
+egl_extensions::device_names()
+{
+    std::vector<std::string>    names;
+    egl_extensions              egl;
+
+    if (!egl.load_client_functions() || !egl.eglQueryDevicesEXT || !egl.eglQueryDeviceStringEXT) {
+        return names;
+    }
+
+    EGLDeviceEXT    devices[max_egl_devices];
+    EGLint          device_count = 0;
+    if (!egl.eglQueryDevicesEXT(max_egl_devices, devices, &device_count)) {
+        return names;
+    }
+
+    for (EGLint d = 0; d < device_count; ++d) {
+        std::set<std::string>   device_ext;
+        std::ostringstream      s;
+        insert_extensions(egl.eglQueryDeviceStringEXT(devices[d], EGL_EXTENSIONS), device_ext);
+
+        s << egl_name_prefix << ":" << d << " (";
+        if (device_ext.count("EGL_MESA_device_software")) {
+            s << "software";
+        }
+        else if (device_ext.count("EGL_EXT_device_drm_render_node")) {
+            const char* node = egl.eglQueryDeviceStringEXT(devices[d], EGL_DRM_RENDER_NODE_FILE_EXT);
+            s << (node ? node : "drm device");
+        }
+        else if (device_ext.count("EGL_EXT_device_drm")) {
+            const char* node = egl.eglQueryDeviceStringEXT(devices[d], EGL_DRM_DEVICE_FILE_EXT);
+            s << (node ? node : "drm device");
+        }
+        else {
+            s << "unknown device";
+        }
+        s << ")";
+        names.push_back(s.str());
+    }
+
+    return names;
+}
+
+bool
+egl_extensions::initialize(const std::string& name, std::ostream& os)
+{
+    if (is_initialized()) {
+        return (true);
+    }
+    if (!is_egl_display_name(name)) {
+        os << "egl_extensions::initialize() <egl>: "
+           << "not an egl display name (" << name << ", expected 'egl', 'egl:<device>' or 'egl:surfaceless').";
+        return (false);
+    }
+
+    load_client_functions();
+
+    const std::string   device = (name.size() > egl_name_prefix.size()) ? name.substr(egl_name_prefix.size() + 1) : "";
+    const bool          surfaceless_supported =    eglGetPlatformDisplayEXT
+                                                && _client_extensions.count("EGL_MESA_platform_surfaceless");
+    const bool          devices_supported     =    eglGetPlatformDisplayEXT && eglQueryDevicesEXT
+                                                && _client_extensions.count("EGL_EXT_platform_device");
+
+    EGLDeviceEXT        devices[max_egl_devices];
+    EGLint              device_count = 0;
+    if (devices_supported) {
+        eglQueryDevicesEXT(max_egl_devices, devices, &device_count);
+    }
+
+    if (device == egl_surfaceless) {
+        if (!surfaceless_supported) {
+            os << "egl_extensions::initialize() <egl>: "
+               << "EGL_MESA_platform_surfaceless not supported.";
+            return (false);
+        }
+        _display     = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0);
+        _description = name;
+    }
+    else if (!device.empty()) {
+        char*       end = 0;
+        const long  d   = std::strtol(device.c_str(), &end, 10);
+        if (*end != 0 || d < 0 || d >= device_count) {
+            os << "egl_extensions::initialize() <egl>: "
+               << "invalid egl device (" << device << ", " << device_count << " devices available).";
+            return (false);
+        }
+        _display     = eglGetPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT, devices[d], 0);
+        _description = name;
+    }
+    else if (device_count > 0) {
+        _display     = eglGetPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT, devices[0], 0);
+        _description = egl_name_prefix + ":0";
+    }
+    else if (surfaceless_supported) {
+        _display     = eglGetPlatformDisplayEXT(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0);
+        _description = egl_name_prefix + ":" + egl_surfaceless;
+    }
+    else {
+        // pre device enumeration drivers (e.g. older nvidia) are headless on the default display
+        _display     = ::eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        _description = egl_name_prefix + " (default display)";
+    }
+
+    if (_display == EGL_NO_DISPLAY) {
+        os << "egl_extensions::initialize() <egl>: "
+           << "unable to get egl display (" << name << ", error: 0x" << std::hex << ::eglGetError() << std::dec << ").";
+        return (false);
+    }
+
+    EGLint egl_major = 0;
+    EGLint egl_minor = 0;
+    {
+        boost::lock_guard<boost::mutex> lock(egl_display_mutex);
+        if (!::eglInitialize(_display, &egl_major, &egl_minor)) {
+            os << "egl_extensions::initialize() <egl>: "
+               << "unable to initialize egl display (" << _description << ", error: 0x" << std::hex << ::eglGetError() << std::dec << ").";
+            _display = EGL_NO_DISPLAY;
+            return (false);
+        }
+        ++egl_display_references[_display];
+    }
+
+    if (((egl_major == 1) && (egl_minor < 4)) || (egl_major < 1)) {
+        os << "egl_extensions::initialize() <egl>: "
+           << "invalid EGL version - at least 1.4 required "
+           << "(EGL version: " << egl_major << "." << egl_minor << ").";
+        return (false);
+    }
+
+    insert_extensions(::eglQueryString(_display, EGL_EXTENSIONS), _egl_extensions);
+
+    // desktop OpenGL contexts with version and profile selection
+    if (   !((egl_major == 1) && (egl_minor >= 5))
+        && !is_supported("EGL_KHR_create_context")) {
+        os << "egl_extensions::initialize() <egl>: "
+           << "EGL_KHR_create_context not supported (EGL version: " << egl_major << "." << egl_minor << ").";
+        return (false);
+    }
+    if (!::eglBindAPI(EGL_OPENGL_API)) {
+        os << "egl_extensions::initialize() <egl>: "
+           << "OpenGL api not supported by egl display (" << _description << ").";
+        return (false);
+    }
+
+    _initialized = true;
+
+    return (true);
+}
+
+bool
+egl_extensions::is_initialized() const
+{
+    return (_initialized);
+}
+
+bool
+egl_extensions::is_supported(const std::string& ext) const
+{
+    if (_egl_extensions.find(ext) != _egl_extensions.end()) {
+        return (true);
+    }
+    else {
+        return (false);
+    }
+}
+
+::EGLDisplay
+egl_extensions::display() const
+{
+    return (_display);
+}
+
+const std::string&
+egl_extensions::description() const
+{
+    return (_description);
+}
+
+::EGLConfig
+egl_extensions::choose_config(const surface::format_desc& in_pfd,
+                              const surface_type          in_surface_type,
+                              std::ostream&               os) const
+{
+    std::vector<EGLint> config_attribs;
+
+    config_attribs.push_back(EGL_SURFACE_TYPE);
+    config_attribs.push_back(in_surface_type == pbuffer_surface ? EGL_PBUFFER_BIT : 0);
+    config_attribs.push_back(EGL_RENDERABLE_TYPE);
+    config_attribs.push_back(EGL_OPENGL_BIT);
+
+    config_attribs.push_back(EGL_RED_SIZE);
+    config_attribs.push_back(size_of_channel(in_pfd._color_format) * 8);
+    config_attribs.push_back(EGL_GREEN_SIZE);
+    config_attribs.push_back(size_of_channel(in_pfd._color_format) * 8);
+    config_attribs.push_back(EGL_BLUE_SIZE);
+    config_attribs.push_back(size_of_channel(in_pfd._color_format) * 8);
+    config_attribs.push_back(EGL_ALPHA_SIZE);
+    if ((channel_count(in_pfd._color_format) > 3)) {
+        config_attribs.push_back(size_of_channel(in_pfd._color_format) * 8);
+    }
+    else {
+        config_attribs.push_back(0);
+    }
+    config_attribs.push_back(EGL_DEPTH_SIZE);
+    config_attribs.push_back(size_of_depth_component(in_pfd._depth_stencil_format) * 8);
+    config_attribs.push_back(EGL_STENCIL_SIZE);
+    config_attribs.push_back(size_of_stencil_component(in_pfd._depth_stencil_format) * 8);
+
+    config_attribs.push_back(EGL_NONE);
+
+    EGLConfig   config       = 0;
+    EGLint      config_count = 0;
+    if (   !::eglChooseConfig(_display, &config_attribs.front(), &config, 1, &config_count)
+        || config_count < 1) {
+        os << "egl_extensions::choose_config() <egl>: "
+           << "unable to find framebuffer config - requested pixel format: " << std::endl
+           << in_pfd;
+        return (0);
+    }
+
+    return (config);
+}
+
+bool
+egl_extensions::load_client_functions()
+{
+    // client extensions are queried without a display (EGL_EXT_client_extensions)
+    insert_extensions(::eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), _client_extensions);
+
+    if (_client_extensions.empty()) {
+        return (false);
+    }
+
+    if (_client_extensions.count("EGL_EXT_device_enumeration") || _client_extensions.count("EGL_EXT_device_base")) {
+        eglQueryDevicesEXT          = (PFNEGLQUERYDEVICESEXTPROC)::eglGetProcAddress("eglQueryDevicesEXT");
+    }
+    if (_client_extensions.count("EGL_EXT_device_query") || _client_extensions.count("EGL_EXT_device_base")) {
+        eglQueryDeviceStringEXT     = (PFNEGLQUERYDEVICESTRINGEXTPROC)::eglGetProcAddress("eglQueryDeviceStringEXT");
+    }
+    if (_client_extensions.count("EGL_EXT_platform_base")) {
+        eglGetPlatformDisplayEXT    = (PFNEGLGETPLATFORMDISPLAYEXTPROC)::eglGetProcAddress("eglGetPlatformDisplayEXT");
+    }
+
+    return (true);
+}
+
+} // namespace util
+} // namespace wm
+} // namepspace gl
+} // namepspace scm
+
+#endif // SCM_PLATFORM == SCM_PLATFORM_LINUX
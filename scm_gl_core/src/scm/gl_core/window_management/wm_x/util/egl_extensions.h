@@ -0,0 +1,88 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_CORE_WM_X_EGL_EXTENSIONS_H_INCLUDED
+#define SCM_GL_CORE_WM_X_EGL_EXTENSIONS_H_INCLUDED
+
+#include <scm/core/platform/platform.h>
+
+#if SCM_PLATFORM == SCM_PLATFORM_LINUX
+
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <scm/gl_core/window_management/surface.h>
+
+namespace scm {
+namespace gl {
+namespace wm {
+namespace util {
+
+// egl_extensions
+//  - headless egl displays without a window system, opened by name:
+//      'egl'               first enumerated device (falls back to mesa surfaceless)
+//      'egl:<n>'           n-th device of EGL_EXT_device_enumeration (see device_names())
+//      'egl:surfaceless'   EGL_MESA_platform_surfaceless (llvmpipe without a gpu)
+//  - the display is initialized once per egl handle and terminated with the last user
+class egl_extensions
+{
+private:
+    typedef std::set<std::string> string_set;
+
+public:
+    typedef enum {
+        pbuffer_surface,
+        no_surface          // EGL_KHR_surfaceless_context, rendering to framebuffer objects only
+    } surface_type;
+
+public:
+    // EGL_EXT_device_enumeration, EGL_EXT_device_query
+    PFNEGLQUERYDEVICESEXTPROC           eglQueryDevicesEXT;
+    PFNEGLQUERYDEVICESTRINGEXTPROC      eglQueryDeviceStringEXT;
+
+    // EGL_EXT_platform_base
+    PFNEGLGETPLATFORMDISPLAYEXTPROC     eglGetPlatformDisplayEXT;
+
+public:
+    egl_extensions();
+    ~egl_extensions();
+
+    static bool                 is_egl_display_name(const std::string& name);
+    static std::vector<std::string> device_names();
+
+    bool                        initialize(const std::string& name, std::ostream& os);
+    bool                        is_initialized() const;
+    bool                        is_supported(const std::string& ext) const;
+
+    ::EGLDisplay                display() const;
+    const std::string&          description() const;
+
+    ::EGLConfig                 choose_config(const surface::format_desc& in_pfd,
+                                              const surface_type          in_surface_type,
+                                              std::ostream&               os) const;
+
+private:
+    bool                        load_client_functions();
+
+private:
+    string_set                  _client_extensions;
+    string_set                  _egl_extensions;
+    ::EGLDisplay                _display;
+    std::string                 _description;
+    bool                        _initialized;
+
+}; // class egl_extensions
+
+} // namespace util
+} // namespace wm
+} // namepspace gl
+} // namepspace scm
+
+#endif // SCM_PLATFORM == SCM_PLATFORM_LINUX
+#endif // SCM_GL_CORE_WM_X_EGL_EXTENSIONS_H_INCLUDED
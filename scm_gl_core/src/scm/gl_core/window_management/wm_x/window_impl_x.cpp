@@ -34,6 +34,13 @@ window::window_impl::window_impl(const display_cptr&      in_display,
     _glx_extensions(in_display->_impl->_glx_extensions)
 {
     try {
+        if (in_display->_impl->headless()) {
+            std::ostringstream s;
+            s << "window::window_impl::window_impl() <xlib>: "
+              << "unable to create window on headless egl display (use a headless_surface).";
+            throw(std::runtime_error(s.str()));
+        }
+
         if (channel_count(in_sf._color_format) < 3) {
             std::ostringstream s;
             s << "window::window_impl::window_impl() <xlib>: "
@@ -0,0 +1,179 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "build_lookup_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <scm/concurrency.h>
+
+namespace {
+
+// integral tables over the linearly interpolated 1d transfer function (index space)
+//  - _tau: extinction, _k*: extinction weighted color
+struct integral_tables
+{
+    std::vector<double>     _tau;
+    std::vector<double>     _kr;
+    std::vector<double>     _kg;
+    std::vector<double>     _kb;
+
+    std::vector<float>      _ext;       // extinction of the table entries
+}; // struct integral_tables
+
+void
+build_integral_tables(const scm::math::vec3f* in_color,
+                      const float*             in_alpha,
+                      unsigned                 in_size,
+                      integral_tables&         out_tables)
+{
+    out_tables._tau.resize(in_size);
+    out_tables._kr.resize(in_size);
+    out_tables._kg.resize(in_size);
+    out_tables._kb.resize(in_size);
+    out_tables._ext.resize(in_size);
+
+    // opacity at the reference sampling distance to extinction coefficient
+    const float max_alpha = 1.0f - 1.0e-6f;
+    for (unsigned i = 0; i < in_size; ++i) {
+        const float a = (std::max)(0.0f, (std::min)(in_alpha[i], max_alpha));
+        out_tables._ext[i] = -std::log(1.0f - a);
+    }
+
+    // trapezoidal integration of the linear segments between the table entries
+    double tau = 0.0;
+    double kr  = 0.0;
+    double kg  = 0.0;
+    double kb  = 0.0;
+
+    out_tables._tau[0] = out_tables._kr[0] = out_tables._kg[0] = out_tables._kb[0] = 0.0;
+    for (unsigned i = 1; i < in_size; ++i) {
+        const double t0 = out_tables._ext[i - 1];
+        const double t1 = out_tables._ext[i];
+
+        tau += 0.5 * (t0 + t1);
+        kr  += 0.5 * (t0 * in_color[i - 1].x + t1 * in_color[i].x);
+        kg  += 0.5 * (t0 * in_color[i - 1].y + t1 * in_color[i].y);
+        kb  += 0.5 * (t0 * in_color[i - 1].z + t1 * in_color[i].z);
+
+        out_tables._tau[i] = tau;
+        out_tables._kr[i]  = kr;
+        out_tables._kg[i]  = kg;
+        out_tables._kb[i]  = kb;
+    }
+}
+
+void
+build_preintegrated_rows(const integral_tables&   in_tables,
+                         const scm::math::vec3f*  in_color,
+                         unsigned                 in_size,
+                         float                    in_distance_ratio,
+                         unsigned                 in_row_begin,
+                         unsigned                 in_row_end,
+                         scm::math::vec4f*        out_table)
+{
+    using namespace scm::math;
+
+    const double*const tau = &in_tables._tau.front();
+    const double*const kr  = &in_tables._kr.front();
+    const double*const kg  = &in_tables._kg.front();
+    const double*const kb  = &in_tables._kb.front();
+
+    const double dr = static_cast<double>(in_distance_ratio);
+
+    // one row per back sample value, the inner loop over the front sample values only
+    // consists of differences of the integral tables and is branch free apart from the
+    // degenerate diagonal, which is patched afterwards
+    std::vector<float> oa(in_size);
+    std::vector<float> oc(in_size * 3);
+
+    for (unsigned b = in_row_begin; b < in_row_end; ++b) {
+        const double tau_b = tau[b];
+        const double kr_b  = kr[b];
+        const double kg_b  = kg[b];
+        const double kb_b  = kb[b];
+
+        for (unsigned f = 0; f < in_size; ++f) {
+            const double len   = (std::max)(1.0, std::fabs(static_cast<double>(b) - static_cast<double>(f)));
+            const double d_tau = std::fabs(tau_b - tau[f]);
+            const double w     = 1.0 / (std::max)(d_tau, 1.0e-12);
+
+            // opacity of the segment from the mean extinction, the color is the extinction
+            // weighted mean color of the segment (self-attenuation within the segment neglected)
+            const double a = 1.0 - std::exp(-dr * d_tau / len);
+
+            oa[f]         = static_cast<float>(a);
+            oc[f * 3    ] = static_cast<float>(a * std::fabs(kr_b - kr[f]) * w);
+            oc[f * 3 + 1] = static_cast<float>(a * std::fabs(kg_b - kg[f]) * w);
+            oc[f * 3 + 2] = static_cast<float>(a * std::fabs(kb_b - kb[f]) * w);
+        }
+
+        // front == back: the classification of the single table entry
+        const double ext_b = in_tables._ext[b];
+        const float  a_b   = static_cast<float>(1.0 - std::exp(-dr * ext_b));
+        oa[b]         = a_b;
+        oc[b * 3    ] = a_b * in_color[b].x;
+        oc[b * 3 + 1] = a_b * in_color[b].y;
+        oc[b * 3 + 2] = a_b * in_color[b].z;
+
+        vec4f*const row = out_table + static_cast<scm::size_t>(b) * in_size;
+        for (unsigned f = 0; f < in_size; ++f) {
+            row[f] = vec4f(oc[f * 3], oc[f * 3 + 1], oc[f * 3 + 2], oa[f]);
+        }
+    }
+}
+
+struct preintegrated_rows_body
+{
+    void operator()(const scm::concurrency::range_1d& r) const {
+        build_preintegrated_rows(*_tables, _color, _size, _distance_ratio,
+                                 static_cast<unsigned>(r._begin), static_cast<unsigned>(r._end), _table);
+    }
+
+    const integral_tables*      _tables;
+    const scm::math::vec3f*     _color;
+    unsigned                    _size;
+    float                       _distance_ratio;
+    scm::math::vec4f*           _table;
+}; // struct preintegrated_rows_body
+
+} // namespace
+
+namespace scm {
+namespace data {
+
+bool
+build_preintegrated_lookup_table(boost::scoped_array<math::vec4f>& dst,
+                                 const math::vec3f*                color_table,
+                                 const float*                      alpha_table,
+                                 unsigned                          size,
+                                 float                             distance_ratio,
+                                 unsigned                          thread_count)
+{
+    if (!dst || size < 1 || color_table == 0 || alpha_table == 0 || distance_ratio <= 0.0f) {
+        return (false);
+    }
+
+    integral_tables tables;
+    build_integral_tables(color_table, alpha_table, size, tables);
+
+    preintegrated_rows_body body;
+    body._tables         = &tables;
+    body._color          = color_table;
+    body._size           = size;
+    body._distance_ratio = distance_ratio;
+    body._table          = dst.get();
+
+    // every row costs the same, the rows are distributed in contiguous ranges over the
+    // core task scheduler
+    const std::size_t grain = thread_count > 0 ? (size + thread_count - 1) / thread_count : 0;
+    concurrency::parallel_for(concurrency::range_1d(0, size, grain), body);
+
+    return (true);
+}
+
+} // namespace data
+} // namespace scm
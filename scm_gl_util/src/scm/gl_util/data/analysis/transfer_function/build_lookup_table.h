@@ -7,9 +7,13 @@
 
 #include <boost/scoped_array.hpp>
 
+#include <scm/core/math.h>
+
 #include <scm/gl_util/data/analysis/transfer_function/piecewise_function_1d.h>
 #include <scm/gl_util/data/analysis/transfer_function/piecewise_function_weighted_1d.h>
 
+#include <scm/core/platform/platform.h>
+
 namespace scm {
 namespace data {
 
@@ -45,10 +49,28 @@ template<typename val_type>
 bool build_lookup_table(boost::scoped_array<val_type>& dst, const piecewise_function_weighted_1d<unsigned char, val_type>& scal_trafu, unsigned size);
 */
 
-//template<typename val_type>
-//bool build_preintegrated_lookup_table(boost::scoped_array<val_type>& dst,
-//                                      const piecewise_function_1d<unsigned char, val_type>& scal_trafu,
-//                                      unsigned size);
+// pre-integrated 2d lookup table from color and opacity transfer functions
+//  - dst (size * size entries) holds the premultiplied color and opacity of a ray segment
+//    between a front and a back sample value at dst[back * size + front]
+//  - opacities are given for the reference sampling distance, distance_ratio (sampling
+//    distance / reference sampling distance) is applied during the integration
+//  - integral tables of extinction and extinction weighted color make every entry O(1),
+//    the table rows are built in thread_count pieces on the core task scheduler (0: automatic)
+template<typename inp_type>
+bool build_preintegrated_lookup_table(boost::scoped_array<math::vec4f>&                 dst,
+                                      const piecewise_function_1d<inp_type, math::vec3f>& color_trafu,
+                                      const piecewise_function_1d<inp_type, float>&       alpha_trafu,
+                                      unsigned                                            size,
+                                      float                                               distance_ratio = 1.0f,
+                                      unsigned                                            thread_count = 0);
+
+__scm_export(gl_util)
+bool build_preintegrated_lookup_table(boost::scoped_array<math::vec4f>& dst,
+                                      const math::vec3f*                color_table,
+                                      const float*                      alpha_table,
+                                      unsigned                          size,
+                                      float                             distance_ratio = 1.0f,
+                                      unsigned                          thread_count = 0);
 
 } // namespace data
 } // namespace scm
@@ -5,6 +5,7 @@
 #include <exception>
 #include <stdexcept>
 
+#include <boost/next_prior.hpp>
 #include <boost/utility.hpp>
 
 namespace scm {
@@ -273,5 +274,29 @@ struct build_lookup_table_impl<val_type, float>
 }; // struct_look_uptable_impl
 
 } // namespace detail
+
+template<typename inp_type>
+bool build_preintegrated_lookup_table(boost::scoped_array<math::vec4f>&                 dst,
+                                      const piecewise_function_1d<inp_type, math::vec3f>& color_trafu,
+                                      const piecewise_function_1d<inp_type, float>&       alpha_trafu,
+                                      unsigned                                            size,
+                                      float                                               distance_ratio,
+                                      unsigned                                            thread_count)
+{
+    if (size < 1) {
+        return (false);
+    }
+
+    boost::scoped_array<math::vec3f>    color_lut(new math::vec3f[size]);
+    boost::scoped_array<float>          alpha_lut(new float[size]);
+
+    if (   !build_lookup_table(color_lut, color_trafu, size)
+        || !build_lookup_table(alpha_lut, alpha_trafu, size)) {
+        return (false);
+    }
+
+    return (build_preintegrated_lookup_table(dst, color_lut.get(), alpha_lut.get(), size, distance_ratio, thread_count));
+}
+
 } // namespace data
 } // namespace scm
@@ -0,0 +1,101 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_COMPILED_FUNCTION_1D_H_INCLUDED
+#define SCM_GL_UTIL_COMPILED_FUNCTION_1D_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+#include <scm/core/math.h>
+
+#include <scm/gl_util/data/analysis/transfer_function/piecewise_function_1d.h>
+
+namespace scm {
+namespace data {
+
+namespace detail {
+
+// per component access of the function results (float or math::vec<>)
+template<typename res_type>
+struct compiled_result_traits
+{
+    static const unsigned components = 1;
+    static float    component(const res_type& r, unsigned)          { return static_cast<float>(r); }
+    static void     set_component(res_type& r, unsigned, float c)   { r = static_cast<res_type>(c); }
+}; // struct compiled_result_traits
+
+template<typename scal_type, const unsigned dim>
+struct compiled_result_traits<math::vec<scal_type, dim> >
+{
+    static const unsigned components = dim;
+    static float    component(const math::vec<scal_type, dim>& r, unsigned i)         { return static_cast<float>(r[i]); }
+    static void     set_component(math::vec<scal_type, dim>& r, unsigned i, float c)  { r[i] = static_cast<scal_type>(c); }
+}; // struct compiled_result_traits
+
+} // namespace detail
+
+// compiled_function_1d
+//  - flat evaluation form of a piecewise_function_1d for per sample classification on the CPU
+//  - the stops are stored in sorted arrays (points, reciprocal segment widths) and one
+//    value array per result component (structure of arrays), a uniform grid over the stop
+//    range maps every cell to the first segment overlapping it, so an evaluation is a grid
+//    lookup followed by at most a few segment steps
+//  - the batch evaluation locates the segments of a block of samples first and then
+//    interpolates the block component by component over the value arrays
+//  - evaluation matches piecewise_function_1d::operator[] (zero outside the stop range),
+//    the compiled form does not track changes of the source function, recompile when
+//    the source is dirty
+template<typename val_type,
+         typename res_type>
+class compiled_function_1d
+{
+public:
+    typedef val_type                                value_type;
+    typedef res_type                                result_type;
+    typedef piecewise_function_1d<val_type, res_type> source_type;
+    typedef detail::compiled_result_traits<res_type>  result_traits;
+
+    static const unsigned max_grid_cells = 4096;
+    static const unsigned components     = result_traits::components;
+
+public:
+    compiled_function_1d();
+    explicit compiled_function_1d(const source_type& source,
+                                  unsigned           grid_cells = 0);   // 0: derived from the stop spacing
+
+    void                    compile(const source_type& source,
+                                    unsigned           grid_cells = 0);
+    void                    clear();
+    bool                    empty() const;
+
+    std::size_t             num_stops() const;
+    unsigned                num_grid_cells() const;
+
+    result_type             operator[](float point) const;
+    result_type             evaluate(float point) const;
+    void                    evaluate(const float* points,
+                                     result_type* results,
+                                     std::size_t  count) const;
+
+protected:
+    unsigned                locate(float point) const;
+    result_type             interpolate(unsigned segment, float a) const;
+
+protected:
+    std::vector<float>          _points;
+    std::vector<float>          _values;            // per component: [c * num_stops + stop]
+    std::vector<float>          _segment_scale;     // 1 / (point[i + 1] - point[i])
+
+    std::vector<unsigned>       _grid;              // first segment overlapping a cell
+    float                       _grid_scale;        // cells per unit
+
+}; // class compiled_function_1d
+
+} // namespace data
+} // namespace scm
+
+#include "compiled_function_1d.inl"
+
+#endif // SCM_GL_UTIL_COMPILED_FUNCTION_1D_H_INCLUDED
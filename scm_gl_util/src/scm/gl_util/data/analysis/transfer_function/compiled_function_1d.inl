@@ -0,0 +1,262 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <scm/core/math/math.h>
+
+namespace scm {
+namespace data {
+
+template<typename val_type,
+         typename res_type>
+compiled_function_1d<val_type, res_type>::compiled_function_1d()
+  : _grid_scale(0.0f)
+{
+}
+
+template<typename val_type,
+         typename res_type>
+compiled_function_1d<val_type, res_type>::compiled_function_1d(const source_type& source,
+                                                               unsigned           grid_cells)
+  : _grid_scale(0.0f)
+{
+    compile(source, grid_cells);
+}
+
+template<typename val_type,
+         typename res_type>
+void compiled_function_1d<val_type, res_type>::compile(const source_type& source,
+                                                       unsigned           grid_cells)
+{
+    clear();
+
+    const std::size_t stops = source.num_stops();
+
+    _points.reserve(stops);
+    _values.resize(components * stops);
+    for (typename source_type::const_stop_iterator it = source.stops_begin(); it != source.stops_end(); ++it) {
+        for (unsigned c = 0; c < components; ++c) {
+            _values[c * stops + _points.size()] = result_traits::component(it->second, c);
+        }
+        _points.push_back(static_cast<float>(it->first));
+    }
+
+    if (_points.size() < 2) {
+        return;
+    }
+
+    const std::size_t segments  = _points.size() - 1;
+    float             min_width = (std::numeric_limits<float>::max)();
+
+    _segment_scale.resize(segments);
+    for (std::size_t s = 0; s < segments; ++s) {
+        const float w = _points[s + 1] - _points[s];
+        _segment_scale[s] = 1.0f / w;
+        min_width         = (std::min)(min_width, w);
+    }
+
+    // enough cells to separate the closest pair of stops, so a lookup steps over at most
+    // one segment boundary (unless limited by max_grid_cells)
+    const float range = _points.back() - _points.front();
+    if (grid_cells == 0) {
+        const float cells = std::ceil(range / min_width);
+        grid_cells = cells < static_cast<float>(max_grid_cells) ? static_cast<unsigned>(cells) : max_grid_cells;
+        grid_cells = (std::max)(grid_cells, (std::min)(static_cast<unsigned>(4 * segments), static_cast<unsigned>(max_grid_cells)));
+    }
+    grid_cells = (std::max)(grid_cells, 1u);
+
+    _grid_scale = static_cast<float>(grid_cells) / range;
+    _grid.resize(grid_cells);
+
+    unsigned s = 0;
+    for (unsigned c = 0; c < grid_cells; ++c) {
+        const float x = _points.front() + static_cast<float>(c) / _grid_scale;
+        while (s + 1 < segments && _points[s + 1] <= x) {
+            ++s;
+        }
+        _grid[c] = s;
+    }
+}
+
+template<typename val_type,
+         typename res_type>
+void compiled_function_1d<val_type, res_type>::clear()
+{
+    _points.clear();
+    _values.clear();
+    _segment_scale.clear();
+    _grid.clear();
+    _grid_scale = 0.0f;
+}
+
+template<typename val_type,
+         typename res_type>
+bool compiled_function_1d<val_type, res_type>::empty() const
+{
+    return (_points.empty());
+}
+
+template<typename val_type,
+         typename res_type>
+std::size_t compiled_function_1d<val_type, res_type>::num_stops() const
+{
+    return (_points.size());
+}
+
+template<typename val_type,
+         typename res_type>
+unsigned compiled_function_1d<val_type, res_type>::num_grid_cells() const
+{
+    return (static_cast<unsigned>(_grid.size()));
+}
+
+template<typename val_type,
+         typename res_type>
+typename compiled_function_1d<val_type, res_type>::result_type
+compiled_function_1d<val_type, res_type>::operator[](float point) const
+{
+    return (evaluate(point));
+}
+
+template<typename val_type,
+         typename res_type>
+typename compiled_function_1d<val_type, res_type>::result_type
+compiled_function_1d<val_type, res_type>::evaluate(float point) const
+{
+    if (std::numeric_limits<value_type>::is_integer) {
+        point = scm::math::clamp<float>(point, static_cast<float>((std::numeric_limits<value_type>::min)()),
+                                               static_cast<float>((std::numeric_limits<value_type>::max)()));
+    }
+
+    if (_points.empty() || !(point >= _points.front() && point <= _points.back())) {
+        return (result_type(0));
+    }
+    if (_grid.empty()) {
+        return (interpolate(0, 0.0f));
+    }
+
+    const unsigned s = locate(point);
+    const float    a = (point - _points[s]) * _segment_scale[s];
+
+    return (interpolate(s, (std::min)(a, 1.0f)));
+}
+
+template<typename val_type,
+         typename res_type>
+unsigned compiled_function_1d<val_type, res_type>::locate(float point) const
+{
+    const unsigned last_cell    = static_cast<unsigned>(_grid.size() - 1);
+    const unsigned last_segment = static_cast<unsigned>(_segment_scale.size() - 1);
+
+    unsigned c = static_cast<unsigned>((point - _points.front()) * _grid_scale);
+    unsigned s = _grid[c < last_cell ? c : last_cell];
+    while (s > 0 && _points[s] > point) {               // cell rounding
+        --s;
+    }
+    while (s < last_segment && _points[s + 1] <= point) {
+        ++s;
+    }
+
+    return (s);
+}
+
+template<typename val_type,
+         typename res_type>
+typename compiled_function_1d<val_type, res_type>::result_type
+compiled_function_1d<val_type, res_type>::interpolate(unsigned segment, float a) const
+{
+    // the single stop function (no grid) evaluates the stop itself
+    const std::size_t stops = _points.size();
+    const std::size_t next  = (segment + 1 < stops) ? segment + 1 : segment;
+
+    result_type r = result_type(0);
+    for (unsigned c = 0; c < components; ++c) {
+        const float*const v = &_values[c * stops];
+        result_traits::set_component(r, c, v[next] * a + v[segment] * (1.0f - a));   // math::lerp
+    }
+
+    return (r);
+}
+
+template<typename val_type,
+         typename res_type>
+void compiled_function_1d<val_type, res_type>::evaluate(const float* points,
+                                                        result_type* results,
+                                                        std::size_t  count) const
+{
+    if (_grid.empty()) {
+        for (std::size_t i = 0; i < count; ++i) {
+            results[i] = evaluate(points[i]);
+        }
+        return;
+    }
+
+    // samples are processed in blocks: segment location and interpolation weight of all
+    // samples of a block, then the interpolation per component over its value array
+    const unsigned block_size = 64;
+
+    unsigned block_segment[block_size];
+    float    block_weight[block_size];
+    bool     block_inside[block_size];
+
+    const float*const    p  = &_points.front();
+    const float*const    ss = &_segment_scale.front();
+    const unsigned*const g  = &_grid.front();
+
+    const std::size_t stops        = _points.size();
+    const float       p_first      = _points.front();
+    const float       p_last       = _points.back();
+    const float       grid_scale   = _grid_scale;
+    const unsigned    last_cell    = static_cast<unsigned>(_grid.size() - 1);
+    const unsigned    last_segment = static_cast<unsigned>(_segment_scale.size() - 1);
+
+    const bool  integer_domain = std::numeric_limits<value_type>::is_integer;
+    const float domain_min     = static_cast<float>((std::numeric_limits<value_type>::min)());
+    const float domain_max     = static_cast<float>((std::numeric_limits<value_type>::max)());
+
+    for (std::size_t b = 0; b < count; b += block_size) {
+        const unsigned n = static_cast<unsigned>((std::min)(static_cast<std::size_t>(block_size), count - b));
+
+        for (unsigned i = 0; i < n; ++i) {
+            float x = points[b + i];
+            if (integer_domain) {
+                x = x < domain_min ? domain_min : (x > domain_max ? domain_max : x);
+            }
+            block_inside[i] = (x >= p_first && x <= p_last);
+            if (!block_inside[i]) {
+                block_segment[i] = 0;
+                block_weight[i]  = 0.0f;
+                continue;
+            }
+
+            const unsigned c = static_cast<unsigned>((x - p_first) * grid_scale);
+            unsigned       s = g[c < last_cell ? c : last_cell];
+            while (s > 0 && p[s] > x) {
+                --s;
+            }
+            while (s < last_segment && p[s + 1] <= x) {
+                ++s;
+            }
+            const float a = (x - p[s]) * ss[s];
+            block_segment[i] = s;
+            block_weight[i]  = a < 1.0f ? a : 1.0f;
+        }
+
+        result_type*const r = results + b;
+        for (unsigned c = 0; c < components; ++c) {
+            const float*const v = &_values[c * stops];
+            for (unsigned i = 0; i < n; ++i) {
+                const unsigned s = block_segment[i];
+                const float    a = block_weight[i];
+                result_traits::set_component(r[i], c, block_inside[i] ? v[s + 1] * a + v[s] * (1.0f - a) : 0.0f);
+            }
+        }
+    }
+}
+
+} // namespace data
+} // namespace scm
@@ -0,0 +1,647 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+
+#include <scm/log.h>
+#include <scm/concurrency.h>
+
+#include <scm/gl_util/data/volume/volume_loader.h>
+#include <scm/gl_util/data/volume/volume_reader.h>
+
+namespace scm {
+namespace gl {
+
+namespace {
+
+const char          stats_file_magic[8] = {'S', 'C', 'M', 'V', 'S', 'T', 'A', 'T'};
+const scm::uint32   stats_file_version  = 1;
+
+// NaN and infinite values (floating point volumes) are left out of all statistics
+inline bool
+finite_value(float v)
+{
+    return v == v && std::fabs(v) <= (std::numeric_limits<float>::max)();
+}
+
+// slab of normalized values including one halo slice on each side (if present in the volume)
+struct slab_view
+{
+    const float*    _data;
+    math::vec3ui    _dimensions;        // volume dimensions
+    unsigned        _buffer_begin;      // first z-slice held in _data
+    unsigned        _buffer_end;
+
+    const float* slice(unsigned z) const {
+        return _data + static_cast<scm::size_t>(z - _buffer_begin) * _dimensions.x * _dimensions.y;
+    }
+
+    // central differences, one-sided at the volume border
+    float gradient_magnitude(const float* s, const float* sp, const float* sn,
+                             unsigned x, unsigned y, float z_scale) const {
+        const unsigned xp = x > 0 ? x - 1 : x;
+        const unsigned xn = x + 1 < _dimensions.x ? x + 1 : x;
+        const unsigned yp = y > 0 ? y - 1 : y;
+        const unsigned yn = y + 1 < _dimensions.y ? y + 1 : y;
+        const unsigned r  = y * _dimensions.x;
+
+        const float gx = (s[r + xn] - s[r + xp]) / static_cast<float>(xn - xp > 0 ? xn - xp : 1);
+        const float gy = (s[yn * _dimensions.x + x] - s[yp * _dimensions.x + x]) / static_cast<float>(yn - yp > 0 ? yn - yp : 1);
+        const float gz = (sn[r + x] - sp[r + x]) * z_scale;
+
+        return std::sqrt(gx * gx + gy * gy + gz * gz);
+    }
+
+    void neighbor_slices(unsigned z, const float*& out_prev, const float*& out_next, float& out_z_scale) const {
+        const unsigned zp = z > _buffer_begin   ? z - 1 : z;
+        const unsigned zn = z + 1 < _buffer_end ? z + 1 : z;
+        out_prev    = slice(zp);
+        out_next    = slice(zn);
+        out_z_scale = zn - zp > 0 ? 1.0f / static_cast<float>(zn - zp) : 0.0f;
+    }
+}; // struct slab_view
+
+// first pass: value range, mean and variance (merged per slice, Chan et al.) and gradient range
+struct moments_pass
+{
+    moments_pass()
+      : _min((std::numeric_limits<float>::max)())
+      , _max(-(std::numeric_limits<float>::max)())
+      , _count(0)
+      , _mean(0.0)
+      , _m2(0.0)
+      , _max_gradient(0.0f)
+    {}
+
+    void merge(scm::uint64 n, double mean, double m2) {
+        if (n == 0) {
+            return;
+        }
+        const scm::uint64 c     = _count + n;
+        const double      delta = mean - _mean;
+        _mean  += delta * static_cast<double>(n) / static_cast<double>(c);
+        _m2    += m2 + delta * delta * static_cast<double>(_count) * static_cast<double>(n) / static_cast<double>(c);
+        _count  = c;
+    }
+
+    void process(const slab_view& v, unsigned z_begin, unsigned z_end) {
+        const unsigned    sx = v._dimensions.x;
+        const unsigned    sy = v._dimensions.y;
+        const scm::size_t n  = static_cast<scm::size_t>(sx) * sy;
+
+        for (unsigned z = z_begin; z < z_end; ++z) {
+            const float* s = v.slice(z);
+
+            float       smin = (std::numeric_limits<float>::max)();
+            float       smax = -(std::numeric_limits<float>::max)();
+            double      ssum = 0.0;
+            scm::size_t sc   = 0;
+            for (scm::size_t i = 0; i < n; ++i) {
+                if (finite_value(s[i])) {
+                    smin  = s[i] < smin ? s[i] : smin;
+                    smax  = s[i] > smax ? s[i] : smax;
+                    ssum += s[i];
+                    ++sc;
+                }
+            }
+            const double smean = sc > 0 ? ssum / static_cast<double>(sc) : 0.0;
+            double       sm2   = 0.0;
+            for (scm::size_t i = 0; i < n; ++i) {
+                if (finite_value(s[i])) {
+                    const double d = s[i] - smean;
+                    sm2 += d * d;
+                }
+            }
+
+            _min = (std::min)(_min, smin);
+            _max = (std::max)(_max, smax);
+            merge(sc, smean, sm2);
+
+            const float* sp;
+            const float* sn;
+            float        zs;
+            v.neighbor_slices(z, sp, sn, zs);
+            for (unsigned y = 0; y < sy; ++y) {
+                for (unsigned x = 0; x < sx; ++x) {
+                    const float g = v.gradient_magnitude(s, sp, sn, x, y, zs);
+                    if (finite_value(g)) {
+                        _max_gradient = (std::max)(_max_gradient, g);
+                    }
+                }
+            }
+        }
+    }
+
+    float           _min;
+    float           _max;
+    scm::uint64     _count;
+    double          _mean;
+    double          _m2;
+    float           _max_gradient;
+}; // struct moments_pass
+
+// second pass: value and value x gradient magnitude histograms
+struct histogram_pass
+{
+    histogram_pass(float min_value, float max_value, float max_gradient, unsigned value_bins, unsigned gradient_bins)
+      : _min_value(min_value)
+      , _value_scale(max_value > min_value ? static_cast<float>(value_bins) / (max_value - min_value) : 0.0f)
+      , _gradient_scale(max_gradient > 0.0f ? static_cast<float>(gradient_bins) / max_gradient : 0.0f)
+      , _value_bins(value_bins)
+      , _gradient_bins(gradient_bins)
+      , _value_histogram(value_bins, 0)
+      , _gradient_histogram(static_cast<scm::size_t>(value_bins) * gradient_bins, 0)
+    {}
+
+    void process(const slab_view& v, unsigned z_begin, unsigned z_end) {
+        const unsigned sx = v._dimensions.x;
+        const unsigned sy = v._dimensions.y;
+        const unsigned vb = _value_bins - 1;
+        const unsigned gb = _gradient_bins - 1;
+
+        for (unsigned z = z_begin; z < z_end; ++z) {
+            const float* s = v.slice(z);
+            const float* sp;
+            const float* sn;
+            float        zs;
+            v.neighbor_slices(z, sp, sn, zs);
+
+            for (unsigned y = 0; y < sy; ++y) {
+                for (unsigned x = 0; x < sx; ++x) {
+                    const float value = s[y * sx + x];
+                    if (!finite_value(value)) {
+                        continue;
+                    }
+                    const unsigned vi = (std::min)(static_cast<unsigned>((value - _min_value) * _value_scale), vb);
+                    ++_value_histogram[vi];
+
+                    // gradients next to non-finite values are left out of the 2d histogram
+                    const float g = v.gradient_magnitude(s, sp, sn, x, y, zs);
+                    if (finite_value(g)) {
+                        const unsigned gi = (std::min)(static_cast<unsigned>(g * _gradient_scale), gb);
+                        ++_gradient_histogram[gi * _value_bins + vi];
+                    }
+                }
+            }
+        }
+    }
+
+    float                               _min_value;
+    float                               _value_scale;
+    float                               _gradient_scale;
+    unsigned                            _value_bins;
+    unsigned                            _gradient_bins;
+    volume_statistics::histogram_type   _value_histogram;
+    volume_statistics::histogram_type   _gradient_histogram;
+}; // struct histogram_pass
+
+template<typename value_type>
+void
+normalize_values(const void* in_src, scm::size_t in_count, float* out_dst)
+{
+    const value_type* src   = static_cast<const value_type*>(in_src);
+    const float       scale = 1.0f / static_cast<float>((std::numeric_limits<value_type>::max)());
+    for (scm::size_t i = 0; i < in_count; ++i) {
+        out_dst[i] = static_cast<float>(src[i]) * scale;
+    }
+}
+
+template<typename value_type>
+bool
+write_values(std::ofstream& out_file, const value_type* in_values, scm::size_t in_count)
+{
+    return !out_file.write(reinterpret_cast<const char*>(in_values), in_count * sizeof(value_type)).fail();
+}
+
+template<typename value_type>
+bool
+read_values(std::ifstream& in_file, value_type* out_values, scm::size_t in_count)
+{
+    return !in_file.read(reinterpret_cast<char*>(out_values), in_count * sizeof(value_type)).fail();
+}
+
+} // namespace
+
+struct volume_statistics::source_stamp
+{
+    scm::uint64     _file_size;
+    scm::int64      _write_time;
+    scm::uint32     _value_bins;
+    scm::uint32     _gradient_bins;
+}; // struct volume_statistics::source_stamp
+
+volume_statistics::volume_statistics(unsigned in_thread_count,
+                                     unsigned in_slab_depth)
+  : _thread_count(in_thread_count)
+  , _slab_depth((std::max)(1u, in_slab_depth))
+  , _valid(false)
+  , _dimensions(0u)
+  , _format(FORMAT_NULL)
+  , _voxel_count(0)
+  , _min_value(0.0f)
+  , _max_value(0.0f)
+  , _mean(0.0)
+  , _variance(0.0)
+  , _max_gradient(0.0f)
+  , _value_bins(0)
+  , _gradient_bins(0)
+{
+    if (_thread_count == 0) {
+        concurrency::task_scheduler* scheduler = concurrency::default_scheduler();
+        _thread_count = scheduler ? scheduler->thread_count() + 1 : 1;
+    }
+}
+
+volume_statistics::~volume_statistics()
+{
+}
+
+bool
+volume_statistics::compute(const std::string& in_volume_path,
+                           unsigned           in_value_bins,
+                           unsigned           in_gradient_bins,
+                           bool               in_use_cache)
+{
+    namespace bfs = boost::filesystem;
+
+    boost::system::error_code ec;
+    source_stamp              stamp;
+    stamp._file_size     = static_cast<scm::uint64>(bfs::file_size(bfs::path(in_volume_path), ec));
+    stamp._write_time    = static_cast<scm::int64>(bfs::last_write_time(bfs::path(in_volume_path), ec));
+    stamp._value_bins    = in_value_bins;
+    stamp._gradient_bins = in_gradient_bins;
+
+    const std::string cache_path = cache_file_name(in_volume_path);
+
+    if (in_use_cache && !ec && load_cache(cache_path, stamp)) {
+        return true;
+    }
+
+    volume_loader             vl;
+    shared_ptr<volume_reader> vol_reader = vl.open_volume_reader(in_volume_path);
+    if (!vol_reader) {
+        return false;
+    }
+
+    if (!compute(*vol_reader, in_value_bins, in_gradient_bins)) {
+        err() << log::error
+              << "volume_statistics::compute(): error computing volume statistics ('" << in_volume_path << "')." << log::end;
+        return false;
+    }
+
+    if (in_use_cache && !ec) {
+        save_cache(cache_path, stamp);
+    }
+
+    return true;
+}
+
+bool
+volume_statistics::compute(volume_reader& in_volume_reader,
+                           unsigned       in_value_bins,
+                           unsigned       in_gradient_bins)
+{
+    using namespace scm::math;
+
+    _valid = false;
+
+    const vec3ui      dims   = in_volume_reader.dimensions();
+    const data_format format = in_volume_reader.format();
+
+    if (   dims.x == 0 || dims.y == 0 || dims.z == 0
+        || in_value_bins == 0 || in_gradient_bins == 0) {
+        err() << log::error
+              << "volume_statistics::compute(): invalid volume dimensions or histogram size." << log::end;
+        return false;
+    }
+    if (format != FORMAT_R_8 && format != FORMAT_R_16 && format != FORMAT_R_32F) {
+        err() << log::error
+              << "volume_statistics::compute(): unsupported volume data format (" << format_string(format) << ")." << log::end;
+        return false;
+    }
+
+    _dimensions = dims;
+    _format     = format;
+
+    const unsigned worker_count = (std::min)(_thread_count, _slab_depth);
+
+    // pass one: value range and moments
+    std::vector<moments_pass> moments(worker_count);
+    if (!stream_slabs(in_volume_reader, moments)) {
+        return false;
+    }
+    moments_pass m;
+    for (unsigned w = 0; w < worker_count; ++w) {
+        m._min          = (std::min)(m._min, moments[w]._min);
+        m._max          = (std::max)(m._max, moments[w]._max);
+        m._max_gradient = (std::max)(m._max_gradient, moments[w]._max_gradient);
+        m.merge(moments[w]._count, moments[w]._mean, moments[w]._m2);
+    }
+    if (m._count == 0) {
+        // no finite values at all
+        m._min = m._max = 0.0f;
+    }
+
+    // pass two: histograms over the now known value and gradient ranges
+    std::vector<histogram_pass> histograms(worker_count, histogram_pass(m._min, m._max, m._max_gradient, in_value_bins, in_gradient_bins));
+    if (!stream_slabs(in_volume_reader, histograms)) {
+        return false;
+    }
+    histogram_type value_histogram(in_value_bins, 0);
+    histogram_type gradient_histogram(static_cast<scm::size_t>(in_value_bins) * in_gradient_bins, 0);
+    for (unsigned w = 0; w < worker_count; ++w) {
+        std::transform(value_histogram.begin(), value_histogram.end(), histograms[w]._value_histogram.begin(),
+                       value_histogram.begin(), std::plus<scm::uint64>());
+        std::transform(gradient_histogram.begin(), gradient_histogram.end(), histograms[w]._gradient_histogram.begin(),
+                       gradient_histogram.begin(), std::plus<scm::uint64>());
+    }
+
+    _voxel_count    = m._count;
+    _min_value      = m._min;
+    _max_value      = m._max;
+    _mean           = m._mean;
+    _variance       = m._count > 0 ? m._m2 / static_cast<double>(m._count) : 0.0;
+    _max_gradient   = m._max_gradient;
+    _value_bins     = in_value_bins;
+    _gradient_bins  = in_gradient_bins;
+    _value_histogram.swap(value_histogram);
+    _gradient_histogram.swap(gradient_histogram);
+    _valid          = true;
+
+    return true;
+}
+
+template<class pass_type>
+bool
+volume_statistics::stream_slabs(volume_reader&          in_volume_reader,
+                                std::vector<pass_type>& in_workers)
+{
+    using namespace scm::math;
+
+    const vec3ui      dims        = _dimensions;
+    const scm::size_t slice_size  = static_cast<scm::size_t>(dims.x) * dims.y;
+    const scm::size_t voxel_size  = size_of_format(_format);
+    const unsigned    buffer_depth = _slab_depth + 2;
+
+    std::vector<unsigned char>  read_buffer(slice_size * buffer_depth * voxel_size);
+    std::vector<float>          slab_buffer(slice_size * buffer_depth);
+
+    const unsigned worker_count = static_cast<unsigned>(in_workers.size());
+
+    for (unsigned z0 = 0; z0 < dims.z; z0 += _slab_depth) {
+        const unsigned z1 = (std::min)(z0 + _slab_depth, dims.z);
+        const unsigned b0 = z0 > 0 ? z0 - 1 : 0;
+        const unsigned b1 = (std::min)(z1 + 1, dims.z);
+
+        if (!in_volume_reader.read(vec3ui(0u, 0u, b0), vec3ui(dims.x, dims.y, b1 - b0), &read_buffer.front())) {
+            err() << log::error
+                  << "volume_statistics::stream_slabs(): unable to read volume slab (" << b0 << ", " << b1 << ")." << log::end;
+            return false;
+        }
+
+        const scm::size_t value_count = slice_size * (b1 - b0);
+        switch (_format) {
+            case FORMAT_R_8:  normalize_values<scm::uint8>(&read_buffer.front(), value_count, &slab_buffer.front());  break;
+            case FORMAT_R_16: normalize_values<scm::uint16>(&read_buffer.front(), value_count, &slab_buffer.front()); break;
+            default:          std::memcpy(&slab_buffer.front(), &read_buffer.front(), value_count * sizeof(float));   break;
+        }
+
+        slab_view view;
+        view._data         = &slab_buffer.front();
+        view._dimensions   = dims;
+        view._buffer_begin = b0;
+        view._buffer_end   = b1;
+
+        // the slices of the slab are distributed to the workers running as tasks on the
+        // core task scheduler, the calling thread processes the first range
+        const unsigned slices = z1 - z0;
+        concurrency::task_scheduler* scheduler = concurrency::default_scheduler();
+        const unsigned active = scheduler ? (std::min)(worker_count, slices) : 1;
+
+        if (active > 1) {
+            concurrency::task_group workers(*scheduler);
+            for (unsigned w = 1; w < active; ++w) {
+                workers.run(boost::bind(&pass_type::process, &in_workers[w], boost::cref(view),
+                                        z0 + (slices * w) / active, z0 + (slices * (w + 1)) / active));
+            }
+            in_workers[0].process(view, z0, z0 + slices / active);
+            workers.wait();
+        }
+        else {
+            in_workers[0].process(view, z0, z1);
+        }
+    }
+
+    return true;
+}
+
+bool
+volume_statistics::valid() const
+{
+    return _valid;
+}
+
+const math::vec3ui&
+volume_statistics::dimensions() const
+{
+    return _dimensions;
+}
+
+data_format
+volume_statistics::format() const
+{
+    return _format;
+}
+
+scm::uint64
+volume_statistics::voxel_count() const
+{
+    return _voxel_count;
+}
+
+float
+volume_statistics::min_value() const
+{
+    return _min_value;
+}
+
+float
+volume_statistics::max_value() const
+{
+    return _max_value;
+}
+
+double
+volume_statistics::mean() const
+{
+    return _mean;
+}
+
+double
+volume_statistics::variance() const
+{
+    return _variance;
+}
+
+double
+volume_statistics::standard_deviation() const
+{
+    return std::sqrt(_variance);
+}
+
+float
+volume_statistics::max_gradient() const
+{
+    return _max_gradient;
+}
+
+unsigned
+volume_statistics::value_bins() const
+{
+    return _value_bins;
+}
+
+const volume_statistics::histogram_type&
+volume_statistics::value_histogram() const
+{
+    return _value_histogram;
+}
+
+unsigned
+volume_statistics::gradient_bins() const
+{
+    return _gradient_bins;
+}
+
+const volume_statistics::histogram_type&
+volume_statistics::gradient_histogram() const
+{
+    return _gradient_histogram;
+}
+
+std::string
+volume_statistics::cache_file_name(const std::string& in_volume_path)
+{
+    return in_volume_path + ".stats";
+}
+
+bool
+volume_statistics::load_cache(const std::string& in_cache_path, const source_stamp& in_stamp)
+{
+    std::ifstream cache_file(in_cache_path.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!cache_file) {
+        return false;
+    }
+
+    char         magic[8];
+    scm::uint32  version = 0;
+    source_stamp stamp;
+    scm::uint32  header[4];     // dimensions, format
+
+    if (   !read_values(cache_file, magic, 8)
+        || !read_values(cache_file, &version, 1)
+        || !read_values(cache_file, &stamp, 1)
+        || !read_values(cache_file, header, 4)) {
+        return false;
+    }
+    if (   0 != std::memcmp(magic, stats_file_magic, sizeof(stats_file_magic))
+        || version              != stats_file_version
+        || stamp._file_size     != in_stamp._file_size
+        || stamp._write_time    != in_stamp._write_time
+        || stamp._value_bins    != in_stamp._value_bins
+        || stamp._gradient_bins != in_stamp._gradient_bins) {
+        // stale cache entry, recomputed and overwritten by the caller
+        return false;
+    }
+
+    scm::uint64     voxel_count;
+    float           range[3];   // min, max, max gradient
+    double          moments[2]; // mean, variance
+    histogram_type  value_histogram(stamp._value_bins);
+    histogram_type  gradient_histogram(static_cast<scm::size_t>(stamp._value_bins) * stamp._gradient_bins);
+
+    if (   !read_values(cache_file, &voxel_count, 1)
+        || !read_values(cache_file, range, 3)
+        || !read_values(cache_file, moments, 2)
+        || !read_values(cache_file, &value_histogram.front(), value_histogram.size())
+        || !read_values(cache_file, &gradient_histogram.front(), gradient_histogram.size())) {
+        out() << log::warning
+              << "volume_statistics::load_cache(): ignoring corrupt statistics cache ('" << in_cache_path << "')." << log::end;
+        return false;
+    }
+
+    _dimensions     = math::vec3ui(header[0], header[1], header[2]);
+    _format         = static_cast<data_format>(header[3]);
+    _voxel_count    = voxel_count;
+    _min_value      = range[0];
+    _max_value      = range[1];
+    _max_gradient   = range[2];
+    _mean           = moments[0];
+    _variance       = moments[1];
+    _value_bins     = stamp._value_bins;
+    _gradient_bins  = stamp._gradient_bins;
+    _value_histogram.swap(value_histogram);
+    _gradient_histogram.swap(gradient_histogram);
+    _valid          = true;
+
+    return true;
+}
+
+bool
+volume_statistics::save_cache(const std::string& in_cache_path, const source_stamp& in_stamp) const
+{
+    namespace bfs = boost::filesystem;
+
+    const std::string temp_path = in_cache_path + ".tmp";
+
+    const scm::uint32 header[4] = { _dimensions.x, _dimensions.y, _dimensions.z, static_cast<scm::uint32>(_format) };
+    const float       range[3]  = { _min_value, _max_value, _max_gradient };
+    const double      moments[2]= { _mean, _variance };
+
+    { // write to a temporary file first, a concurrent reader never sees a partial cache
+        std::ofstream cache_file(temp_path.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+        if (   !cache_file
+            || !write_values(cache_file, stats_file_magic, 8)
+            || !write_values(cache_file, &stats_file_version, 1)
+            || !write_values(cache_file, &in_stamp, 1)
+            || !write_values(cache_file, header, 4)
+            || !write_values(cache_file, &_voxel_count, 1)
+            || !write_values(cache_file, range, 3)
+            || !write_values(cache_file, moments, 2)
+            || !write_values(cache_file, &_value_histogram.front(), _value_histogram.size())
+            || !write_values(cache_file, &_gradient_histogram.front(), _gradient_histogram.size())
+            || !cache_file.flush()) {
+            out() << log::warning
+                  << "volume_statistics::save_cache(): unable to write statistics cache ('" << temp_path << "')." << log::end;
+            cache_file.close();
+            boost::system::error_code ec;
+            bfs::remove(bfs::path(temp_path), ec);
+            return false;
+        }
+    }
+
+    boost::system::error_code ec;
+    bfs::rename(bfs::path(temp_path), bfs::path(in_cache_path), ec);
+    if (ec) {
+        out() << log::warning
+              << "volume_statistics::save_cache(): unable to write statistics cache ('" << in_cache_path << "', " << ec.message() << ")." << log::end;
+        bfs::remove(bfs::path(temp_path), ec);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,116 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_STATISTICS_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_STATISTICS_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/data_formats.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+class volume_reader;
+
+// volume_statistics
+//  - value range, mean, variance, value histogram and 2d value x gradient magnitude
+//    histogram of a volume
+//  - values are normalized like the texture samplers return them (unsigned normalized
+//    integer formats in [0, 1], floating point formats unchanged), gradient magnitudes
+//    are central differences in normalized values per voxel
+//  - non-finite values (NaN, inf) of floating point volumes are left out, voxel_count()
+//    counts the finite values
+//  - the volume is streamed through in slabs of z-slices (two passes: range and moments,
+//    then histograms) so out-of-core volumes never need to be loaded completely, the
+//    slices of each slab are processed by workers running on the core task scheduler
+//  - results for volume files are cached in a file next to the volume
+//    (<volume file>.stats), the cache is invalidated when the volume file changes
+class __scm_export(gl_util) volume_statistics
+{
+public:
+    typedef std::vector<scm::uint64>    histogram_type;
+
+public:
+    volume_statistics(unsigned in_thread_count = 0,     // 0: scheduler workers and the calling thread
+                      unsigned in_slab_depth   = 32);
+    virtual ~volume_statistics();
+
+    bool                        compute(const std::string& in_volume_path,
+                                        unsigned           in_value_bins    = 256,
+                                        unsigned           in_gradient_bins = 64,
+                                        bool               in_use_cache     = true);
+    bool                        compute(volume_reader&     in_volume_reader,
+                                        unsigned           in_value_bins    = 256,
+                                        unsigned           in_gradient_bins = 64);
+    bool                        valid() const;
+
+    const math::vec3ui&         dimensions() const;
+    data_format                 format() const;
+    scm::uint64                 voxel_count() const;
+
+    float                       min_value() const;
+    float                       max_value() const;
+    double                      mean() const;
+    double                      variance() const;
+    double                      standard_deviation() const;
+    float                       max_gradient() const;
+
+    // value histogram over [min_value, max_value]
+    unsigned                    value_bins() const;
+    const histogram_type&       value_histogram() const;
+
+    // 2d histogram, value over [min_value, max_value] (x, fastest), gradient magnitude
+    // over [0, max_gradient] (y)
+    unsigned                    gradient_bins() const;
+    const histogram_type&       gradient_histogram() const;
+
+    static std::string          cache_file_name(const std::string& in_volume_path);
+
+protected:
+    struct source_stamp;
+
+    bool                        load_cache(const std::string& in_cache_path, const source_stamp& in_stamp);
+    bool                        save_cache(const std::string& in_cache_path, const source_stamp& in_stamp) const;
+
+    template<class pass_type>
+    bool                        stream_slabs(volume_reader& in_volume_reader,
+                                             std::vector<pass_type>& in_workers);
+
+protected:
+    unsigned                    _thread_count;
+    unsigned                    _slab_depth;
+
+    bool                        _valid;
+    math::vec3ui                _dimensions;
+    data_format                 _format;
+    scm::uint64                 _voxel_count;
+
+    float                       _min_value;
+    float                       _max_value;
+    double                      _mean;
+    double                      _variance;
+    float                       _max_gradient;
+
+    unsigned                    _value_bins;
+    unsigned                    _gradient_bins;
+    histogram_type              _value_histogram;
+    histogram_type              _gradient_histogram;
+
+}; // class volume_statistics
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_STATISTICS_H_INCLUDED
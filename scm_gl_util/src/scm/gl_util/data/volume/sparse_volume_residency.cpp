@@ -0,0 +1,422 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "sparse_volume_residency.h"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+#include <scm/log.h>
+
+#include <scm/gl_core/render_device.h>
+#include <scm/gl_core/texture_objects.h>
+#include <scm/gl_core/primitives/box.h>
+#include <scm/gl_core/primitives/frustum.h>
+
+#include <scm/gl_util/data/volume/volume_brick_grid.h>
+#include <scm/gl_util/data/volume/volume_reader.h>
+
+namespace scm {
+namespace gl {
+
+namespace {
+
+typedef std::pair<float, unsigned>          brick_distance;     // squared distance to the viewer, brick index
+typedef std::pair<scm::uint64, unsigned>    brick_last_needed;  // last update needing the brick, brick index
+
+} // namespace
+
+sparse_volume_residency::sparse_volume_residency(const render_device_ptr&         in_device,
+                                                 const shared_ptr<volume_reader>& in_volume_reader,
+                                                 scm::size_t                      in_max_resident_bricks,
+                                                 unsigned                         in_max_uploads_per_update)
+  : _volume_reader(in_volume_reader)
+  , _format(FORMAT_NULL)
+  , _volume_dimensions(0u)
+  , _brick_size(0u)
+  , _grid_dimensions(0u)
+  , _residency_dirty(false)
+  , _max_resident_bricks(in_max_resident_bricks)
+  , _max_uploads_per_update(in_max_uploads_per_update)
+  , _resident_brick_count(0)
+  , _needed_brick_count(0)
+  , _pending_brick_count(0)
+  , _update_count(0)
+{
+    using namespace scm::math;
+
+    if (!_volume_reader || !(*_volume_reader)) {
+        err() << log::error
+              << "sparse_volume_residency::sparse_volume_residency(): invalid volume reader." << log::end;
+        return;
+    }
+
+    _format            = _volume_reader->format();
+    _volume_dimensions = _volume_reader->dimensions();
+    _brick_size        = in_device->texture_3d_sparse_page_size(_format);
+
+    if (_brick_size == vec3ui(0u)) {
+        err() << log::error
+              << "sparse_volume_residency::sparse_volume_residency(): sparse 3d textures not supported for volume format ("
+              << format_string(_format) << ")." << log::end;
+        return;
+    }
+
+    _grid_dimensions = (_volume_dimensions + _brick_size - vec3ui(1u)) / _brick_size;
+
+    _volume_texture = in_device->create_texture_3d(texture_3d_desc(_grid_dimensions * _brick_size, _format, 1, true));
+    if (!_volume_texture) {
+        err() << log::error
+              << "sparse_volume_residency::sparse_volume_residency(): unable to create sparse volume texture ("
+              << "size: " << _grid_dimensions * _brick_size << ")." << log::end;
+        return;
+    }
+
+    const scm::size_t brick_count = static_cast<scm::size_t>(_grid_dimensions.x) * _grid_dimensions.y * _grid_dimensions.z;
+
+    _bricks.resize(brick_count);
+    _residency.assign(brick_count, 0u);
+
+    std::vector<void*> init_data;
+    init_data.push_back(&_residency.front());
+
+    _residency_texture = in_device->create_texture_3d(_grid_dimensions, FORMAT_R_8, 1, FORMAT_R_8, init_data);
+    if (!_residency_texture) {
+        err() << log::error
+              << "sparse_volume_residency::sparse_volume_residency(): unable to create residency texture." << log::end;
+        _volume_texture.reset();
+    }
+}
+
+sparse_volume_residency::~sparse_volume_residency()
+{
+    _residency_texture.reset();
+    _volume_texture.reset();
+    _volume_reader.reset();
+}
+
+bool
+sparse_volume_residency::ok() const
+{
+    return _volume_texture && _residency_texture;
+}
+
+void
+sparse_volume_residency::set_occupancy(const volume_brick_grid& in_brick_grid)
+{
+    using namespace scm::math;
+
+    if (   in_brick_grid.empty()
+        || in_brick_grid.volume_dimensions() != _volume_dimensions) {
+        err() << log::error
+              << "sparse_volume_residency::set_occupancy(): brick grid does not match the volume." << log::end;
+        return;
+    }
+
+    const vec3ui grid_brick_size(in_brick_grid.brick_size());
+
+    for (unsigned i = 0; i < _bricks.size(); ++i) {
+        // the grid bricks overlapping the voxels of the page
+        const vec3ui o = brick_coordinates(i) * _brick_size;
+        const vec3ui e = min(o + _brick_size, _volume_dimensions) - vec3ui(1u);
+        const vec3ui gb = o / grid_brick_size;
+        const vec3ui ge = e / grid_brick_size;
+
+        bool occupied = false;
+        for (unsigned z = gb.z; z <= ge.z && !occupied; ++z) {
+            for (unsigned y = gb.y; y <= ge.y && !occupied; ++y) {
+                for (unsigned x = gb.x; x <= ge.x && !occupied; ++x) {
+                    occupied = in_brick_grid.occupied(vec3ui(x, y, z));
+                }
+            }
+        }
+        _bricks[i]._occupied = occupied;
+    }
+}
+
+void
+sparse_volume_residency::clear_occupancy()
+{
+    for (brick_array::iterator b = _bricks.begin(); b != _bricks.end(); ++b) {
+        b->_occupied = true;
+    }
+}
+
+bool
+sparse_volume_residency::update(render_context&      in_context,
+                                const math::mat4f&   in_volume_mvp,
+                                const math::vec3f&   in_viewer_position)
+{
+    using namespace scm::math;
+
+    if (!ok()) {
+        return false;
+    }
+
+    ++_update_count;
+
+    // visible bricks, nearest first
+    const frustumf  view_frustum(in_volume_mvp);
+    const vec3f     volume_dimensions(_volume_dimensions);
+
+    std::vector<brick_distance> visible_bricks;
+    visible_bricks.reserve(_bricks.size());
+
+    for (unsigned i = 0; i < _bricks.size(); ++i) {
+        if (!_bricks[i]._occupied) {
+            continue;
+        }
+        const vec3ui o         = brick_coordinates(i) * _brick_size;
+        const vec3f  box_min   = vec3f(o) / volume_dimensions;
+        const vec3f  box_max   = vec3f(min(o + _brick_size, _volume_dimensions)) / volume_dimensions;
+
+        if (view_frustum.classify(boxf(box_min, box_max)) != frustumf::outside) {
+            const vec3f d = (box_min + box_max) * 0.5f - in_viewer_position;
+            visible_bricks.push_back(brick_distance(dot(d, d), i));
+        }
+    }
+
+    _needed_brick_count = (std::min)(visible_bricks.size(), _max_resident_bricks);
+    std::partial_sort(visible_bricks.begin(), visible_bricks.begin() + _needed_brick_count, visible_bricks.end());
+
+    for (scm::size_t n = 0; n < _needed_brick_count; ++n) {
+        _bricks[visible_bricks[n].second]._last_needed = _update_count;
+    }
+
+    // resident bricks not needed in this update, least recently needed first
+    std::vector<brick_last_needed> evictable_bricks;
+    for (unsigned i = 0; i < _bricks.size(); ++i) {
+        if (_bricks[i]._resident && _bricks[i]._last_needed != _update_count) {
+            evictable_bricks.push_back(brick_last_needed(_bricks[i]._last_needed, i));
+        }
+    }
+    std::sort(evictable_bricks.begin(), evictable_bricks.end());
+
+    std::vector<brick_last_needed>::const_iterator next_evictable = evictable_bricks.begin();
+
+    // shrink to a lowered budget
+    while (_resident_brick_count > _max_resident_bricks && next_evictable != evictable_bricks.end()) {
+        decommit_brick(in_context, (next_evictable++)->second);
+    }
+
+    unsigned uploads = 0;
+    for (scm::size_t n = 0; n < _needed_brick_count && uploads < _max_uploads_per_update; ++n) {
+        const unsigned i = visible_bricks[n].second;
+        if (_bricks[i]._resident) {
+            continue;
+        }
+        if (_resident_brick_count >= _max_resident_bricks) {
+            if (next_evictable == evictable_bricks.end()) {
+                break;
+            }
+            decommit_brick(in_context, (next_evictable++)->second);
+        }
+        if (commit_brick(in_context, i)) {
+            ++uploads;
+        }
+        else {
+            break;
+        }
+    }
+
+    _pending_brick_count = 0;
+    for (scm::size_t n = 0; n < _needed_brick_count; ++n) {
+        if (!_bricks[visible_bricks[n].second]._resident) {
+            ++_pending_brick_count;
+        }
+    }
+
+    return update_residency_texture(in_context);
+}
+
+void
+sparse_volume_residency::decommit_all(render_context& in_context)
+{
+    for (unsigned i = 0; i < _bricks.size(); ++i) {
+        if (_bricks[i]._resident) {
+            decommit_brick(in_context, i);
+        }
+    }
+    _pending_brick_count = _needed_brick_count;
+
+    update_residency_texture(in_context);
+}
+
+const texture_3d_ptr&
+sparse_volume_residency::volume_texture() const
+{
+    return _volume_texture;
+}
+
+const texture_3d_ptr&
+sparse_volume_residency::residency_texture() const
+{
+    return _residency_texture;
+}
+
+math::vec3f
+sparse_volume_residency::texture_coordinate_scale() const
+{
+    if (!ok()) {
+        return math::vec3f(1.0f);
+    }
+    return math::vec3f(_volume_dimensions) / math::vec3f(_grid_dimensions * _brick_size);
+}
+
+const math::vec3ui&
+sparse_volume_residency::volume_dimensions() const
+{
+    return _volume_dimensions;
+}
+
+const math::vec3ui&
+sparse_volume_residency::brick_size() const
+{
+    return _brick_size;
+}
+
+const math::vec3ui&
+sparse_volume_residency::grid_dimensions() const
+{
+    return _grid_dimensions;
+}
+
+bool
+sparse_volume_residency::resident(const math::vec3ui& in_brick) const
+{
+    return _bricks[brick_index(in_brick)]._resident;
+}
+
+scm::size_t
+sparse_volume_residency::max_resident_bricks() const
+{
+    return _max_resident_bricks;
+}
+
+void
+sparse_volume_residency::max_resident_bricks(scm::size_t in_count)
+{
+    _max_resident_bricks = in_count;
+}
+
+unsigned
+sparse_volume_residency::max_uploads_per_update() const
+{
+    return _max_uploads_per_update;
+}
+
+void
+sparse_volume_residency::max_uploads_per_update(unsigned in_count)
+{
+    _max_uploads_per_update = in_count;
+}
+
+scm::size_t
+sparse_volume_residency::resident_brick_count() const
+{
+    return _resident_brick_count;
+}
+
+scm::size_t
+sparse_volume_residency::needed_brick_count() const
+{
+    return _needed_brick_count;
+}
+
+scm::size_t
+sparse_volume_residency::pending_brick_count() const
+{
+    return _pending_brick_count;
+}
+
+scm::size_t
+sparse_volume_residency::resident_memory() const
+{
+    const scm::size_t brick_voxels = static_cast<scm::size_t>(_brick_size.x) * _brick_size.y * _brick_size.z;
+
+    return _resident_brick_count * brick_voxels * size_of_format(_format);
+}
+
+unsigned
+sparse_volume_residency::brick_index(const math::vec3ui& in_brick) const
+{
+    assert(in_brick.x < _grid_dimensions.x && in_brick.y < _grid_dimensions.y && in_brick.z < _grid_dimensions.z);
+
+    return in_brick.x + _grid_dimensions.x * (in_brick.y + _grid_dimensions.y * in_brick.z);
+}
+
+math::vec3ui
+sparse_volume_residency::brick_coordinates(unsigned in_index) const
+{
+    return math::vec3ui(in_index % _grid_dimensions.x,
+                        (in_index / _grid_dimensions.x) % _grid_dimensions.y,
+                        in_index / (_grid_dimensions.x * _grid_dimensions.y));
+}
+
+bool
+sparse_volume_residency::commit_brick(render_context& in_context, unsigned in_index)
+{
+    using namespace scm::math;
+
+    assert(!_bricks[in_index]._resident);
+
+    // the page is committed as a whole, only the part inside the volume is read
+    const vec3ui o = brick_coordinates(in_index) * _brick_size;
+    const vec3ui s = min(o + _brick_size, _volume_dimensions) - o;
+
+    if (!in_context.commit_texture_pages(_volume_texture, texture_region(o, _brick_size))) {
+        return false;
+    }
+
+    _brick_data.resize(static_cast<scm::size_t>(s.x) * s.y * s.z * size_of_format(_format));
+
+    if (   !_volume_reader->read(o, s, &_brick_data.front())
+        || !in_context.update_sub_texture(_volume_texture, texture_region(o, s), 0, _format, &_brick_data.front())) {
+        err() << log::error
+              << "sparse_volume_residency::commit_brick(): error reading or uploading brick " << brick_coordinates(in_index)
+              << "." << log::end;
+        in_context.decommit_texture_pages(_volume_texture, texture_region(o, _brick_size));
+        return false;
+    }
+
+    _bricks[in_index]._resident = true;
+    _residency[in_index]        = 255u;
+    _residency_dirty            = true;
+    ++_resident_brick_count;
+
+    return true;
+}
+
+void
+sparse_volume_residency::decommit_brick(render_context& in_context, unsigned in_index)
+{
+    assert(_bricks[in_index]._resident);
+
+    const math::vec3ui o = brick_coordinates(in_index) * _brick_size;
+
+    in_context.decommit_texture_pages(_volume_texture, texture_region(o, _brick_size));
+
+    _bricks[in_index]._resident = false;
+    _residency[in_index]        = 0u;
+    _residency_dirty            = true;
+    --_resident_brick_count;
+}
+
+bool
+sparse_volume_residency::update_residency_texture(render_context& in_context)
+{
+    if (!_residency_dirty) {
+        return false;
+    }
+
+    in_context.update_sub_texture(_residency_texture, texture_region(math::vec3ui(0u), _grid_dimensions),
+                                  0, FORMAT_R_8, &_residency.front());
+    _residency_dirty = false;
+
+    return true;
+}
+
+} // namespace gl
+} // namespace scm
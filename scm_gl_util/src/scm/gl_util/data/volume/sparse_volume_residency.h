@@ -0,0 +1,136 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_SPARSE_VOLUME_RESIDENCY_H_INCLUDED
+#define SCM_GL_UTIL_SPARSE_VOLUME_RESIDENCY_H_INCLUDED
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/data_formats.h>
+#include <scm/gl_core/render_device/render_device_fwd.h>
+#include <scm/gl_core/texture_objects/texture_objects_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+class volume_brick_grid;
+class volume_reader;
+class sparse_volume_residency;
+
+typedef shared_ptr<sparse_volume_residency>        sparse_volume_residency_ptr;
+typedef shared_ptr<sparse_volume_residency const>  sparse_volume_residency_cptr;
+
+// sparse_volume_residency
+//  - addresses a large volume through a single sparse 3d texture (ARB_sparse_texture), only
+//    the bricks needed for the current view are committed, the device memory used is
+//    proportional to the visible part of the volume instead of the volume size
+//  - a brick is one virtual page of the texture, the texture size is rounded up to whole
+//    pages, texture_coordinate_scale() maps normalized volume to texture coordinates
+//  - update() selects the bricks intersecting the view frustum (and occupied, if a
+//    classified volume_brick_grid was set), nearest to the viewer first; missing bricks are
+//    committed and read from the volume reader up to the upload budget per update, bricks
+//    no longer needed are decommitted least recently needed first once the resident brick
+//    budget is exhausted
+//  - uncommitted bricks read undefined, the residency texture (FORMAT_R_8, one texel per
+//    brick, 255: resident) lets the ray casters skip them
+class __scm_export(gl_util) sparse_volume_residency : boost::noncopyable
+{
+protected:
+    struct brick {
+        brick() : _resident(false), _occupied(true), _last_needed(0) {}
+
+        bool            _resident;
+        bool            _occupied;
+        scm::uint64     _last_needed;
+    }; // struct brick
+
+    typedef std::vector<brick>          brick_array;
+
+public:
+    sparse_volume_residency(const render_device_ptr&         in_device,
+                            const shared_ptr<volume_reader>& in_volume_reader,
+                            scm::size_t                      in_max_resident_bricks,
+                            unsigned                         in_max_uploads_per_update = 16);
+    virtual ~sparse_volume_residency();
+
+    bool                        ok() const;
+
+    // marks the bricks without occupied grid bricks as not needed, call again after the
+    // grid was re-classified
+    void                        set_occupancy(const volume_brick_grid& in_brick_grid);
+    void                        clear_occupancy();
+
+    // in_volume_mvp transforms normalized volume coordinates ([0, 1]^3) to clip space, the
+    // viewer position is given in normalized volume coordinates, returns true if the
+    // residency changed
+    bool                        update(render_context&      in_context,
+                                       const math::mat4f&   in_volume_mvp,
+                                       const math::vec3f&   in_viewer_position);
+    void                        decommit_all(render_context& in_context);
+
+    const texture_3d_ptr&       volume_texture() const;
+    const texture_3d_ptr&       residency_texture() const;
+    math::vec3f                 texture_coordinate_scale() const;
+
+    const math::vec3ui&         volume_dimensions() const;
+    const math::vec3ui&         brick_size() const;
+    const math::vec3ui&         grid_dimensions() const;
+    bool                        resident(const math::vec3ui& in_brick) const;
+
+    scm::size_t                 max_resident_bricks() const;
+    void                        max_resident_bricks(scm::size_t in_count);
+    unsigned                    max_uploads_per_update() const;
+    void                        max_uploads_per_update(unsigned in_count);
+
+    scm::size_t                 resident_brick_count() const;
+    scm::size_t                 needed_brick_count() const;         // of the last update
+    scm::size_t                 pending_brick_count() const;        // needed, not yet resident
+    scm::size_t                 resident_memory() const;            // byte
+
+protected:
+    unsigned                    brick_index(const math::vec3ui& in_brick) const;
+    math::vec3ui                brick_coordinates(unsigned in_index) const;
+    bool                        commit_brick(render_context& in_context, unsigned in_index);
+    void                        decommit_brick(render_context& in_context, unsigned in_index);
+    bool                        update_residency_texture(render_context& in_context);
+
+protected:
+    shared_ptr<volume_reader>   _volume_reader;
+    data_format                 _format;
+    math::vec3ui                _volume_dimensions;
+    math::vec3ui                _brick_size;
+    math::vec3ui                _grid_dimensions;
+
+    texture_3d_ptr              _volume_texture;
+    texture_3d_ptr              _residency_texture;
+
+    brick_array                 _bricks;
+    std::vector<scm::uint8>     _residency;
+    bool                        _residency_dirty;
+    std::vector<scm::uint8>     _brick_data;
+
+    scm::size_t                 _max_resident_bricks;
+    unsigned                    _max_uploads_per_update;
+    scm::size_t                 _resident_brick_count;
+    scm::size_t                 _needed_brick_count;
+    scm::size_t                 _pending_brick_count;
+    scm::uint64                 _update_count;
+
+}; // class sparse_volume_residency
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_SPARSE_VOLUME_RESIDENCY_H_INCLUDED
@@ -0,0 +1,426 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_brick_grid.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include <boost/bind.hpp>
+#include <boost/scoped_array.hpp>
+
+#include <scm/log.h>
+#include <scm/concurrency.h>
+
+#include <scm/gl_core/render_device.h>
+#include <scm/gl_core/texture_objects.h>
+
+#include <scm/gl_util/data/analysis/transfer_function/build_lookup_table.h>
+
+namespace scm {
+namespace gl {
+
+namespace {
+
+template<typename value_type>
+float
+normalized_value(const value_type v)
+{
+    return static_cast<float>(v) / static_cast<float>((std::numeric_limits<value_type>::max)());
+}
+
+template<>
+float
+normalized_value<float>(const float v)
+{
+    return v;
+}
+
+// min/max over the bricks in the z-layers [in_layer_begin, in_layer_end), each brick
+// covers its voxels plus the one voxel border read by trilinear filtering
+template<typename value_type>
+void
+build_min_max_layers(const value_type*        in_data,
+                     const math::vec3ui&      in_volume_dimensions,
+                     const math::vec3ui&      in_grid_dimensions,
+                     unsigned                 in_brick_size,
+                     unsigned                 in_layer_begin,
+                     unsigned                 in_layer_end,
+                     math::vec2f*             out_min_max)
+{
+    using namespace scm::math;
+
+    const scm::size_t sy = in_volume_dimensions.x;
+    const scm::size_t sz = static_cast<scm::size_t>(in_volume_dimensions.x) * in_volume_dimensions.y;
+
+    for (unsigned bz = in_layer_begin; bz < in_layer_end; ++bz) {
+        for (unsigned by = 0; by < in_grid_dimensions.y; ++by) {
+            for (unsigned bx = 0; bx < in_grid_dimensions.x; ++bx) {
+                const vec3ui b(bx, by, bz);
+                const vec3ui vb = vec3ui(max(vec3i(b * in_brick_size) - vec3i(1), vec3i(0)));
+                const vec3ui ve = min((b + vec3ui(1)) * in_brick_size + vec3ui(1), in_volume_dimensions);
+
+                float vmin = (std::numeric_limits<float>::max)();
+                float vmax = -(std::numeric_limits<float>::max)();
+
+                for (unsigned z = vb.z; z < ve.z; ++z) {
+                    for (unsigned y = vb.y; y < ve.y; ++y) {
+                        const value_type* row = in_data + z * sz + y * sy;
+                        for (unsigned x = vb.x; x < ve.x; ++x) {
+                            const float v = normalized_value(row[x]);
+                            vmin = v < vmin ? v : vmin;
+                            vmax = v > vmax ? v : vmax;
+                        }
+                    }
+                }
+
+                out_min_max[(static_cast<scm::size_t>(bz) * in_grid_dimensions.y + by) * in_grid_dimensions.x + bx] = vec2f(vmin, vmax);
+            }
+        }
+    }
+}
+
+template<typename value_type>
+struct min_max_layers_body
+{
+    void operator()(const concurrency::range_1d& r) const {
+        build_min_max_layers<value_type>(_data, _volume_dimensions, _grid_dimensions, _brick_size,
+                                         static_cast<unsigned>(r._begin), static_cast<unsigned>(r._end), _min_max);
+    }
+
+    const value_type*       _data;
+    math::vec3ui            _volume_dimensions;
+    math::vec3ui            _grid_dimensions;
+    unsigned                _brick_size;
+    math::vec2f*            _min_max;
+}; // struct min_max_layers_body
+
+template<typename value_type>
+void
+build_min_max(const value_type*        in_data,
+              const math::vec3ui&      in_volume_dimensions,
+              const math::vec3ui&      in_grid_dimensions,
+              unsigned                 in_brick_size,
+              unsigned                 in_thread_count,
+              math::vec2f*             out_min_max)
+{
+    const unsigned layers = in_grid_dimensions.z;
+
+    min_max_layers_body<value_type> body;
+    body._data              = in_data;
+    body._volume_dimensions = in_volume_dimensions;
+    body._grid_dimensions   = in_grid_dimensions;
+    body._brick_size        = in_brick_size;
+    body._min_max           = out_min_max;
+
+    // the bricks do not overlap in the output, the z-layers are distributed over the
+    // core task scheduler
+    const std::size_t grain = in_thread_count > 0 ? (layers + in_thread_count - 1) / in_thread_count : 0;
+    concurrency::parallel_for(concurrency::range_1d(0, layers, grain), body);
+}
+
+} // namespace
+
+volume_brick_grid::volume_brick_grid()
+  : _brick_size(0)
+  , _volume_dimensions(0u)
+  , _grid_dimensions(0u)
+  , _build_octree(false)
+  , _occupied_brick_count(0)
+  , _classified(false)
+  , _classification_range(0.0f)
+{
+}
+
+volume_brick_grid::~volume_brick_grid()
+{
+}
+
+bool
+volume_brick_grid::build(const math::vec3ui& in_volume_dimensions,
+                         const data_format   in_volume_format,
+                         const void*         in_volume_data,
+                         unsigned            in_brick_size,
+                         bool                in_build_octree,
+                         unsigned            in_thread_count)
+{
+    using namespace scm::math;
+
+    if (   in_volume_dimensions.x == 0 || in_volume_dimensions.y == 0 || in_volume_dimensions.z == 0
+        || in_volume_data == 0
+        || in_brick_size == 0) {
+        err() << log::error
+              << "volume_brick_grid::build(): invalid volume data (dimensions: " << in_volume_dimensions
+              << ", brick size: " << in_brick_size << ")." << log::end;
+        return false;
+    }
+
+    const vec3ui grid_dimensions = (in_volume_dimensions + vec3ui(in_brick_size - 1)) / in_brick_size;
+
+    std::vector<vec2f> min_max(static_cast<scm::size_t>(grid_dimensions.x) * grid_dimensions.y * grid_dimensions.z);
+
+    switch (in_volume_format) {
+        case FORMAT_R_8:
+            build_min_max(static_cast<const scm::uint8*>(in_volume_data),  in_volume_dimensions, grid_dimensions,
+                          in_brick_size, in_thread_count, &min_max.front());
+            break;
+        case FORMAT_R_16:
+            build_min_max(static_cast<const scm::uint16*>(in_volume_data), in_volume_dimensions, grid_dimensions,
+                          in_brick_size, in_thread_count, &min_max.front());
+            break;
+        case FORMAT_R_32F:
+            build_min_max(static_cast<const float*>(in_volume_data),       in_volume_dimensions, grid_dimensions,
+                          in_brick_size, in_thread_count, &min_max.front());
+            break;
+        default:
+            err() << log::error
+                  << "volume_brick_grid::build(): unsupported volume data format (" << format_string(in_volume_format) << ")." << log::end;
+            return false;
+    }
+
+    _brick_size        = in_brick_size;
+    _volume_dimensions = in_volume_dimensions;
+    _grid_dimensions   = grid_dimensions;
+    _min_max.swap(min_max);
+    _build_octree      = in_build_octree;
+    _classified        = false;
+
+    build_octree_levels();
+
+    return true;
+}
+
+bool
+volume_brick_grid::empty() const
+{
+    return _min_max.empty();
+}
+
+unsigned
+volume_brick_grid::brick_size() const
+{
+    return _brick_size;
+}
+
+const math::vec3ui&
+volume_brick_grid::volume_dimensions() const
+{
+    return _volume_dimensions;
+}
+
+const math::vec3ui&
+volume_brick_grid::grid_dimensions() const
+{
+    return _grid_dimensions;
+}
+
+const math::vec2f&
+volume_brick_grid::brick_min_max(const math::vec3ui& in_brick) const
+{
+    assert(in_brick.x < _grid_dimensions.x && in_brick.y < _grid_dimensions.y && in_brick.z < _grid_dimensions.z);
+    return _min_max[(static_cast<scm::size_t>(in_brick.z) * _grid_dimensions.y + in_brick.y) * _grid_dimensions.x + in_brick.x];
+}
+
+void
+volume_brick_grid::classify(const float* in_alpha_table,
+                            unsigned     in_table_size,
+                            float        in_value_offset,
+                            float        in_value_scale)
+{
+    if (empty() || in_table_size == 0) {
+        return;
+    }
+
+    // prefix sum over the non transparent table entries, a brick is occupied if the
+    // table range touched by its linear filtered lookups contains any of them
+    std::vector<unsigned> visible_prefix(in_table_size + 1, 0u);
+    for (unsigned i = 0; i < in_table_size; ++i) {
+        visible_prefix[i + 1] = visible_prefix[i] + (in_alpha_table[i] > 0.0f ? 1u : 0u);
+    }
+
+    const float table_scale = static_cast<float>(in_table_size);
+    const float table_max   = static_cast<float>(in_table_size - 1);
+
+    occupancy_array& occ = _occupancy_levels[0]._occupancy;
+    _occupied_brick_count = 0;
+
+    for (scm::size_t b = 0; b < _min_max.size(); ++b) {
+        float t0 = ((_min_max[b].x - in_value_offset) * in_value_scale) * table_scale - 0.5f;
+        float t1 = ((_min_max[b].y - in_value_offset) * in_value_scale) * table_scale - 0.5f;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        const unsigned i0 = static_cast<unsigned>(math::clamp(t0, 0.0f, table_max));
+        const unsigned i1 = (std::min)(static_cast<unsigned>(math::clamp(t1, 0.0f, table_max)) + 1, in_table_size - 1);
+
+        const bool visible = visible_prefix[i1 + 1] - visible_prefix[i0] > 0;
+        occ[b] = visible ? 255u : 0u;
+        _occupied_brick_count += visible ? 1 : 0;
+    }
+
+    update_octree_levels();
+
+    _classified = true;
+}
+
+bool
+volume_brick_grid::classify(const alpha_map_type& in_alpha_map,
+                            float                 in_min_value,
+                            float                 in_max_value,
+                            unsigned              in_table_size)
+{
+    if (empty()) {
+        return false;
+    }
+
+    boost::scoped_array<float> alpha_lut(new float[in_table_size]);
+
+    if (   in_table_size == 0
+        || !scm::data::build_lookup_table(alpha_lut, in_alpha_map, in_table_size)) {
+        err() << log::error
+              << "volume_brick_grid::classify(): error generating alpha lookup table." << log::end;
+        return false;
+    }
+
+    classify(alpha_lut.get(), in_table_size, in_min_value, 1.0f / (in_max_value - in_min_value));
+    _classification_range = math::vec3f(in_min_value, in_max_value, static_cast<float>(in_table_size));
+
+    return true;
+}
+
+bool
+volume_brick_grid::update_classification(const alpha_map_type& in_alpha_map,
+                                         float                 in_min_value,
+                                         float                 in_max_value,
+                                         unsigned              in_table_size)
+{
+    if (   !_classified
+        || in_alpha_map.dirty()
+        || _classification_range != math::vec3f(in_min_value, in_max_value, static_cast<float>(in_table_size))) {
+        return classify(in_alpha_map, in_min_value, in_max_value, in_table_size);
+    }
+
+    return true;
+}
+
+bool
+volume_brick_grid::classified() const
+{
+    return _classified;
+}
+
+unsigned
+volume_brick_grid::occupancy_level_count() const
+{
+    return static_cast<unsigned>(_occupancy_levels.size());
+}
+
+const volume_brick_grid::occupancy_level&
+volume_brick_grid::occupancy(unsigned in_level) const
+{
+    assert(in_level < _occupancy_levels.size());
+    return _occupancy_levels[in_level];
+}
+
+bool
+volume_brick_grid::occupied(const math::vec3ui& in_brick, unsigned in_level) const
+{
+    const occupancy_level& l = occupancy(in_level);
+    return 0 != l._occupancy[(static_cast<scm::size_t>(in_brick.z) * l._dimensions.y + in_brick.y) * l._dimensions.x + in_brick.x];
+}
+
+scm::size_t
+volume_brick_grid::occupied_brick_count() const
+{
+    return _occupied_brick_count;
+}
+
+texture_3d_ptr
+volume_brick_grid::create_occupancy_texture(render_device& in_device,
+                                            unsigned       in_level) const
+{
+    if (in_level >= _occupancy_levels.size()) {
+        err() << log::error
+              << "volume_brick_grid::create_occupancy_texture(): invalid occupancy level (" << in_level << ")." << log::end;
+        return texture_3d_ptr();
+    }
+
+    const occupancy_level& l = _occupancy_levels[in_level];
+    std::vector<void*> init_data;
+    init_data.push_back(const_cast<scm::uint8*>(&l._occupancy.front()));
+
+    return in_device.create_texture_3d(l._dimensions, FORMAT_R_8, 1, FORMAT_R_8, init_data);
+}
+
+bool
+volume_brick_grid::update_occupancy_texture(render_context&       in_context,
+                                            const texture_3d_ptr& in_texture,
+                                            unsigned              in_level) const
+{
+    if (   in_level >= _occupancy_levels.size()
+        || !in_texture
+        || in_texture->descriptor()._size != _occupancy_levels[in_level]._dimensions) {
+        err() << log::error
+              << "volume_brick_grid::update_occupancy_texture(): invalid occupancy level or texture." << log::end;
+        return false;
+    }
+
+    const occupancy_level& l = _occupancy_levels[in_level];
+
+    return in_context.update_sub_texture(in_texture, texture_region(math::vec3ui(0u), l._dimensions),
+                                         0, FORMAT_R_8, &l._occupancy.front());
+}
+
+void
+volume_brick_grid::build_octree_levels()
+{
+    using namespace scm::math;
+
+    _occupancy_levels.clear();
+
+    occupancy_level base;
+    base._dimensions = _grid_dimensions;
+    base._occupancy.assign(_min_max.size(), 255u);
+    _occupancy_levels.push_back(base);
+    _occupied_brick_count = _min_max.size();
+
+    if (_build_octree) {
+        vec3ui d = _grid_dimensions;
+        while (d.x > 1 || d.y > 1 || d.z > 1) {
+            d = (d + vec3ui(1u)) / 2u;
+            occupancy_level l;
+            l._dimensions = d;
+            l._occupancy.assign(static_cast<scm::size_t>(d.x) * d.y * d.z, 255u);
+            _occupancy_levels.push_back(l);
+        }
+    }
+}
+
+void
+volume_brick_grid::update_octree_levels()
+{
+    using namespace scm::math;
+
+    for (scm::size_t lvl = 1; lvl < _occupancy_levels.size(); ++lvl) {
+        const occupancy_level& c = _occupancy_levels[lvl - 1];
+        occupancy_level&       p = _occupancy_levels[lvl];
+
+        std::fill(p._occupancy.begin(), p._occupancy.end(), 0u);
+
+        for (unsigned z = 0; z < c._dimensions.z; ++z) {
+            for (unsigned y = 0; y < c._dimensions.y; ++y) {
+                for (unsigned x = 0; x < c._dimensions.x; ++x) {
+                    if (c._occupancy[(static_cast<scm::size_t>(z) * c._dimensions.y + y) * c._dimensions.x + x]) {
+                        p._occupancy[(static_cast<scm::size_t>(z / 2) * p._dimensions.y + y / 2) * p._dimensions.x + x / 2] = 255u;
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace gl
+} // namespace scm
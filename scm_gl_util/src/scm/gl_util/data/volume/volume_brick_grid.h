@@ -0,0 +1,122 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_BRICK_GRID_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_BRICK_GRID_H_INCLUDED
+
+#include <vector>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/data_formats.h>
+#include <scm/gl_core/render_device/render_device_fwd.h>
+#include <scm/gl_core/texture_objects/texture_objects_fwd.h>
+
+#include <scm/gl_util/data/analysis/transfer_function/piecewise_function_1d.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+class volume_brick_grid;
+
+typedef shared_ptr<volume_brick_grid>        volume_brick_grid_ptr;
+typedef shared_ptr<volume_brick_grid const>  volume_brick_grid_cptr;
+
+// volume_brick_grid
+//  - empty space skipping structure, stores the min/max normalized value of each brick
+//    of the volume (including the one voxel border touched by trilinear filtering)
+//  - the min/max grid is built once from the volume data, the brick occupancy is
+//    re-classified against an alpha transfer function in O(1) per brick using a
+//    prefix sum over the opacity lookup table
+//  - the optional occupancy octree stores for each coarser level whether any of the
+//    2x2x2 child nodes is occupied, level 0 is the brick grid itself
+class __scm_export(gl_util) volume_brick_grid
+{
+public:
+    typedef scm::data::piecewise_function_1d<float, float>  alpha_map_type;
+    typedef std::vector<scm::uint8>                         occupancy_array;
+
+    struct occupancy_level {
+        math::vec3ui        _dimensions;
+        occupancy_array     _occupancy;         // 0: empty, 255: occupied, x fastest
+    }; // struct occupancy_level
+
+public:
+    volume_brick_grid();
+    virtual ~volume_brick_grid();
+
+    // build the min/max grid from normalized volume data (FORMAT_R_8, FORMAT_R_16 or FORMAT_R_32F)
+    bool                        build(const math::vec3ui& in_volume_dimensions,
+                                      const data_format   in_volume_format,
+                                      const void*         in_volume_data,
+                                      unsigned            in_brick_size   = 16,
+                                      bool                in_build_octree = true,
+                                      unsigned            in_thread_count = 0);     // concurrent pieces on the core scheduler, 0: automatic
+    bool                        empty() const;
+
+    unsigned                    brick_size() const;
+    const math::vec3ui&         volume_dimensions() const;
+    const math::vec3ui&         grid_dimensions() const;
+    const math::vec2f&          brick_min_max(const math::vec3ui& in_brick) const;
+
+    // classify against an opacity lookup table, the normalized data values are mapped
+    // to the table domain by (v - in_value_offset) * in_value_scale
+    void                        classify(const float* in_alpha_table,
+                                         unsigned     in_table_size,
+                                         float        in_value_offset,
+                                         float        in_value_scale);
+    bool                        classify(const alpha_map_type& in_alpha_map,
+                                         float                 in_min_value = 0.0f,
+                                         float                 in_max_value = 1.0f,
+                                         unsigned              in_table_size = 256);
+    // re-classify only if the alpha map is dirty or the value range changed, the dirty flag
+    // is left to the owner of the transfer function as other consumers may depend on it
+    bool                        update_classification(const alpha_map_type& in_alpha_map,
+                                                      float                 in_min_value = 0.0f,
+                                                      float                 in_max_value = 1.0f,
+                                                      unsigned              in_table_size = 256);
+    bool                        classified() const;
+
+    unsigned                    occupancy_level_count() const;
+    const occupancy_level&      occupancy(unsigned in_level = 0) const;
+    bool                        occupied(const math::vec3ui& in_brick, unsigned in_level = 0) const;
+    scm::size_t                 occupied_brick_count() const;
+
+    // export of an occupancy level as a FORMAT_R_8 3d texture for the GPU ray casters
+    texture_3d_ptr              create_occupancy_texture(render_device& in_device,
+                                                         unsigned       in_level = 0) const;
+    bool                        update_occupancy_texture(render_context&       in_context,
+                                                         const texture_3d_ptr& in_texture,
+                                                         unsigned              in_level = 0) const;
+
+protected:
+    void                        build_octree_levels();
+    void                        update_octree_levels();
+
+protected:
+    unsigned                        _brick_size;
+    math::vec3ui                    _volume_dimensions;
+    math::vec3ui                    _grid_dimensions;
+    std::vector<math::vec2f>        _min_max;
+
+    bool                            _build_octree;
+    std::vector<occupancy_level>    _occupancy_levels;
+    scm::size_t                     _occupied_brick_count;
+
+    bool                            _classified;
+    math::vec3f                     _classification_range; // min, max value, table size
+
+}; // class volume_brick_grid
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_BRICK_GRID_H_INCLUDED
@@ -41,6 +41,7 @@
 #include <scm/gl_util/data/volume/volume_reader_raw.h>
 #include <scm/gl_util/data/volume/volume_reader_segy.h>
 #include <scm/gl_util/data/volume/volume_reader_vgeo.h>
+#include <scm/gl_util/data/volume/volume_brick_grid.h>
 
 #include <scm/gl_util/data/imaging/texture_image_data.h>
 
@@ -126,6 +127,26 @@ volume_loader::load_texture_3d(render_device&       in_device,
 texture_3d_ptr
 volume_loader::load_volume_data(render_device&      in_device,
 								const std::string&  in_image_path)
+{
+    return load_volume_data(in_device, in_image_path, 0, 0, false);
+}
+
+texture_3d_ptr
+volume_loader::load_volume_data(render_device&       in_device,
+                                const std::string&   in_image_path,
+                                volume_brick_grid&   out_brick_grid,
+                                unsigned             in_brick_size,
+                                bool                 in_build_octree)
+{
+    return load_volume_data(in_device, in_image_path, &out_brick_grid, in_brick_size, in_build_octree);
+}
+
+texture_3d_ptr
+volume_loader::load_volume_data(render_device&       in_device,
+                                const std::string&   in_image_path,
+                                volume_brick_grid*   out_brick_grid,
+                                unsigned             in_brick_size,
+                                bool                 in_build_octree)
 {
     using namespace scm::gl;
     using namespace scm::math;
@@ -158,13 +179,13 @@ volume_loader::load_volume_data(render_device&      in_device,
     }
     else {
         err() << log::error
-              << "volume_data::load_volume(): unable to open file ('" << in_image_path << "')." << log::end;
+              << "volume_loader::load_volume_data(): unable to open file ('" << in_image_path << "')." << log::end;
         return texture_3d_ptr();
     }
 
     if (!(*vol_reader)) {
         err() << log::error
-                << "volume_data::load_volume(): unable to open file ('" << in_image_path << "')." << log::end;
+              << "volume_loader::load_volume_data(): unable to open file ('" << in_image_path << "')." << log::end;
         return texture_3d_ptr();
     }
     out() << "source data dimensions: " << vol_reader->dimensions() << log::end;
@@ -186,7 +207,7 @@ volume_loader::load_volume_data(render_device&      in_device,
     timer.start();
     if (!vol_reader->read(data_offset, data_dimensions, read_buffer.get())) {
         err() << log::error
-                << "volume_data::load_volume(): unable to read data from file ('" << in_image_path << "')." << log::end;
+              << "volume_loader::load_volume_data(): unable to read data from file ('" << in_image_path << "')." << log::end;
         return texture_3d_ptr();
     }
     timer.stop();
@@ -195,6 +216,20 @@ volume_loader::load_volume_data(render_device&      in_device,
           << time::to_seconds(timer.get_time()) << "s, "
           << (static_cast<double>(read_buffer_size) / (1024.0*1024.0)) / time::to_seconds(timer.get_time()) << "MiB/s)" << log::end;
 
+    if (out_brick_grid) {
+        out() << "building empty space skipping brick grid (brick size: " << in_brick_size << ")..." << log::end;
+        timer.start();
+        if (!out_brick_grid->build(data_dimensions, data_format, read_buffer.get(), in_brick_size, in_build_octree)) {
+            err() << log::warning
+                  << "volume_loader::load_volume_data(): unable to build brick grid ('" << in_image_path << "')." << log::end;
+        }
+        timer.stop();
+        out() << "building empty space skipping brick grid done"
+              << " (grid dimensions: " << out_brick_grid->grid_dimensions()
+              << ", elapsed time: " << std::fixed << std::setprecision(3)
+              << time::to_seconds(timer.get_time()) << "s)" << log::end;
+    }
+
     //_min_value = 0.0f;
     //_max_value = 1.0f;
     //if (is_float_type(data_format)) {
@@ -299,13 +334,13 @@ volume_loader::read_dimensions(const std::string&  in_image_path)
 	}
 	else {
 		err() << log::error
-			<< "volume_data::load_volume(): unable to open file ('" << in_image_path << "')." << log::end;
+			<< "volume_loader::read_dimensions(): unable to open file ('" << in_image_path << "')." << log::end;
 		return scm::math::vec3ui::zero();
 	}
 
 	if (!(*vol_reader)) {
 		err() << log::error
-			<< "volume_data::load_volume(): unable to open file ('" << in_image_path << "')." << log::end;
+			<< "volume_loader::read_dimensions(): unable to open file ('" << in_image_path << "')." << log::end;
 		return scm::math::vec3ui::zero();
 	}
 	//out() << "source data dimensions: " << vol_reader->dimensions() << log::end;
@@ -316,6 +351,84 @@ volume_loader::read_dimensions(const std::string&  in_image_path)
 	return data_dimensions;
 }
 
+shared_ptr<volume_reader>
+volume_loader::open_volume_reader(const std::string& in_volume_path)
+{
+    using namespace boost::filesystem;
+
+    path                    file_path(in_volume_path);
+    std::string             file_extension  = file_path.extension().string();
+
+    boost::algorithm::to_lower(file_extension);
+
+    shared_ptr<volume_reader> vol_reader;
+
+    if (file_extension == ".raw") {
+        vol_reader.reset(new volume_reader_raw(file_path.string(), false));
+    }
+    else if (file_extension == ".vol") {
+        vol_reader.reset(new volume_reader_vgeo(file_path.string(), true));
+    }
+    else if (file_extension == ".segy" || file_extension == ".sgy") {
+        vol_reader.reset(new volume_reader_segy(file_path.string(), true));
+    }
+    else {
+        err() << log::error
+              << "volume_loader::open_volume_reader(): unsupported volume file format ('" << file_extension << "')." << log::end;
+        return shared_ptr<volume_reader>();
+    }
+
+    if (!(*vol_reader)) {
+        err() << log::error
+              << "volume_loader::open_volume_reader(): unable to open file ('" << in_volume_path << "')." << log::end;
+        return shared_ptr<volume_reader>();
+    }
+
+    return vol_reader;
+}
+
+bool
+volume_loader::read_volume_data(const std::string&                in_volume_path,
+                                scm::math::vec3ui&                out_dimensions,
+                                data_format&                      out_format,
+                                scm::shared_array<unsigned char>& out_data)
+{
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    shared_ptr<gl::volume_reader> vol_reader = open_volume_reader(in_volume_path);
+
+    if (!vol_reader) {
+        return false;
+    }
+
+    const vec3ui        data_dimensions = vol_reader->dimensions();
+    const data_format   volume_format   = vol_reader->format();
+
+    if (volume_format == FORMAT_NULL) {
+        err() << log::error
+              << "volume_loader::read_volume_data(): unable to determine volume data format ('" << in_volume_path << "')." << log::end;
+        return false;
+    }
+
+    scm::size_t read_buffer_size =   static_cast<scm::size_t>(data_dimensions.x) * data_dimensions.y * data_dimensions.z
+                                   * size_of_format(volume_format);
+
+    scm::shared_array<unsigned char> read_buffer(new unsigned char[read_buffer_size]);
+
+    if (!vol_reader->read(vec3ui(0u), data_dimensions, read_buffer.get())) {
+        err() << log::error
+              << "volume_loader::read_volume_data(): unable to read data from file ('" << in_volume_path << "')." << log::end;
+        return false;
+    }
+
+    out_dimensions = data_dimensions;
+    out_format     = volume_format;
+    out_data       = read_buffer;
+
+    return true;
+}
+
 } // namespace gl
 } // namespace scm
 
@@ -22,6 +22,9 @@
 namespace scm {
 namespace gl {
 
+class volume_brick_grid;
+class volume_reader;
+
 class __scm_export(gl_util) volume_loader
 {
 
@@ -35,9 +38,32 @@ public:
 
 	texture_3d_ptr              load_volume_data(render_device&       in_device,
 											     const std::string&  in_volume_path);
+    // additionally builds the empty space skipping brick grid from the loaded data
+    texture_3d_ptr              load_volume_data(render_device&       in_device,
+                                                 const std::string&   in_volume_path,
+                                                 volume_brick_grid&   out_brick_grid,
+                                                 unsigned             in_brick_size = 16,
+                                                 bool                 in_build_octree = true);
 
 	scm::math::vec3ui			read_dimensions(const std::string&  in_volume_path);
 
+    // create the volume reader matching the file extension (.raw, .vol, .segy, .sgy)
+    shared_ptr<volume_reader>   open_volume_reader(const std::string& in_volume_path);
+
+    // read the complete volume into system memory without requiring a render device
+    // (e.g. for software rendering or data analysis)
+    bool                        read_volume_data(const std::string&                in_volume_path,
+                                                 scm::math::vec3ui&                out_dimensions,
+                                                 data_format&                      out_format,
+                                                 scm::shared_array<unsigned char>& out_data);
+
+protected:
+    texture_3d_ptr              load_volume_data(render_device&       in_device,
+                                                 const std::string&   in_volume_path,
+                                                 volume_brick_grid*   out_brick_grid,
+                                                 unsigned             in_brick_size,
+                                                 bool                 in_build_octree);
+
 }; // class volume_loader
 
 } // namespace gl
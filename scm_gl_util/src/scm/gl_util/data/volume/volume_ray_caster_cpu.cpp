@@ -0,0 +1,843 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "volume_ray_caster_cpu.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+
+#include <boost/bind.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <scm/log.h>
+#include <scm/concurrency.h>
+#include <scm/core/time/high_res_timer.h>
+
+#include <scm/gl_core/primitives/ray.h>
+
+#include <scm/gl_util/data/analysis/transfer_function/build_lookup_table.h>
+#include <scm/gl_util/data/volume/volume_loader.h>
+
+namespace scm {
+namespace gl {
+
+namespace {
+
+const float early_ray_termination_alpha = 0.99f;
+
+inline
+float
+clamp_value(const float v, const float lo, const float hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+inline
+scm::uint8
+to_unorm8(const float v)
+{
+    return static_cast<scm::uint8>(clamp_value(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+inline
+math::vec3ui
+parent_node(const math::vec3ui& n, const unsigned levels)
+{
+    return math::vec3ui(n.x >> levels, n.y >> levels, n.z >> levels);
+}
+
+} // namespace
+
+struct volume_ray_caster_cpu::render_setup
+{
+    math::mat4f                 _mvp_matrix_inverse;
+    math::vec2ui                _image_size;
+    math::vec2f                 _image_size_rcp;
+    unsigned                    _tiles_x;
+    unsigned                    _tiles_y;
+
+    float                       _sample_distance;       // object space
+    math::vec3f                 _voxel_scale;           // object space to voxel space
+
+    float                       _value_offset;
+    float                       _value_scale;
+
+    bool                        _skip_empty_space;
+
+    // opacity corrected color alpha table, the correction is applied to the
+    // table entries instead of each interpolated sample
+    std::vector<math::vec4f>    _color_alpha_table;
+    float                       _table_scale;
+    float                       _table_max;
+
+    // pre-integrated table (premultiplied, table size^2 entries, back value rows), 0 if disabled
+    const math::vec4f*          _preintegrated_table;
+}; // struct volume_ray_caster_cpu::render_setup
+
+struct volume_ray_caster_cpu::tile_queue
+{
+    tile_queue() : _begin(0), _end(0) {}
+
+    // the owning worker takes tiles from the front, thieves from the back
+    bool pop_front(unsigned& out_tile) {
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_begin < _end) {
+            out_tile = _begin++;
+            return true;
+        }
+        return false;
+    }
+    bool pop_back(unsigned& out_tile) {
+        boost::mutex::scoped_lock lock(_mutex);
+        if (_begin < _end) {
+            out_tile = --_end;
+            return true;
+        }
+        return false;
+    }
+
+    boost::mutex                _mutex;
+    unsigned                    _begin;
+    unsigned                    _end;
+}; // struct volume_ray_caster_cpu::tile_queue
+
+volume_ray_caster_cpu::volume_ray_caster_cpu(unsigned in_thread_count,
+                                             unsigned in_tile_size)
+  : _thread_count(in_thread_count)
+  , _tile_size(in_tile_size)
+  , _data_dimensions(0u)
+  , _extends(0.0f)
+  , _transform(math::mat4f::identity())
+  , _min_value(0.0f)
+  , _max_value(1.0f)
+  , _sample_distance_factor(1.0f)
+  , _sample_distance_ref_factor(1.0f)
+  , _empty_space_skipping(true)
+  , _brick_grid_dirty(true)
+  , _preintegration(false)
+  , _preintegrated_table_ratio(0.0f)
+  , _image_size(0u)
+{
+    if (_thread_count == 0) {
+        concurrency::task_scheduler* scheduler = concurrency::default_scheduler();
+        _thread_count = scheduler ? scheduler->thread_count() + 1 : 1;
+    }
+    // tiles are traced in full packets per row
+    _tile_size = (std::max)(packet_size, ((_tile_size + packet_size - 1) / packet_size) * packet_size);
+}
+
+volume_ray_caster_cpu::~volume_ray_caster_cpu()
+{
+}
+
+bool
+volume_ray_caster_cpu::volume(const std::string& in_volume_path)
+{
+    math::vec3ui                        data_dimensions;
+    data_format                         volume_format = FORMAT_NULL;
+    scm::shared_array<unsigned char>    volume_data;
+
+    volume_loader vl;
+    if (!vl.read_volume_data(in_volume_path, data_dimensions, volume_format, volume_data)) {
+        err() << log::error
+              << "volume_ray_caster_cpu::volume(): unable to read volume data ('" << in_volume_path << "')." << log::end;
+        return false;
+    }
+
+    return volume(data_dimensions, volume_format, volume_data.get());
+}
+
+bool
+volume_ray_caster_cpu::volume(const math::vec3ui& in_dimensions,
+                              const data_format   in_format,
+                              const void*         in_data)
+{
+    using namespace scm::math;
+
+    if (   in_dimensions.x == 0 || in_dimensions.y == 0 || in_dimensions.z == 0
+        || in_data == 0) {
+        err() << log::error
+              << "volume_ray_caster_cpu::volume(): invalid volume data (dimensions: " << in_dimensions << ")." << log::end;
+        return false;
+    }
+
+    const scm::size_t voxel_count = static_cast<scm::size_t>(in_dimensions.x) * in_dimensions.y * in_dimensions.z;
+
+    // convert to normalized values, the same values the GPU path samples from the volume texture
+    std::vector<float> volume_data(voxel_count);
+    switch (in_format) {
+        case FORMAT_R_8: {
+                const scm::uint8* src = static_cast<const scm::uint8*>(in_data);
+                for (scm::size_t i = 0; i < voxel_count; ++i) {
+                    volume_data[i] = static_cast<float>(src[i]) / 255.0f;
+                }
+            } break;
+        case FORMAT_R_16: {
+                const scm::uint16* src = static_cast<const scm::uint16*>(in_data);
+                for (scm::size_t i = 0; i < voxel_count; ++i) {
+                    volume_data[i] = static_cast<float>(src[i]) / 65535.0f;
+                }
+            } break;
+        case FORMAT_R_32F: {
+                const float* src = static_cast<const float*>(in_data);
+                std::copy(src, src + voxel_count, volume_data.begin());
+            } break;
+        default:
+            err() << log::error
+                  << "volume_ray_caster_cpu::volume(): unsupported volume data format (" << format_string(in_format) << ")." << log::end;
+            return false;
+    }
+
+    _volume_data.swap(volume_data);
+    _data_dimensions = in_dimensions;
+
+    const float max_dim = static_cast<float>(max(max(_data_dimensions.x, _data_dimensions.y), _data_dimensions.z));
+    _extends         = vec3f(_data_dimensions) / max_dim;
+    _bbox            = gl::box(vec3f(0.0f), _extends);
+
+    if (!_brick_grid.build(_data_dimensions, FORMAT_R_32F, &_volume_data.front(), 16, true, _thread_count)) {
+        err() << log::warning
+              << "volume_ray_caster_cpu::volume(): unable to build brick grid, empty space skipping disabled." << log::end;
+    }
+    _brick_grid_dirty = true;
+
+    return true;
+}
+
+const math::vec3ui&
+volume_ray_caster_cpu::data_dimensions() const
+{
+    return _data_dimensions;
+}
+
+const math::vec3f&
+volume_ray_caster_cpu::extends() const
+{
+    return _extends;
+}
+
+const gl::box&
+volume_ray_caster_cpu::bbox() const
+{
+    return _bbox;
+}
+
+const math::mat4f&
+volume_ray_caster_cpu::transform() const
+{
+    return _transform;
+}
+
+void
+volume_ray_caster_cpu::transform(const math::mat4f& in_transform)
+{
+    _transform = in_transform;
+}
+
+float
+volume_ray_caster_cpu::min_value() const
+{
+    return _min_value;
+}
+
+float
+volume_ray_caster_cpu::max_value() const
+{
+    return _max_value;
+}
+
+void
+volume_ray_caster_cpu::value_range(float in_min_value, float in_max_value)
+{
+    _min_value = in_min_value;
+    _max_value = in_max_value;
+    _brick_grid_dirty = true;
+}
+
+float
+volume_ray_caster_cpu::sample_distance_factor() const
+{
+    return _sample_distance_factor;
+}
+
+void
+volume_ray_caster_cpu::sample_distance_factor(float in_factor)
+{
+    _sample_distance_factor = in_factor;
+}
+
+float
+volume_ray_caster_cpu::sample_distance_ref_factor() const
+{
+    return _sample_distance_ref_factor;
+}
+
+void
+volume_ray_caster_cpu::sample_distance_ref_factor(float in_factor)
+{
+    _sample_distance_ref_factor = in_factor;
+}
+
+bool
+volume_ray_caster_cpu::transfer_function(const color_map_type& in_color_map,
+                                         const alpha_map_type& in_alpha_map,
+                                         unsigned              in_table_size)
+{
+    using namespace scm::math;
+
+    if (in_table_size == 0) {
+        err() << log::error
+              << "volume_ray_caster_cpu::transfer_function(): invalid lookup table size." << log::end;
+        return false;
+    }
+
+    boost::scoped_array<vec3f>  color_lut(new vec3f[in_table_size]);
+    boost::scoped_array<float>  alpha_lut(new float[in_table_size]);
+
+    if (   !scm::data::build_lookup_table(color_lut, in_color_map, in_table_size)
+        || !scm::data::build_lookup_table(alpha_lut, in_alpha_map, in_table_size)) {
+        err() << log::error
+              << "volume_ray_caster_cpu::transfer_function(): error generating color alpha lookup table." << log::end;
+        return false;
+    }
+
+    _color_alpha_table.resize(in_table_size);
+    for (unsigned i = 0; i < in_table_size; ++i) {
+        _color_alpha_table[i] = vec4f(color_lut[i], alpha_lut[i]);
+    }
+    _brick_grid_dirty          = true;
+    _preintegrated_table_ratio = 0.0f;
+
+    return true;
+}
+
+bool
+volume_ray_caster_cpu::empty_space_skipping() const
+{
+    return _empty_space_skipping;
+}
+
+void
+volume_ray_caster_cpu::empty_space_skipping(bool in_enable)
+{
+    _empty_space_skipping = in_enable;
+}
+
+const volume_brick_grid&
+volume_ray_caster_cpu::brick_grid() const
+{
+    return _brick_grid;
+}
+
+bool
+volume_ray_caster_cpu::preintegration() const
+{
+    return _preintegration;
+}
+
+void
+volume_ray_caster_cpu::preintegration(bool in_enable)
+{
+    _preintegration = in_enable;
+}
+
+unsigned
+volume_ray_caster_cpu::thread_count() const
+{
+    return _thread_count;
+}
+
+unsigned
+volume_ray_caster_cpu::tile_size() const
+{
+    return _tile_size;
+}
+
+bool
+volume_ray_caster_cpu::render(const math::mat4f&  in_view_matrix,
+                              const math::mat4f&  in_projection_matrix,
+                              const math::vec2ui& in_image_size)
+{
+    using namespace scm::math;
+
+    if (_volume_data.empty()) {
+        err() << log::error
+              << "volume_ray_caster_cpu::render(): no volume data." << log::end;
+        return false;
+    }
+    if (_color_alpha_table.empty()) {
+        err() << log::error
+              << "volume_ray_caster_cpu::render(): no transfer function." << log::end;
+        return false;
+    }
+    if (in_image_size.x == 0 || in_image_size.y == 0) {
+        err() << log::error
+              << "volume_ray_caster_cpu::render(): invalid image size (" << in_image_size << ")." << log::end;
+        return false;
+    }
+
+    time::high_res_timer timer;
+    timer.start();
+
+    const float max_dim = static_cast<float>(max(max(_data_dimensions.x, _data_dimensions.y), _data_dimensions.z));
+
+    render_setup setup;
+    setup._mvp_matrix_inverse = inverse(in_projection_matrix * in_view_matrix * _transform);
+    setup._image_size         = in_image_size;
+    setup._image_size_rcp     = vec2f(1.0f) / vec2f(in_image_size);
+    setup._tiles_x            = (in_image_size.x + _tile_size - 1) / _tile_size;
+    setup._tiles_y            = (in_image_size.y + _tile_size - 1) / _tile_size;
+    setup._sample_distance    = _sample_distance_factor / max_dim;
+    setup._voxel_scale        = vec3f(_data_dimensions) / _extends;
+    setup._value_offset       = _min_value;
+    // an empty value range maps all samples to the first table entry
+    setup._value_scale        = (_max_value != _min_value) ? 1.0f / (_max_value - _min_value) : 0.0f;
+    setup._skip_empty_space   = _empty_space_skipping && !_brick_grid.empty();
+
+    if (setup._skip_empty_space && _brick_grid_dirty) {
+        std::vector<float> alpha_table(_color_alpha_table.size());
+        for (scm::size_t i = 0; i < _color_alpha_table.size(); ++i) {
+            alpha_table[i] = _color_alpha_table[i].w;
+        }
+        _brick_grid.classify(&alpha_table.front(), static_cast<unsigned>(alpha_table.size()),
+                             setup._value_offset, setup._value_scale);
+        _brick_grid_dirty = false;
+    }
+
+    const float opacity_correction = _sample_distance_factor / _sample_distance_ref_factor;
+    setup._color_alpha_table.resize(_color_alpha_table.size());
+    for (scm::size_t i = 0; i < _color_alpha_table.size(); ++i) {
+        const vec4f& c = _color_alpha_table[i];
+        setup._color_alpha_table[i] = vec4f(c.x, c.y, c.z, 1.0f - std::pow(1.0f - c.w, opacity_correction));
+    }
+    setup._table_scale = static_cast<float>(_color_alpha_table.size());
+    setup._table_max   = static_cast<float>(_color_alpha_table.size() - 1);
+
+    setup._preintegrated_table = 0;
+    if (_preintegration) {
+        if (_preintegrated_table_ratio != opacity_correction) {
+            const unsigned table_size = static_cast<unsigned>(_color_alpha_table.size());
+
+            std::vector<vec3f> color_table(table_size);
+            std::vector<float> alpha_table(table_size);
+            for (unsigned i = 0; i < table_size; ++i) {
+                color_table[i] = vec3f(_color_alpha_table[i]);
+                alpha_table[i] = _color_alpha_table[i].w;
+            }
+            boost::scoped_array<vec4f> preint_table(new vec4f[static_cast<scm::size_t>(table_size) * table_size]);
+            if (!scm::data::build_preintegrated_lookup_table(preint_table, &color_table.front(), &alpha_table.front(),
+                                                             table_size, opacity_correction, _thread_count)) {
+                err() << log::error
+                      << "volume_ray_caster_cpu::render(): error generating pre-integrated lookup table." << log::end;
+                return false;
+            }
+            _preintegrated_table.assign(preint_table.get(), preint_table.get() + static_cast<scm::size_t>(table_size) * table_size);
+            _preintegrated_table_ratio = opacity_correction;
+        }
+        setup._preintegrated_table = &_preintegrated_table.front();
+    }
+
+    _image_size = in_image_size;
+    _rgba_image.resize(static_cast<scm::size_t>(in_image_size.x) * in_image_size.y * 4);
+
+    // distribute contiguous tile ranges to the workers
+    const unsigned tile_count   = setup._tiles_x * setup._tiles_y;
+    const unsigned worker_count = (std::min)(_thread_count, tile_count);
+
+    boost::scoped_array<tile_queue> queues(new tile_queue[worker_count]);
+    std::vector<statistics>         worker_statistics(worker_count);
+    for (unsigned w = 0; w < worker_count; ++w) {
+        queues[w]._begin = (tile_count * w)       / worker_count;
+        queues[w]._end   = (tile_count * (w + 1)) / worker_count;
+    }
+
+    // the calling thread acts as the first worker, without a scheduler it steals all tiles
+    if (concurrency::task_scheduler* scheduler = concurrency::default_scheduler()) {
+        concurrency::task_group workers(*scheduler);
+        for (unsigned w = 1; w < worker_count; ++w) {
+            workers.run(boost::bind(&volume_ray_caster_cpu::render_tiles, this,
+                                    boost::cref(setup), queues.get(), w, boost::ref(worker_statistics[w])));
+        }
+        render_tiles(setup, queues.get(), 0, worker_statistics[0]);
+        workers.wait();
+    }
+    else {
+        render_tiles(setup, queues.get(), 0, worker_statistics[0]);
+    }
+
+    _statistics = statistics();
+    for (unsigned w = 0; w < worker_count; ++w) {
+        _statistics._rays               += worker_statistics[w]._rays;
+        _statistics._samples            += worker_statistics[w]._samples;
+        _statistics._skipped_samples    += worker_statistics[w]._skipped_samples;
+        _statistics._early_terminations += worker_statistics[w]._early_terminations;
+        _statistics._stolen_tiles       += worker_statistics[w]._stolen_tiles;
+    }
+
+    timer.stop();
+    _statistics._render_time = time::to_seconds(timer.get_time());
+
+    return true;
+}
+
+const math::vec2ui&
+volume_ray_caster_cpu::image_size() const
+{
+    return _image_size;
+}
+
+const volume_ray_caster_cpu::rgba_image_type&
+volume_ray_caster_cpu::rgba_image() const
+{
+    return _rgba_image;
+}
+
+const volume_ray_caster_cpu::statistics&
+volume_ray_caster_cpu::render_statistics() const
+{
+    return _statistics;
+}
+
+void
+volume_ray_caster_cpu::render_tiles(const render_setup& in_setup,
+                                    tile_queue*         in_queues,
+                                    unsigned            in_worker,
+                                    statistics&         out_statistics)
+{
+    const unsigned worker_count = (std::min)(_thread_count, in_setup._tiles_x * in_setup._tiles_y);
+
+    unsigned tile = 0;
+    while (in_queues[in_worker].pop_front(tile)) {
+        render_tile(in_setup, tile, out_statistics);
+    }
+
+    // own range exhausted, steal from the back of the other workers ranges
+    for (unsigned v = 1; v < worker_count; ++v) {
+        tile_queue& victim = in_queues[(in_worker + v) % worker_count];
+        while (victim.pop_back(tile)) {
+            render_tile(in_setup, tile, out_statistics);
+            ++out_statistics._stolen_tiles;
+        }
+    }
+}
+
+void
+volume_ray_caster_cpu::render_tile(const render_setup& in_setup,
+                                   unsigned            in_tile,
+                                   statistics&         out_statistics)
+{
+    const unsigned tile_x = (in_tile % in_setup._tiles_x) * _tile_size;
+    const unsigned tile_y = (in_tile / in_setup._tiles_x) * _tile_size;
+    const unsigned end_x  = (std::min)(tile_x + _tile_size, in_setup._image_size.x);
+    const unsigned end_y  = (std::min)(tile_y + _tile_size, in_setup._image_size.y);
+
+    for (unsigned y = tile_y; y < end_y; ++y) {
+        for (unsigned x = tile_x; x < end_x; x += packet_size) {
+            trace_packet(in_setup, x, y, (std::min)(packet_size, end_x - x), out_statistics);
+        }
+    }
+}
+
+void
+volume_ray_caster_cpu::trace_packet(const render_setup& in_setup,
+                                    unsigned            in_x,
+                                    unsigned            in_y,
+                                    unsigned            in_count,
+                                    statistics&         out_statistics)
+{
+    using namespace scm::math;
+
+    // packet state in structure of arrays layout, the per sample arithmetic runs
+    // over all lanes with inactive lanes masked out
+    scm_align(32) float pos_x[packet_size];
+    scm_align(32) float pos_y[packet_size];
+    scm_align(32) float pos_z[packet_size];
+    scm_align(32) float inc_x[packet_size];
+    scm_align(32) float inc_y[packet_size];
+    scm_align(32) float inc_z[packet_size];
+    scm_align(32) float dst_r[packet_size];
+    scm_align(32) float dst_g[packet_size];
+    scm_align(32) float dst_b[packet_size];
+    scm_align(32) float dst_a[packet_size];
+    scm_align(32) float src_r[packet_size];
+    scm_align(32) float src_g[packet_size];
+    scm_align(32) float src_b[packet_size];
+    scm_align(32) float src_a[packet_size];
+    scm_align(32) float src_w[packet_size];         // color weight, 1 for premultiplied samples
+    scm_align(32) float front[packet_size];         // pre-integration front table coordinate, < 0: none
+    scm_align(32) float active[packet_size];
+    scm_align(32) float opaque[packet_size];
+    int                 steps[packet_size];
+
+    unsigned active_count = 0;
+
+    // ray setup, entry and exit points through the volume bounding box
+    for (unsigned l = 0; l < packet_size; ++l) {
+        dst_r[l] = dst_g[l] = dst_b[l] = dst_a[l] = 0.0f;
+        pos_x[l] = pos_y[l] = pos_z[l] = 0.0f;
+        inc_x[l] = inc_y[l] = inc_z[l] = 0.0f;
+        steps[l]  = 0;
+        front[l]  = -1.0f;
+        active[l] = 0.0f;
+
+        if (l >= in_count) {
+            continue;
+        }
+
+        const float ndc_x = (static_cast<float>(in_x + l) + 0.5f) * in_setup._image_size_rcp.x * 2.0f - 1.0f;
+        const float ndc_y = (static_cast<float>(in_y)     + 0.5f) * in_setup._image_size_rcp.y * 2.0f - 1.0f;
+
+        vec4f near_pos = in_setup._mvp_matrix_inverse * vec4f(ndc_x, ndc_y, -1.0f, 1.0f);
+        vec4f far_pos  = in_setup._mvp_matrix_inverse * vec4f(ndc_x, ndc_y,  1.0f, 1.0f);
+        const vec3f ray_org = vec3f(near_pos) / near_pos.w;
+        const vec3f ray_end = vec3f(far_pos)  / far_pos.w;
+
+        const ray   r(ray_org, ray_end - ray_org);
+        vec3f       entry;
+        vec3f       exit;
+
+        if (_bbox.classify(ray_org) == gl::box::inside) {
+            // intersect reports no hit for origins inside the box, the exit point is still valid
+            _bbox.intersect(r, entry, exit);
+            entry = ray_org;
+        }
+        else if (!_bbox.intersect(r, entry, exit)) {
+            continue;
+        }
+
+        const vec3f ray_increment = r.direction() * in_setup._sample_distance;
+        const int   sample_count  = static_cast<int>(std::floor(length(exit - entry) / in_setup._sample_distance));
+
+        ++out_statistics._rays;
+
+        if (sample_count <= 0) {
+            continue;
+        }
+
+        // first sample one increment into the volume like the GPU ray caster
+        pos_x[l] = entry.x + ray_increment.x;
+        pos_y[l] = entry.y + ray_increment.y;
+        pos_z[l] = entry.z + ray_increment.z;
+        inc_x[l] = ray_increment.x;
+        inc_y[l] = ray_increment.y;
+        inc_z[l] = ray_increment.z;
+        steps[l]  = sample_count;
+        active[l] = 1.0f;
+        ++active_count;
+    }
+
+    const vec4f*const cat        = &in_setup._color_alpha_table.front();
+    const vec4f*const pit        = in_setup._preintegrated_table;
+    const int         table_size = static_cast<int>(in_setup._color_alpha_table.size());
+
+    while (active_count > 0) {
+        // sampling and classification (gathers, scalar per lane)
+        for (unsigned l = 0; l < packet_size; ++l) {
+            if (active[l] == 0.0f) {
+                src_r[l] = src_g[l] = src_b[l] = src_a[l] = src_w[l] = 0.0f;
+                continue;
+            }
+            if (in_setup._skip_empty_space) {
+                // advance to the last sample inside the empty node, the regular ray
+                // advance below then steps out of it without compositing
+                const int skip = (std::min)(steps[l],
+                                            empty_space_steps(pos_x[l] * in_setup._voxel_scale.x,
+                                                              pos_y[l] * in_setup._voxel_scale.y,
+                                                              pos_z[l] * in_setup._voxel_scale.z,
+                                                              inc_x[l] * in_setup._voxel_scale.x,
+                                                              inc_y[l] * in_setup._voxel_scale.y,
+                                                              inc_z[l] * in_setup._voxel_scale.z));
+                if (skip > 0) {
+                    const float s = static_cast<float>(skip - 1);
+                    pos_x[l] += inc_x[l] * s;
+                    pos_y[l] += inc_y[l] * s;
+                    pos_z[l] += inc_z[l] * s;
+                    steps[l] -= skip - 1;
+                    front[l]  = -1.0f;
+                    src_r[l] = src_g[l] = src_b[l] = src_a[l] = src_w[l] = 0.0f;
+                    out_statistics._skipped_samples += skip;
+                    continue;
+                }
+            }
+            ++out_statistics._samples;
+            const float v = (sample_volume(pos_x[l] * in_setup._voxel_scale.x,
+                                           pos_y[l] * in_setup._voxel_scale.y,
+                                           pos_z[l] * in_setup._voxel_scale.z)
+                             - in_setup._value_offset) * in_setup._value_scale;
+
+            // linear filtered table lookup matching a 1d texture with clamp to edge
+            const float t  = clamp_value(v * in_setup._table_scale - 0.5f, 0.0f, in_setup._table_max);
+            const int   i0 = static_cast<int>(t);
+            const int   i1 = (std::min)(i0 + 1, static_cast<int>(in_setup._table_max));
+            const float f  = t - static_cast<float>(i0);
+
+            if (pit != 0) {
+                // bilinear lookup of the segment from the previous sample, the first segment
+                // of a ray (or after skipped space) degenerates to the current sample
+                const float tf = front[l] < 0.0f ? t : front[l];
+                const int   j0 = static_cast<int>(tf);
+                const int   j1 = (std::min)(j0 + 1, static_cast<int>(in_setup._table_max));
+                const float g  = tf - static_cast<float>(j0);
+                const vec4f c  = lerp(lerp(pit[i0 * table_size + j0], pit[i0 * table_size + j1], g),
+                                      lerp(pit[i1 * table_size + j0], pit[i1 * table_size + j1], g), f);
+                front[l] = t;
+
+                src_r[l] = c.x;
+                src_g[l] = c.y;
+                src_b[l] = c.z;
+                src_a[l] = c.w;
+                src_w[l] = 1.0f;
+            }
+            else {
+                const vec4f c  = lerp(cat[i0], cat[i1], f);
+
+                src_r[l] = c.x;
+                src_g[l] = c.y;
+                src_b[l] = c.z;
+                src_a[l] = c.w;
+                src_w[l] = c.w;
+            }
+        }
+
+        // ray termination, the early termination test uses the opacity before compositing
+        // the current sample like the GPU ray caster
+        for (unsigned l = 0; l < packet_size; ++l) {
+            opaque[l] = dst_a[l] >= early_ray_termination_alpha ? 1.0f : 0.0f;
+        }
+
+        // front-to-back compositing and ray advance over all lanes
+        for (unsigned l = 0; l < packet_size; ++l) {
+            const float omda    = (1.0f - dst_a[l]) * active[l];
+            const float omda_sw = omda * src_w[l];
+            dst_r[l] += omda_sw * src_r[l];
+            dst_g[l] += omda_sw * src_g[l];
+            dst_b[l] += omda_sw * src_b[l];
+            dst_a[l] += omda * src_a[l];
+
+            pos_x[l] += inc_x[l] * active[l];
+            pos_y[l] += inc_y[l] * active[l];
+            pos_z[l] += inc_z[l] * active[l];
+        }
+
+        for (unsigned l = 0; l < packet_size; ++l) {
+            if (active[l] == 0.0f) {
+                continue;
+            }
+            if (--steps[l] <= 0) {
+                active[l] = 0.0f;
+                --active_count;
+            }
+            else if (opaque[l] != 0.0f) {
+                ++out_statistics._early_terminations;
+                active[l] = 0.0f;
+                --active_count;
+            }
+        }
+    }
+
+    // write out the packet
+    scm::uint8* dst = &_rgba_image[(static_cast<scm::size_t>(in_y) * in_setup._image_size.x + in_x) * 4];
+    for (unsigned l = 0; l < in_count; ++l) {
+        dst[l * 4 + 0] = to_unorm8(dst_r[l]);
+        dst[l * 4 + 1] = to_unorm8(dst_g[l]);
+        dst[l * 4 + 2] = to_unorm8(dst_b[l]);
+        dst[l * 4 + 3] = to_unorm8(dst_a[l]);
+    }
+}
+
+float
+volume_ray_caster_cpu::sample_volume(const float in_x, const float in_y, const float in_z) const
+{
+    // trilinear filtering with clamp to edge, voxel centers at integer + 0.5
+    const float max_x = static_cast<float>(_data_dimensions.x - 1);
+    const float max_y = static_cast<float>(_data_dimensions.y - 1);
+    const float max_z = static_cast<float>(_data_dimensions.z - 1);
+
+    const float x = clamp_value(in_x - 0.5f, 0.0f, max_x);
+    const float y = clamp_value(in_y - 0.5f, 0.0f, max_y);
+    const float z = clamp_value(in_z - 0.5f, 0.0f, max_z);
+
+    const unsigned x0 = static_cast<unsigned>(x);
+    const unsigned y0 = static_cast<unsigned>(y);
+    const unsigned z0 = static_cast<unsigned>(z);
+    const unsigned x1 = (std::min)(x0 + 1, _data_dimensions.x - 1);
+    const unsigned y1 = (std::min)(y0 + 1, _data_dimensions.y - 1);
+    const unsigned z1 = (std::min)(z0 + 1, _data_dimensions.z - 1);
+
+    const float fx = x - static_cast<float>(x0);
+    const float fy = y - static_cast<float>(y0);
+    const float fz = z - static_cast<float>(z0);
+
+    const scm::size_t sx  = 1;
+    const scm::size_t sy  = _data_dimensions.x;
+    const scm::size_t sz  = static_cast<scm::size_t>(_data_dimensions.x) * _data_dimensions.y;
+
+    const float*const d = &_volume_data.front();
+
+    const float v000 = d[x0 * sx + y0 * sy + z0 * sz];
+    const float v100 = d[x1 * sx + y0 * sy + z0 * sz];
+    const float v010 = d[x0 * sx + y1 * sy + z0 * sz];
+    const float v110 = d[x1 * sx + y1 * sy + z0 * sz];
+    const float v001 = d[x0 * sx + y0 * sy + z1 * sz];
+    const float v101 = d[x1 * sx + y0 * sy + z1 * sz];
+    const float v011 = d[x0 * sx + y1 * sy + z1 * sz];
+    const float v111 = d[x1 * sx + y1 * sy + z1 * sz];
+
+    const float v00 = v000 + (v100 - v000) * fx;
+    const float v10 = v010 + (v110 - v010) * fx;
+    const float v01 = v001 + (v101 - v001) * fx;
+    const float v11 = v011 + (v111 - v011) * fx;
+
+    const float v0  = v00 + (v10 - v00) * fy;
+    const float v1  = v01 + (v11 - v01) * fy;
+
+    return v0 + (v1 - v0) * fz;
+}
+
+int
+volume_ray_caster_cpu::empty_space_steps(const float in_px, const float in_py, const float in_pz,
+                                         const float in_ix, const float in_iy, const float in_iz) const
+{
+    using namespace scm::math;
+
+    // position and increment in voxel space, the bricks cover the voxel space
+    // region [b * brick_size, (b + 1) * brick_size)
+    const float    bs     = static_cast<float>(_brick_grid.brick_size());
+    const vec3ui&  gd     = _brick_grid.grid_dimensions();
+    const vec3ui   brick(min(static_cast<unsigned>(clamp_value(in_px / bs, 0.0f, static_cast<float>(gd.x - 1))), gd.x - 1),
+                         min(static_cast<unsigned>(clamp_value(in_py / bs, 0.0f, static_cast<float>(gd.y - 1))), gd.y - 1),
+                         min(static_cast<unsigned>(clamp_value(in_pz / bs, 0.0f, static_cast<float>(gd.z - 1))), gd.z - 1));
+
+    if (_brick_grid.occupied(brick, 0)) {
+        return 0;
+    }
+
+    // climb the occupancy hierarchy while the parent nodes are empty
+    unsigned level = 0;
+    while (   level + 1 < _brick_grid.occupancy_level_count()
+           && !_brick_grid.occupied(parent_node(brick, level + 1), level + 1)) {
+        ++level;
+    }
+
+    const float  cs = bs * static_cast<float>(1u << level);
+    const vec3f  node_min = vec3f(parent_node(brick, level)) * cs;
+    const vec3f  node_max = node_min + vec3f(cs);
+
+    float t = (std::numeric_limits<float>::max)();
+    if (in_ix > 0.0f)      t = (std::min)(t, (node_max.x - in_px) / in_ix);
+    else if (in_ix < 0.0f) t = (std::min)(t, (node_min.x - in_px) / in_ix);
+    if (in_iy > 0.0f)      t = (std::min)(t, (node_max.y - in_py) / in_iy);
+    else if (in_iy < 0.0f) t = (std::min)(t, (node_min.y - in_py) / in_iy);
+    if (in_iz > 0.0f)      t = (std::min)(t, (node_max.z - in_pz) / in_iz);
+    else if (in_iz < 0.0f) t = (std::min)(t, (node_min.z - in_pz) / in_iz);
+
+    // samples on the node boundary are still covered by the brick border voxels
+    return static_cast<int>(std::floor((std::max)(t, 0.0f))) + 1;
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,181 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_VOLUME_RAY_CASTER_CPU_H_INCLUDED
+#define SCM_GL_UTIL_VOLUME_RAY_CASTER_CPU_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/memory.h>
+
+#include <scm/gl_core/data_formats.h>
+#include <scm/gl_core/primitives/box.h>
+
+#include <scm/gl_util/data/analysis/transfer_function/piecewise_function_1d.h>
+#include <scm/gl_util/data/volume/volume_brick_grid.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// volume_ray_caster_cpu
+//  - software implementation of the ex_volume_ray_cast front-to-back ray caster for
+//    machines without a GPU, the output is meant to be compared against the GPU images
+//  - the volume is placed in object space in [0, extends] (extends = dimensions / max dimension),
+//    sampling, opacity correction and compositing follow the volume_ray_cast shader
+//  - the image is split into tiles rendered by a set of workers running as tasks on the
+//    core task scheduler (core::scheduler()), every worker owns a range of tiles and steals
+//    tiles from the other workers when its range is exhausted
+//  - rays are traced in packets of 8 neighboring pixels (structure of arrays layout),
+//    rays leave the packet on early ray termination or when leaving the volume
+//  - with empty space skipping enabled rays step over the largest empty node of the
+//    brick grid occupancy hierarchy containing the current sample position
+//  - with pre-integration enabled the ray segments between consecutive samples are
+//    classified using a pre-integrated 2d lookup table (rebuilt on transfer function or
+//    sampling distance changes)
+class __scm_export(gl_util) volume_ray_caster_cpu : boost::noncopyable
+{
+public:
+    typedef scm::data::piecewise_function_1d<float, math::vec3f>   color_map_type;
+    typedef scm::data::piecewise_function_1d<float, float>         alpha_map_type;
+
+    typedef std::vector<scm::uint8>                                 rgba_image_type;
+
+    static const unsigned       packet_size = 8;
+
+    struct statistics {
+        statistics() : _rays(0), _samples(0), _skipped_samples(0), _early_terminations(0), _stolen_tiles(0), _render_time(0.0) {}
+        scm::uint64     _rays;
+        scm::uint64     _samples;
+        scm::uint64     _skipped_samples;
+        scm::uint64     _early_terminations;
+        scm::uint64     _stolen_tiles;
+        double          _render_time;           // seconds
+    }; // struct statistics
+
+protected:
+    struct render_setup;
+    struct tile_queue;
+
+public:
+    volume_ray_caster_cpu(unsigned in_thread_count = 0,     // 0: scheduler workers and the calling thread
+                          unsigned in_tile_size    = 32);
+    virtual ~volume_ray_caster_cpu();
+
+    // volume data
+    bool                        volume(const std::string&  in_volume_path);
+    bool                        volume(const math::vec3ui& in_dimensions,
+                                       const data_format   in_format,
+                                       const void*         in_data);
+
+    const math::vec3ui&         data_dimensions() const;
+    const math::vec3f&          extends() const;
+    const gl::box&              bbox() const;
+
+    const math::mat4f&          transform() const;
+    void                        transform(const math::mat4f& in_transform);
+
+    // value range mapped to the transfer function domain [0, 1] (normalized data values)
+    float                       min_value() const;
+    float                       max_value() const;
+    void                        value_range(float in_min_value, float in_max_value);
+
+    // sampling distance in voxels
+    float                       sample_distance_factor() const;
+    void                        sample_distance_factor(float in_factor);
+    float                       sample_distance_ref_factor() const;
+    void                        sample_distance_ref_factor(float in_factor);
+
+    // transfer function, sampled into a lookup table using the same table
+    // generation as the GPU color map textures
+    bool                        transfer_function(const color_map_type& in_color_map,
+                                                  const alpha_map_type& in_alpha_map,
+                                                  unsigned              in_table_size = 256);
+
+    // empty space skipping using a min/max brick grid built from the volume data
+    bool                        empty_space_skipping() const;
+    void                        empty_space_skipping(bool in_enable);
+    const volume_brick_grid&    brick_grid() const;
+
+    // pre-integrated classification of the ray segments
+    bool                        preintegration() const;
+    void                        preintegration(bool in_enable);
+
+    unsigned                    thread_count() const;
+    unsigned                    tile_size() const;
+
+    // render the volume into the RGBA image (premultiplied alpha, 8bit per channel,
+    // rows bottom to top like a frame buffer read back)
+    bool                        render(const math::mat4f&  in_view_matrix,
+                                       const math::mat4f&  in_projection_matrix,
+                                       const math::vec2ui& in_image_size);
+
+    const math::vec2ui&         image_size() const;
+    const rgba_image_type&      rgba_image() const;
+
+    const statistics&           render_statistics() const;
+
+protected:
+    void                        render_tiles(const render_setup& in_setup,
+                                             tile_queue*         in_queues,
+                                             unsigned            in_worker,
+                                             statistics&         out_statistics);
+    void                        render_tile(const render_setup& in_setup,
+                                            unsigned            in_tile,
+                                            statistics&         out_statistics);
+    void                        trace_packet(const render_setup& in_setup,
+                                             unsigned            in_x,
+                                             unsigned            in_y,
+                                             unsigned            in_count,
+                                             statistics&         out_statistics);
+
+    float                       sample_volume(const float in_x, const float in_y, const float in_z) const;
+    int                         empty_space_steps(const float in_px, const float in_py, const float in_pz,
+                                                  const float in_ix, const float in_iy, const float in_iz) const;
+
+protected:
+    unsigned                    _thread_count;
+    unsigned                    _tile_size;
+
+    math::vec3ui                _data_dimensions;
+    math::vec3f                 _extends;
+    gl::box                     _bbox;
+    math::mat4f                 _transform;
+    std::vector<float>          _volume_data;           // normalized values, x fastest
+
+    float                       _min_value;
+    float                       _max_value;
+    float                       _sample_distance_factor;
+    float                       _sample_distance_ref_factor;
+
+    std::vector<math::vec4f>    _color_alpha_table;
+
+    bool                        _empty_space_skipping;
+    volume_brick_grid           _brick_grid;
+    bool                        _brick_grid_dirty;
+
+    bool                        _preintegration;
+    std::vector<math::vec4f>    _preintegrated_table;
+    float                       _preintegrated_table_ratio;     // sampling distance ratio of the table, 0: invalid
+
+    math::vec2ui                _image_size;
+    rgba_image_type             _rgba_image;
+
+    statistics                  _statistics;
+
+}; // class volume_ray_caster_cpu
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_VOLUME_RAY_CASTER_CPU_H_INCLUDED
@@ -11,8 +11,15 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/convenience.hpp>
 
+#include <scm/core/platform/platform.h>
+
+#if SCM_ARCHITECTURE_X86
+#   include <immintrin.h>
+#endif // SCM_ARCHITECTURE_X86
+
 #include <scm/core/io/file.h>
 #include <scm/core/platform/byte_swap.h>
+#include <scm/core/platform/cpu_dispatch.h>
 
 #include <scm/gl_core/log.h>
 
@@ -52,9 +59,8 @@ ibm_to_ieee(float* f)
     }
 }
 
-inline
 void
-swap_bytes_array_ibm_to_ieee(float* d, float* s, scm::size_t c)
+swap_bytes_array_ibm_to_ieee_generic(float* d, float* s, scm::size_t c)
 {
     for (scm::size_t i = 0; i < c; ++i) {
         scm::do_swap_bytes<float, sizeof(float)>()(d + i, s + i);
@@ -62,6 +68,101 @@ swap_bytes_array_ibm_to_ieee(float* d, float* s, scm::size_t c)
     }
 }
 
+#if SCM_ARCHITECTURE_X86
+
+// branch free variant of ibm_to_ieee() on the byte swapped bits:
+//  - the 24bit fraction converts exactly to float, its exponent is the normalization shift
+//    of the scalar loop, the hex exponent adds 4 * (e - 64) - 24 on top
+//  - exponents above the float range saturate to +-max, below it (and zero fractions) to 0
+scm_target("sse2")
+void
+swap_bytes_array_ibm_to_ieee_sse2(float* d, float* s, scm::size_t c)
+{
+    const __m128i   byte_mask   = _mm_set1_epi32(0x0000ff00);
+    const __m128i   frac_mask   = _mm_set1_epi32(0x00ffffff);
+    const __m128i   hexp_mask   = _mm_set1_epi32(0x000001fc);
+    const __m128i   mant_mask   = _mm_set1_epi32(0x007fffff);
+    const __m128i   sign_mask   = _mm_set1_epi32(0x80000000);
+    const __m128i   max_float   = _mm_set1_epi32(0x7f7fffff);
+    const __m128i   exp_bias    = _mm_set1_epi32(280);
+    const __m128i   exp_max     = _mm_set1_epi32(254);
+    const __m128i   zero        = _mm_setzero_si128();
+
+    scm::size_t i = 0;
+    for (; i + 4 <= c; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        x = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(x, 24), _mm_srli_epi32(x, 24)),
+                         _mm_or_si128(_mm_and_si128(_mm_srli_epi32(x, 8), byte_mask),
+                                      _mm_slli_epi32(_mm_and_si128(x, byte_mask), 8)));
+
+        const __m128i frac = _mm_and_si128(x, frac_mask);
+        const __m128i fb   = _mm_castps_si128(_mm_cvtepi32_ps(frac));
+        const __m128i t    = _mm_sub_epi32(_mm_add_epi32(_mm_srli_epi32(fb, 23),
+                                                         _mm_and_si128(_mm_srli_epi32(x, 22), hexp_mask)),
+                                           exp_bias);
+        const __m128i sign = _mm_and_si128(x, sign_mask);
+        const __m128i over = _mm_cmpgt_epi32(t, exp_max);
+        const __m128i keep = _mm_andnot_si128(_mm_cmpeq_epi32(frac, zero), _mm_cmpgt_epi32(t, zero));
+
+        __m128i r = _mm_or_si128(_mm_slli_epi32(t, 23), _mm_and_si128(fb, mant_mask));
+        r = _mm_or_si128(_mm_andnot_si128(over, r), _mm_and_si128(over, max_float));
+        r = _mm_and_si128(_mm_or_si128(sign, r), keep);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), r);
+    }
+
+    swap_bytes_array_ibm_to_ieee_generic(d + i, s + i, c - i);
+}
+
+scm_target("avx2")
+void
+swap_bytes_array_ibm_to_ieee_avx2(float* d, float* s, scm::size_t c)
+{
+    const __m256i   byte_swap   = _mm256_setr_epi8( 3,  2,  1,  0,  7,  6,  5,  4, 11, 10,  9,  8, 15, 14, 13, 12,
+                                                    3,  2,  1,  0,  7,  6,  5,  4, 11, 10,  9,  8, 15, 14, 13, 12);
+    const __m256i   frac_mask   = _mm256_set1_epi32(0x00ffffff);
+    const __m256i   hexp_mask   = _mm256_set1_epi32(0x000001fc);
+    const __m256i   mant_mask   = _mm256_set1_epi32(0x007fffff);
+    const __m256i   sign_mask   = _mm256_set1_epi32(0x80000000);
+    const __m256i   max_float   = _mm256_set1_epi32(0x7f7fffff);
+    const __m256i   exp_bias    = _mm256_set1_epi32(280);
+    const __m256i   exp_max     = _mm256_set1_epi32(254);
+    const __m256i   zero        = _mm256_setzero_si256();
+
+    scm::size_t i = 0;
+    for (; i + 8 <= c; i += 8) {
+        const __m256i x    = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)), byte_swap);
+        const __m256i frac = _mm256_and_si256(x, frac_mask);
+        const __m256i fb   = _mm256_castps_si256(_mm256_cvtepi32_ps(frac));
+        const __m256i t    = _mm256_sub_epi32(_mm256_add_epi32(_mm256_srli_epi32(fb, 23),
+                                                               _mm256_and_si256(_mm256_srli_epi32(x, 22), hexp_mask)),
+                                              exp_bias);
+        const __m256i sign = _mm256_and_si256(x, sign_mask);
+        const __m256i over = _mm256_cmpgt_epi32(t, exp_max);
+        const __m256i keep = _mm256_andnot_si256(_mm256_cmpeq_epi32(frac, zero), _mm256_cmpgt_epi32(t, zero));
+
+        __m256i r = _mm256_or_si256(_mm256_slli_epi32(t, 23), _mm256_and_si256(fb, mant_mask));
+        r = _mm256_blendv_epi8(r, max_float, over);
+        r = _mm256_and_si256(_mm256_or_si256(sign, r), keep);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), r);
+    }
+
+    swap_bytes_array_ibm_to_ieee_generic(d + i, s + i, c - i);
+}
+
+#endif // SCM_ARCHITECTURE_X86
+
+typedef void (swap_bytes_array_ibm_to_ieee_func)(float*, float*, scm::size_t);
+
+const scm::cpu_dispatch<swap_bytes_array_ibm_to_ieee_func> swap_bytes_array_ibm_to_ieee_kernels
+    = scm::cpu_dispatch<swap_bytes_array_ibm_to_ieee_func>(swap_bytes_array_ibm_to_ieee_generic)
+#if SCM_ARCHITECTURE_X86
+        .add(scm::simd_sse2, swap_bytes_array_ibm_to_ieee_sse2)
+        .add(scm::simd_avx2, swap_bytes_array_ibm_to_ieee_avx2)
+#endif // SCM_ARCHITECTURE_X86
+        ;
+
 } // namespace
 
 
@@ -125,6 +226,9 @@ volume_reader_segy::read(const scm::math::vec3ui& o,
         return false;
     }
 
+    // resolved once for all lines of the request
+    swap_bytes_array_ibm_to_ieee_func*const swap_bytes_array_ibm_to_ieee = swap_bytes_array_ibm_to_ieee_kernels.get();
+
     {
         // read subvolume
         //if (   (o.x + s.x > _dimensions.x)
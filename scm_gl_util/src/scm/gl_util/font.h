@@ -8,6 +8,7 @@
 #include <scm/gl_util/font/font_fwd.h>
 #include <scm/gl_util/font/font_face.h>
 #include <scm/gl_util/font/text.h>
+#include <scm/gl_util/font/text_batch.h>
 #include <scm/gl_util/font/text_renderer.h>
 
 #endif // SCM_GL_UTIL_FONT_H_INCLUDED
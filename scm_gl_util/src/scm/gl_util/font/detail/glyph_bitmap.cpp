@@ -0,0 +1,211 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "glyph_bitmap.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const float edt_infinity = 1.0e20f;
+
+int
+floor_div(int a, int b)
+{
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+int
+ceil_div(int a, int b)
+{
+    return -floor_div(-a, b);
+}
+
+// 1d squared euclidean distance transform of the sampled function f (lower envelope of parabolas)
+void
+distance_transform_1d(const float* f,
+                      int          n,
+                      float*       d,
+                      int*         v,
+                      float*       z)
+{
+    int k = 0;
+    v[0] = 0;
+    z[0] = -edt_infinity;
+    z[1] =  edt_infinity;
+
+    for (int q = 1; q < n; ++q) {
+        float s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            --k;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        ++k;
+        v[k]     = q;
+        z[k]     = s;
+        z[k + 1] = edt_infinity;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; ++q) {
+        while (z[k + 1] < q) {
+            ++k;
+        }
+        d[q] = static_cast<float>((q - v[k]) * (q - v[k])) + f[v[k]];
+    }
+}
+
+// 2d squared euclidean distance transform in place, columns followed by rows
+void
+distance_transform_2d(std::vector<float>& grid,
+                      int                 width,
+                      int                 height)
+{
+    const int          n = (std::max)(width, height);
+    std::vector<float> f(n);
+    std::vector<float> d(n);
+    std::vector<int>   v(n);
+    std::vector<float> z(n + 1);
+
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            f[y] = grid[y * width + x];
+        }
+        distance_transform_1d(&f.front(), height, &d.front(), &v.front(), &z.front());
+        for (int y = 0; y < height; ++y) {
+            grid[y * width + x] = d[y];
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        std::copy(grid.begin() + y * width, grid.begin() + (y + 1) * width, f.begin());
+        distance_transform_1d(&f.front(), width, &d.front(), &v.front(), &z.front());
+        std::copy(d.begin(), d.begin() + width, grid.begin() + y * width);
+    }
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+namespace detail {
+
+void
+copy_glyph_bitmap(const FT_Bitmap& bitmap,
+                  int              left,
+                  int              top,
+                  int              components,
+                  int              bitmap_ycomp,
+                  glyph_bitmap&    out_bitmap)
+{
+    const int w = static_cast<int>(bitmap.width) / (bitmap.pixel_mode == FT_PIXEL_MODE_LCD ? bitmap_ycomp : 1);
+    const int h = static_cast<int>(bitmap.rows);
+
+    out_bitmap._size    = math::vec2i(w, h);
+    out_bitmap._bearing = math::vec2i(left, top - h);
+    out_bitmap._texels.assign(static_cast<size_t>(w) * h * components, 0u);
+
+    for (int dy = 0; dy < h; ++dy) {
+        const unsigned char* src = bitmap.buffer + dy * bitmap.pitch;
+        unsigned char*       dst = &out_bitmap._texels.front() + static_cast<size_t>(h - 1 - dy) * w * components;
+
+        switch (bitmap.pixel_mode) {
+            case FT_PIXEL_MODE_GRAY:
+                for (int dx = 0; dx < w; ++dx) {
+                    dst[dx * components] = src[dx];
+                }
+                break;
+            case FT_PIXEL_MODE_LCD:
+                for (int dx = 0; dx < w; ++dx) {
+                    dst[dx * components    ] = src[dx * bitmap_ycomp];
+                    dst[dx * components + 1] = src[dx * bitmap_ycomp + 1];
+                    dst[dx * components + 2] = src[dx * bitmap_ycomp + 2];
+                }
+                break;
+            case FT_PIXEL_MODE_MONO:
+                for (int dx = 0; dx < w; ++dx) {
+                    const unsigned char v = (src[dx >> 3] & (0x80 >> (dx & 7))) ? 255u : 0u;
+                    for (int l = 0; l < components; ++l) {
+                        dst[dx * components + l] = v;
+                    }
+                }
+                break;
+            default:
+                out_bitmap = glyph_bitmap();
+                return;
+        }
+    }
+}
+
+void
+make_distance_field(const glyph_bitmap& in_coverage,
+                    int                 in_upscale,
+                    int                 in_spread,
+                    glyph_bitmap&       out_field)
+{
+    using namespace scm::math;
+
+    out_field = glyph_bitmap();
+
+    if (in_coverage._size.x <= 0 || in_coverage._size.y <= 0 || in_upscale < 1) {
+        return;
+    }
+
+    // field texels covering the glyph plus the spread
+    const vec2i field_min = vec2i(floor_div(in_coverage._bearing.x, in_upscale),
+                                  floor_div(in_coverage._bearing.y, in_upscale)) - vec2i(in_spread);
+    const vec2i field_max = vec2i(ceil_div(in_coverage._bearing.x + in_coverage._size.x, in_upscale),
+                                  ceil_div(in_coverage._bearing.y + in_coverage._size.y, in_upscale)) + vec2i(in_spread);
+    const vec2i field_size = field_max - field_min;
+
+    // high resolution grid under the field texels
+    const int   grid_w = field_size.x * in_upscale;
+    const int   grid_h = field_size.y * in_upscale;
+    const vec2i cov_o  = in_coverage._bearing - field_min * in_upscale;
+
+    std::vector<float> outside(static_cast<size_t>(grid_w) * grid_h, edt_infinity);   // distance to the glyph
+    std::vector<float> inside(static_cast<size_t>(grid_w) * grid_h, 0.0f);            // distance to the background
+
+    for (int y = 0; y < in_coverage._size.y; ++y) {
+        for (int x = 0; x < in_coverage._size.x; ++x) {
+            if (in_coverage._texels[y * in_coverage._size.x + x] >= 128u) {
+                const size_t i = static_cast<size_t>(cov_o.y + y) * grid_w + cov_o.x + x;
+                outside[i] = 0.0f;
+                inside[i]  = edt_infinity;
+            }
+        }
+    }
+
+    distance_transform_2d(outside, grid_w, grid_h);
+    distance_transform_2d(inside,  grid_w, grid_h);
+
+    out_field._size    = field_size;
+    out_field._bearing = field_min;
+    out_field._texels.resize(static_cast<size_t>(field_size.x) * field_size.y);
+
+    // even upscale factors place the texel center between four grid pixels
+    const int   sample_dim   = (in_upscale % 2 == 0) ? 2 : 1;
+    const int   sample_off   = (in_upscale - sample_dim) / 2;
+    const float sample_scale = 1.0f / static_cast<float>(sample_dim * sample_dim * in_upscale);
+    const float value_scale  = 0.5f / static_cast<float>(in_spread);
+
+    for (int y = 0; y < field_size.y; ++y) {
+        for (int x = 0; x < field_size.x; ++x) {
+            float sd = 0.0f;
+            for (int sy = 0; sy < sample_dim; ++sy) {
+                for (int sx = 0; sx < sample_dim; ++sx) {
+                    const size_t i = static_cast<size_t>(y * in_upscale + sample_off + sy) * grid_w + x * in_upscale + sample_off + sx;
+                    // pixel center distances, the outline lies half a pixel from the centers
+                    sd += (outside[i] > 0.0f) ? std::sqrt(outside[i]) - 0.5f : 0.5f - std::sqrt(inside[i]);
+                }
+            }
+            const float v = 0.5f - sd * sample_scale * value_scale;
+            out_field._texels[y * field_size.x + x] = static_cast<unsigned char>(clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+        }
+    }
+}
+
+} // namespace detail
+} // namespace gl
+} // namespace scm
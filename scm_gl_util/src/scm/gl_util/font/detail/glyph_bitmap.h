@@ -0,0 +1,53 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_DETAIL_GLYPH_BITMAP_H_INCLUDED
+#define SCM_GL_UTIL_DETAIL_GLYPH_BITMAP_H_INCLUDED
+
+#include <vector>
+
+#include <scm/core/math.h>
+
+#include <scm/gl_util/font/detail/freetype_types.h>
+
+namespace scm {
+namespace gl {
+namespace detail {
+
+// bitmap of a rasterized glyph (rows bottom to top like the texture images)
+struct glyph_bitmap
+{
+    glyph_bitmap() : _size(0), _bearing(0) {}
+
+    math::vec2i                 _size;
+    math::vec2i                 _bearing;
+    std::vector<unsigned char>  _texels;
+}; // struct glyph_bitmap
+
+void
+copy_glyph_bitmap(const FT_Bitmap& bitmap,
+                  int              left,
+                  int              top,
+                  int              components,
+                  int              bitmap_ycomp,
+                  glyph_bitmap&    out_bitmap);
+
+// signed distance field of a single component glyph coverage bitmap
+//  - the coverage is rasterized at in_upscale times the resolution of the distance field,
+//    the bearing of the coverage bitmap is in these high resolution pixels
+//  - the field is padded by in_spread texels around the glyph, distances in [-spread, spread]
+//    texels map to [1, 0], the glyph outline is at 0.5
+//  - exact euclidean distance transform of the thresholded coverage (Felzenszwalb and
+//    Huttenlocher), sampled at the texel centers
+void
+make_distance_field(const glyph_bitmap& in_coverage,
+                    int                 in_upscale,
+                    int                 in_spread,
+                    glyph_bitmap&       out_field);
+
+} // namespace detail
+} // namespace gl
+} // namespace scm
+
+#endif // SCM_GL_UTIL_DETAIL_GLYPH_BITMAP_H_INCLUDED
@@ -4,23 +4,36 @@
 
 #include "font_face.h"
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
 #include <iostream>
 #include <exception>
+#include <fstream>
+#include <iomanip>
 #include <stdexcept>
 #include <set>
 #include <sstream>
 #include <string>
 
+#include <boost/bind.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/assign/list_of.hpp>
 #include <boost/assign/std/vector.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/thread/mutex.hpp>
 //#include <boost/tuple/tuple.hpp>
 
+#include <scm/concurrency.h>
+
 #include <scm/gl_core/log.h>
 #include <scm/gl_core/render_device.h>
 #include <scm/gl_core/texture_objects.h>
 
 #include <scm/gl_util/font/detail/freetype_types.h>
+#include <scm/gl_util/font/detail/glyph_bitmap.h>
 
 namespace scm {
 namespace gl {
@@ -169,8 +182,616 @@ available_72dpi_size(const std::string& file_name,
     return (font_size);
 }
 
+const char          field_cache_magic[8] = {'S', 'C', 'M', 'F', 'O', 'N', 'T', 'D'};
+const scm::uint32   field_cache_version  = 2;
+
+boost::mutex        field_cache_directory_mutex;
+bool                field_cache_directory_set = false;
+std::string         field_cache_directory;
+
+// stable 64bit FNV-1a hash of the font path, distinguishes fonts of the same name in the cache directory
+scm::uint64
+field_cache_path_hash(const std::string& in_path)
+{
+    scm::uint64 h = 0xcbf29ce484222325ull;
+    for (std::string::const_iterator c = in_path.begin(); c != in_path.end(); ++c) {
+        h = (h ^ static_cast<unsigned char>(*c)) * 0x100000001b3ull;
+    }
+    return h;
+}
+
+template<typename value_type>
+bool
+write_values(std::ofstream& out_file, const value_type* in_values, scm::size_t in_count)
+{
+    return !out_file.write(reinterpret_cast<const char*>(in_values), in_count * sizeof(value_type)).fail();
+}
+
+template<typename value_type>
+bool
+read_values(std::ifstream& in_file, value_type* out_values, scm::size_t in_count)
+{
+    return !in_file.read(reinterpret_cast<char*>(out_values), in_count * sizeof(value_type)).fail();
+}
+
 } // namesapce detail
 
+struct font_face::glyph_cache
+{
+    struct shelf {
+        unsigned    _y;
+        unsigned    _height;
+        unsigned    _next_x;
+    }; // struct shelf
+    struct page {
+        page() : _shelves_end(0), _last_use(0), _dirty(false), _dirty_min(0u), _dirty_max(0u) {}
+        std::vector<shelf>          _shelves;
+        unsigned                    _shelves_end;
+        scm::uint64                 _last_use;
+        std::vector<scm::uint64>    _glyph_keys;
+        bool                        _dirty;
+        math::vec2ui                _dirty_min;
+        math::vec2ui                _dirty_max;         // exclusive
+    }; // struct page
+
+    // distance field glyphs are kept independent of the atlas pages, evicted glyphs are
+    // placed again without regenerating the field, the fields are cached on disk
+    struct field_glyph {
+        field_glyph() : _advance(0) {}
+        unsigned                    _advance;
+        detail::glyph_bitmap        _field;
+    }; // struct field_glyph
+    struct field_stamp {
+        scm::uint64                 _file_size[style_count];    // 0 for styles without a file
+        scm::int64                  _write_time[style_count];
+        scm::uint32                 _font_size;
+        scm::uint32                 _dpi;
+        scm::uint32                 _spread;
+        scm::uint32                 _upscale;
+    }; // struct field_stamp
+
+    typedef boost::unordered_map<scm::uint64, glyph_info>   glyph_map;
+    typedef boost::unordered_map<scm::uint64, int>          kerning_map;
+    typedef boost::unordered_map<scm::uint64, field_glyph>  field_map;
+    typedef std::vector<unsigned char>                      page_image;
+    typedef std::pair<std::string, style_type>              prefetch_request;
+
+    glyph_cache()
+      : _glyph_components(0)
+      , _glyph_bitmap_ycomp(1)
+      , _glyph_render_mode(FT_RENDER_MODE_NORMAL)
+      , _glyph_load_flags(FT_LOAD_DEFAULT)
+      , _glyph_texture_format(FORMAT_NULL)
+      , _border_size(0)
+      , _distance_field(false)
+      , _field_spread(0)
+      , _field_upscale(1)
+      , _fields_dirty(false)
+      , _page_size(0u)
+      , _texture_layers(0)
+      , _kerning(style_count)
+      , _use_clock(0)
+      , _generation(0)
+      , _prefetch_running(false)
+    {
+    }
+    ~glyph_cache() {
+        wait_prefetch();
+        if (_distance_field && _fields_dirty && !_field_cache_path.empty()) {
+            save_field_cache();
+        }
+    }
+
+    static scm::uint64 glyph_key(code_point c, style_type s) {
+        return (static_cast<scm::uint64>(s) << 32) | c;
+    }
+
+    size_t page_image_size() const {
+        return static_cast<size_t>(_page_size.x) * _page_size.y * _glyph_components;
+    }
+
+    void add_page() {
+        _pages.push_back(page());
+        _core_images.push_back(page_image(page_image_size(), 0u));
+        if (_border_size > 0) {
+            _border_images.push_back(page_image(page_image_size(), 0u));
+        }
+    }
+
+    void evict_page(unsigned p) {
+        page& evicted = _pages[p];
+        for (size_t k = 0; k < evicted._glyph_keys.size(); ++k) {
+            _glyphs.erase(evicted._glyph_keys[k]);
+        }
+        evicted = page();
+        std::fill(_core_images[p].begin(), _core_images[p].end(), 0u);
+        if (_border_size > 0) {
+            std::fill(_border_images[p].begin(), _border_images[p].end(), 0u);
+        }
+        mark_dirty(p, math::vec2ui(0u), _page_size);
+        ++_generation;
+    }
+
+    void mark_dirty(unsigned p, const math::vec2ui& o, const math::vec2ui& s) {
+        page& dp = _pages[p];
+        if (dp._dirty) {
+            dp._dirty_min = math::min(dp._dirty_min, o);
+            dp._dirty_max = math::max(dp._dirty_max, o + s);
+        }
+        else {
+            dp._dirty     = true;
+            dp._dirty_min = o;
+            dp._dirty_max = o + s;
+        }
+    }
+
+    // shelf packing, the shelf with the least height fitting the glyph is used, new shelves
+    // and pages are opened when no shelf has room, the least recently used page is evicted
+    // when the atlas has reached max_atlas_pages
+    bool allocate(const math::vec2ui& size, unsigned& out_page, math::vec2ui& out_origin) {
+        if (size.x > _page_size.x || size.y > _page_size.y) {
+            return false;
+        }
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            unsigned best_page  = 0;
+            shelf*   best_shelf = 0;
+            for (unsigned p = 0; p < _pages.size(); ++p) {
+                for (size_t i = 0; i < _pages[p]._shelves.size(); ++i) {
+                    shelf& cs = _pages[p]._shelves[i];
+                    if (   cs._height >= size.y && cs._next_x + size.x <= _page_size.x
+                        && (best_shelf == 0 || cs._height < best_shelf->_height)) {
+                        best_page  = p;
+                        best_shelf = &cs;
+                    }
+                }
+            }
+            if (best_shelf) {
+                out_page        = best_page;
+                out_origin      = math::vec2ui(best_shelf->_next_x, best_shelf->_y);
+                best_shelf->_next_x += size.x;
+                return true;
+            }
+            for (unsigned p = 0; p < _pages.size(); ++p) {
+                if (_pages[p]._shelves_end + size.y <= _page_size.y) {
+                    shelf ns;
+                    ns._y      = _pages[p]._shelves_end;
+                    ns._height = size.y;
+                    ns._next_x = size.x;
+                    _pages[p]._shelves.push_back(ns);
+                    _pages[p]._shelves_end += size.y;
+                    out_page   = p;
+                    out_origin = math::vec2ui(0u, ns._y);
+                    return true;
+                }
+            }
+            if (_pages.size() < max_atlas_pages) {
+                add_page();
+            }
+            else {
+                unsigned lru_page = 0;
+                for (unsigned p = 1; p < _pages.size(); ++p) {
+                    if (_pages[p]._last_use < _pages[lru_page]._last_use) {
+                        lru_page = p;
+                    }
+                }
+                evict_page(lru_page);
+            }
+        }
+        return false;
+    }
+
+    void blit(page_image& dst_image, const math::vec2ui& origin, const detail::glyph_bitmap& src) {
+        const size_t row_size = static_cast<size_t>(src._size.x) * _glyph_components;
+        for (int y = 0; y < src._size.y; ++y) {
+            const size_t dst_off = ((origin.y + y) * static_cast<size_t>(_page_size.x) + origin.x) * _glyph_components;
+            std::copy(src._texels.begin() + y * row_size, src._texels.begin() + (y + 1) * row_size, dst_image.begin() + dst_off);
+        }
+    }
+
+    unsigned glyph_advance(const detail::ft_face& ft_font, int upscale) const {
+        if (ft_font.get_face()->face_flags & FT_FACE_FLAG_SCALABLE) {
+            // linearHoriAdvance contains the 16.16 representation of the horizontal advance
+            // horiAdvance contains only the rounded advance which can be off by 1 and
+            // lead to sub styles beeing rendered to narrow
+            if (upscale > 1) {
+                return static_cast<unsigned>((ft_font.get_glyph()->linearHoriAdvance / upscale + 0x8000) >> 16);
+            }
+            return FT_CeilFix(ft_font.get_glyph()->linearHoriAdvance) >> 16;
+        }
+        else {
+            return ft_font.get_glyph()->metrics.horiAdvance >> 6;
+        }
+    }
+
+    glyph_info rasterize(code_point c, style_type s) {
+        if (_distance_field) {
+            const scm::uint64         key = glyph_key(c, s);
+            field_map::const_iterator f   = _fields.find(key);
+            if (f == _fields.end()) {
+                field_glyph          new_field;
+                detail::glyph_bitmap coverage;
+                render_field_coverage(c, s, coverage, new_field._advance);
+                detail::make_distance_field(coverage, _field_upscale, _field_spread, new_field._field);
+                f = _fields.insert(field_map::value_type(key, new_field)).first;
+                _fields_dirty = true;
+            }
+            return place(c, s, f->second._advance, f->second._field, detail::glyph_bitmap());
+        }
+
+        detail::ft_face&     ft_font = *_ft_faces[s];
+        detail::glyph_bitmap core;
+        detail::glyph_bitmap border;
+
+        ft_font.load_glyph(c, _glyph_load_flags);
+        const unsigned advance = glyph_advance(ft_font, 1);
+
+        if (_border_size > 0) {
+            detail::ft_stroker stroker(_ft_library, _border_size);
+            FT_Glyph           ft_glyph;
+
+            if (FT_Get_Glyph(ft_font.get_glyph(), &ft_glyph)) {
+                throw std::runtime_error("font_face::glyph(): error during FT_Get_Glyph");
+            }
+            if (   FT_Glyph_Stroke(&ft_glyph, stroker.get_stroker(), true)
+                || FT_Glyph_To_Bitmap(&ft_glyph, _glyph_render_mode, 0, true)) {
+                FT_Done_Glyph(ft_glyph);
+                throw std::runtime_error("font_face::glyph(): error during FT_Glyph_Stroke or FT_Glyph_To_Bitmap");
+            }
+            FT_BitmapGlyph ft_bitmap_glyph = (FT_BitmapGlyph)ft_glyph;
+            detail::copy_glyph_bitmap(ft_bitmap_glyph->bitmap, ft_bitmap_glyph->left, ft_bitmap_glyph->top,
+                                      _glyph_components, _glyph_bitmap_ycomp, border);
+            FT_Done_Glyph(ft_glyph);
+        }
+        if (FT_Render_Glyph(ft_font.get_glyph(), _glyph_render_mode)) {
+            throw std::runtime_error("font_face::glyph(): error during FT_Render_Glyph");
+        }
+        detail::copy_glyph_bitmap(ft_font.get_glyph()->bitmap, ft_font.get_glyph()->bitmap_left, ft_font.get_glyph()->bitmap_top,
+                                  _glyph_components, _glyph_bitmap_ycomp, core);
+
+        return place(c, s, advance, core, border);
+    }
+
+    // coverage of a glyph from the high resolution faces for the distance field generation
+    void render_field_coverage(code_point c, style_type s, detail::glyph_bitmap& out_coverage, unsigned& out_advance) {
+        detail::ft_face& ft_font = *_ft_field_faces[s];
+
+        ft_font.load_glyph(c, _glyph_load_flags);
+        out_advance = glyph_advance(ft_font, _field_upscale);
+
+        if (FT_Render_Glyph(ft_font.get_glyph(), _glyph_render_mode)) {
+            throw std::runtime_error("font_face::glyph(): error during FT_Render_Glyph");
+        }
+        detail::copy_glyph_bitmap(ft_font.get_glyph()->bitmap, ft_font.get_glyph()->bitmap_left, ft_font.get_glyph()->bitmap_top,
+                                  1, 1, out_coverage);
+    }
+
+    glyph_info place(code_point c, style_type s, unsigned advance, const detail::glyph_bitmap& core, const detail::glyph_bitmap& border) {
+        using namespace scm::math;
+
+        glyph_info cur_glyph;
+        cur_glyph._advance = advance;
+
+        // the core is placed inside the border box, both share the texture coordinates
+        vec2i box_diff = vec2i::zero();
+        vec2i box_size = core._size;
+        if (_border_size > 0) {
+            box_diff = max(vec2i::zero(), core._bearing - border._bearing);
+            box_size = max(border._size, core._size + box_diff);
+        }
+        cur_glyph._box_size       = box_size;
+        cur_glyph._border_bearing = border._bearing;
+        cur_glyph._bearing        = core._bearing - box_diff;
+
+        if (box_size.x > 0 && box_size.y > 0) {
+            unsigned page_index = 0;
+            vec2ui   origin;
+            // space of at least one texel around all glyphs
+            if (!allocate(vec2ui(box_size) + vec2ui(1u), page_index, origin)) {
+                throw std::runtime_error("font_face::glyph(): glyph exceeds the atlas page size");
+            }
+            blit(_core_images[page_index], origin + vec2ui(box_diff), core);
+            if (_border_size > 0) {
+                blit(_border_images[page_index], origin, border);
+            }
+            mark_dirty(page_index, origin, vec2ui(box_size));
+            _pages[page_index]._glyph_keys.push_back(glyph_key(c, s));
+
+            cur_glyph._texture_layer    = page_index;
+            cur_glyph._texture_origin   = vec2f(origin) / vec2f(_page_size);
+            cur_glyph._texture_box_size = vec2f(box_size) / vec2f(_page_size);
+        }
+
+        return cur_glyph;
+    }
+
+    // lookup or rasterize a glyph, has to be called with the cache mutex locked
+    const glyph_info& find_glyph(code_point c, style_type s) {
+        const scm::uint64         key = glyph_key(c, s);
+        glyph_map::const_iterator g   = _glyphs.find(key);
+
+        if (g == _glyphs.end()) {
+            glyph_info new_glyph;
+            try {
+                new_glyph = rasterize(c, s);
+            }
+            catch (const std::exception& e) {
+                glerr() << log::warning << e.what() << " (code point: " << c << ")" << log::end;
+            }
+            g = _glyphs.insert(glyph_map::value_type(key, new_glyph)).first;
+        }
+        if (g->second._box_size.x > 0) {
+            _pages[g->second._texture_layer]._last_use = ++_use_clock;
+        }
+        return g->second;
+    }
+
+    void prefetch(const std::string str, style_type s) {
+        if (_distance_field) {
+            prefetch_fields(str, s);
+        }
+        for (std::string::const_iterator c = str.begin(); c != str.end();) {
+            const code_point cp = font_face::next_code_point(c, str.end());
+            if (cp >= 32u) {
+                boost::mutex::scoped_lock lock(_mutex);
+                find_glyph(cp, s);
+            }
+        }
+    }
+
+    // the coverage of the missing glyphs is rendered sequentially (the freetype faces are
+    // not thread safe), the distance transforms of the glyphs run on the core task scheduler
+    void prefetch_fields(const std::string& str, style_type s) {
+        std::vector<scm::uint64>            keys;
+        std::vector<detail::glyph_bitmap>   coverage;
+        std::vector<field_glyph>            fields;
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            for (std::string::const_iterator c = str.begin(); c != str.end();) {
+                const code_point  cp  = font_face::next_code_point(c, str.end());
+                const scm::uint64 key = glyph_key(cp, s);
+                if (   cp < 32u
+                    || _fields.find(key) != _fields.end()
+                    || std::find(keys.begin(), keys.end(), key) != keys.end()) {
+                    continue;
+                }
+                try {
+                    field_glyph          new_field;
+                    detail::glyph_bitmap new_coverage;
+                    render_field_coverage(cp, s, new_coverage, new_field._advance);
+                    keys.push_back(key);
+                    coverage.push_back(new_coverage);
+                    fields.push_back(new_field);
+                }
+                catch (const std::exception& e) {
+                    glerr() << log::warning << e.what() << " (code point: " << cp << ")" << log::end;
+                }
+            }
+        }
+        if (keys.empty()) {
+            return;
+        }
+
+        concurrency::parallel_for(concurrency::range_1d(0, keys.size()),
+                                  boost::bind(&glyph_cache::make_fields, this, boost::cref(coverage), boost::ref(fields), _1));
+
+        boost::mutex::scoped_lock lock(_mutex);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            _fields.insert(field_map::value_type(keys[i], fields[i]));
+        }
+        _fields_dirty = true;
+    }
+
+    void make_fields(const std::vector<detail::glyph_bitmap>& coverage, std::vector<field_glyph>& fields,
+                     const concurrency::range_1d& r) const {
+        for (size_t i = r._begin; i < r._end; ++i) {
+            detail::make_distance_field(coverage[i], _field_upscale, _field_spread, fields[i]._field);
+        }
+    }
+
+    bool load_field_cache() {
+        std::ifstream cache_file(_field_cache_path.c_str(), std::ios_base::in | std::ios_base::binary);
+        if (!cache_file) {
+            return false;
+        }
+        cache_file.seekg(0, std::ios_base::end);
+        const scm::uint64 file_length = static_cast<scm::uint64>(cache_file.tellg());
+        cache_file.seekg(0, std::ios_base::beg);
+
+        char        magic[8];
+        scm::uint32 version = 0;
+        field_stamp stamp;
+        scm::uint32 count   = 0;
+
+        if (   !detail::read_values(cache_file, magic, 8)
+            || !detail::read_values(cache_file, &version, 1)
+            || !detail::read_values(cache_file, &stamp, 1)
+            || !detail::read_values(cache_file, &count, 1)) {
+            return false;
+        }
+        bool files_match = true;
+        for (int s = 0; s < style_count; ++s) {
+            files_match =    files_match
+                          && stamp._file_size[s]  == _field_stamp._file_size[s]
+                          && stamp._write_time[s] == _field_stamp._write_time[s];
+        }
+        if (   0 != std::memcmp(magic, detail::field_cache_magic, sizeof(detail::field_cache_magic))
+            || version           != detail::field_cache_version
+            || !files_match
+            || stamp._font_size  != _field_stamp._font_size
+            || stamp._dpi        != _field_stamp._dpi
+            || stamp._spread     != _field_stamp._spread
+            || stamp._upscale    != _field_stamp._upscale) {
+            // stale cache, overwritten with the fields generated by this font
+            return false;
+        }
+        // every entry holds at least its key and header
+        const scm::uint64 entry_min_size = sizeof(scm::uint64) + 5 * sizeof(scm::int32);
+        if (static_cast<scm::uint64>(count) * entry_min_size > file_length - static_cast<scm::uint64>(cache_file.tellg())) {
+            glout() << log::warning
+                    << "font_face::font_face(): ignoring corrupt distance field cache ('" << _field_cache_path << "')." << log::end;
+            return false;
+        }
+
+        field_map fields;
+        for (scm::uint32 i = 0; i < count; ++i) {
+            scm::uint64 key;
+            scm::int32  header[5];      // advance, bearing, size
+            field_glyph cur_field;
+
+            if (   !detail::read_values(cache_file, &key, 1)
+                || !detail::read_values(cache_file, header, 5)
+                || header[3] < 0 || header[4] < 0
+                || static_cast<scm::uint64>(header[3]) * static_cast<scm::uint64>(header[4])
+                       > file_length - static_cast<scm::uint64>(cache_file.tellg())) {
+                glout() << log::warning
+                        << "font_face::font_face(): ignoring corrupt distance field cache ('" << _field_cache_path << "')." << log::end;
+                return false;
+            }
+            cur_field._advance        = static_cast<unsigned>(header[0]);
+            cur_field._field._bearing = math::vec2i(header[1], header[2]);
+            cur_field._field._size    = math::vec2i(header[3], header[4]);
+            cur_field._field._texels.resize(static_cast<size_t>(header[3]) * header[4]);
+            if (   !cur_field._field._texels.empty()
+                && !detail::read_values(cache_file, &cur_field._field._texels.front(), cur_field._field._texels.size())) {
+                glout() << log::warning
+                        << "font_face::font_face(): ignoring corrupt distance field cache ('" << _field_cache_path << "')." << log::end;
+                return false;
+            }
+            fields.insert(field_map::value_type(key, cur_field));
+        }
+        _fields.swap(fields);
+
+        return true;
+    }
+
+    bool save_field_cache() const {
+        namespace bfs = boost::filesystem;
+
+        const std::string temp_path = _field_cache_path + ".tmp";
+
+        boost::system::error_code ec;
+        bfs::create_directories(bfs::path(_field_cache_path).parent_path(), ec);
+
+        { // write to a temporary file first, a concurrent reader never sees a partial cache
+            std::ofstream cache_file(temp_path.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+            const scm::uint32 count = static_cast<scm::uint32>(_fields.size());
+            bool              ok    =    cache_file
+                                      && detail::write_values(cache_file, detail::field_cache_magic, 8)
+                                      && detail::write_values(cache_file, &detail::field_cache_version, 1)
+                                      && detail::write_values(cache_file, &_field_stamp, 1)
+                                      && detail::write_values(cache_file, &count, 1);
+
+            for (field_map::const_iterator f = _fields.begin(); ok && f != _fields.end(); ++f) {
+                const detail::glyph_bitmap& field     = f->second._field;
+                const scm::int32            header[5] = { static_cast<scm::int32>(f->second._advance),
+                                                          field._bearing.x, field._bearing.y, field._size.x, field._size.y };
+                ok =    detail::write_values(cache_file, &f->first, 1)
+                     && detail::write_values(cache_file, header, 5)
+                     && (field._texels.empty() || detail::write_values(cache_file, &field._texels.front(), field._texels.size()));
+            }
+            if (!ok || !cache_file.flush()) {
+                glout() << log::warning
+                        << "font_face::~font_face(): unable to write distance field cache ('" << temp_path << "')." << log::end;
+                cache_file.close();
+                bfs::remove(bfs::path(temp_path), ec);
+                return false;
+            }
+        }
+
+        bfs::rename(bfs::path(temp_path), bfs::path(_field_cache_path), ec);
+        if (ec) {
+            glout() << log::warning
+                    << "font_face::~font_face(): unable to write distance field cache ('" << _field_cache_path << "', " << ec.message() << ")." << log::end;
+            bfs::remove(bfs::path(temp_path), ec);
+            return false;
+        }
+
+        return true;
+    }
+
+    // background requests are queued and worked off in order by a single task on the core
+    // task scheduler, the task is started when the first request arrives and ends with the
+    // queue, the caller never waits for a running prefetch
+    void queue_prefetch(const std::string& str, style_type s) {
+        {
+            boost::mutex::scoped_lock lock(_mutex);
+            concurrency::task_scheduler* scheduler = concurrency::default_scheduler();
+            if (scheduler) {
+                _prefetch_queue.push_back(prefetch_request(str, s));
+                if (_prefetch_running) {
+                    return;
+                }
+                if (!_prefetch_tasks) {
+                    _prefetch_tasks.reset(new concurrency::task_group(*scheduler));
+                }
+                _prefetch_running = true;
+                _prefetch_tasks->run(boost::bind(&glyph_cache::run_prefetch_queue, this));
+                return;
+            }
+        }
+        // without a task scheduler the glyphs are prefetched on the calling thread
+        prefetch(str, s);
+    }
+
+    void run_prefetch_queue() {
+        for (;;) {
+            prefetch_request request;
+            {
+                boost::mutex::scoped_lock lock(_mutex);
+                if (_prefetch_queue.empty()) {
+                    _prefetch_running = false;
+                    return;
+                }
+                request = _prefetch_queue.front();
+                _prefetch_queue.pop_front();
+            }
+            prefetch(request.first, request.second);
+        }
+    }
+
+    void wait_prefetch() {
+        if (_prefetch_tasks && !_prefetch_tasks->done()) {
+            _prefetch_tasks->wait();
+        }
+    }
+
+    detail::ft_library                      _ft_library;
+    std::vector<shared_ptr<detail::ft_face> > _ft_faces;
+
+    int                                     _glyph_components;
+    int                                     _glyph_bitmap_ycomp;
+    FT_Render_Mode                          _glyph_render_mode;
+    unsigned                                _glyph_load_flags;
+    data_format                             _glyph_texture_format;
+    unsigned                                _border_size;
+
+    bool                                    _distance_field;
+    int                                     _field_spread;      // in atlas texels
+    int                                     _field_upscale;     // coverage resolution over the atlas resolution
+    std::vector<shared_ptr<detail::ft_face> > _ft_field_faces;
+    field_map                               _fields;
+    bool                                    _fields_dirty;
+    std::string                             _field_cache_path;
+    field_stamp                             _field_stamp;
+
+    math::vec2ui                            _page_size;
+    std::vector<page>                       _pages;
+    std::vector<page_image>                 _core_images;
+    std::vector<page_image>                 _border_images;
+    unsigned                                _texture_layers;
+
+    glyph_map                               _glyphs;
+    std::vector<kerning_map>                _kerning;
+    scm::uint64                             _use_clock;
+    unsigned                                _generation;
+
+    boost::mutex                            _mutex;
+    std::deque<prefetch_request>            _prefetch_queue;
+    bool                                    _prefetch_running;
+    boost::scoped_ptr<concurrency::task_group> _prefetch_tasks;
+}; // struct font_face::glyph_cache
+
 font_face::font_face(const render_device_ptr& device,
                      const std::string&       font_file,
                      unsigned                 point_size,
@@ -180,6 +801,8 @@ font_face::font_face(const render_device_ptr& device,
   : _font_styles(style_count)
   , _font_styles_available(style_count)
   , _font_smooth_style(smooth_type)
+  , _render_device(device)
+  , _glyph_cache(new glyph_cache())
   , _point_size(point_size)
   , _border_size(static_cast<unsigned>(math::floor(border_size * 64.0f)))
   , _dpi(display_dpi)
@@ -188,8 +811,7 @@ font_face::font_face(const render_device_ptr& device,
     using namespace scm::math;
 
     try {
-
-        detail::ft_library  ft_lib;
+        glyph_cache& gc = *_glyph_cache;
 
         if (!detail::check_file(font_file)) {
             std::ostringstream s;
@@ -213,26 +835,44 @@ font_face::font_face(const render_device_ptr& device,
         std::vector<std::string>    font_style_files;
         detail::find_font_style_files(font_file, font_style_files);
 
-        // fill font styles
+        switch (smooth_type) {
+            case smooth_normal: gc._glyph_components     = 2;
+                                gc._glyph_render_mode    = FT_RENDER_MODE_NORMAL; //FT_RENDER_MODE_LIGHT; //
+                                gc._glyph_load_flags     = FT_LOAD_DEFAULT; //FT_LOAD_FORCE_AUTOHINT | FT_LOAD_TARGET_LIGHT; //
+                                gc._glyph_texture_format = FORMAT_RG_8;
+                                break;
+            case smooth_lcd:    gc._glyph_components     = 3;
+                                gc._glyph_bitmap_ycomp   = 3;
+                                gc._glyph_render_mode    = FT_RENDER_MODE_LCD;
+                                gc._glyph_load_flags     = FT_LOAD_TARGET_LCD;//FT_LOAD_FORCE_AUTOHINT | FT_LOAD_TARGET_LIGHT;
+                                gc._glyph_texture_format = FORMAT_RGB_8;
+                                FT_Library_SetLcdFilter(gc._ft_library.get_lib(), FT_LCD_FILTER_LIGHT);
+                                break;
+            case smooth_distance_field:
+                                gc._glyph_components     = 1;
+                                gc._glyph_render_mode    = FT_RENDER_MODE_NORMAL;
+                                gc._glyph_load_flags     = FT_LOAD_NO_HINTING; // hinting does not scale
+                                gc._glyph_texture_format = FORMAT_R_8;
+                                gc._distance_field       = true;
+                                break;
+            default:
+                std::ostringstream s;
+                s << "font_face::font_face(): unsupported smoothing style.";
+                throw(std::runtime_error(s.str()));
+        }
+
+        // open the font styles, the glyphs are rasterized on first use
         math::vec2ui max_glyph_size(0u, 0u); // to store the maximal glyph size over all styles
+        gc._ft_faces.resize(style_count);
         for (int i = 0; i < style_count; ++i) {
             _font_styles_available[i] = !font_style_files[i].empty();
 
             std::string         cur_font_file = _font_styles_available[i] ? font_style_files[i] : font_style_files[0];
-            detail::ft_face     ft_font(ft_lib, cur_font_file);
+            gc._ft_faces[i].reset(new detail::ft_face(gc._ft_library, cur_font_file));
+            detail::ft_face&    ft_font = *gc._ft_faces[i];
 
             ft_font.set_size(font_size, display_dpi);
 
-            // calculate kerning information
-            _font_styles[i]._kerning_table.resize(boost::extents[max_char][max_char]);
-            for (unsigned l = min_char; l < max_char; ++l) {
-                for (unsigned r = min_char; r < max_char; ++r) {
-                    //if (l == 'T' && r == 'e')
-                    //    std::cout << "kerning: " << int(ft_font.get_kerning(l, r)) << std::endl;
-                    _font_styles[i]._kerning_table[l][r] = ft_font.get_kerning(l, r);
-                }
-            }
-
             // retrieve the maximal bounding box of all glyphs in the face
             vec2f  font_bbox_x;
             vec2f  font_bbox_y;
@@ -268,328 +908,92 @@ font_face::font_face(const render_device_ptr& device,
                 throw(std::runtime_error(s.str()));
             }
 
-            vec2ui font_size = vec2ui(static_cast<unsigned>(ceil(font_bbox_x.y) - floor(font_bbox_x.x)),
-                                      static_cast<unsigned>(ceil(font_bbox_y.y) - floor(font_bbox_y.x)));
-            max_glyph_size.x = max<unsigned>(max_glyph_size.x, font_size.x);
-            max_glyph_size.y = max<unsigned>(max_glyph_size.y, font_size.y);
-
+            vec2ui glyph_bbox_size = vec2ui(static_cast<unsigned>(ceil(font_bbox_x.y) - floor(font_bbox_x.x)),
+                                            static_cast<unsigned>(ceil(font_bbox_y.y) - floor(font_bbox_y.x)));
+            max_glyph_size.x = max<unsigned>(max_glyph_size.x, glyph_bbox_size.x);
+            max_glyph_size.y = max<unsigned>(max_glyph_size.y, glyph_bbox_size.y);
         }
         // end fill font styles
 
-        // generate texture image
-        int             glyph_components     = 0;
-        int             glyph_bitmap_ycomp   = 1;
-        FT_Render_Mode  glyph_render_mode    = FT_RENDER_MODE_NORMAL;
-        unsigned        glyph_load_flags     = FT_LOAD_DEFAULT;
-        data_format     glyph_texture_format = FORMAT_NULL;
-
-        switch (smooth_type) {
-            case smooth_normal: glyph_components     = 2;
-                                glyph_render_mode    = FT_RENDER_MODE_NORMAL; //FT_RENDER_MODE_LIGHT; //
-                                glyph_load_flags     = FT_LOAD_DEFAULT; //FT_LOAD_FORCE_AUTOHINT | FT_LOAD_TARGET_LIGHT; //
-                                glyph_texture_format = FORMAT_RG_8;
-                                break;
-            case smooth_lcd:    glyph_components     = 3;
-                                glyph_bitmap_ycomp   = 3;
-                                glyph_render_mode    = FT_RENDER_MODE_LCD;
-                                glyph_load_flags     = FT_LOAD_TARGET_LCD;//FT_LOAD_FORCE_AUTOHINT | FT_LOAD_TARGET_LIGHT;
-                                glyph_texture_format = FORMAT_RGB_8;
-                                FT_Library_SetLcdFilter(ft_lib.get_lib(), FT_LCD_FILTER_LIGHT);
-                                break;
-            default:
-                std::ostringstream s;
-                s << "font_face::font_face(): unsupported smoothing style.";
-                throw(std::runtime_error(s.str()));
-        }
-
-
-        for (int i = 0; i < style_count; ++i) {
-            _font_styles[i]._glyphs.resize(max_char);
-        }
-
-        //typedef vec<unsigned char, 2> glyph_texel; // 2 components (core, border... TO BE DONE!, currently only first used)
-        max_glyph_size += math::vec2ui(1u) + 2 * (_border_size >> 6); // space of at least one texel around all glyphs
-
-        int                           grid_size = static_cast<int>(ceil(math::sqrt(static_cast<double>(max_char - min_char))));
-        vec3ui                        glyph_texture_dim  = vec3ui(max_glyph_size * grid_size, style_count); // a 16x16 grid of 256 glyphs in 4 layers
-        size_t                        glyph_texture_size = static_cast<size_t>(glyph_texture_dim.x) * glyph_texture_dim.y * glyph_texture_dim.z;
-        scoped_array<unsigned char>   glyph_texture(new unsigned char[glyph_texture_size * glyph_components]);
-
-        if (_border_size > 0) { // border
-            memset(glyph_texture.get(), 0u, glyph_texture_size * glyph_components); // clear to black
+        if (gc._distance_field) {
+            // the field extends beyond the outline width, the coverage is rendered at up to
+            // 8 times the atlas resolution
+            gc._field_spread  = max(4, static_cast<int>(ceil(border_size)) + 2);
+            gc._field_upscale = max(1, min(8, 256 / static_cast<int>(font_size)));
 
+            gc._ft_field_faces.resize(style_count);
             for (int i = 0; i < style_count; ++i) {
-                std::string cur_font_file = _font_styles_available[i] ? font_style_files[i] : font_style_files[0];
-
-                detail::ft_face     ft_font(ft_lib, cur_font_file);
-                ft_font.set_size(font_size, display_dpi);
-                FT_Bitmap           bitmap;
-
-                for (unsigned c = min_char; c < max_char; ++c) {
-                    glyph_info& cur_glyph = _font_styles[i]._glyphs[c];
-                    FT_Glyph    ft_glyph;
-
-                    ft_font.load_glyph(c, glyph_load_flags);
-                    {
-                        detail::ft_stroker stroker(ft_lib, _border_size);
-                        FT_Error ft_err;
-
-                        ft_err = FT_Get_Glyph(ft_font.get_glyph(), &ft_glyph);
-                        if (ft_err) {
-                            throw std::runtime_error("font_face::font_face(): error during FT_Get_Glyph");
-                        }
-                        ft_err = FT_Glyph_Stroke(&ft_glyph, stroker.get_stroker(), true);
-                        if (ft_err) {
-                            throw std::runtime_error("font_face::font_face(): error during FT_Glyph_Stroke");
-                        }
-                        ft_err = FT_Glyph_To_Bitmap(&ft_glyph, glyph_render_mode, 0, true);
-                        if (ft_err) {
-                            throw std::runtime_error("font_face::font_face(): error during FT_Glyph_To_Bitmap");
-                        }
-                        FT_BitmapGlyph ft_bitmap_glyph = (FT_BitmapGlyph)ft_glyph;
-                        bitmap = ft_bitmap_glyph->bitmap;
-                    }
+                const std::string& cur_font_file = _font_styles_available[i] ? font_style_files[i] : font_style_files[0];
+                gc._ft_field_faces[i].reset(new detail::ft_face(gc._ft_library, cur_font_file));
 
-                    // calculate the glyphs grid position in the font texture array
-                    vec3ui tex_array_dst;
-                    tex_array_dst.x = ((c - min_char) % grid_size) * max_glyph_size.x;
-                    tex_array_dst.y = glyph_texture_dim.y - (((c - min_char) / grid_size) + 1) * max_glyph_size.y;
-                    //tex_array_dst.x = (c & 0x0F) * max_glyph_size.x;
-                    //tex_array_dst.y = glyph_texture_dim.y - ((c >> 4) + 1) * max_glyph_size.y;
-                    tex_array_dst.z = i;
-
-                    FT_BitmapGlyph ft_bitmap_glyph = (FT_BitmapGlyph)ft_glyph;
-                    cur_glyph._box_size         = vec2i(bitmap.width / glyph_bitmap_ycomp, bitmap.rows);
-                    cur_glyph._border_bearing   = vec2i(ft_bitmap_glyph->left, ft_bitmap_glyph->top - ft_bitmap_glyph->bitmap.rows);
-                    cur_glyph._texture_origin   = vec2f(static_cast<float>(tex_array_dst.x) / glyph_texture_dim.x,
-                                                        static_cast<float>(tex_array_dst.y) / glyph_texture_dim.y);
-                    cur_glyph._texture_box_size = vec2f(static_cast<float>(cur_glyph._box_size.x) / glyph_texture_dim.x,
-                                                        static_cast<float>(cur_glyph._box_size.y) / glyph_texture_dim.y);
-
-                    if (ft_font.get_face()->face_flags & FT_FACE_FLAG_SCALABLE) {
-                        // linearHoriAdvance contains the 16.16 representation of the horizontal advance
-                        // horiAdvance contains only the rounded advance which can be off by 1 and
-                        // lead to sub styles beeing rendered to narrow
-                        cur_glyph._advance          =  FT_CeilFix(ft_font.get_face()->glyph->linearHoriAdvance) >> 16;
-                    }
-                    else if (ft_font.get_face()->face_flags & FT_FACE_FLAG_FIXED_SIZES) {
-                        cur_glyph._advance          = ft_font.get_face()->glyph->metrics.horiAdvance >> 6;
-                    }
-                    cur_glyph._bearing          = vec2i(   ft_font.get_face()->glyph->metrics.horiBearingX >> 6,
-                                                          (ft_font.get_face()->glyph->metrics.horiBearingY >> 6)
-                                                        - (ft_font.get_face()->glyph->metrics.height >> 6));
-                    FT_Face ff = ft_font.get_face();
-                    int ksks = ft_font.get_face()->glyph->lsb_delta;
-                    int ksds = ft_font.get_face()->glyph->rsb_delta;
-
-                    // fill texture
-                    switch (bitmap.pixel_mode) {
-                        case FT_PIXEL_MODE_GRAY:
-                            for (unsigned dy = 0; dy < bitmap.rows; ++dy) {
-                                unsigned src_off = dy * bitmap.pitch;
-                                unsigned dst_off =    tex_array_dst.x
-                                                   + (tex_array_dst.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                   + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                for (unsigned dx = 0; dx < bitmap.width; ++dx) {
-                                    glyph_texture[(dst_off + dx) * glyph_components] = bitmap.buffer[src_off + dx];
-                                }
-                            }
-                            break;
-                        case FT_PIXEL_MODE_LCD:
-                            for (unsigned dy = 0; dy < bitmap.rows; ++dy) {
-                                unsigned src_off = dy * bitmap.pitch;
-                                unsigned dst_off =    tex_array_dst.x
-                                                   + (tex_array_dst.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                   + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                for (unsigned dx = 0; dx < bitmap.width / glyph_bitmap_ycomp; ++dx) {
-                                    glyph_texture[(dst_off + dx) * glyph_components    ] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp];
-                                    glyph_texture[(dst_off + dx) * glyph_components + 1] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp + 1];
-                                    glyph_texture[(dst_off + dx) * glyph_components + 2] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp + 2];
-                                }
-                            }
-                            break;
-                        case FT_PIXEL_MODE_MONO:
-                            for (unsigned dy = 0; dy < bitmap.rows; ++dy) {
-                                for (int dx = 0; dx < bitmap.pitch; ++dx) {
-                                    unsigned        src_off     = dx + dy * bitmap.pitch;
-                                    unsigned char   src_byte    = bitmap.buffer[src_off];
-                                    for (int bx = 0; bx < 8; ++bx) {
-                                        unsigned        dst_off =   (tex_array_dst.x + dx * 8 + bx)
-                                                                  + (tex_array_dst.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                                  + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                        unsigned char   src_set = src_byte & (0x80 >> bx);
-                                        unsigned char*  plah    = &src_byte;
-                                        for (int l = 0; l < glyph_components; ++l) {
-                                            glyph_texture[dst_off * glyph_components + l] = src_set ? 255u : 0u;
-                                        }
-                                    }
-                                }
-                            }
-                            break;
-                        default:
-                            continue;
-                    }
-                    FT_Done_Glyph(ft_glyph);
+                if (!(gc._ft_field_faces[i]->get_face()->face_flags & FT_FACE_FLAG_SCALABLE)) {
+                    std::ostringstream s;
+                    s << "font_face::font_face(): distance field glyphs require a scalable font (font: " << cur_font_file << ")";
+                    throw(std::runtime_error(s.str()));
                 }
+                gc._ft_field_faces[i]->set_size(font_size * gc._field_upscale, display_dpi);
             }
-            // end generate texture image
-            std::vector<void*> image_array_data_raw;
-            image_array_data_raw.push_back(glyph_texture.get());
-
-            _font_styles_border_texture_array = device->create_texture_2d(vec2ui(glyph_texture_dim.x, glyph_texture_dim.y),
-                                                                   glyph_texture_format, 1, glyph_texture_dim.z, 1,
-                                                                   glyph_texture_format, image_array_data_raw);
-
-            if (!_font_styles_border_texture_array) {
-                std::ostringstream s;
-                s << "font_face::font_face(): unable to create texture object (border).";
-                throw(std::runtime_error(s.str()));
-            }
-
-            image_array_data_raw.clear();
-        }
-        // TODO the bearing and box is not wrong!!! FIXME
-        { // core
-            memset(glyph_texture.get(), 0u, glyph_texture_size * glyph_components); // clear to black
 
+            namespace bfs = boost::filesystem;
+            boost::system::error_code ec;
+            bool                      stamped = true;
             for (int i = 0; i < style_count; ++i) {
-                std::string cur_font_file = _font_styles_available[i] ? font_style_files[i] : font_style_files[0];
-
-                detail::ft_face     ft_font(ft_lib, cur_font_file);
-                ft_font.set_size(font_size, display_dpi);
-                FT_Bitmap           bitmap;
-
-                for (unsigned c = min_char; c < max_char; ++c) {
-                    glyph_info&      cur_glyph = _font_styles[i]._glyphs[c];
-
-                    ft_font.load_glyph(c, glyph_load_flags);
-                    if (FT_Render_Glyph(ft_font.get_glyph(), glyph_render_mode)) {
-                        //glout() << static_cast<char>(c) << " afafaf";
-                        continue;
-                    }
-                    bitmap = ft_font.get_face()->glyph->bitmap;
-
-                    // calculate the glyphs grid position in the font texture array
-                    vec3ui tex_array_dst;
-                    tex_array_dst.x = ((c - min_char) % grid_size) * max_glyph_size.x;
-                    tex_array_dst.y = glyph_texture_dim.y - (((c - min_char) / grid_size) + 1) * max_glyph_size.y;
-                    //tex_array_dst.x = (c & 0x0F) * max_glyph_size.x;
-                    //tex_array_dst.y = glyph_texture_dim.y - ((c >> 4) + 1) * max_glyph_size.y;
-                    tex_array_dst.z = i;
-
-                    vec2i cur_core_box = vec2i(bitmap.width / glyph_bitmap_ycomp, bitmap.rows);
-                    vec2i cur_bm_bearing = vec2i(ft_font.get_face()->glyph->bitmap_left, ft_font.get_face()->glyph->bitmap_top - ft_font.get_face()->glyph->bitmap.rows);
-                    vec2i box_diff = vec2i::zero();
-                    if (_border_size > 0) {
-                        box_diff.x = max(0, cur_bm_bearing.x - cur_glyph._border_bearing.x);
-                        box_diff.y = max(0, cur_bm_bearing.y - cur_glyph._border_bearing.y);
-                    }
-                    cur_glyph._box_size.x = max(cur_glyph._box_size.x, cur_core_box.x);
-                    cur_glyph._box_size.y = max(cur_glyph._box_size.y, cur_core_box.y);
-
-                    cur_glyph._texture_origin   = vec2f(static_cast<float>(tex_array_dst.x) / glyph_texture_dim.x,
-                                                        static_cast<float>(tex_array_dst.y) / glyph_texture_dim.y);
-                    cur_glyph._texture_box_size = vec2f(static_cast<float>(cur_glyph._box_size.x) / glyph_texture_dim.x,
-                                                        static_cast<float>(cur_glyph._box_size.y) / glyph_texture_dim.y);
-
-                    if (ft_font.get_face()->face_flags & FT_FACE_FLAG_SCALABLE) {
-                        // linearHoriAdvance contains the 16.16 representation of the horizontal advance
-                        // horiAdvance contains only the rounded advance which can be off by 1 and
-                        // lead to sub styles beeing rendered to narrow
-                        cur_glyph._advance          =  FT_CeilFix(ft_font.get_face()->glyph->linearHoriAdvance) >> 16;
-                    }
-                    else if (ft_font.get_face()->face_flags & FT_FACE_FLAG_FIXED_SIZES) {
-                        cur_glyph._advance          = ft_font.get_face()->glyph->metrics.horiAdvance >> 6;
-                    }
-                    cur_glyph._bearing          = //vec2i(   ft_font.get_face()->glyph->metrics.horiBearingX >> 6,
-                                                  //        (ft_font.get_face()->glyph->metrics.horiBearingY >> 6)
-                                                  //      - (ft_font.get_face()->glyph->metrics.height >> 6))
-                                                    cur_bm_bearing
-                                                  - box_diff;
-                                                  //+ cur_glyph._border_bearing;
-                    // fill texture
-                    switch (bitmap.pixel_mode) {
-                        case FT_PIXEL_MODE_GRAY:
-                            for (unsigned dy = 0; dy < bitmap.rows; ++dy) {
-                                unsigned src_off = dy * bitmap.pitch;
-                                unsigned dst_off =    tex_array_dst.x + box_diff.x
-                                                   + (tex_array_dst.y + box_diff.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                   + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                for (unsigned dx = 0; dx < bitmap.width; ++dx) {
-                                    glyph_texture[(dst_off + dx) * glyph_components] = bitmap.buffer[src_off + dx];
-                                }
-                            }
-                            break;
-                        case FT_PIXEL_MODE_LCD:
-                            for (unsigned dy = 0; dy < bitmap.rows; ++dy) {
-                                unsigned src_off = dy * bitmap.pitch;
-                                unsigned dst_off =    tex_array_dst.x + box_diff.x
-                                                   + (tex_array_dst.y + box_diff.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                   + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                for (unsigned dx = 0; dx < bitmap.width / glyph_bitmap_ycomp; ++dx) {
-                                    glyph_texture[(dst_off + dx) * glyph_components    ] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp];
-                                    glyph_texture[(dst_off + dx) * glyph_components + 1] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp + 1];
-                                    glyph_texture[(dst_off + dx) * glyph_components + 2] = bitmap.buffer[src_off + dx * glyph_bitmap_ycomp + 2];
-                                }
-                            }
-                            break;
-                        case FT_PIXEL_MODE_MONO:
-                            for (unsigned dy = 0; dy < bitmap.rows; ++dy) {
-                                for (int dx = 0; dx < bitmap.pitch; ++dx) {
-                                    unsigned        src_off     = dx + dy * bitmap.pitch;
-                                    unsigned char   src_byte    = bitmap.buffer[src_off];
-                                    for (int bx = 0; bx < 8; ++bx) {
-                                        unsigned        dst_off =   (tex_array_dst.x + box_diff.x + dx * 8 + bx)
-                                                                  + (tex_array_dst.y + box_diff.y + bitmap.rows - 1 - dy) * glyph_texture_dim.x
-                                                                  + i * (glyph_texture_dim.x * glyph_texture_dim.y);
-                                        unsigned char   src_set = src_byte & (0x80 >> bx);
-                                        unsigned char*  plah    = &src_byte;
-                                        for (int l = 0; l < glyph_components; ++l) {
-                                            glyph_texture[dst_off * glyph_components + l] = src_set ? 255u : 0u;
-                                        }
-                                    }
-                                }
-                            }
-                            break;
-                        default:
-                            continue;
-                    }
+                gc._field_stamp._file_size[i]  = 0;
+                gc._field_stamp._write_time[i] = 0;
+                if (_font_styles_available[i]) {
+                    gc._field_stamp._file_size[i]  = static_cast<scm::uint64>(bfs::file_size(bfs::path(font_style_files[i]), ec));
+                    stamped = stamped && !ec;
+                    gc._field_stamp._write_time[i] = static_cast<scm::int64>(bfs::last_write_time(bfs::path(font_style_files[i]), ec));
+                    stamped = stamped && !ec;
                 }
             }
-            // end generate texture image
-            std::vector<void*> image_array_data_raw;
-            image_array_data_raw.push_back(glyph_texture.get());
-
-            _font_styles_texture_array = device->create_texture_2d(vec2ui(glyph_texture_dim.x, glyph_texture_dim.y),
-                                                                   glyph_texture_format, 1, glyph_texture_dim.z, 1,
-                                                                   glyph_texture_format, image_array_data_raw);
-
-            if (!_font_styles_texture_array) {
-                std::ostringstream s;
-                s << "font_face::font_face(): unable to create texture object.";
-                throw(std::runtime_error(s.str()));
+            gc._field_stamp._font_size  = font_size;
+            gc._field_stamp._dpi        = display_dpi;
+            gc._field_stamp._spread     = gc._field_spread;
+            gc._field_stamp._upscale    = gc._field_upscale;
+            if (stamped) {
+                gc._field_cache_path = distance_field_cache_file_name(font_file, point_size);
+                if (!gc._field_cache_path.empty()) {
+                    gc.load_field_cache();
+                }
             }
 
-            image_array_data_raw.clear();
+            max_glyph_size += math::vec2ui(1u) + 2 * gc._field_spread;
+        }
+        else {
+            max_glyph_size += math::vec2ui(1u) + 2 * (_border_size >> 6); // space of at least one texel around all glyphs
         }
 
-        glyph_texture.reset();
+        // atlas pages hold at least a 16x16 grid of the largest glyphs
+        unsigned page_dim = 256;
+        while (page_dim < 16 * max(max_glyph_size.x, max_glyph_size.y) && page_dim < 4096) {
+            page_dim *= 2;
+        }
+        gc._page_size   = vec2ui(page_dim);
+        gc._border_size = gc._distance_field ? 0 : _border_size;   // distance field outlines are drawn from the field
+        gc.add_page();
+
+        if (!update_textures(device->main_context())) {
+            std::ostringstream s;
+            s << "font_face::font_face(): unable to create texture object.";
+            throw(std::runtime_error(s.str()));
+        }
 
         std::stringstream os;
         os << std::fixed << std::setprecision(2)
            << "font_face::font_face(): " << std::endl
-           << " - created font textures for font '" << font_file << "' "
+           << " - opened font '" << font_file << "' "
            << "(point size: " << point_size << ", border size: " << border_size << ")" << std::endl
-           << "   - style texture:  format " << gl::format_string(glyph_texture_format)
-                << ", size " <<      glyph_texture_dim
-                << ", glyph box " << max_glyph_size
-                << ", memory " <<      static_cast<double>(glyph_texture_dim.x * glyph_texture_dim.y * glyph_texture_dim.z * size_of_format(glyph_texture_format)) / 1024.0 << "KiB";
-        if (_border_size > 0) {
+           << "   - glyph atlas: format " << gl::format_string(gc._glyph_texture_format)
+                << ", page size " << gc._page_size
+                << ", max pages " << max_atlas_pages
+                << ", page memory " << static_cast<double>(gc.page_image_size()) / 1024.0 << "KiB"
+                << (gc._border_size > 0 ? " (core and border)" : "");
+        if (gc._distance_field) {
             os << std::endl
-               << "   - border texture: format " << gl::format_string(glyph_texture_format)
-               << ", size " <<      glyph_texture_dim
-               << ", glyph box " << max_glyph_size
-               << ", memory " <<      static_cast<double>(glyph_texture_dim.x * glyph_texture_dim.y * glyph_texture_dim.z * size_of_format(glyph_texture_format)) / 1024.0 << "KiB";
+               << "   - distance field: spread " << gc._field_spread << " texels"
+                    << ", coverage upscale " << gc._field_upscale
+                    << ", cached glyphs " << gc._fields.size();
         }
         glout() << log::info << os.str();
 
@@ -646,10 +1050,11 @@ font_face::has_style(style_type s) const
     return (_font_styles_available[s]);
 }
 
-const font_face::glyph_info&
-font_face::glyph(char c, style_type s) const
+font_face::glyph_info
+font_face::glyph(code_point c, style_type s) const
 {
-    return (_font_styles[s]._glyphs[c]);
+    boost::mutex::scoped_lock lock(_glyph_cache->_mutex);
+    return (_glyph_cache->find_glyph(c, s));
 }
 
 unsigned
@@ -659,21 +1064,233 @@ font_face::line_advance(style_type s) const
 }
 
 int
-font_face::kerning(char l, char r, style_type s) const
+font_face::kerning(code_point l, code_point r, style_type s) const
 {
-    return (_font_styles[s]._kerning_table[l][r]);
+    glyph_cache&              gc = *_glyph_cache;
+    boost::mutex::scoped_lock lock(gc._mutex);
+
+    const scm::uint64                        key = (static_cast<scm::uint64>(l) << 32) | r;
+    glyph_cache::kerning_map::const_iterator k   = gc._kerning[s].find(key);
+
+    if (k == gc._kerning[s].end()) {
+        k = gc._kerning[s].insert(glyph_cache::kerning_map::value_type(key, gc._ft_faces[s]->get_kerning(l, r))).first;
+    }
+    return (k->second);
 }
 
-int
-font_face::underline_position(style_type s) const
+void
+font_face::prefetch_glyphs(const std::string& utf8_str,
+                           style_type         s,
+                           bool               in_background) const
 {
-    return (_font_styles[s]._underline_position);
+    glyph_cache& gc = *_glyph_cache;
+
+    if (in_background) {
+        gc.queue_prefetch(utf8_str, s);
+    }
+    else {
+        gc.prefetch(utf8_str, s);
+    }
 }
 
-int
-font_face::underline_thickness(style_type s) const
+bool
+font_face::update_textures(const render_context_ptr& context) const
+{
+    using namespace scm::math;
+
+    glyph_cache&              gc = *_glyph_cache;
+    boost::mutex::scoped_lock lock(gc._mutex);
+
+    if (gc._texture_layers < gc._pages.size() || !_font_styles_texture_array) {
+        // grow the texture arrays, all pages are uploaded with the new textures
+        render_device_ptr device = _render_device.lock();
+        if (!device) {
+            glerr() << log::error
+                    << "font_face::update_textures(): unable to optain render device from weak pointer." << log::end;
+            return (false);
+        }
+
+        unsigned layers = 1;
+        while (layers < gc._pages.size()) {
+            layers *= 2;
+        }
+        layers = min(layers, static_cast<unsigned>(max_atlas_pages));
+
+        const size_t page_size = gc.page_image_size();
+        scoped_array<unsigned char> layer_data(new unsigned char[page_size * layers]);
+        std::vector<void*>          image_array_data_raw(1, layer_data.get());
+
+        memset(layer_data.get(), 0u, page_size * layers);
+        for (size_t p = 0; p < gc._pages.size(); ++p) {
+            std::copy(gc._core_images[p].begin(), gc._core_images[p].end(), layer_data.get() + p * page_size);
+        }
+        texture_2d_ptr core_texture = device->create_texture_2d(gc._page_size, gc._glyph_texture_format, 1, layers, 1,
+                                                                gc._glyph_texture_format, image_array_data_raw);
+        if (!core_texture) {
+            glerr() << log::error
+                    << "font_face::update_textures(): unable to create texture object (layers: " << layers << ")." << log::end;
+            return (false);
+        }
+
+        texture_2d_ptr border_texture;
+        if (gc._border_size > 0) {
+            for (size_t p = 0; p < gc._pages.size(); ++p) {
+                std::copy(gc._border_images[p].begin(), gc._border_images[p].end(), layer_data.get() + p * page_size);
+            }
+            border_texture = device->create_texture_2d(gc._page_size, gc._glyph_texture_format, 1, layers, 1,
+                                                       gc._glyph_texture_format, image_array_data_raw);
+            if (!border_texture) {
+                glerr() << log::error
+                        << "font_face::update_textures(): unable to create texture object (border, layers: " << layers << ")." << log::end;
+                return (false);
+            }
+        }
+
+        _font_styles_texture_array        = core_texture;
+        _font_styles_border_texture_array = border_texture;
+        gc._texture_layers                = layers;
+
+        for (size_t p = 0; p < gc._pages.size(); ++p) {
+            gc._pages[p]._dirty = false;
+        }
+        return (true);
+    }
+
+    // upload the bounding region of the glyphs rasterized since the last update per page
+    std::vector<unsigned char> region_data;
+    for (unsigned p = 0; p < gc._pages.size(); ++p) {
+        glyph_cache::page& cp = gc._pages[p];
+        if (!cp._dirty) {
+            continue;
+        }
+        const vec2ui region_size = cp._dirty_max - cp._dirty_min;
+        const size_t row_size    = static_cast<size_t>(region_size.x) * gc._glyph_components;
+        const texture_region region(vec3ui(cp._dirty_min, p), vec3ui(region_size, 1u));
+
+        region_data.resize(row_size * region_size.y);
+        for (int t = 0; t < (gc._border_size > 0 ? 2 : 1); ++t) {
+            const glyph_cache::page_image& src_image = t == 0 ? gc._core_images[p] : gc._border_images[p];
+            for (unsigned y = 0; y < region_size.y; ++y) {
+                const size_t src_off = ((cp._dirty_min.y + y) * static_cast<size_t>(gc._page_size.x) + cp._dirty_min.x) * gc._glyph_components;
+                std::copy(src_image.begin() + src_off, src_image.begin() + src_off + row_size, region_data.begin() + y * row_size);
+            }
+            const texture_2d_ptr& dst_texture = t == 0 ? _font_styles_texture_array : _font_styles_border_texture_array;
+            if (!context->update_sub_texture(dst_texture, region, 0, gc._glyph_texture_format, &region_data.front())) {
+                glerr() << log::error
+                        << "font_face::update_textures(): unable to update texture region (page: " << p << ")." << log::end;
+                return (false);
+            }
+        }
+        cp._dirty = false;
+    }
+
+    return (true);
+}
+
+unsigned
+font_face::distance_field_spread() const
+{
+    return (_glyph_cache->_distance_field ? static_cast<unsigned>(_glyph_cache->_field_spread) : 0u);
+}
+
+void
+font_face::distance_field_cache_directory(const std::string& directory)
 {
-    return (_font_styles[s]._underline_thickness);
+    boost::mutex::scoped_lock lock(detail::field_cache_directory_mutex);
+    detail::field_cache_directory     = directory;
+    detail::field_cache_directory_set = true;
+}
+
+std::string
+font_face::distance_field_cache_directory()
+{
+    boost::mutex::scoped_lock lock(detail::field_cache_directory_mutex);
+    if (!detail::field_cache_directory_set) {
+        boost::system::error_code ec;
+        boost::filesystem::path   temp_dir = boost::filesystem::temp_directory_path(ec);
+        detail::field_cache_directory     = ec ? std::string() : (temp_dir / "scm_font_cache").string();
+        detail::field_cache_directory_set = true;
+    }
+    return (detail::field_cache_directory);
+}
+
+std::string
+font_face::distance_field_cache_file_name(const std::string& font_file,
+                                          unsigned           point_size)
+{
+    using namespace boost::filesystem;
+
+    const std::string cache_dir = distance_field_cache_directory();
+    if (cache_dir.empty()) {
+        return (std::string());
+    }
+
+    boost::system::error_code ec;
+    path                      font_path = canonical(path(font_file), ec);
+    if (ec) {
+        font_path = absolute(path(font_file));
+    }
+
+    std::ostringstream s;
+    s << font_path.filename().string() << "."
+      << std::hex << std::setw(16) << std::setfill('0') << detail::field_cache_path_hash(font_path.generic_string())
+      << std::dec << "." << point_size << ".sdf";
+    return ((path(cache_dir) / s.str()).string());
+}
+
+unsigned
+font_face::atlas_generation() const
+{
+    boost::mutex::scoped_lock lock(_glyph_cache->_mutex);
+    return (_glyph_cache->_generation);
+}
+
+unsigned
+font_face::atlas_page_count() const
+{
+    boost::mutex::scoped_lock lock(_glyph_cache->_mutex);
+    return (static_cast<unsigned>(_glyph_cache->_pages.size()));
+}
+
+const math::vec2ui&
+font_face::atlas_page_size() const
+{
+    return (_glyph_cache->_page_size);
+}
+
+font_face::code_point
+font_face::next_code_point(std::string::const_iterator&       it,
+                           const std::string::const_iterator& end)
+{
+    const code_point    replacement = 0xfffd;
+    const unsigned char lead        = static_cast<unsigned char>(*it++);
+
+    if (lead < 0x80) {
+        return (lead);
+    }
+
+    unsigned    trail_bytes;
+    code_point  c;
+    code_point  min_c;
+    if      ((lead & 0xe0) == 0xc0) { trail_bytes = 1; c = lead & 0x1f; min_c = 0x80; }
+    else if ((lead & 0xf0) == 0xe0) { trail_bytes = 2; c = lead & 0x0f; min_c = 0x800; }
+    else if ((lead & 0xf8) == 0xf0) { trail_bytes = 3; c = lead & 0x07; min_c = 0x10000; }
+    else {
+        return (replacement);
+    }
+
+    for (unsigned i = 0; i < trail_bytes; ++i) {
+        if (it == end || (static_cast<unsigned char>(*it) & 0xc0) != 0x80) {
+            return (replacement);
+        }
+        c = (c << 6) | (static_cast<unsigned char>(*it++) & 0x3f);
+    }
+    // overlong encodings, surrogates and values beyond the unicode range
+    if (c < min_c || c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff)) {
+        return (replacement);
+    }
+
+    return (c);
 }
 
 void
@@ -682,6 +1299,8 @@ font_face::cleanup()
     _font_styles.clear();
     _font_styles_available.clear();
     _font_styles_texture_array.reset();
+    _font_styles_border_texture_array.reset();
+    _glyph_cache.reset();
 }
 
 const texture_2d_ptr&
@@ -6,13 +6,13 @@
 #define SCM_GL_UTIL_FONT_FACE_H_INCLUDED
 
 #include <cstddef>
-#include <map>
 #include <string>
 #include <vector>
 
-#include <boost/multi_array.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
 
 #include <scm/gl_core/gl_core_fwd.h>
 
@@ -24,9 +24,25 @@
 namespace scm {
 namespace gl {
 
+// font_face
+//  - glyphs of all styles are rasterized on first use and shelf-packed into the pages
+//    (layers) of the style texture arrays, text is given as UTF-8
+//  - the texture arrays grow up to max_atlas_pages layers, beyond that the least recently
+//    used page is evicted, which increments the atlas generation (text objects laid out
+//    with an older generation have to be updated)
+//  - newly rasterized glyphs are uploaded by update_textures() on the rendering thread,
+//    prefetch_glyphs() can rasterize the glyphs of a string ahead of time, background requests
+//    are queued and rasterized in order by a task on the core task scheduler
+//  - smooth_distance_field stores signed distance fields of the glyphs instead of coverage,
+//    one atlas serves all text scales, outlines (border size) and shadows are drawn from the
+//    field, the fields are generated in parallel by prefetch_glyphs() and cached on disk
+//    in the distance field cache directory (distance_field_cache_file_name()), the cache
+//    is stamped with the size and write time of all style files of the font
 class __scm_export(gl_util) font_face
 {
 public:
+    typedef scm::uint32     code_point;
+
     typedef enum {
         style_regular       = 0x00,
         style_italic,
@@ -38,12 +54,14 @@ public:
     typedef enum {
         smooth_normal   = 0x00,
         smooth_lcd,
+        smooth_distance_field,
 
         smooth_count
     } smooth_type;
     struct glyph_info {
         math::vec2f    _texture_origin;
         math::vec2f    _texture_box_size;
+        unsigned       _texture_layer;
 
         math::vec2i    _box_size;
         math::vec2i    _border_bearing;
@@ -53,6 +71,7 @@ public:
         glyph_info()
           : _texture_origin(math::vec2f::zero())
           , _texture_box_size(math::vec2f::zero())
+          , _texture_layer(0)
           , _box_size(math::vec2i::zero())
           , _border_bearing(math::vec2i::zero())
           , _advance(0)
@@ -61,8 +80,7 @@ public:
         }
     }; // struct glyph_info
 
-    static const unsigned       min_char = 32u;
-    static const unsigned       max_char = 128u;
+    static const unsigned       max_atlas_pages      = 16;
 
     static const unsigned       default_point_size   = 12;
     //static const float          default_border_size  = 0.0f;
@@ -70,16 +88,13 @@ public:
     static const smooth_type    default_smooth_style = smooth_normal;
 
 protected:
-    typedef std::vector<glyph_info>     glyph_container;
-    typedef boost::multi_array<char, 2> kerning_table;
     struct font_style {
-        glyph_container _glyphs;
-        kerning_table   _kerning_table;
         int             _underline_position;
         unsigned        _underline_thickness;
         unsigned        _line_spacing;
     }; // struct style_info
     typedef std::vector<font_style>     style_container;
+    struct glyph_cache;
 
 public:
     font_face(const render_device_ptr& device,                  
@@ -97,9 +112,18 @@ public:
     smooth_type                     smooth_style() const;
     bool                            has_style(style_type s) const;
 
-    const glyph_info&               glyph(char c, style_type s = style_regular) const;
+    glyph_info                      glyph(code_point c, style_type s = style_regular) const;
     unsigned                        line_advance(style_type s = style_regular) const;
-    int                             kerning(char l, char r, style_type s = style_regular) const;
+    int                             kerning(code_point l, code_point r, style_type s = style_regular) const;
+
+    void                            prefetch_glyphs(const std::string& utf8_str,
+                                                    style_type         s             = style_regular,
+                                                    bool               in_background = false) const;
+    bool                            update_textures(const render_context_ptr& context) const;
+    unsigned                        atlas_generation() const;
+    unsigned                        atlas_page_count() const;
+    const math::vec2ui&             atlas_page_size() const;
+    unsigned                        distance_field_spread() const;      // in atlas texels, 0 for coverage glyphs
 
     int                             underline_position(style_type s = style_regular) const;
     int                             underline_thickness(style_type s = style_regular) const;
@@ -107,18 +131,30 @@ public:
     const texture_2d_ptr&           styles_texture_array() const;
     const texture_2d_ptr&           styles_border_texture_array() const;
 
-protected:
-    void                            render_glyphs();
+    // default: <temp directory>/scm_font_cache, an empty directory disables the disk cache
+    static void                     distance_field_cache_directory(const std::string& directory);
+    static std::string              distance_field_cache_directory();
+    // empty if the disk cache is disabled
+    static std::string              distance_field_cache_file_name(const std::string& font_file,
+                                                                   unsigned           point_size);
 
+    // decodes the next code point of an UTF-8 string, invalid sequences yield U+FFFD
+    static code_point               next_code_point(std::string::const_iterator&      it,
+                                                    const std::string::const_iterator& end);
+
+protected:
     void                            cleanup();
 
 protected:
     style_container                 _font_styles;
     std::vector<bool>               _font_styles_available;
-    texture_2d_ptr                  _font_styles_texture_array;
-    texture_2d_ptr                  _font_styles_border_texture_array;
+    mutable texture_2d_ptr          _font_styles_texture_array;
+    mutable texture_2d_ptr          _font_styles_border_texture_array;
     smooth_type                     _font_smooth_style;
 
+    render_device_wptr              _render_device;
+    boost::scoped_ptr<glyph_cache>  _glyph_cache;
+
     std::string                     _name;
     unsigned                        _point_size;
     unsigned                        _border_size;
@@ -30,9 +30,10 @@ struct vertex {
 #if GEOM_SHADER_FONT == 1
     scm::math::vec4f pos_bbox;
     scm::math::vec4f tex_bbox;
+    float            tex_layer;
 #else
     scm::math::vec2f pos;
-    scm::math::vec2f tex;
+    scm::math::vec3f tex;
 #endif
 };
 } // namespace
@@ -48,11 +49,13 @@ text::text(const render_device_ptr&     device,
   , _text_style(stl)
   , _text_string(str)
   , _text_kerning(true)
+  , _text_scale(1.0f)
   , _text_color(math::vec4f::one())
   , _text_outline_color(math::vec4f(0.0f, 0.0f, 0.0f, 1.0f))
   , _text_shadow_color(math::vec4f(0.0f, 0.0f, 0.0f, 1.0f))
   , _text_shadow_offset(math::vec2i(1, -1))
   , _text_bounding_box(math::vec2i(0, 0))
+  , _atlas_generation(0)
   , _indices_count(0)
   , _topology(PRIMITIVE_TRIANGLE_LIST)
   , _glyph_capacity(20)
@@ -65,7 +68,8 @@ text::text(const render_device_ptr&     device,
     int num_vertices = _glyph_capacity; // one point per glyph 
     _vertex_buffer = device->create_buffer(BIND_VERTEX_BUFFER, USAGE_STREAM_DRAW, num_vertices * sizeof(vertex), 0);
     _vertex_array  = device->create_vertex_array(vertex_format(0, 0, TYPE_VEC4F, sizeof(vertex))
-                                                              (0, 2, TYPE_VEC4F, sizeof(vertex)),
+                                                              (0, 2, TYPE_VEC4F, sizeof(vertex))
+                                                              (0, 3, TYPE_FLOAT, sizeof(vertex)),
                                                  list_of(_vertex_buffer));
 #else
     int num_vertices = _glyph_capacity * 4; // one quad per glyph 
@@ -73,7 +77,7 @@ text::text(const render_device_ptr&     device,
     _vertex_buffer = device->create_buffer(BIND_VERTEX_BUFFER, USAGE_STREAM_DRAW, num_vertices * sizeof(vertex), 0);
     _index_buffer  = device->create_buffer(BIND_INDEX_BUFFER, USAGE_STREAM_DRAW,  num_indices  * sizeof(unsigned short), 0);
     _vertex_array  = device->create_vertex_array(vertex_format(0, 0, TYPE_VEC2F, sizeof(vertex))
-                                                              (0, 2, TYPE_VEC2F, sizeof(vertex)),
+                                                              (0, 2, TYPE_VEC3F, sizeof(vertex)),
                                                  list_of(_vertex_buffer));
 
     // fill index data
@@ -148,6 +152,18 @@ text::text_kerning(bool k)
     _text_kerning = k;
 }
 
+float
+text::text_scale() const
+{
+    return _text_scale;
+}
+
+void
+text::text_scale(float s)
+{
+    _text_scale = s;
+}
+
 const math::vec4f&
 text::text_color() const
 {
@@ -196,10 +212,10 @@ text::text_shadow_offset(const math::vec2i& o)
     _text_shadow_offset = o;
 }
 
-const math::vec2i&
+math::vec2i
 text::text_bounding_box() const
 {
-    return _text_bounding_box;
+    return math::vec2i(math::vec2f(_text_bounding_box) * _text_scale + math::vec2f(0.5f));
 }
 
 void
@@ -277,55 +293,65 @@ text::update()
                 return;
             }
             vertex*const    vertex_data = reinterpret_cast<vertex*const>(vb_map.data_ptr());
-            vec2i           current_pos = vec2i(0, 0);
-            int             current_lw  = 0;
-            char            prev_char   = 0;
 
-            _indices_count     = 0;
-            _text_bounding_box = vec2i(0, _font->line_advance(_text_style));
             assert(_text_string.size() < (6 * (std::numeric_limits<unsigned short>::max)()));
 
-            std::for_each(_text_string.begin(), _text_string.end(), [&](char cur_char) -> void {
-                using namespace scm::gl;
-                using namespace scm::math;
-
-                if (cur_char == '\n') {
-                    current_pos.x         = 0;
-                    current_pos.y        -= _font->line_advance(_text_style);
-                    prev_char             = 0;
-                    _text_bounding_box.y += _font->line_advance(_text_style);
-                    _text_bounding_box.x  = max(current_lw, _text_bounding_box.x);
-                    current_lw            = 0;
-                }
-                else if (font_face::min_char <= cur_char && cur_char < font_face::max_char) {
-                    const font_face::glyph_info& cur_glyph = _font->glyph(cur_char, _text_style);
-                    // kerning
-                    if (_text_kerning && prev_char) {
-                        current_pos.x += _font->kerning(prev_char, cur_char, _text_style);
+            // glyphs rasterized during the layout may evict atlas pages holding glyphs laid out
+            // before, in this case the layout is repeated once with the glyphs of the text resident
+            for (int layout_pass = 0; layout_pass < 2; ++layout_pass) {
+                const unsigned          layout_generation = _font->atlas_generation();
+                vec2i                   current_pos       = vec2i(0, 0);
+                int                     current_lw        = 0;
+                font_face::code_point   prev_char         = 0;
+
+                _indices_count     = 0;
+                _text_bounding_box = vec2i(0, _font->line_advance(_text_style));
+
+                for (std::string::const_iterator c = _text_string.begin(); c != _text_string.end();) {
+                    const font_face::code_point cur_char = font_face::next_code_point(c, _text_string.end());
+
+                    if (cur_char == '\n') {
+                        current_pos.x         = 0;
+                        current_pos.y        -= _font->line_advance(_text_style);
+                        prev_char             = 0;
+                        _text_bounding_box.y += _font->line_advance(_text_style);
+                        _text_bounding_box.x  = max(current_lw, _text_bounding_box.x);
+                        current_lw            = 0;
+                    }
+                    else if (cur_char >= 32u) {
+                        const font_face::glyph_info cur_glyph = _font->glyph(cur_char, _text_style);
+                        // kerning
+                        if (_text_kerning && prev_char) {
+                            current_pos.x += _font->kerning(prev_char, cur_char, _text_style);
+                        }
+
+                        vec2f pos  = vec2f(current_pos + cur_glyph._bearing);
+                        vec2f bbox = vec2f(cur_glyph._box_size);
+                        vertex_data[_indices_count].pos_bbox  = vec4f(pos, bbox.x, bbox.y);
+                        vertex_data[_indices_count].tex_bbox  = vec4f(cur_glyph._texture_origin, cur_glyph._texture_box_size.x, cur_glyph._texture_box_size.y);
+                        vertex_data[_indices_count].tex_layer = static_cast<float>(cur_glyph._texture_layer);
+
+                        _indices_count += 1;
+                        // advance the position
+                        current_pos.x += cur_glyph._advance;
+                        current_lw    += cur_glyph._advance;
+
+                        // remember just drawn glyph for kerning
+                        prev_char = cur_char;
                     }
-
-                    vec2f pos  = vec2f(current_pos + cur_glyph._bearing);   
-                    vec2f bbox = vec2f(cur_glyph._box_size);   
-                    vertex_data[_indices_count].pos_bbox = vec4f(pos, bbox.x, bbox.y);
-                    vertex_data[_indices_count].tex_bbox = vec4f(cur_glyph._texture_origin, cur_glyph._texture_box_size.x, cur_glyph._texture_box_size.y);
-
-                    _indices_count += 1;
-                    // advance the position
-                    current_pos.x += cur_glyph._advance;
-                    current_lw    += cur_glyph._advance;
-
-                    // remember just drawn glyph for kerning
-                    prev_char = cur_char;
                 }
-                else {
+                _text_bounding_box.x  = max(current_lw, _text_bounding_box.x);
+                _atlas_generation     = layout_generation;
+
+                if (_font->atlas_generation() == layout_generation) {
+                    break;
                 }
-            });
-            _text_bounding_box.x  = max(current_lw, _text_bounding_box.x);
+            }
         }
 #else
-        vec2i           current_pos = vec2i(0, 0);
-        int             current_lw  = 0;
-        char            prev_char   = 0;
+        vec2i                   current_pos = vec2i(0, 0);
+        int                     current_lw  = 0;
+        font_face::code_point   prev_char   = 0;
         //vertex*         vertex_data = static_cast<vertex*>(context->map_buffer_range(_vertex_buffer, 0, 4 * _text_string.size() * sizeof(vertex), ACCESS_WRITE_INVALIDATE_BUFFER));
         vertex*         vertex_data = static_cast<vertex*>(context->map_buffer(_vertex_buffer, ACCESS_WRITE_INVALIDATE_BUFFER));
 
@@ -337,15 +363,12 @@ text::update()
 
         _indices_count     = 0;
         _text_bounding_box = vec2i(0, _font->line_advance(_text_style));
+        _atlas_generation  = _font->atlas_generation();
         assert(_text_string.size() < (6 * (std::numeric_limits<unsigned short>::max)()));
         //unsigned short str_size = static_cast<unsigned short>( _text_string.size());
         size_t i = 0;
-        std::for_each(_text_string.begin(), _text_string.end(), [&](char cur_char) -> void {
-        //for (size_t i = 0; i < _text_string.size(); ++i) {
-        //    char  cur_char = _text_string[i];
-
-            using namespace scm::gl;
-            using namespace scm::math;
+        for (std::string::const_iterator c = _text_string.begin(); c != _text_string.end();) {
+            const font_face::code_point cur_char = font_face::next_code_point(c, _text_string.end());
 
             if (cur_char == '\n') {
                 current_pos.x         = 0;
@@ -355,11 +378,9 @@ text::update()
                 _text_bounding_box.x  = max(current_lw, _text_bounding_box.x);
                 current_lw            = 0;
             }
-            else {
-                //if (!isalnum(cur_char) && (cur_char != ' ')) {
-                //    continue;
-                //}
-                const font_face::glyph_info& cur_glyph = _font->glyph(cur_char, _text_style);
+            else if (cur_char >= 32u) {
+                const font_face::glyph_info cur_glyph = _font->glyph(cur_char, _text_style);
+                const float                 layer     = static_cast<float>(cur_glyph._texture_layer);
                 // kerning
                 if (_text_kerning && prev_char) {
                     current_pos.x += _font->kerning(prev_char, cur_char, _text_style);
@@ -370,15 +391,10 @@ text::update()
                 vertex_data[i * 4 + 2].pos = vec2f(current_pos + cur_glyph._bearing + cur_glyph._box_size);             // 11
                 vertex_data[i * 4 + 3].pos = vec2f(current_pos + cur_glyph._bearing + vec2i(0, cur_glyph._box_size.y)); // 01
 
-                vertex_data[i * 4    ].tex = cur_glyph._texture_origin;                                              // 00
-                vertex_data[i * 4 + 1].tex = cur_glyph._texture_origin + vec2f(cur_glyph._texture_box_size.x, 0.0f); // 10
-                vertex_data[i * 4 + 2].tex = cur_glyph._texture_origin + cur_glyph._texture_box_size;                // 11
-                vertex_data[i * 4 + 3].tex = cur_glyph._texture_origin + vec2f(0.0f, cur_glyph._texture_box_size.y); // 01
-
-                //vertex_data[i * 4    ].tex.z = static_cast<float>(_text_style);
-                //vertex_data[i * 4 + 1].tex.z = static_cast<float>(_text_style);
-                //vertex_data[i * 4 + 2].tex.z = static_cast<float>(_text_style);
-                //vertex_data[i * 4 + 3].tex.z = static_cast<float>(_text_style);
+                vertex_data[i * 4    ].tex = vec3f(cur_glyph._texture_origin, layer);                                              // 00
+                vertex_data[i * 4 + 1].tex = vec3f(cur_glyph._texture_origin + vec2f(cur_glyph._texture_box_size.x, 0.0f), layer); // 10
+                vertex_data[i * 4 + 2].tex = vec3f(cur_glyph._texture_origin + cur_glyph._texture_box_size, layer);                // 11
+                vertex_data[i * 4 + 3].tex = vec3f(cur_glyph._texture_origin + vec2f(0.0f, cur_glyph._texture_box_size.y), layer); // 01
 
                 _indices_count += 6;
                 ++i;
@@ -389,11 +405,14 @@ text::update()
                 // remember just drawn glyph for kerning
                 prev_char = cur_char;
             }
-        });
+        }
         _text_bounding_box.x  = max(current_lw, _text_bounding_box.x);
         
         context->unmap_buffer(_vertex_buffer);
 #endif
+
+        // upload the glyphs rasterized for this text
+        _font->update_textures(context);
     }
     else {
         err() << log::error
@@ -37,6 +37,9 @@ public:
                                             const font_face::style_type stl);
     bool                        text_kerning() const;
     void                        text_kerning(bool k);
+    // scale of the glyphs over the font point size, meant for distance field fonts
+    float                       text_scale() const;
+    void                        text_scale(float s);
 
     const math::vec4f&          text_color() const;
     void                        text_color(const math::vec4f& c) ;
@@ -47,7 +50,7 @@ public:
     const math::vec2i&          text_shadow_offset() const;
     void                        text_shadow_offset(const math::vec2i& o);
 
-    const math::vec2i&          text_bounding_box() const;
+    math::vec2i                 text_bounding_box() const;
 
 protected:
     void                        update();
@@ -57,13 +60,15 @@ protected:
     font_face::style_type       _text_style;
     std::string                 _text_string;
     bool                        _text_kerning;
+    float                       _text_scale;
 
     math::vec4f                 _text_color;
     math::vec4f                 _text_outline_color;
     math::vec4f                 _text_shadow_color;
     math::vec2i                 _text_shadow_offset;
 
-    math::vec2i                 _text_bounding_box;
+    math::vec2i                 _text_bounding_box;     // unscaled
+    unsigned                    _atlas_generation;      // font atlas generation of the glyph layout
 
     int                         _glyph_capacity;
     buffer_ptr                  _vertex_buffer;
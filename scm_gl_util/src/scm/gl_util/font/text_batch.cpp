@@ -0,0 +1,320 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "text_batch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <boost/assign/list_of.hpp>
+
+#include <scm/log.h>
+
+#include <scm/gl_core/math.h>
+#include <scm/gl_core/buffer_objects.h>
+#include <scm/gl_core/render_device.h>
+
+#include <scm/gl_util/font/text.h>
+
+namespace {
+
+struct batch_vertex {
+    scm::math::vec4f pos_bbox;
+    scm::math::vec4f tex_bbox;
+    float            tex_layer;
+    scm::math::vec4f color;
+    scm::math::vec4f outline_color;
+};
+
+// draws held by the streaming ring before an allocation waits for the oldest one
+const scm::size_t stream_draw_count = 3;
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+text_batch::text_batch(const render_device_ptr& device,
+                       unsigned                 glyph_capacity)
+  : _glyph_capacity(0)
+  , _render_device(device)
+{
+    if (!create_stream(device, (std::max)(glyph_capacity, 64u))) {
+        err() << log::error << "text_batch::text_batch(): error creating vertex buffer." << log::end;
+        throw std::runtime_error("text_batch::text_batch(): error creating vertex buffer.");
+    }
+}
+
+text_batch::~text_batch()
+{
+    _vertex_array.reset();
+    _vertex_buffer.reset();
+    _stream.reset();
+}
+
+void
+text_batch::clear()
+{
+    // keep the allocations for the next frame
+    _fonts.clear();
+    _runs.clear();
+    _string_data.clear();
+}
+
+bool
+text_batch::empty() const
+{
+    return _runs.empty();
+}
+
+scm::size_t
+text_batch::run_count() const
+{
+    return _runs.size();
+}
+
+void
+text_batch::append(const math::vec2i&          pos,
+                   const font_face_cptr&       font,
+                   const font_face::style_type stl,
+                   const std::string&          str,
+                   const math::vec4f&          color,
+                   bool                        kerning,
+                   float                       scale)
+{
+    append_run(pos, font, stl, str, color, math::vec4f::zero(), kerning, scale);
+}
+
+void
+text_batch::append_outlined(const math::vec2i&          pos,
+                            const font_face_cptr&       font,
+                            const font_face::style_type stl,
+                            const std::string&          str,
+                            const math::vec4f&          color,
+                            const math::vec4f&          outline_color,
+                            bool                        kerning,
+                            float                       scale)
+{
+    append_run(pos, font, stl, str, color, outline_color, kerning, scale);
+}
+
+void
+text_batch::append(const math::vec2i& pos,
+                   const text_cptr&   txt)
+{
+    append_run(pos, txt->font(), txt->text_style(), txt->text_string(),
+               txt->text_color(), math::vec4f::zero(), txt->text_kerning(), txt->text_scale());
+}
+
+void
+text_batch::append_shadowed(const math::vec2i& pos,
+                            const text_cptr&   txt)
+{
+    append_run(pos + txt->text_shadow_offset(), txt->font(), txt->text_style(), txt->text_string(),
+               txt->text_shadow_color(), math::vec4f::zero(), txt->text_kerning(), txt->text_scale());
+    append_run(pos, txt->font(), txt->text_style(), txt->text_string(),
+               txt->text_color(), math::vec4f::zero(), txt->text_kerning(), txt->text_scale());
+}
+
+void
+text_batch::append_outlined(const math::vec2i& pos,
+                            const text_cptr&   txt)
+{
+    append_run(pos, txt->font(), txt->text_style(), txt->text_string(),
+               txt->text_color(), txt->text_outline_color(), txt->text_kerning(), txt->text_scale());
+}
+
+void
+text_batch::append_run(const math::vec2i&          pos,
+                       const font_face_cptr&       font,
+                       const font_face::style_type stl,
+                       const std::string&          str,
+                       const math::vec4f&          color,
+                       const math::vec4f&          outline_color,
+                       bool                        kerning,
+                       float                       scale)
+{
+    if (!font || str.empty()) {
+        return;
+    }
+
+    std::vector<font_face_cptr>::const_iterator f = std::find(_fonts.begin(), _fonts.end(), font);
+    if (f == _fonts.end()) {
+        f = _fonts.insert(_fonts.end(), font);
+    }
+
+    text_run run;
+    run._position      = pos;
+    run._font          = static_cast<unsigned>(f - _fonts.begin());
+    run._style         = stl;
+    run._kerning       = kerning;
+    run._scale         = scale;
+    run._string_offset = _string_data.size();
+    run._string_length = str.size();
+    run._color         = color;
+    run._outline_color = outline_color;
+
+    _string_data.append(str);
+    _runs.push_back(run);
+}
+
+bool
+text_batch::create_stream(const render_device_ptr& device,
+                          scm::size_t              glyph_capacity)
+{
+    using boost::assign::list_of;
+
+    // a ring size of whole vertices keeps all allocations (aligned to the vertex size) at
+    // vertex boundaries, the draws start at the vertex index of their range
+    _stream.reset(new streaming_buffer(device, BIND_VERTEX_BUFFER, stream_draw_count * glyph_capacity * sizeof(batch_vertex)));
+    if (_stream->ok()) {
+        _vertex_buffer = _stream->stream_buffer();
+    }
+    else {
+        _stream.reset();
+        _vertex_buffer = device->create_buffer(BIND_VERTEX_BUFFER, USAGE_STREAM_DRAW, glyph_capacity * sizeof(batch_vertex), 0);
+    }
+    if (!_vertex_buffer) {
+        return false;
+    }
+    _vertex_array  = device->create_vertex_array(vertex_format(0, 0, TYPE_VEC4F, sizeof(batch_vertex))
+                                                              (0, 2, TYPE_VEC4F, sizeof(batch_vertex))
+                                                              (0, 3, TYPE_FLOAT, sizeof(batch_vertex))
+                                                              (0, 4, TYPE_VEC4F, sizeof(batch_vertex))
+                                                              (0, 5, TYPE_VEC4F, sizeof(batch_vertex)),
+                                                 list_of(_vertex_buffer));
+    _glyph_capacity = glyph_capacity;
+
+    return static_cast<bool>(_vertex_array);
+}
+
+bool
+text_batch::commit(const render_context_ptr& context,
+                   draw_range_array&         ranges)
+{
+    using namespace scm::math;
+
+    ranges.clear();
+
+    if (_runs.empty()) {
+        return true;
+    }
+
+    // the string bytes are an upper bound for the glyph count
+    const scm::size_t max_glyphs = _string_data.size();
+
+    if (max_glyphs > _glyph_capacity) {
+        // the draws still using the previous ring keep its buffer alive
+        render_device_ptr device = _render_device.lock();
+        if (!device) {
+            err() << log::error
+                  << "text_batch::commit(): unable to optain render device from weak pointer." << log::end;
+            return false;
+        }
+        const scm::size_t new_capacity = max_glyphs + max_glyphs / 2;
+        if (!create_stream(device, new_capacity)) {
+            err() << log::error
+                  << "text_batch::commit(): unable to resize vertex buffer (size : " << new_capacity * sizeof(batch_vertex) << ")." << log::end;
+            return false;
+        }
+    }
+
+    batch_vertex* vertex_data = 0;
+    int           first_glyph = 0;
+    if (_stream) {
+        const streaming_buffer::allocation a = _stream->allocate(context, max_glyphs * sizeof(batch_vertex), sizeof(batch_vertex));
+        vertex_data = static_cast<batch_vertex*>(a._data);
+        first_glyph = static_cast<int>(a._offset / sizeof(batch_vertex));
+    }
+    else {
+        vertex_data = static_cast<batch_vertex*>(context->map_buffer_range(_vertex_buffer, 0, max_glyphs * sizeof(batch_vertex),
+                                                                           ACCESS_WRITE_INVALIDATE_BUFFER));
+    }
+    if (0 == vertex_data) {
+        err() << log::error
+              << "text_batch::commit(): unable to map vertex buffer." << log::end;
+        return false;
+    }
+    int glyph_count = 0;
+
+    for (unsigned fi = 0; fi < _fonts.size(); ++fi) {
+        const font_face& font        = *_fonts[fi];
+        const int        range_first = glyph_count;
+
+        // glyphs rasterized during the layout may evict atlas pages holding glyphs laid out
+        // before, in this case the layout of the font is repeated once
+        for (int layout_pass = 0; layout_pass < 2; ++layout_pass) {
+            const unsigned layout_generation = font.atlas_generation();
+
+            glyph_count = range_first;
+            for (std::vector<text_run>::const_iterator r = _runs.begin(); r != _runs.end(); ++r) {
+                if (r->_font != fi) {
+                    continue;
+                }
+                const std::string::const_iterator str_end = _string_data.begin() + (r->_string_offset + r->_string_length);
+                const vec2f                       run_pos = vec2f(r->_position);
+                vec2i                             cur_pos = vec2i(0, 0);
+                font_face::code_point             prev_c  = 0;
+
+                for (std::string::const_iterator c = _string_data.begin() + r->_string_offset; c != str_end;) {
+                    const font_face::code_point cur_c = font_face::next_code_point(c, str_end);
+
+                    if (cur_c == '\n') {
+                        cur_pos.x  = 0;
+                        cur_pos.y -= font.line_advance(r->_style);
+                        prev_c     = 0;
+                    }
+                    else if (cur_c >= 32u) {
+                        const font_face::glyph_info g = font.glyph(cur_c, r->_style);
+                        if (r->_kerning && prev_c) {
+                            cur_pos.x += font.kerning(prev_c, cur_c, r->_style);
+                        }
+
+                        batch_vertex& v = vertex_data[glyph_count++];
+                        v.pos_bbox      = vec4f(run_pos + vec2f(cur_pos + g._bearing) * r->_scale,
+                                                static_cast<float>(g._box_size.x) * r->_scale, static_cast<float>(g._box_size.y) * r->_scale);
+                        v.tex_bbox      = vec4f(g._texture_origin, g._texture_box_size.x, g._texture_box_size.y);
+                        v.tex_layer     = static_cast<float>(g._texture_layer);
+                        v.color         = r->_color;
+                        v.outline_color = r->_outline_color;
+
+                        cur_pos.x += g._advance;
+                        prev_c     = cur_c;
+                    }
+                }
+            }
+            if (font.atlas_generation() == layout_generation) {
+                break;
+            }
+        }
+
+        font.update_textures(context);
+
+        if (glyph_count > range_first) {
+            draw_range range;
+            range._font  = _fonts[fi];
+            range._first = first_glyph + range_first;
+            range._count = glyph_count - range_first;
+            ranges.push_back(range);
+        }
+    }
+
+    if (!_stream) {
+        context->unmap_buffer(_vertex_buffer);
+    }
+
+    return true;
+}
+
+void
+text_batch::end_draw(const render_context_ptr& context)
+{
+    // fences the ring range of the draws issued since the last commit
+    if (_stream) {
+        _stream->end_frame(context);
+    }
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,125 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_TEXT_BATCH_H_INCLUDED
+#define SCM_GL_UTIL_TEXT_BATCH_H_INCLUDED
+
+#include <string>
+#include <vector>
+
+#include <scm/core/math.h>
+#include <scm/core/numeric_types.h>
+
+#include <scm/gl_core/gl_core_fwd.h>
+
+#include <scm/gl_util/font/font_fwd.h>
+#include <scm/gl_util/font/font_face.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// text_batch
+//  - collects the strings of a frame (labels, overlays) for drawing them with a single
+//    draw call per font (text_renderer::draw(context, batch))
+//  - appending only records the string runs, the glyph layout is done when the batch is
+//    drawn directly into a streaming vertex buffer, colors and positions are per glyph
+//  - the glyphs of every draw are written to a range of a streaming_buffer (persistently
+//    mapped ring, fenced after the draw), the ring holds the glyphs of a few draws and
+//    grows with the batch, without persistent buffer storage (OpenGL 4.4) a regular
+//    vertex buffer is orphaned for every draw
+//  - a batch is drawn in the order of appending per font, clear() it for the next frame
+//  - the scale of a run applies to its glyphs (distance field fonts), not its position
+class __scm_export(gl_util) text_batch
+{
+public:
+    text_batch(const render_device_ptr& device,
+               unsigned                 glyph_capacity = 4096);
+    virtual ~text_batch();
+
+    void                        clear();
+    bool                        empty() const;
+    scm::size_t                 run_count() const;
+
+    void                        append(const math::vec2i&          pos,
+                                       const font_face_cptr&       font,
+                                       const font_face::style_type stl,
+                                       const std::string&          str,
+                                       const math::vec4f&          color,
+                                       bool                        kerning = true,
+                                       float                       scale   = 1.0f);
+    void                        append_outlined(const math::vec2i&          pos,
+                                                const font_face_cptr&       font,
+                                                const font_face::style_type stl,
+                                                const std::string&          str,
+                                                const math::vec4f&          color,
+                                                const math::vec4f&          outline_color,
+                                                bool                        kerning = true,
+                                                float                       scale   = 1.0f);
+
+    // text objects, using their string, style, colors and scale
+    void                        append(const math::vec2i& pos,
+                                       const text_cptr&   txt);
+    void                        append_shadowed(const math::vec2i& pos,
+                                                const text_cptr&   txt);
+    void                        append_outlined(const math::vec2i& pos,
+                                                const text_cptr&   txt);
+
+protected:
+    struct text_run {
+        math::vec2i             _position;
+        unsigned                _font;
+        font_face::style_type   _style;
+        bool                    _kerning;
+        float                   _scale;
+        scm::size_t             _string_offset;     // into _string_data
+        scm::size_t             _string_length;
+        math::vec4f             _color;
+        math::vec4f             _outline_color;
+    }; // struct text_run
+
+    struct draw_range {
+        font_face_cptr          _font;
+        int                     _first;
+        int                     _count;
+    }; // struct draw_range
+    typedef std::vector<draw_range> draw_range_array;
+
+    void                        append_run(const math::vec2i&          pos,
+                                           const font_face_cptr&       font,
+                                           const font_face::style_type stl,
+                                           const std::string&          str,
+                                           const math::vec4f&          color,
+                                           const math::vec4f&          outline_color,
+                                           bool                        kerning,
+                                           float                       scale);
+    bool                        create_stream(const render_device_ptr& device,
+                                              scm::size_t              glyph_capacity);
+    bool                        commit(const render_context_ptr& context,
+                                       draw_range_array&         ranges);
+    void                        end_draw(const render_context_ptr& context);
+
+protected:
+    std::vector<font_face_cptr> _fonts;
+    std::vector<text_run>       _runs;
+    std::string                 _string_data;
+
+    streaming_buffer_ptr        _stream;
+    buffer_ptr                  _vertex_buffer;
+    vertex_array_ptr            _vertex_array;
+    scm::size_t                 _glyph_capacity;    // per draw
+
+    render_device_wptr          _render_device;
+
+    friend class text_renderer;
+}; // class text_batch
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_TEXT_BATCH_H_INCLUDED
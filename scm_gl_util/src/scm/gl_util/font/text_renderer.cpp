@@ -20,6 +20,7 @@
 
 #include <scm/gl_util/font/font_face.h>
 #include <scm/gl_util/font/text.h>
+#include <scm/gl_util/font/text_batch.h>
 #include <scm/gl_util/primitives/quad.h>
 
 #define GEOM_SHADER_FONT  1
@@ -35,16 +36,19 @@ std::string v_source = "\
                                                                                                     \n\
     layout(location = 0) in vec4 in_position_bbox;                                                  \n\
     layout(location = 2) in vec4 in_texcoord_bbox;                                                  \n\
+    layout(location = 3) in float in_texcoord_layer;                                                \n\
                                                                                                     \n\
     out per_vertex {                                                                                \n\
         vec4 in_position_bbox;                                                                      \n\
-        vec4 in_texcoord_bbox;                                                                      \n\
+        vec4  in_texcoord_bbox;                                                                     \n\
+        float in_texcoord_layer;                                                                    \n\
     } v_out;                                                                                        \n\
                                                                                                     \n\
     void main()                                                                                     \n\
     {                                                                                               \n\
         v_out.in_position_bbox  = in_position_bbox;                                                 \n\
         v_out.in_texcoord_bbox  = in_texcoord_bbox;                                                 \n\
+        v_out.in_texcoord_layer = in_texcoord_layer;                                                \n\
         //gl_Position             = in_mvp * vec4(in_position.xy, 0.0, 1.0);                        \n\
     }                                                                                               \n\
     ";
@@ -59,11 +63,12 @@ std::string g_source = "\
                                                                                                     \n\
     in per_vertex {                                                                                 \n\
         vec4 in_position_bbox;                                                                      \n\
-        vec4 in_texcoord_bbox;                                                                      \n\
+        vec4  in_texcoord_bbox;                                                                     \n\
+        float in_texcoord_layer;                                                                    \n\
     } v_in[];                                                                                       \n\
                                                                                                     \n\
     out per_vertex {                                                                                \n\
-        vec2 tex_coord;                                                                             \n\
+        vec3 tex_coord;                                                                             \n\
     } v_out;                                                                                        \n\
                                                                                                     \n\
     void main()                                                                                     \n\
@@ -73,25 +78,26 @@ std::string g_source = "\
                                                                                                     \n\
         vec2 t  = v_in[0].in_texcoord_bbox.xy;                                                      \n\
         vec2 ts = v_in[0].in_texcoord_bbox.zw;                                                      \n\
+        float l = v_in[0].in_texcoord_layer;                                                        \n\
                                                                                                     \n\
         // 10                                                                                       \n\
         gl_Position       = in_mvp * vec4(p + vec2(ps.x, 0.0), 0.0, 1.0);                           \n\
-        v_out.tex_coord   =          vec2(t + vec2(ts.x, 0.0));                                     \n\
+        v_out.tex_coord   =          vec3(t + vec2(ts.x, 0.0), l);                                  \n\
         EmitVertex();                                                                               \n\
                                                                                                     \n\
         // 11                                                                                       \n\
         gl_Position       = in_mvp * vec4(p + ps, 0.0, 1.0);                                        \n\
-        v_out.tex_coord   =          vec2(t + ts);                                                  \n\
+        v_out.tex_coord   =          vec3(t + ts, l);                                               \n\
         EmitVertex();                                                                               \n\
                                                                                                     \n\
         // 00                                                                                       \n\
         gl_Position       = in_mvp * vec4(p, 0.0, 1.0);                                             \n\
-        v_out.tex_coord   = vec2(t);                                                                \n\
+        v_out.tex_coord   = vec3(t, l);                                                             \n\
         EmitVertex();                                                                               \n\
                                                                                                     \n\
         // 01                                                                                       \n\
         gl_Position       = in_mvp * vec4(p + vec2(0.0, ps.y), 0.0, 1.0);                           \n\
-        v_out.tex_coord   =          vec2(t + vec2(0.0, ts.y));                                     \n\
+        v_out.tex_coord   =          vec3(t + vec2(0.0, ts.y), l);                                  \n\
         EmitVertex();                                                                               \n\
         EndPrimitive();                                                                             \n\
     }                                                                                               \n\
@@ -103,16 +109,16 @@ std::string v_source = "\
     uniform mat4  in_mvp;                                                                           \n\
                                                                                                     \n\
     layout(location = 0) in vec2 in_position;                                                       \n\
-    layout(location = 2) in vec2 in_texcoord;                                                       \n\
+    layout(location = 2) in vec3 in_texcoord;                                                       \n\
                                                                                                     \n\
     out per_vertex {                                                                                \n\
-        vec2 tex_coord;                                                                             \n\
+        vec3 tex_coord;                                                                             \n\
     } v_out;                                                                                        \n\
                                                                                                     \n\
     void main()                                                                                     \n\
     {                                                                                               \n\
         //v_out.os_position   = in_position;                                                        \n\
-        v_out.tex_coord     = in_texcoord.xy;                                                       \n\
+        v_out.tex_coord     = in_texcoord;                                                          \n\
         gl_Position         = in_mvp * vec4(in_position.xy, 0.0, 1.0);                              \n\
     }                                                                                               \n\
     ";
@@ -126,11 +132,11 @@ std::string g_source = "\
     uniform mat4  in_mvp;                                                                           \n\
                                                                                                     \n\
     in per_vertex {                                                                                 \n\
-        vec2 tex_coord;                                                                             \n\
+        vec3 tex_coord;                                                                             \n\
     } v_in[];                                                                                       \n\
                                                                                                     \n\
     out per_vertex {                                                                                \n\
-        vec2 tex_coord;                                                                             \n\
+        vec3 tex_coord;                                                                             \n\
     } v_out;                                                                                        \n\
                                                                                                     \n\
     void main()                                                                                     \n\
@@ -150,20 +156,18 @@ std::string g_source = "\
 std::string f_source_gray = "\
     #version 330 core                                                                               \n\
                                                                                                     \n\
-    uniform int             in_style;                                                               \n\
     uniform vec4            in_color;                                                               \n\
     uniform sampler2DArray  in_font_array;                                                          \n\
                                                                                                     \n\
     layout(location = 0) out vec4 out_color;                                                        \n\
                                                                                                     \n\
     in per_vertex {                                                                                 \n\
-        vec2 tex_coord;                                                                             \n\
+        vec3 tex_coord;                                                                             \n\
     } v_in;                                                                                         \n\
                                                                                                     \n\
     void main()                                                                                     \n\
     {                                                                                               \n\
-        float core    = texture(in_font_array,                                                      \n\
-                                vec3(v_in.tex_coord, float(in_style))).r;                           \n\
+        float core    = texture(in_font_array, v_in.tex_coord).r;                                   \n\
         out_color.rgb = in_color.rgb;                                                               \n\
         out_color.a   = core * in_color.a;                                                          \n\
     }                                                                                               \n\
@@ -172,7 +176,6 @@ std::string f_source_gray = "\
 std::string f_source_outline_gray = "\
     #version 330 core                                                                               \n\
                                                                                                     \n\
-    uniform int             in_style;                                                               \n\
     uniform vec4            in_color;                                                               \n\
     uniform vec4            in_outline_color;                                                       \n\
     uniform sampler2DArray  in_font_array;                                                          \n\
@@ -181,12 +184,12 @@ std::string f_source_outline_gray = "\
     layout(location = 0) out vec4 out_color;                                                        \n\
                                                                                                     \n\
     in per_vertex {                                                                                 \n\
-        vec2 tex_coord;                                                                             \n\
+        vec3 tex_coord;                                                                             \n\
     } v_in;                                                                                         \n\
                                                                                                     \n\
     void main()                                                                                     \n\
     {                                                                                               \n\
-        vec3  tc      = vec3(v_in.tex_coord, float(in_style));                                      \n\
+        vec3  tc      = v_in.tex_coord;                                                             \n\
         float core    = texture(in_font_array, tc).r;                                               \n\
         float outline = texture(in_font_border_array, tc).r;                                        \n\
                                                                                                     \n\
@@ -204,7 +207,6 @@ std::string f_source_lcd = "\
                                                                                                     \n\
     in vec2 tex_coord;                                                                              \n\
                                                                                                     \n\
-    uniform int             in_style;                                                               \n\
     uniform vec4            in_color;                                                               \n\
     uniform sampler2DArray  in_font_array;                                                          \n\
                                                                                                     \n\
@@ -212,13 +214,12 @@ std::string f_source_lcd = "\
     layout(location = 0, index = 1) out vec4 out_sup_pixel_blend;                                   \n\
                                                                                                     \n\
     in per_vertex {                                                                                 \n\
-        vec2 tex_coord;                                                                             \n\
+        vec3 tex_coord;                                                                             \n\
     } v_in;                                                                                         \n\
                                                                                                     \n\
     void main()                                                                                     \n\
     {                                                                                               \n\
-        vec3 core           = texture(in_font_array,                                                \n\
-                                      vec3(v_in.tex_coord, float(in_style))).rgb;                   \n\
+        vec3 core           = texture(in_font_array, v_in.tex_coord).rgb;                           \n\
                                                                                                     \n\
         out_color           = in_color;                                                             \n\
         out_sup_pixel_blend = vec4(core.rgb * in_color.a, 1.0);                                     \n\
@@ -230,7 +231,6 @@ std::string f_source_outline_lcd = "\
                                                                                                     \n\
     in vec2 tex_coord;                                                                              \n\
                                                                                                     \n\
-    uniform int             in_style;                                                               \n\
     uniform vec4            in_color;                                                               \n\
     uniform vec4            in_outline_color;                                                       \n\
     uniform sampler2DArray  in_font_array;                                                          \n\
@@ -240,12 +240,12 @@ std::string f_source_outline_lcd = "\
     layout(location = 0, index = 1) out vec4 out_sup_pixel_blend;                                   \n\
                                                                                                     \n\
     in per_vertex {                                                                                 \n\
-        vec2 tex_coord;                                                                             \n\
+        vec3 tex_coord;                                                                             \n\
     } v_in;                                                                                         \n\
                                                                                                     \n\
     void main()                                                                                     \n\
     {                                                                                               \n\
-        vec3 tc      = vec3(v_in.tex_coord, float(in_style));                                       \n\
+        vec3 tc      = v_in.tex_coord;                                                              \n\
         vec3 core    = texture(in_font_array, tc).rgb;                                              \n\
         vec3 outline = texture(in_font_border_array, tc).rgb;                                       \n\
                                                                                                     \n\
@@ -258,6 +258,257 @@ std::string f_source_outline_lcd = "\
     }                                                                                               \n\
     ";
 
+// batched text, positions, colors and texture coordinates per glyph (text_batch)
+std::string v_source_batch = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    layout(location = 0) in vec4  in_position_bbox;                                                 \n\
+    layout(location = 2) in vec4  in_texcoord_bbox;                                                 \n\
+    layout(location = 3) in float in_texcoord_layer;                                                \n\
+    layout(location = 4) in vec4  in_color;                                                         \n\
+    layout(location = 5) in vec4  in_outline_color;                                                 \n\
+                                                                                                    \n\
+    out per_vertex {                                                                                \n\
+        vec4  in_position_bbox;                                                                     \n\
+        vec4  in_texcoord_bbox;                                                                     \n\
+        float in_texcoord_layer;                                                                    \n\
+        vec4  in_color;                                                                             \n\
+        vec4  in_outline_color;                                                                     \n\
+    } v_out;                                                                                        \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        v_out.in_position_bbox  = in_position_bbox;                                                 \n\
+        v_out.in_texcoord_bbox  = in_texcoord_bbox;                                                 \n\
+        v_out.in_texcoord_layer = in_texcoord_layer;                                                \n\
+        v_out.in_color          = in_color;                                                         \n\
+        v_out.in_outline_color  = in_outline_color;                                                 \n\
+    }                                                                                               \n\
+    ";
+
+std::string g_source_batch = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    layout(points, invocations = 1)          in;                                                    \n\
+    layout(triangle_strip, max_vertices = 4) out;                                                   \n\
+                                                                                                    \n\
+    uniform mat4  in_mvp;                                                                           \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec4  in_position_bbox;                                                                     \n\
+        vec4  in_texcoord_bbox;                                                                     \n\
+        float in_texcoord_layer;                                                                    \n\
+        vec4  in_color;                                                                             \n\
+        vec4  in_outline_color;                                                                     \n\
+    } v_in[];                                                                                       \n\
+                                                                                                    \n\
+    out per_vertex {                                                                                \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_out;                                                                                        \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        vec2 p  = v_in[0].in_position_bbox.xy;                                                      \n\
+        vec2 ps = v_in[0].in_position_bbox.zw;                                                      \n\
+                                                                                                    \n\
+        vec2 t  = v_in[0].in_texcoord_bbox.xy;                                                      \n\
+        vec2 ts = v_in[0].in_texcoord_bbox.zw;                                                      \n\
+        float l = v_in[0].in_texcoord_layer;                                                        \n\
+                                                                                                    \n\
+        v_out.color         = v_in[0].in_color;                                                     \n\
+        v_out.outline_color = v_in[0].in_outline_color;                                             \n\
+        gl_Position         = in_mvp * vec4(p + vec2(ps.x, 0.0), 0.0, 1.0);                         \n\
+        v_out.tex_coord     =          vec3(t + vec2(ts.x, 0.0), l);                                \n\
+        EmitVertex();                                                                               \n\
+                                                                                                    \n\
+        v_out.color         = v_in[0].in_color;                                                     \n\
+        v_out.outline_color = v_in[0].in_outline_color;                                             \n\
+        gl_Position         = in_mvp * vec4(p + ps, 0.0, 1.0);                                      \n\
+        v_out.tex_coord     =          vec3(t + ts, l);                                             \n\
+        EmitVertex();                                                                               \n\
+                                                                                                    \n\
+        v_out.color         = v_in[0].in_color;                                                     \n\
+        v_out.outline_color = v_in[0].in_outline_color;                                             \n\
+        gl_Position         = in_mvp * vec4(p, 0.0, 1.0);                                           \n\
+        v_out.tex_coord     =          vec3(t, l);                                                  \n\
+        EmitVertex();                                                                               \n\
+                                                                                                    \n\
+        v_out.color         = v_in[0].in_color;                                                     \n\
+        v_out.outline_color = v_in[0].in_outline_color;                                             \n\
+        gl_Position         = in_mvp * vec4(p + vec2(0.0, ps.y), 0.0, 1.0);                         \n\
+        v_out.tex_coord     =          vec3(t + vec2(0.0, ts.y), l);                                \n\
+        EmitVertex();                                                                               \n\
+        EndPrimitive();                                                                             \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_gray = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+                                                                                                    \n\
+    layout(location = 0) out vec4 out_color;                                                        \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        float core    = texture(in_font_array, v_in.tex_coord).r;                                   \n\
+        out_color.rgb = v_in.color.rgb;                                                             \n\
+        out_color.a   = core * v_in.color.a;                                                        \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_outline_gray = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+    uniform sampler2DArray  in_font_border_array;                                                   \n\
+                                                                                                    \n\
+    layout(location = 0) out vec4 out_color;                                                        \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        // glyphs without outline carry a transparent outline color                                \n\
+        float core    = texture(in_font_array, v_in.tex_coord).r        * v_in.color.a;             \n\
+        float outline = texture(in_font_border_array, v_in.tex_coord).r * v_in.outline_color.a;     \n\
+                                                                                                    \n\
+        out_color.a   = core + outline - core * outline;                                            \n\
+        out_color.rgb =   (v_in.color.rgb * core + v_in.outline_color.rgb * outline * (1.0 - core)) \n\
+                        / max(out_color.a, 1.0e-5);                                                 \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_lcd = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+                                                                                                    \n\
+    layout(location = 0, index = 0) out vec4 out_color;                                             \n\
+    layout(location = 0, index = 1) out vec4 out_sup_pixel_blend;                                   \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        vec3 core           = texture(in_font_array, v_in.tex_coord).rgb;                           \n\
+                                                                                                    \n\
+        out_color           = v_in.color;                                                           \n\
+        out_sup_pixel_blend = vec4(core.rgb * v_in.color.a, 1.0);                                   \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_outline_lcd = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+    uniform sampler2DArray  in_font_border_array;                                                   \n\
+                                                                                                    \n\
+    layout(location = 0, index = 0) out vec4 out_color;                                             \n\
+    layout(location = 0, index = 1) out vec4 out_sup_pixel_blend;                                   \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        vec3 core    = texture(in_font_array, v_in.tex_coord).rgb        * v_in.color.a;            \n\
+        vec3 outline = texture(in_font_border_array, v_in.tex_coord).rgb * v_in.outline_color.a;    \n\
+                                                                                                    \n\
+        out_sup_pixel_blend.rgb = core + outline - core * outline;                                  \n\
+        out_sup_pixel_blend.a   = 1.0;                                                              \n\
+        out_color.rgb =   (v_in.color.rgb * core + v_in.outline_color.rgb * outline * (1.0 - core)) \n\
+                        / max(out_sup_pixel_blend.rgb, vec3(1.0e-5));                               \n\
+        out_color.a   = 1.0;                                                                        \n\
+    }                                                                                               \n\
+    ";
+
+// distance field glyphs, coverage and outline from the distance to the glyph outline (0.5)
+std::string f_source_distance_field = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform vec4            in_color;                                                               \n\
+    uniform vec4            in_outline_color;                                                       \n\
+    uniform float           in_outline_width;                                                       \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+                                                                                                    \n\
+    layout(location = 0) out vec4 out_color;                                                        \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3 tex_coord;                                                                             \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        float d       = texture(in_font_array, v_in.tex_coord).r;                                   \n\
+        float w       = max(0.7 * fwidth(d), 1.0e-4);                                               \n\
+        float core    = smoothstep(0.5 - w, 0.5 + w, d) * in_color.a;                               \n\
+        float outline =   smoothstep(0.5 - in_outline_width - w, 0.5 - in_outline_width + w, d)     \n\
+                        * in_outline_color.a;                                                       \n\
+                                                                                                    \n\
+        out_color.a   = core + outline * (1.0 - core);                                              \n\
+        out_color.rgb =   (in_color.rgb * core + in_outline_color.rgb * outline * (1.0 - core))     \n\
+                        / max(out_color.a, 1.0e-5);                                                 \n\
+    }                                                                                               \n\
+    ";
+
+std::string f_source_batch_distance_field = "\
+    #version 330 core                                                                               \n\
+                                                                                                    \n\
+    uniform float           in_outline_width;                                                       \n\
+    uniform sampler2DArray  in_font_array;                                                          \n\
+                                                                                                    \n\
+    layout(location = 0) out vec4 out_color;                                                        \n\
+                                                                                                    \n\
+    in per_vertex {                                                                                 \n\
+        vec3      tex_coord;                                                                        \n\
+        flat vec4 color;                                                                            \n\
+        flat vec4 outline_color;                                                                    \n\
+    } v_in;                                                                                         \n\
+                                                                                                    \n\
+    void main()                                                                                     \n\
+    {                                                                                               \n\
+        float d       = texture(in_font_array, v_in.tex_coord).r;                                   \n\
+        float w       = max(0.7 * fwidth(d), 1.0e-4);                                               \n\
+        float core    = smoothstep(0.5 - w, 0.5 + w, d) * v_in.color.a;                             \n\
+        float outline =   smoothstep(0.5 - in_outline_width - w, 0.5 - in_outline_width + w, d)     \n\
+                        * v_in.outline_color.a;                                                     \n\
+                                                                                                    \n\
+        out_color.a   = core + outline * (1.0 - core);                                              \n\
+        out_color.rgb =   (v_in.color.rgb * core + v_in.outline_color.rgb * outline * (1.0 - core)) \n\
+                        / max(out_color.a, 1.0e-5);                                                 \n\
+    }                                                                                               \n\
+    ";
+
+// outline width of a distance field font in field units (the field spans 2 * spread texels)
+float
+distance_field_outline_width(const scm::gl::font_face& font)
+{
+    if (font.distance_field_spread() == 0) {
+        return 0.0f;
+    }
+    return (static_cast<float>(font.border_size()) / 64.0f) / (2.0f * static_cast<float>(font.distance_field_spread()));
+}
+
 } // namespace
 
 
@@ -296,15 +547,50 @@ text_renderer::text_renderer(const render_device_ptr& device)
                                                                (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_outline_lcd,  "text_renderer::f_source_outline_lcd")),
                                                 "text_renderer::font_program_outline_lcd");
 
+    _batch_program_gray         = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,              "text_renderer::v_source_batch"))
+                                                                    (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,              "text_renderer::g_source_batch"))
+                                                                    (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_gray,         "text_renderer::f_source_batch_gray")),
+                                                         "text_renderer::batch_program_gray");
+    _batch_program_lcd          = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,              "text_renderer::v_source_batch"))
+                                                                    (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,              "text_renderer::g_source_batch"))
+                                                                    (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_lcd,          "text_renderer::f_source_batch_lcd")),
+                                                         "text_renderer::batch_program_lcd");
+    _batch_program_outline_gray = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,              "text_renderer::v_source_batch"))
+                                                                    (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,              "text_renderer::g_source_batch"))
+                                                                    (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_outline_gray, "text_renderer::f_source_batch_outline_gray")),
+                                                         "text_renderer::batch_program_outline_gray");
+    _batch_program_outline_lcd  = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,              "text_renderer::v_source_batch"))
+                                                                    (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,              "text_renderer::g_source_batch"))
+                                                                    (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_outline_lcd,  "text_renderer::f_source_batch_outline_lcd")),
+                                                         "text_renderer::batch_program_outline_lcd");
+
+    _font_program_distance_field  = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source,                      "text_renderer::v_source"))
+#if GEOM_SHADER_FONT == 1
+                                                                      (device->create_shader(STAGE_GEOMETRY_SHADER, g_source,                      "text_renderer::g_source"))
+#endif
+                                                                      (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_distance_field,       "text_renderer::f_source_distance_field")),
+                                                           "text_renderer::font_program_distance_field");
+    _batch_program_distance_field = device->create_program(list_of(device->create_shader(STAGE_VERTEX_SHADER,   v_source_batch,                "text_renderer::v_source_batch"))
+                                                                      (device->create_shader(STAGE_GEOMETRY_SHADER, g_source_batch,                "text_renderer::g_source_batch"))
+                                                                      (device->create_shader(STAGE_FRAGMENT_SHADER, f_source_batch_distance_field, "text_renderer::f_source_batch_distance_field")),
+                                                           "text_renderer::batch_program_distance_field");
+
     if (   !_font_program_gray
         || !_font_program_lcd
         || !_font_program_outline_gray
-        || !_font_program_outline_lcd) {
+        || !_font_program_outline_lcd
+        || !_batch_program_gray
+        || !_batch_program_lcd
+        || !_batch_program_outline_gray
+        || !_batch_program_outline_lcd
+        || !_font_program_distance_field
+        || !_batch_program_distance_field) {
         scm::err() << "font_renderer::font_renderer(): error creating shader programs." << log::end;
         throw std::runtime_error("font_renderer::font_renderer(): error creating shader programs.");
     }
 
-    _font_sampler_state = device->create_sampler_state(FILTER_MIN_MAG_NEAREST, WRAP_CLAMP_TO_EDGE);
+    _font_sampler_state        = device->create_sampler_state(FILTER_MIN_MAG_NEAREST, WRAP_CLAMP_TO_EDGE);
+    _font_sampler_state_linear = device->create_sampler_state(FILTER_MIN_MAG_LINEAR,  WRAP_CLAMP_TO_EDGE);
     _font_blend_gray    = device->create_blend_state(true, FUNC_SRC_ALPHA,  FUNC_ONE_MINUS_SRC_ALPHA,  FUNC_ONE, FUNC_ZERO);
     _font_blend_lcd     = device->create_blend_state(true, FUNC_SRC1_COLOR, FUNC_ONE_MINUS_SRC1_COLOR, FUNC_ONE, FUNC_ZERO);
     //_font_blend_lcd     = device->create_blend_state(true, FUNC_ONE, FUNC_ZERO, FUNC_ONE, FUNC_ZERO);
@@ -312,6 +598,7 @@ text_renderer::text_renderer(const render_device_ptr& device)
     _font_raster_state  = device->create_rasterizer_state(FILL_SOLID, CULL_BACK, ORIENT_CCW, true);
 
     if (   !_font_sampler_state
+        || !_font_sampler_state_linear
         || !_font_blend_gray
         || !_font_blend_lcd
         || !_font_dstate
@@ -327,7 +614,16 @@ text_renderer::~text_renderer()
 {
     _font_program_gray.reset();
     _font_program_lcd.reset();
+    _font_program_outline_gray.reset();
+    _font_program_outline_lcd.reset();
+    _batch_program_gray.reset();
+    _batch_program_lcd.reset();
+    _batch_program_outline_gray.reset();
+    _batch_program_outline_lcd.reset();
+    _font_program_distance_field.reset();
+    _batch_program_distance_field.reset();
     _font_sampler_state.reset();
+    _font_sampler_state_linear.reset();
     _font_dstate.reset();
     _font_raster_state.reset();
     _font_blend_gray.reset();
@@ -345,12 +641,18 @@ text_renderer::draw(const render_context_ptr& context,
     using namespace scm::gl;
     using namespace scm::math;
 
+    if (txt->font()->smooth_style() == font_face::smooth_distance_field) {
+        return draw_distance_field(context, pos, txt, txt->text_color(), vec4f::zero(), 0.0f);
+    }
+
+    prepare_glyphs(context, txt);
+
     context_vertex_input_guard  vig(context);
     context_state_objects_guard csg(context);
     context_texture_units_guard tug(context);
     context_program_guard       cpg(context);
     
-    mat4f v = make_translation(vec3f(vec2f(pos), 0.0f));
+    mat4f v = make_translation(vec3f(vec2f(pos), 0.0f)) * make_scale(txt->text_scale(), txt->text_scale(), 1.0f);
     //scale(v, static_cast<float>(txt->font()->styles_texture_array()->dimensions().x),
     //         static_cast<float>(txt->font()->styles_texture_array()->dimensions().y), 1.0f);
     mat4f mvp = _projection_matrix * v;
@@ -362,7 +664,6 @@ text_renderer::draw(const render_context_ptr& context,
     switch (txt->font()->smooth_style()) {
         case font_face::smooth_normal:
             _font_program_gray->uniform("in_mvp", mvp);
-            _font_program_gray->uniform("in_style", static_cast<int>(txt->text_style()));
             _font_program_gray->uniform("in_color", txt->text_color());
             _font_program_gray->uniform_sampler("in_font_array", 0);
 
@@ -371,7 +672,6 @@ text_renderer::draw(const render_context_ptr& context,
            break;
         case font_face::smooth_lcd:
             _font_program_lcd->uniform("in_mvp", mvp);
-            _font_program_lcd->uniform("in_style", static_cast<int>(txt->text_style()));
             _font_program_lcd->uniform("in_color", txt->text_color());
             _font_program_lcd->uniform_sampler("in_font_array", 0);
 
@@ -405,13 +705,19 @@ text_renderer::draw_outlined(const render_context_ptr& context,
                              const math::vec2i&        pos,
                              const text_ptr&           txt) const
 {
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    if (txt->font()->smooth_style() == font_face::smooth_distance_field) {
+        return draw_distance_field(context, pos, txt, txt->text_color(), txt->text_outline_color(),
+                                   distance_field_outline_width(*txt->font()));
+    }
     if (!txt->font()->styles_border_texture_array()) {
         return draw(context, pos, txt);
     }
 
-    using namespace scm;
-    using namespace scm::gl;
-    using namespace scm::math;
+    prepare_glyphs(context, txt);
 
     context_vertex_input_guard  vig(context);
     context_state_objects_guard csg(context);
@@ -427,13 +733,12 @@ text_renderer::draw_outlined(const render_context_ptr& context,
     context->bind_index_buffer(txt->_index_buffer, txt->_topology, TYPE_USHORT);
 #endif
 
-    mat4f  v  = make_translation(vec3f(vec2f(pos), 0.0f));
+    mat4f  v  = make_translation(vec3f(vec2f(pos), 0.0f)) * make_scale(txt->text_scale(), txt->text_scale(), 1.0f);
     mat4f mvp = _projection_matrix * v;
 
     switch (txt->font()->smooth_style()) {
         case font_face::smooth_normal:
             _font_program_outline_gray->uniform("in_mvp",               mvp);
-            _font_program_outline_gray->uniform("in_style",             static_cast<int>(txt->text_style()));
             _font_program_outline_gray->uniform("in_color",             txt->text_color());
             _font_program_outline_gray->uniform("in_outline_color",     txt->text_outline_color());
             _font_program_outline_gray->uniform_sampler("in_font_array",        0);
@@ -494,7 +799,6 @@ text_renderer::draw_outlined(const render_context_ptr& context,
             break;
         case font_face::smooth_lcd:
             _font_program_outline_lcd->uniform("in_mvp",               mvp);
-            _font_program_outline_lcd->uniform("in_style",             static_cast<int>(txt->text_style()));
             _font_program_outline_lcd->uniform("in_color",             txt->text_color());
             _font_program_outline_lcd->uniform("in_outline_color",     txt->text_outline_color());
             _font_program_outline_lcd->uniform_sampler("in_font_array",        0);
@@ -574,6 +878,14 @@ text_renderer::draw_shadowed(const render_context_ptr& context,
     using namespace scm::gl;
     using namespace scm::math;
 
+    if (txt->font()->smooth_style() == font_face::smooth_distance_field) {
+        draw_distance_field(context, pos + txt->text_shadow_offset(), txt, txt->text_shadow_color(), vec4f::zero(), 0.0f);
+        draw_distance_field(context, pos,                             txt, txt->text_color(),        vec4f::zero(), 0.0f);
+        return;
+    }
+
+    prepare_glyphs(context, txt);
+
     context_vertex_input_guard  vig(context);
     context_state_objects_guard csg(context);
     context_texture_units_guard tug(context);
@@ -596,11 +908,10 @@ text_renderer::draw_shadowed(const render_context_ptr& context,
             context->set_blend_state(_font_blend_gray);
             context->bind_program(_font_program_gray);
             { // shadow
-                mat4f v   = make_translation(vec3f(vec2f(pos + txt->text_shadow_offset()), 0.0f));
+                mat4f v   = make_translation(vec3f(vec2f(pos + txt->text_shadow_offset()), 0.0f)) * make_scale(txt->text_scale(), txt->text_scale(), 1.0f);
                 mat4f mvp = _projection_matrix * v;
 
                 _font_program_gray->uniform("in_mvp", mvp);
-                _font_program_gray->uniform("in_style", static_cast<int>(txt->text_style()));
                 _font_program_gray->uniform("in_color", txt->text_shadow_color());
 
 #if GEOM_SHADER_FONT == 1
@@ -618,10 +929,10 @@ text_renderer::draw_shadowed(const render_context_ptr& context,
             { // text
                 mat4f v = mat4f::identity();
                 translate(v, vec3f(vec2f(pos), 0.0f));
+                scale(v, txt->text_scale(), txt->text_scale(), 1.0f);
                 mat4f mvp = _projection_matrix * v;
 
                 _font_program_gray->uniform("in_mvp", mvp);
-                _font_program_gray->uniform("in_style", static_cast<int>(txt->text_style()));
                 _font_program_gray->uniform("in_color", txt->text_color());
 
 #if GEOM_SHADER_FONT == 1
@@ -641,11 +952,10 @@ text_renderer::draw_shadowed(const render_context_ptr& context,
             _font_program_lcd->uniform_sampler("in_font_array", 0);
             context->bind_program(_font_program_lcd);
             { // shadow
-                mat4f v   = make_translation(vec3f(vec2f(pos + txt->text_shadow_offset()), 0.0f));
+                mat4f v   = make_translation(vec3f(vec2f(pos + txt->text_shadow_offset()), 0.0f)) * make_scale(txt->text_scale(), txt->text_scale(), 1.0f);
                 mat4f mvp = _projection_matrix * v;
 
                 _font_program_lcd->uniform("in_mvp", mvp);
-                _font_program_lcd->uniform("in_style", static_cast<int>(txt->text_style()));
                 _font_program_lcd->uniform("in_color", txt->text_shadow_color());
                 context->set_blend_state(_font_blend_lcd/*, txt->text_shadow_color()*/);
 
@@ -664,10 +974,10 @@ text_renderer::draw_shadowed(const render_context_ptr& context,
             { // text
                 mat4f v = mat4f::identity();
                 translate(v, vec3f(vec2f(pos), 0.0f));
+                scale(v, txt->text_scale(), txt->text_scale(), 1.0f);
                 mat4f mvp = _projection_matrix * v;
 
                 _font_program_lcd->uniform("in_mvp", mvp);
-                _font_program_lcd->uniform("in_style", static_cast<int>(txt->text_style()));
                 _font_program_lcd->uniform("in_color", txt->text_color());
                 context->set_blend_state(_font_blend_lcd/*, txt->text_color()*/);
 
@@ -691,6 +1001,119 @@ text_renderer::draw_shadowed(const render_context_ptr& context,
     //_quad->draw(context, geometry::MODE_SOLID);
 }
 
+void
+text_renderer::draw(const render_context_ptr& context,
+                    const text_batch_ptr&     batch) const
+{
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    // layout of all runs into the streaming buffer, one range per font
+    text_batch::draw_range_array& ranges = _batch_ranges;
+    if (!batch->commit(context, ranges) || ranges.empty()) {
+        return;
+    }
+
+    context_vertex_input_guard  vig(context);
+    context_state_objects_guard csg(context);
+    context_texture_units_guard tug(context);
+    context_program_guard       cpg(context);
+
+    context->set_depth_stencil_state(_font_dstate);
+    context->set_rasterizer_state(_font_raster_state);
+    context->bind_vertex_array(batch->_vertex_array);
+
+    for (text_batch::draw_range_array::const_iterator r = ranges.begin(); r != ranges.end(); ++r) {
+        const font_face_cptr& font    = r->_font;
+        const bool            outline = static_cast<bool>(font->styles_border_texture_array());
+        const bool            lcd     = font->smooth_style() == font_face::smooth_lcd;
+
+        const bool            field   = font->smooth_style() == font_face::smooth_distance_field;
+
+        const program_ptr& p =   field   ? _batch_program_distance_field
+                               : outline ? (lcd ? _batch_program_outline_lcd : _batch_program_outline_gray)
+                                         : (lcd ? _batch_program_lcd         : _batch_program_gray);
+
+        p->uniform("in_mvp", _projection_matrix);
+        p->uniform_sampler("in_font_array", 0);
+        if (field) {
+            p->uniform("in_outline_width", distance_field_outline_width(*font));
+        }
+        context->bind_texture(font->styles_texture_array(), field ? _font_sampler_state_linear : _font_sampler_state, 0);
+        if (outline) {
+            p->uniform_sampler("in_font_border_array", 1);
+            context->bind_texture(font->styles_border_texture_array(), _font_sampler_state, 1);
+        }
+
+        context->set_blend_state(lcd ? _font_blend_lcd : _font_blend_gray);
+        context->bind_program(p);
+        context->apply();
+        context->draw_arrays(PRIMITIVE_POINT_LIST, r->_first, r->_count);
+    }
+
+    batch->end_draw(context);
+}
+
+void
+text_renderer::draw_distance_field(const render_context_ptr& context,
+                                   const math::vec2i&        pos,
+                                   const text_ptr&           txt,
+                                   const math::vec4f&        color,
+                                   const math::vec4f&        outline_color,
+                                   float                     outline_width) const
+{
+    using namespace scm;
+    using namespace scm::gl;
+    using namespace scm::math;
+
+    prepare_glyphs(context, txt);
+
+    if (txt->_indices_count <= 0) {
+        return;
+    }
+
+    context_vertex_input_guard  vig(context);
+    context_state_objects_guard csg(context);
+    context_texture_units_guard tug(context);
+    context_program_guard       cpg(context);
+
+    mat4f v   = make_translation(vec3f(vec2f(pos), 0.0f)) * make_scale(txt->text_scale(), txt->text_scale(), 1.0f);
+    mat4f mvp = _projection_matrix * v;
+
+    _font_program_distance_field->uniform("in_mvp",           mvp);
+    _font_program_distance_field->uniform("in_color",         color);
+    _font_program_distance_field->uniform("in_outline_color", outline_color);
+    _font_program_distance_field->uniform("in_outline_width", outline_width);
+    _font_program_distance_field->uniform_sampler("in_font_array", 0);
+
+    context->set_depth_stencil_state(_font_dstate);
+    context->set_rasterizer_state(_font_raster_state);
+    context->set_blend_state(_font_blend_gray);
+    context->bind_texture(txt->font()->styles_texture_array(), _font_sampler_state_linear, 0);
+    context->bind_program(_font_program_distance_field);
+    context->bind_vertex_array(txt->_vertex_array);
+#if GEOM_SHADER_FONT == 1
+    context->apply();
+    context->draw_arrays(PRIMITIVE_POINT_LIST, 0, txt->_indices_count);
+#else
+    context->bind_index_buffer(txt->_index_buffer, txt->_topology, TYPE_USHORT);
+    context->apply();
+    context->draw_elements(txt->_indices_count);
+#endif
+}
+
+void
+text_renderer::prepare_glyphs(const render_context_ptr& context,
+                              const text_ptr&           txt) const
+{
+    // pages of the font atlas holding glyphs of the text may have been evicted since its layout
+    if (txt->_atlas_generation != txt->font()->atlas_generation()) {
+        txt->update();
+    }
+    txt->font()->update_textures(context);
+}
+
 void
 text_renderer::projection_matrix(const math::mat4f& m)
 {
@@ -10,6 +10,7 @@
 #include <scm/gl_core/gl_core_fwd.h>
 
 #include <scm/gl_util/font/font_fwd.h>
+#include <scm/gl_util/font/text_batch.h>
 #include <scm/gl_util/primitives/primitives_fwd.h>
 
 #include <scm/core/platform/platform.h>
@@ -34,20 +35,42 @@ public:
                                   const math::vec2i&        pos,
                                   const text_ptr&           txt) const;
 
+    // all runs of the batch, a single draw call per font
+    void            draw(const render_context_ptr& context,
+                         const text_batch_ptr&     batch) const;
+
     void            projection_matrix(const math::mat4f& m);
 
+protected:
+    void            draw_distance_field(const render_context_ptr& context,
+                                        const math::vec2i&        pos,
+                                        const text_ptr&           txt,
+                                        const math::vec4f&        color,
+                                        const math::vec4f&        outline_color,
+                                        float                     outline_width) const;
+    void            prepare_glyphs(const render_context_ptr& context,
+                                   const text_ptr&           txt) const;
+
 protected:
     program_ptr                 _font_program_gray;
     program_ptr                 _font_program_lcd;
     program_ptr                 _font_program_outline_gray;
     program_ptr                 _font_program_outline_lcd;
+    program_ptr                 _batch_program_gray;
+    program_ptr                 _batch_program_lcd;
+    program_ptr                 _batch_program_outline_gray;
+    program_ptr                 _batch_program_outline_lcd;
+    program_ptr                 _font_program_distance_field;
+    program_ptr                 _batch_program_distance_field;
     sampler_state_ptr           _font_sampler_state;
+    sampler_state_ptr           _font_sampler_state_linear;     // distance field glyphs
     depth_stencil_state_ptr     _font_dstate;
     rasterizer_state_ptr        _font_raster_state;
     blend_state_ptr             _font_blend_gray;
     blend_state_ptr             _font_blend_lcd;
 
     math::mat4f                 _projection_matrix;
+    mutable text_batch::draw_range_array _batch_ranges;
 
     //// temporary
     quad_geometry_ptr           _quad;
@@ -10,6 +10,9 @@
 #include <scm/gl_util/utilities/utilities_fwd.h>
 #include <scm/gl_util/utilities/accum_timer_query.h>
 #include <scm/gl_util/utilities/coordinate_cross.h>
+#include <scm/gl_util/utilities/dynamic_resolution.h>
+#include <scm/gl_util/utilities/frame_capture.h>
+#include <scm/gl_util/utilities/frame_pacer.h>
 #include <scm/gl_util/utilities/geometry_highlight.h>
 #include <scm/gl_util/utilities/overlay_text_output.h>
 #include <scm/gl_util/utilities/profiling_host.h>
@@ -20,9 +20,12 @@
 namespace scm {
 namespace gl {
 
-accum_timer_query::accum_timer_query(const render_device_ptr& device)
+accum_timer_query::accum_timer_query(const render_device_ptr& device,
+                                     unsigned                 frames_in_flight)
   : time::accum_timer_base()
-  , _timer_query_finished(true)
+  , _device(device)
+  , _active(false)
+  , _pool_size(0)
   , _cpu_timer()
 {
     reset();
@@ -31,117 +34,139 @@ accum_timer_query::accum_timer_query(const render_device_ptr& device)
     _detailed_average_time.user =
     _detailed_average_time.system = 0;
 
-    _timer_query_begin = device->create_timer_query();
-    _timer_query_end = device->create_timer_query();
-
-    if (   !_timer_query_begin
-        || !_timer_query_end) {
-        throw std::runtime_error("accum_timer_query::accum_timer_query(): error creating query object.");
+    // one measurement per frame in flight plus the one currently recorded
+    for (unsigned i = 0; i < frames_in_flight + 1; ++i) {
+        query_sample s;
+        if (!allocate_sample(s)) {
+            throw std::runtime_error("accum_timer_query::accum_timer_query(): error creating query object.");
+        }
+        _free_samples.push_back(s);
     }
 }
 
 accum_timer_query::~accum_timer_query()
 {
-    _timer_query_begin.reset();
-    _timer_query_end.reset();
+    _active_sample = query_sample();
+    _pending_samples.clear();
+    _free_samples.clear();
+    _device.reset();
 }
 
 void
 accum_timer_query::start(const render_context_ptr& context)
 {
-    assert(_timer_query_begin);
-    assert(_timer_query_end);
+    if (_active) {
+        // unmatched start, restart the measurement
+        _free_samples.push_back(_active_sample);
+        _active = false;
+    }
 
-    if (_timer_query_finished) {
-        _cpu_timer.start();
-        context->query_time_stamp(_timer_query_begin);
-        _timer_context = context;
+    if (_free_samples.empty()) {
+        query_sample s;
+        if (!allocate_sample(s)) {
+            return;
+        }
+        _free_samples.push_back(s);
     }
+
+    _active_sample          = _free_samples.back();
+    _active_sample._context = context;
+    _free_samples.pop_back();
+    _active                 = true;
+
+    _cpu_timer.start();
+    context->query_time_stamp(_active_sample._begin);
 }
 
 void
 accum_timer_query::stop()
 {
-    assert(_timer_query_begin);
-    assert(_timer_query_end);
-
-    if (_timer_query_finished && _timer_context) {
-        _timer_context->query_time_stamp(_timer_query_end);
+    if (_active) {
+        _active_sample._context->query_time_stamp(_active_sample._end);
         _cpu_timer.stop();
+        _active_sample._cpu_times = _cpu_timer.detailed_elapsed();
+
+        _pending_samples.push_back(_active_sample);
+        _active_sample = query_sample();
+        _active        = false;
     }
 }
 
 void
 accum_timer_query::collect()
 {
-    assert(_timer_query_begin);
-    assert(_timer_query_end);
-
-    if (_timer_context) {
-        if (_timer_context->query_result_available(_timer_query_end)) {
-            _timer_context->collect_query_results(_timer_query_begin);
-            _timer_context->collect_query_results(_timer_query_end);
-
-            scm::uint64 start = _timer_query_begin->result();
-            scm::uint64 end   = _timer_query_end->result();
-            scm::uint64 diff  = ((end > start) ? (end - start) : (~start + 1 + end));
+    // results become available in submission order, stop at the first pending one
+    while (   !_pending_samples.empty()
+           && _pending_samples.front()._context->query_result_available(_pending_samples.front()._end)) {
+        accumulate_sample(_pending_samples.front());
+        _pending_samples.pop_front();
+    }
+}
 
-            time::cpu_timer::cpu_times t = _cpu_timer.detailed_elapsed();
+void
+accum_timer_query::force_collect()
+{
+    while (!_pending_samples.empty()) {
+        accumulate_sample(_pending_samples.front());
+        _pending_samples.pop_front();
+    }
+}
 
-            _last_time         = static_cast<nanosec_type>(diff);
-            _accumulated_time += _last_time;
+unsigned
+accum_timer_query::pending_count() const
+{
+    return static_cast<unsigned>(_pending_samples.size());
+}
 
-            _detailed_last_time.gl     = _last_time;
-            _detailed_last_time.wall   = t.wall;
-            _detailed_last_time.user   = t.user;
-            _detailed_last_time.system = t.system;
+unsigned
+accum_timer_query::pool_size() const
+{
+    return _pool_size;
+}
 
-            _detailed_accumulated_time.gl     += _detailed_last_time.gl;
-            _detailed_accumulated_time.wall   += _detailed_last_time.wall;
-            _detailed_accumulated_time.user   += _detailed_last_time.user;
-            _detailed_accumulated_time.system += _detailed_last_time.system;
+bool
+accum_timer_query::allocate_sample(query_sample& s)
+{
+    s._begin = _device->create_timer_query();
+    s._end   = _device->create_timer_query();
 
-            ++_accumulation_count;
-            _timer_query_finished = true;
-        }
-        else {
-            _timer_query_finished = false;
-        }
+    if (   !s._begin
+        || !s._end) {
+        return false;
     }
+    ++_pool_size;
+
+    return true;
 }
 
 void
-accum_timer_query::force_collect()
+accum_timer_query::accumulate_sample(const query_sample& s)
 {
-    assert(_timer_query_begin);
-    assert(_timer_query_end);
-
-    if (_timer_context) {
-        _timer_context->collect_query_results(_timer_query_begin);
-        _timer_context->collect_query_results(_timer_query_end);
+    s._context->collect_query_results(s._begin);
+    s._context->collect_query_results(s._end);
 
-        scm::uint64 start = _timer_query_begin->result();
-        scm::uint64 end   = _timer_query_end->result();
-        scm::uint64 diff  = ((end > start) ? (end - start) : (~start + 1 + end));
+    scm::uint64 start = s._begin->result();
+    scm::uint64 end   = s._end->result();
+    scm::uint64 diff  = ((end > start) ? (end - start) : (~start + 1 + end));
 
-        time::cpu_timer::cpu_times t = _cpu_timer.detailed_elapsed();
+    _last_time         = static_cast<nanosec_type>(diff);
+    _accumulated_time += _last_time;
 
-        _last_time         = static_cast<nanosec_type>(diff);
-        _accumulated_time += _last_time;
+    _detailed_last_time.gl     = _last_time;
+    _detailed_last_time.wall   = s._cpu_times.wall;
+    _detailed_last_time.user   = s._cpu_times.user;
+    _detailed_last_time.system = s._cpu_times.system;
 
-        _detailed_last_time.gl     = _last_time;
-        _detailed_last_time.wall   = t.wall;
-        _detailed_last_time.user   = t.user;
-        _detailed_last_time.system = t.system;
+    _detailed_accumulated_time.gl     += _detailed_last_time.gl;
+    _detailed_accumulated_time.wall   += _detailed_last_time.wall;
+    _detailed_accumulated_time.user   += _detailed_last_time.user;
+    _detailed_accumulated_time.system += _detailed_last_time.system;
 
-        _detailed_accumulated_time.gl     += _detailed_last_time.gl;
-        _detailed_accumulated_time.wall   += _detailed_last_time.wall;
-        _detailed_accumulated_time.user   += _detailed_last_time.user;
-        _detailed_accumulated_time.system += _detailed_last_time.system;
+    ++_accumulation_count;
 
-        ++_accumulation_count;
-        _timer_query_finished = true;
-    }
+    query_sample free_sample(s);
+    free_sample._context.reset();
+    _free_samples.push_back(free_sample);
 }
 
 void
@@ -174,8 +199,7 @@ accum_timer_query::reset()
 {
     time::accum_timer_base::reset();
 
-    _timer_query_finished   = true;
-    _timer_context.reset();
+    // pending measurements are accumulated into the next interval
 
     _detailed_accumulated_time.gl     = 
     _detailed_accumulated_time.wall   = 
@@ -5,6 +5,9 @@
 #ifndef SCM_GL_UTIL_accum_timer_query_H_INCLUDED
 #define SCM_GL_UTIL_accum_timer_query_H_INCLUDED
 
+#include <deque>
+#include <vector>
+
 #include <scm/core/time/accum_timer_base.h>
 #include <scm/core/time/cpu_timer.h>
 
@@ -18,6 +21,12 @@
 namespace scm {
 namespace gl {
 
+// accum_timer_query
+//  - every start()/stop() pair records its own pair of time stamp queries, the pairs
+//    come from a pool sized for frames_in_flight frames and the pool grows when more
+//    measurements are pending
+//  - collect() accumulates all pending measurements with available results in order
+//    without blocking, force_collect() waits for all pending results
 class __scm_export(gl_util) accum_timer_query : public time::accum_timer_base
 {
 public:
@@ -27,8 +36,22 @@ public:
         nanosec_type    gl;
     };
 
+    static const unsigned   default_frames_in_flight = 3;
+
+protected:
+    struct query_sample {
+        timer_query_ptr             _begin;
+        timer_query_ptr             _end;
+        render_context_ptr          _context;
+        time::cpu_timer::cpu_times  _cpu_times;
+    }; // struct query_sample
+
+    typedef std::vector<query_sample>   sample_pool;
+    typedef std::deque<query_sample>    sample_queue;
+
 public:
-    accum_timer_query(const render_device_ptr& device);
+    accum_timer_query(const render_device_ptr& device,
+                      unsigned                 frames_in_flight = default_frames_in_flight);
     virtual ~accum_timer_query();
 
     void                    start(const render_context_ptr& context);
@@ -39,6 +62,9 @@ public:
     void                    update(int interval = 100);
     void                    reset();
 
+    unsigned                pending_count() const;
+    unsigned                pool_size() const;
+
     gl_times                detailed_last_time() const;
     gl_times                detailed_accumulated_time() const;
     gl_times                detailed_average_time() const;
@@ -49,11 +75,16 @@ public:
     void                    detailed_report(std::ostream& os, size_t dsize, time::time_io unit  = time::time_io(time::time_io::msec, time::time_io::MiBps)) const;
 
 protected:
-    timer_query_ptr         _timer_query_begin;
-    timer_query_ptr         _timer_query_end;
-    bool                    _timer_query_finished;
+    bool                    allocate_sample(query_sample& s);
+    void                    accumulate_sample(const query_sample& s);
 
-    render_context_ptr      _timer_context;
+protected:
+    render_device_ptr       _device;
+    sample_pool             _free_samples;
+    sample_queue            _pending_samples;
+    query_sample            _active_sample;
+    bool                    _active;
+    unsigned                _pool_size;
 
     gl_times                _detailed_last_time;
     gl_times                _detailed_accumulated_time;
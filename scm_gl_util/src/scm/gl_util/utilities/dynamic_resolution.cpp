@@ -0,0 +1,171 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "dynamic_resolution.h"
+
+#include <cmath>
+
+#include <scm/gl_util/utilities/accum_timer_query.h>
+
+namespace {
+
+const double    time_filter_weight  = 0.25;     // weight of a new measurement
+const double    upper_tolerance     = 1.05;     // lower the scale above target * upper_tolerance
+const double    lower_tolerance     = 0.85;     // raise the scale below target * lower_tolerance
+const float     raise_gain          = 0.25f;    // fraction of the predicted scale change applied when raising
+const unsigned  raise_delay         = 8;        // measurements below the lower tolerance before raising
+const float     scale_step          = 1.0f / 64.0f;
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+dynamic_resolution::dynamic_resolution(const render_device_ptr& device,
+                                       double                   target_time_ms,
+                                       float                    min_scale,
+                                       float                    max_scale)
+  : _gpu_timer(new accum_timer_query(device))
+  , _target_time(target_time_ms)
+  , _min_scale(1.0f)
+  , _max_scale(1.0f)
+  , _scale(1.0f)
+  , _filtered_time(0.0)
+  , _skip_samples(1) // the first measurement includes the driver warm up
+  , _headroom_samples(0)
+{
+    scale_range(min_scale, max_scale);
+    _scale = _max_scale;
+}
+
+dynamic_resolution::~dynamic_resolution()
+{
+    _gpu_timer.reset();
+}
+
+double
+dynamic_resolution::target_time() const
+{
+    return _target_time;
+}
+
+void
+dynamic_resolution::target_time(double t)
+{
+    _target_time = math::max(t, 0.0);
+}
+
+float
+dynamic_resolution::min_scale() const
+{
+    return _min_scale;
+}
+
+float
+dynamic_resolution::max_scale() const
+{
+    return _max_scale;
+}
+
+void
+dynamic_resolution::scale_range(float min_scale, float max_scale)
+{
+    _max_scale = math::clamp(max_scale, scale_step, 1.0f);
+    _min_scale = math::clamp(min_scale, scale_step, _max_scale);
+    _scale     = math::clamp(_scale, _min_scale, _max_scale);
+}
+
+float
+dynamic_resolution::scale() const
+{
+    return _scale;
+}
+
+void
+dynamic_resolution::scale(float s)
+{
+    const float new_scale = math::clamp(s, _min_scale, _max_scale);
+
+    if (new_scale != _scale) {
+        // keep the filter history, predicted for the new pixel count
+        _filtered_time *= math::sqr(new_scale / _scale);
+        _scale          = new_scale;
+        _skip_samples   = _gpu_timer->pending_count() + 1;
+    }
+}
+
+math::vec2ui
+dynamic_resolution::render_size(const math::vec2ui& full_size) const
+{
+    return math::max(math::vec2ui(math::vec2f(full_size) * _scale + math::vec2f(0.5f)), math::vec2ui(1u));
+}
+
+void
+dynamic_resolution::begin_frame(const render_context_ptr& context)
+{
+    _gpu_timer->start(context);
+}
+
+void
+dynamic_resolution::end_frame()
+{
+    _gpu_timer->stop();
+}
+
+bool
+dynamic_resolution::update()
+{
+    _gpu_timer->collect();
+
+    const unsigned samples = _gpu_timer->accumulation_count();
+    if (samples == 0) {
+        return false;
+    }
+
+    const double frame_time = static_cast<double>(_gpu_timer->accumulated_time()) / samples * 1.0e-6;
+    _gpu_timer->reset();
+
+    // measurements of frames recorded before the last scale change
+    if (_skip_samples > 0) {
+        _skip_samples -= math::min(_skip_samples, samples);
+        return false;
+    }
+
+    _filtered_time = (_filtered_time > 0.0) ? math::lerp(_filtered_time, frame_time, time_filter_weight) : frame_time;
+
+    if (_filtered_time <= 0.0 || _target_time <= 0.0) {
+        return false;
+    }
+
+    float new_scale = _scale;
+    if (_filtered_time > _target_time * upper_tolerance) {
+        new_scale         = _scale * static_cast<float>(std::sqrt(_target_time / _filtered_time));
+        _headroom_samples = 0;
+    }
+    else if (_filtered_time < _target_time * lower_tolerance) {
+        if (++_headroom_samples >= raise_delay) {
+            const float predicted = _scale * static_cast<float>(std::sqrt(_target_time / _filtered_time));
+            new_scale         = _scale + math::max(predicted - _scale, scale_step) * raise_gain;
+            _headroom_samples = 0;
+        }
+    }
+    else {
+        _headroom_samples = 0;
+    }
+    new_scale = math::round(new_scale / scale_step) * scale_step;
+
+    const float old_scale = _scale;
+    scale(new_scale);
+
+    return old_scale != _scale;
+}
+
+double
+dynamic_resolution::gpu_time() const
+{
+    return _filtered_time;
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,74 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_DYNAMIC_RESOLUTION_H_INCLUDED
+#define SCM_GL_UTIL_DYNAMIC_RESOLUTION_H_INCLUDED
+
+#include <scm/core/math.h>
+
+#include <scm/gl_core/gl_core_fwd.h>
+
+#include <scm/gl_util/utilities/utilities_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// dynamic_resolution
+//  - adjusts a render resolution scale (per axis, relative to the full render target)
+//    so that the gpu time of the scaled passes meets a target time
+//  - the passes are measured between begin_frame() and end_frame() with an
+//    accum_timer_query, update() consumes the results without blocking
+//  - the gpu time is assumed proportional to the pixel count (scale^2), the scale is
+//    lowered immediately when over budget and raised slowly after a number of frames with
+//    headroom, the results of frames in flight at a scale change are ignored
+class __scm_export(gl_util) dynamic_resolution
+{
+public:
+    dynamic_resolution(const render_device_ptr& device,
+                       double                   target_time_ms = 12.0,
+                       float                    min_scale      = 0.5f,
+                       float                    max_scale      = 1.0f);
+    virtual ~dynamic_resolution();
+
+    double                  target_time() const;    // ms
+    void                    target_time(double t);
+    float                   min_scale() const;
+    float                   max_scale() const;
+    void                    scale_range(float min_scale, float max_scale);
+
+    float                   scale() const;
+    void                    scale(float s);
+    math::vec2ui            render_size(const math::vec2ui& full_size) const;
+
+    void                    begin_frame(const render_context_ptr& context);
+    void                    end_frame();
+
+    // returns true if the scale changed
+    bool                    update();
+
+    double                  gpu_time() const;       // ms, filtered
+
+protected:
+    accum_timer_query_ptr   _gpu_timer;
+
+    double                  _target_time;
+    float                   _min_scale;
+    float                   _max_scale;
+    float                   _scale;
+
+    double                  _filtered_time;
+    unsigned                _skip_samples;
+    unsigned                _headroom_samples;
+
+}; // class dynamic_resolution
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_DYNAMIC_RESOLUTION_H_INCLUDED
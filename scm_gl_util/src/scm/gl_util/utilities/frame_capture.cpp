@@ -0,0 +1,365 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "frame_capture.h"
+
+#include <cassert>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <boost/bind.hpp>
+#include <boost/thread/locks.hpp>
+
+#include <scm/gl_core/log.h>
+#include <scm/gl_core/buffer_objects.h>
+#include <scm/gl_core/data_types.h>
+#include <scm/gl_core/render_device.h>
+#include <scm/gl_core/sync_objects/fence_sync.h>
+
+namespace {
+
+// frame.png -> frame_000042.png
+std::string
+numbered_file_name(const std::string& file_name, scm::uint64 frame)
+{
+    const std::string::size_type dir = file_name.find_last_of("/\\");
+    const std::string::size_type ext = file_name.find_last_of('.');
+    const std::string::size_type pos = (ext != std::string::npos && (dir == std::string::npos || ext > dir)) ? ext : file_name.size();
+
+    std::ostringstream s;
+    s << file_name.substr(0, pos) << "_" << std::setw(6) << std::setfill('0') << frame << file_name.substr(pos);
+
+    return s.str();
+}
+
+} // namespace
+
+namespace scm {
+namespace gl {
+
+frame_capture::frame_capture(const render_device_ptr& device,
+                             const write_function&    image_writer,
+                             unsigned                 readback_buffers,
+                             unsigned                 max_queued_images)
+  : _device(device)
+  , _image_writer(image_writer)
+  , _max_queued_images(math::max(max_queued_images, 1u))
+  , _sequence_active(false)
+  , _sequence_mode(numbered_images)
+  , _sequence_frame(0)
+  , _running(true)
+  , _writing(false)
+  , _written_images(0)
+  , _failed_images(0)
+{
+    // buffers are created on first use with the size of the captured images
+    _free_readbacks.resize(math::max(readback_buffers, 1u));
+
+    _writer_thread = boost::thread(boost::bind(&frame_capture::run_writer, this));
+}
+
+frame_capture::~frame_capture()
+{
+    // pending readbacks need a context, see flush()
+    _pending_readbacks.clear();
+    _free_readbacks.clear();
+
+    {
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        _running = false;
+    }
+    _queue_condition.notify_all();
+    _writer_thread.join();
+
+    _sequence_stream.reset();
+    _device.reset();
+}
+
+bool
+frame_capture::capture(const render_context_ptr& context,
+                       const frame_buffer_ptr&   frame_buffer,
+                       unsigned                  color_buffer,
+                       const math::vec2ui&       size,
+                       data_format               format,
+                       const std::string&        file_name)
+{
+    image_ptr img(new image());
+    img->_file_name = file_name;
+    img->_frame     = 0;
+
+    return start_readback(context, frame_buffer, color_buffer, size, format, img);
+}
+
+bool
+frame_capture::begin_sequence(const std::string& file_name,
+                              sequence_mode      mode)
+{
+    end_sequence();
+
+    if (mode == raw_stream) {
+        shared_ptr<std::ofstream> s(new std::ofstream(file_name.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc));
+        if (!(*s)) {
+            glerr() << log::error
+                    << "frame_capture::begin_sequence(): error opening output file: " << file_name << log::end;
+            return false;
+        }
+        _sequence_stream = s;
+    }
+
+    _sequence_active    = true;
+    _sequence_mode      = mode;
+    _sequence_file_name = file_name;
+    _sequence_frame     = 0;
+
+    return true;
+}
+
+void
+frame_capture::end_sequence()
+{
+    // the raw stream is closed by the writer with the last image referencing it
+    _sequence_active = false;
+    _sequence_stream.reset();
+}
+
+bool
+frame_capture::sequence_active() const
+{
+    return _sequence_active;
+}
+
+bool
+frame_capture::capture_sequence_frame(const render_context_ptr& context,
+                                      const frame_buffer_ptr&   frame_buffer,
+                                      unsigned                  color_buffer,
+                                      const math::vec2ui&       size,
+                                      data_format               format)
+{
+    if (!_sequence_active) {
+        return false;
+    }
+
+    image_ptr img(new image());
+    img->_frame = _sequence_frame++;
+    if (_sequence_mode == raw_stream) {
+        img->_file_name = _sequence_file_name;
+        img->_stream    = _sequence_stream;
+    }
+    else {
+        img->_file_name = numbered_file_name(_sequence_file_name, img->_frame);
+    }
+
+    return start_readback(context, frame_buffer, color_buffer, size, format, img);
+}
+
+void
+frame_capture::update(const render_context_ptr& context)
+{
+    // readbacks complete in submission order, stop at the first pending one
+    while (   !_pending_readbacks.empty()
+           && context->sync_signal_status(_pending_readbacks.front()._fence) == SYNC_SIGNALED) {
+        complete_readback(context, _pending_readbacks.front());
+        _pending_readbacks.pop_front();
+    }
+}
+
+void
+frame_capture::flush(const render_context_ptr& context)
+{
+    while (!_pending_readbacks.empty()) {
+        complete_readback(context, _pending_readbacks.front());
+        _pending_readbacks.pop_front();
+    }
+
+    boost::unique_lock<boost::mutex> lock(_mutex);
+    while (!_images.empty() || _writing) {
+        _written_condition.wait(lock);
+    }
+}
+
+unsigned
+frame_capture::pending_readbacks() const
+{
+    return static_cast<unsigned>(_pending_readbacks.size());
+}
+
+unsigned
+frame_capture::queued_images() const
+{
+    boost::lock_guard<boost::mutex> lock(_mutex);
+    return static_cast<unsigned>(_images.size());
+}
+
+scm::uint64
+frame_capture::written_images() const
+{
+    boost::lock_guard<boost::mutex> lock(_mutex);
+    return _written_images;
+}
+
+scm::uint64
+frame_capture::failed_images() const
+{
+    boost::lock_guard<boost::mutex> lock(_mutex);
+    return _failed_images;
+}
+
+bool
+frame_capture::start_readback(const render_context_ptr& context,
+                              const frame_buffer_ptr&   frame_buffer,
+                              unsigned                  color_buffer,
+                              const math::vec2ui&       size,
+                              data_format               format,
+                              const image_ptr&          img)
+{
+    assert(context);
+
+    update(context);
+
+    if (_free_readbacks.empty()) {
+        // all buffers in flight, wait for the oldest readback
+        complete_readback(context, _pending_readbacks.front());
+        _pending_readbacks.pop_front();
+    }
+
+    readback rb = _free_readbacks.back();
+    _free_readbacks.pop_back();
+
+    const scm::size_t image_bytes = static_cast<scm::size_t>(size.x) * size.y * size_of_format(format);
+
+    if (!rb._buffer || rb._buffer->descriptor()._size < image_bytes) {
+        rb._buffer = _device->create_buffer(BIND_PIXEL_PACK_BUFFER, USAGE_STREAM_READ, image_bytes);
+        if (!rb._buffer) {
+            glerr() << log::error
+                    << "frame_capture::start_readback(): unable to create readback buffer "
+                    << "(size: " << image_bytes << "byte)." << log::end;
+            _free_readbacks.push_back(readback());
+            return false;
+        }
+    }
+
+    img->_size   = size;
+    img->_format = format;
+
+    context->capture_color_buffer(frame_buffer, color_buffer, texture_region(math::vec3ui(0u), math::vec3ui(size, 1u)),
+                                  format, rb._buffer);
+    rb._fence = context->insert_fence_sync();
+    rb._image = img;
+
+    _pending_readbacks.push_back(rb);
+
+    return true;
+}
+
+void
+frame_capture::complete_readback(const render_context_ptr& context,
+                                 readback&                 rb)
+{
+    const scm::size_t image_bytes =   static_cast<scm::size_t>(rb._image->_size.x) * rb._image->_size.y
+                                    * size_of_format(rb._image->_format);
+
+    const scm::uint8* data = static_cast<const scm::uint8*>(context->map_buffer_range(rb._buffer, 0, image_bytes, ACCESS_READ_ONLY));
+    if (data) {
+        rb._image->_data.assign(data, data + image_bytes);
+        context->unmap_buffer(rb._buffer);
+        queue_image(rb._image);
+    }
+    else {
+        glerr() << log::error
+                << "frame_capture::complete_readback(): unable to map readback buffer ("
+                << rb._image->_file_name << ")." << log::end;
+        boost::lock_guard<boost::mutex> lock(_mutex);
+        ++_failed_images;
+    }
+
+    readback free_rb;
+    free_rb._buffer = rb._buffer;
+    _free_readbacks.push_back(free_rb);
+}
+
+void
+frame_capture::queue_image(const image_ptr& img)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(_mutex);
+        while (_images.size() >= _max_queued_images) {
+            _written_condition.wait(lock);
+        }
+        _images.push_back(img);
+    }
+    _queue_condition.notify_one();
+}
+
+void
+frame_capture::run_writer()
+{
+    for (;;) {
+        image_ptr img;
+        {
+            boost::unique_lock<boost::mutex> lock(_mutex);
+            while (_running && _images.empty()) {
+                _queue_condition.wait(lock);
+            }
+            if (_images.empty()) {
+                break;
+            }
+            img = _images.front();
+            _images.pop_front();
+            _writing = true;
+        }
+
+        const bool written = write_image(*img);
+        img.reset();
+
+        {
+            boost::lock_guard<boost::mutex> lock(_mutex);
+            _writing = false;
+            if (written) {
+                ++_written_images;
+            }
+            else {
+                ++_failed_images;
+            }
+        }
+        _written_condition.notify_all();
+    }
+}
+
+bool
+frame_capture::write_image(const image& img) const
+{
+    if (img._data.empty()) {
+        return false;
+    }
+
+    try {
+        if (img._stream) {
+            img._stream->write(reinterpret_cast<const char*>(&img._data.front()), img._data.size());
+            return !img._stream->fail();
+        }
+        if (_image_writer) {
+            return _image_writer(img);
+        }
+
+        std::ofstream of(img._file_name.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        of.write(reinterpret_cast<const char*>(&img._data.front()), img._data.size());
+        if (!of) {
+            glerr() << log::error
+                    << "frame_capture::write_image(): error writing output file: " << img._file_name << log::end;
+            return false;
+        }
+    }
+    catch (std::exception& e) {
+        glerr() << log::error
+                << "frame_capture::write_image(): error writing " << img._file_name << " (" << e.what() << ")." << log::end;
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace gl
+} // namespace scm
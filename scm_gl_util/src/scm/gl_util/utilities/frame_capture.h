@@ -0,0 +1,154 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_FRAME_CAPTURE_H_INCLUDED
+#define SCM_GL_UTIL_FRAME_CAPTURE_H_INCLUDED
+
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <scm/core/memory.h>
+#include <scm/core/numeric_types.h>
+#include <scm/core/math.h>
+
+#include <scm/gl_core/data_formats.h>
+#include <scm/gl_core/gl_core_fwd.h>
+
+#include <scm/gl_util/utilities/utilities_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// frame_capture
+//  - non-blocking color buffer capture: capture() reads back into a pixel pack buffer and
+//    inserts a fence, update() maps the buffers of completed readbacks (usually a frame
+//    later) and hands the images to a writer thread for encoding and file output
+//  - sequences capture one image per frame, as numbered files (the frame number is
+//    inserted before the file extension) or appended to a single raw stream
+//  - images are encoded by the write function (e.g. using an image library), without one
+//    the raw pixel data is written
+//  - capture() only blocks when all readback buffers are in flight, the writer only
+//    blocks the render thread when more than max_queued_images wait to be written
+class __scm_export(gl_util) frame_capture : boost::noncopyable
+{
+public:
+    enum sequence_mode {
+        numbered_images = 0x00,
+        raw_stream
+    }; // enum sequence_mode
+
+    struct image {
+        std::string                 _file_name;
+        math::vec2ui                _size;
+        data_format                 _format;
+        scm::uint64                 _frame;
+        std::vector<scm::uint8>     _data;
+        shared_ptr<std::ostream>    _stream;    // raw stream sequences only
+    }; // struct image
+
+    typedef shared_ptr<image>                       image_ptr;
+    typedef boost::function<bool (const image&)>    write_function;
+
+protected:
+    struct readback {
+        buffer_ptr                  _buffer;
+        fence_sync_ptr              _fence;
+        image_ptr                   _image;
+    }; // struct readback
+
+    typedef std::vector<readback>   readback_array;
+    typedef std::deque<readback>    readback_queue;
+    typedef std::deque<image_ptr>   image_queue;
+
+public:
+    frame_capture(const render_device_ptr& device,
+                  const write_function&    image_writer      = write_function(),
+                  unsigned                 readback_buffers  = 3,
+                  unsigned                 max_queued_images = 8);
+    virtual ~frame_capture();
+
+    bool                        capture(const render_context_ptr& context,
+                                        const frame_buffer_ptr&   frame_buffer,
+                                        unsigned                  color_buffer,
+                                        const math::vec2ui&       size,
+                                        data_format               format,
+                                        const std::string&        file_name);
+
+    bool                        begin_sequence(const std::string& file_name,
+                                               sequence_mode      mode = numbered_images);
+    void                        end_sequence();
+    bool                        sequence_active() const;
+    bool                        capture_sequence_frame(const render_context_ptr& context,
+                                                       const frame_buffer_ptr&   frame_buffer,
+                                                       unsigned                  color_buffer,
+                                                       const math::vec2ui&       size,
+                                                       data_format               format);
+
+    // hands completed readbacks to the writer, call once per frame
+    void                        update(const render_context_ptr& context);
+    // completes all readbacks and waits until all images are written
+    void                        flush(const render_context_ptr& context);
+
+    unsigned                    pending_readbacks() const;
+    unsigned                    queued_images() const;
+    scm::uint64                 written_images() const;
+    scm::uint64                 failed_images() const;
+
+protected:
+    bool                        start_readback(const render_context_ptr& context,
+                                               const frame_buffer_ptr&   frame_buffer,
+                                               unsigned                  color_buffer,
+                                               const math::vec2ui&       size,
+                                               data_format               format,
+                                               const image_ptr&          img);
+    void                        complete_readback(const render_context_ptr& context,
+                                                  readback&                 rb);
+    void                        queue_image(const image_ptr& img);
+
+    void                        run_writer();
+    bool                        write_image(const image& img) const;
+
+protected:
+    render_device_ptr           _device;
+    write_function              _image_writer;
+    unsigned                    _max_queued_images;
+
+    readback_array              _free_readbacks;
+    readback_queue              _pending_readbacks;
+
+    bool                        _sequence_active;
+    sequence_mode               _sequence_mode;
+    std::string                 _sequence_file_name;
+    shared_ptr<std::ostream>    _sequence_stream;
+    scm::uint64                 _sequence_frame;
+
+    boost::thread               _writer_thread;
+    mutable boost::mutex        _mutex;
+    boost::condition_variable   _queue_condition;
+    boost::condition_variable   _written_condition;
+    image_queue                 _images;
+    bool                        _running;
+    bool                        _writing;
+    scm::uint64                 _written_images;
+    scm::uint64                 _failed_images;
+
+}; // class frame_capture
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_FRAME_CAPTURE_H_INCLUDED
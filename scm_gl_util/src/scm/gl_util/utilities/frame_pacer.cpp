@@ -0,0 +1,316 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "frame_pacer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+#include <boost/chrono.hpp>
+#include <boost/io/ios_state.hpp>
+
+#include <scm/gl_core/render_device.h>
+#include <scm/gl_core/query_objects/timer_query.h>
+#include <scm/gl_core/sync_objects/fence_sync.h>
+
+namespace scm {
+namespace gl {
+
+// frame_pacer::frame_times ///////////////////////////////////////////////////////////////////////
+frame_pacer::frame_times::frame_times()
+  : _frame(0)
+  , _cpu_begin(0.0)
+  , _cpu_submit(0.0)
+  , _present(0.0)
+  , _gpu_begin(0.0)
+  , _gpu_complete(0.0)
+  , _wait_time(0.0)
+{
+}
+
+double
+frame_pacer::frame_times::motion_to_photon() const
+{
+    return std::max(_gpu_complete, _present) - _cpu_begin;
+}
+
+double
+frame_pacer::frame_times::gpu_time() const
+{
+    return _gpu_complete - _gpu_begin;
+}
+
+// frame_pacer ////////////////////////////////////////////////////////////////////////////////////
+frame_pacer::frame_pacer(const render_device_ptr& device,
+                         unsigned                 max_frames_in_flight,
+                         unsigned                 history_size)
+  : _device(device)
+  , _max_frames_in_flight(max_frames_in_flight)
+  , _history_size(std::max(history_size, 1u))
+  , _frame_count(0)
+  , _frame_active(false)
+{
+    // one query pair per frame in flight plus the one currently recorded
+    for (unsigned i = 0; i < _max_frames_in_flight + 1; ++i) {
+        const frame_queries q = allocate_queries();
+        if (!q._begin || !q._end) {
+            throw std::runtime_error("frame_pacer::frame_pacer(): error creating query objects.");
+        }
+        _free_queries.push_back(q);
+    }
+}
+
+frame_pacer::~frame_pacer()
+{
+    _active_frame = pending_frame();
+    _pending_frames.clear();
+    _free_queries.clear();
+    _device.reset();
+}
+
+unsigned
+frame_pacer::max_frames_in_flight() const
+{
+    return _max_frames_in_flight;
+}
+
+void
+frame_pacer::max_frames_in_flight(unsigned n)
+{
+    _max_frames_in_flight = n;
+}
+
+void
+frame_pacer::begin_frame(const render_context_ptr& context)
+{
+    assert(context);
+
+    if (_frame_active) {
+        // unmatched begin, drop the recorded frame
+        _free_queries.push_back(_active_frame._queries);
+        _active_frame = pending_frame();
+        _frame_active = false;
+    }
+
+    resolve_frames();
+
+    // wait until frame n - max_frames_in_flight completed on the gpu
+    double wait_time = 0.0;
+    if (   _max_frames_in_flight > 0
+        && _pending_frames.size() >= _max_frames_in_flight) {
+        const pending_frame& f = _pending_frames[_pending_frames.size() - _max_frames_in_flight];
+        if (f._fence) {
+            const double wait_start = clock_time();
+            context->sync_client_wait(f._fence);
+            wait_time = clock_time() - wait_start;
+        }
+        resolve_frames();
+    }
+
+    _active_frame._context          = context;
+    _active_frame._queries          = allocate_queries();
+    _active_frame._times._frame     = _frame_count;
+    _active_frame._times._wait_time = wait_time;
+
+    // gpu time stamps are mapped to the cpu clock relative to this point
+    _active_frame._calibration_gpu  = context->current_time_stamp();
+    _active_frame._calibration_cpu  = clock_time();
+    _active_frame._times._cpu_begin = _active_frame._calibration_cpu;
+
+    if (_active_frame._queries._begin) {
+        context->query_time_stamp(_active_frame._queries._begin);
+    }
+
+    _frame_active = true;
+}
+
+void
+frame_pacer::end_frame(const render_context_ptr& context)
+{
+    if (!_frame_active) {
+        return;
+    }
+    assert(context == _active_frame._context);
+
+    if (_active_frame._queries._end) {
+        context->query_time_stamp(_active_frame._queries._end);
+    }
+    _active_frame._fence             = context->insert_fence_sync();
+    _active_frame._times._cpu_submit = clock_time();
+
+    _pending_frames.push_back(_active_frame);
+    _active_frame = pending_frame();
+    _frame_active = false;
+
+    ++_frame_count;
+}
+
+void
+frame_pacer::present()
+{
+    // frames are resolved in the next begin_frame() at the earliest
+    if (!_pending_frames.empty() && _pending_frames.back()._times._present == 0.0) {
+        _pending_frames.back()._times._present = clock_time();
+    }
+}
+
+bool
+frame_pacer::frame_active() const
+{
+    return _frame_active;
+}
+
+scm::uint64
+frame_pacer::frame_count() const
+{
+    return _frame_count;
+}
+
+unsigned
+frame_pacer::frames_in_flight() const
+{
+    return static_cast<unsigned>(_pending_frames.size());
+}
+
+const frame_pacer::frame_times_history&
+frame_pacer::history() const
+{
+    return _history;
+}
+
+const frame_pacer::frame_times&
+frame_pacer::last_frame() const
+{
+    static const frame_times no_frame;
+
+    return _history.empty() ? no_frame : _history.back();
+}
+
+double
+frame_pacer::average_motion_to_photon() const
+{
+    if (_history.empty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (frame_times_history::const_iterator f = _history.begin(); f != _history.end(); ++f) {
+        sum += f->motion_to_photon();
+    }
+    return sum / static_cast<double>(_history.size());
+}
+
+double
+frame_pacer::max_motion_to_photon() const
+{
+    double max_time = 0.0;
+    for (frame_times_history::const_iterator f = _history.begin(); f != _history.end(); ++f) {
+        max_time = std::max(max_time, f->motion_to_photon());
+    }
+    return max_time;
+}
+
+double
+frame_pacer::average_wait_time() const
+{
+    if (_history.empty()) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (frame_times_history::const_iterator f = _history.begin(); f != _history.end(); ++f) {
+        sum += f->_wait_time;
+    }
+    return sum / static_cast<double>(_history.size());
+}
+
+double
+frame_pacer::predicted_display_time() const
+{
+    return clock_time() + average_motion_to_photon();
+}
+
+/*static*/
+double
+frame_pacer::clock_time()
+{
+    using namespace boost::chrono;
+
+    return duration_cast<duration<double> >(steady_clock::now().time_since_epoch()).count();
+}
+
+void
+frame_pacer::resolve_frames()
+{
+    // results become available in submission order, stop at the first pending one
+    while (!_pending_frames.empty()) {
+        pending_frame&             f   = _pending_frames.front();
+        const render_context_ptr&  ctx = f._context;
+
+        if (f._queries._end) {
+            if (!ctx->query_result_available(f._queries._end)) {
+                break;
+            }
+            ctx->collect_query_results(f._queries._begin);
+            ctx->collect_query_results(f._queries._end);
+
+            const scm::int64 begin_offset = static_cast<scm::int64>(f._queries._begin->result() - f._calibration_gpu);
+            const scm::int64 end_offset   = static_cast<scm::int64>(f._queries._end->result()   - f._calibration_gpu);
+
+            f._times._gpu_begin    = f._calibration_cpu + static_cast<double>(begin_offset) * 1.0e-9;
+            f._times._gpu_complete = f._calibration_cpu + static_cast<double>(end_offset)   * 1.0e-9;
+
+            _free_queries.push_back(f._queries);
+        }
+        else if (f._fence && ctx->sync_signal_status(f._fence) != SYNC_SIGNALED) {
+            break;
+        }
+
+        _history.push_back(f._times);
+        while (_history.size() > _history_size) {
+            _history.pop_front();
+        }
+        _pending_frames.pop_front();
+    }
+}
+
+frame_pacer::frame_queries
+frame_pacer::allocate_queries()
+{
+    frame_queries q;
+
+    if (!_free_queries.empty()) {
+        q = _free_queries.back();
+        _free_queries.pop_back();
+    }
+    else {
+        // without a frame limit the pool grows with the frames queued by the driver
+        q._begin = _device->create_timer_query();
+        q._end   = _device->create_timer_query();
+        if (!q._begin || !q._end) {
+            q = frame_queries();
+        }
+    }
+
+    return q;
+}
+
+std::ostream& operator<<(std::ostream& os, const frame_pacer::frame_times& t)
+{
+    boost::io::ios_all_saver saved_state(os);
+
+    os << std::fixed << std::setprecision(3)
+       << "frame " << t._frame << ": "
+       << "submit "           << (t._cpu_submit - t._cpu_begin) * 1000.0 << "ms, "
+       << "gpu "              << t.gpu_time() * 1000.0 << "ms, "
+       << "present "          << (t._present - t._cpu_begin) * 1000.0 << "ms, "
+       << "motion-to-photon " << t.motion_to_photon() * 1000.0 << "ms, "
+       << "wait "             << t._wait_time * 1000.0 << "ms";
+
+    return os;
+}
+
+} // namespace gl
+} // namespace scm
@@ -0,0 +1,128 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_GL_UTIL_FRAME_PACER_H_INCLUDED
+#define SCM_GL_UTIL_FRAME_PACER_H_INCLUDED
+
+#include <deque>
+#include <iosfwd>
+#include <vector>
+
+#include <scm/core/numeric_types.h>
+
+#include <scm/gl_core/gl_core_fwd.h>
+
+#include <scm/gl_util/utilities/utilities_fwd.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace gl {
+
+// frame_pacer
+//  - limits the frames queued ahead of the gpu: end_frame() inserts a fence after the
+//    commands of frame n, begin_frame() of frame n waits on the fence of frame
+//    n - max_frames_in_flight (sync_client_wait), 0 frames in flight only records times
+//  - records per frame the cpu begin, cpu submit, gpu begin/complete and present times,
+//    gpu time stamps are mapped to the cpu clock with a calibration taken at every frame
+//    begin, results are read back without blocking once available
+//  - all times in seconds on the clock of inp::tracker::clock_time() (steady clock), so
+//    predicted_display_time() can be passed to tracking pose prediction
+//  - motion-to-photon is estimated from the frame begin (input sampling) to the later of
+//    gpu completion and present, the scan-out of the display is not included
+class __scm_export(gl_util) frame_pacer
+{
+public:
+    struct frame_times {
+        frame_times();
+
+        double          motion_to_photon() const;
+        double          gpu_time() const;
+
+        scm::uint64     _frame;
+        double          _cpu_begin;     // begin_frame(), after the pacing wait
+        double          _cpu_submit;    // end_frame()
+        double          _present;       // present(), return of the buffer swap
+        double          _gpu_begin;
+        double          _gpu_complete;
+        double          _wait_time;     // time blocked in begin_frame() for pacing
+    }; // struct frame_times
+
+    typedef std::deque<frame_times>     frame_times_history;
+
+protected:
+    struct frame_queries {
+        timer_query_ptr         _begin;
+        timer_query_ptr         _end;
+    }; // struct frame_queries
+
+    struct pending_frame {
+        frame_times             _times;
+        frame_queries           _queries;
+        fence_sync_ptr          _fence;
+        render_context_ptr      _context;
+        double                  _calibration_cpu;
+        scm::uint64             _calibration_gpu;
+    }; // struct pending_frame
+
+    typedef std::vector<frame_queries>  query_pool;
+    typedef std::deque<pending_frame>   pending_frame_queue;
+
+public:
+    frame_pacer(const render_device_ptr& device,
+                unsigned                 max_frames_in_flight = 1,
+                unsigned                 history_size         = 120);
+    virtual ~frame_pacer();
+
+    unsigned                    max_frames_in_flight() const;
+    void                        max_frames_in_flight(unsigned n);
+
+    void                        begin_frame(const render_context_ptr& context);
+    void                        end_frame(const render_context_ptr& context);
+    void                        present();
+    bool                        frame_active() const;
+
+    scm::uint64                 frame_count() const;
+    unsigned                    frames_in_flight() const;
+
+    // resolved frames, oldest first
+    const frame_times_history&  history() const;
+    const frame_times&          last_frame() const;
+
+    double                      average_motion_to_photon() const;
+    double                      max_motion_to_photon() const;
+    double                      average_wait_time() const;
+
+    // expected present time of a frame beginning now
+    double                      predicted_display_time() const;
+
+    static double               clock_time();
+
+protected:
+    void                        resolve_frames();
+    frame_queries               allocate_queries();
+
+protected:
+    render_device_ptr           _device;
+    unsigned                    _max_frames_in_flight;
+    unsigned                    _history_size;
+    scm::uint64                 _frame_count;
+
+    bool                        _frame_active;
+    pending_frame               _active_frame;
+    pending_frame_queue         _pending_frames;
+    query_pool                  _free_queries;
+    frame_times_history         _history;
+
+}; // class frame_pacer
+
+__scm_export(gl_util) std::ostream& operator<<(std::ostream& os, const frame_pacer::frame_times& t);
+
+} // namespace gl
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_GL_UTIL_FRAME_PACER_H_INCLUDED
@@ -48,6 +48,7 @@ namespace util {
 profiling_host::profiling_host()
   : _enabled(false)
   , _update_interval(0)
+  , _gl_frames_in_flight(gl_accum_timer::default_frames_in_flight)
 {
 }
 
@@ -68,6 +69,18 @@ profiling_host::enabled(bool e)
     _enabled = e;
 }
 
+unsigned
+profiling_host::gl_frames_in_flight() const
+{
+    return _gl_frames_in_flight;
+}
+
+void
+profiling_host::gl_frames_in_flight(unsigned n)
+{
+    _gl_frames_in_flight = n;
+}
+
 void
 profiling_host::cpu_start(const std::string& tname)
 {
@@ -104,7 +117,7 @@ profiling_host::gl_start(const std::string& tname, const render_context_ptr& con
         if (ti == _timers.end()) {
             // EVIL!!!111einseinself
             render_device_ptr d(&(context->parent_device()), null_deleter());
-            t = new gl_accum_timer(d);
+            t = new gl_accum_timer(d, _gl_frames_in_flight);
             _timers.insert(timer_map::value_type(tname, timer_instance(GL_TIMER, t)));
         }
         else {
@@ -71,6 +71,11 @@ public:
     bool                    enabled() const;
     void                    enabled(bool e);
 
+    // time stamp query pairs preallocated per gl timer, each start/stop is resolved
+    // asynchronously up to this many frames later (see accum_timer_query)
+    unsigned                gl_frames_in_flight() const;
+    void                    gl_frames_in_flight(unsigned n);
+
     void                    cpu_start(const std::string& tname);
     void                    gl_start(const std::string& tname, const render_context_ptr& context);
 #if SCM_ENABLE_CUDA_CL_SUPPORT
@@ -106,6 +111,7 @@ protected:
     bool                    _enabled;
     timer_map               _timers;
     int                     _update_interval;
+    unsigned                _gl_frames_in_flight;
 
 }; // profiling_host
 
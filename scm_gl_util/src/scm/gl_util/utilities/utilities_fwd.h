@@ -18,6 +18,18 @@ class coordinate_cross;
 typedef shared_ptr<coordinate_cross>                coordinate_cross_ptr;
 typedef shared_ptr<coordinate_cross const>          coordinate_cross_cptr;
 
+class dynamic_resolution;
+typedef shared_ptr<dynamic_resolution>              dynamic_resolution_ptr;
+typedef shared_ptr<dynamic_resolution const>        dynamic_resolution_cptr;
+
+class frame_capture;
+typedef shared_ptr<frame_capture>                   frame_capture_ptr;
+typedef shared_ptr<frame_capture const>             frame_capture_cptr;
+
+class frame_pacer;
+typedef shared_ptr<frame_pacer>                     frame_pacer_ptr;
+typedef shared_ptr<frame_pacer const>               frame_pacer_cptr;
+
 class geometry_highlight;
 typedef shared_ptr<geometry_highlight>              geometry_highlight_ptr;
 typedef shared_ptr<geometry_highlight const>        geometry_highlight_cptr;
@@ -36,6 +36,8 @@
 #include <scm/gl_util/font/text_renderer.h>
 #include <scm/gl_util/primitives/fullscreen_triangle.h>
 #include <scm/gl_util/primitives/quad.h>
+#include <scm/gl_util/utilities/dynamic_resolution.h>
+#include <scm/gl_util/utilities/frame_pacer.h>
 #include <scm/gl_core/window_management/context.h>
 #include <scm/gl_core/window_management/display.h>
 #include <scm/gl_core/window_management/window.h>
@@ -64,14 +66,37 @@ const std::string color_present_fsrc = "
     in vec2 tex_coord;                                                                  \n\
     uniform sampler2D in_texture;                                                       \n\
     uniform int       in_level;                                                         \n\
+    uniform vec2      in_uv_scale;                                                      \n\
                                                                                         \n\
     layout(location = 0) out vec4 out_color;                                            \n\
     void main()                                                                         \n\
     {                                                                                   \n\
-        out_color = texelFetch(in_texture, ivec2(gl_FragCoord.xy), in_level).rgba;      \n\
+        if (in_uv_scale.x < 1.0 || in_uv_scale.y < 1.0) {                               \n\
+            vec2 uv_max = in_uv_scale - 0.5 / vec2(textureSize(in_texture, in_level));  \n\
+            out_color = textureLod(in_texture, min(tex_coord * in_uv_scale, uv_max),    \n\
+                                   float(in_level)).rgba;                               \n\
+        }                                                                               \n\
+        else {                                                                          \n\
+            out_color = texelFetch(in_texture, ivec2(gl_FragCoord.xy), in_level).rgba;  \n\
+        }                                                                               \n\
     }                                                                                   \n\
     ";
 
+// runs on the writer thread of the frame capture
+bool
+write_captured_image(const scm::gl::frame_capture::image& img)
+{
+    fipImage of(FIT_BITMAP, img._size.x, img._size.y, scm::gl::bit_per_pixel(img._format));
+    memcpy(of.accessPixels(), &img._data.front(), img._data.size());
+
+    if (!of.save(img._file_name.c_str())) {
+        scm::gl::glerr() << scm::log::error
+                         << "viewer: unable to write image file: " << img._file_name << scm::log::end;
+        return false;
+    }
+    return true;
+}
+
 } // namespace 
 
 namespace scm {
@@ -86,6 +111,11 @@ viewer::viewer_settings::viewer_settings()
   , _clear_stencil(0)
   , _show_frame_times(false)
   , _full_screen(false)
+  , _frame_pacing(false)
+  , _max_frames_in_flight(1)
+  , _dynamic_resolution(false)
+  , _dynamic_resolution_target_time(12.0)
+  , _dynamic_resolution_min_scale(0.5f)
 {
 }
 
@@ -117,6 +147,7 @@ viewer::render_target::~render_target()
 
     _filter_nearest.reset();
     _filter_linear.reset();
+    _filter_linear_mip_nearest.reset();
     _no_blend.reset();
     _dstate_no_zwrite.reset();
     _cull_back.reset();
@@ -155,6 +186,11 @@ viewer::viewer(const math::vec2ui&                  vp_dim,
         initialize_shader_includes();
         initialize_render_target();
 
+        _frame_pacer.reset(new frame_pacer(_device, _settings._max_frames_in_flight));
+        _frame_capture.reset(new frame_capture(_device, write_captured_image));
+        _dynamic_resolution.reset(new dynamic_resolution(_device, _settings._dynamic_resolution_target_time,
+                                                                  _settings._dynamic_resolution_min_scale));
+
         font_face_ptr counter_font(new font_face(_device, "../../../res/fonts/Consola.ttf", 12, 0.7f, font_face::smooth_lcd));
         _text_renderer.reset(new text_renderer(_device));
         _frame_counter_text.reset(new text(_device, counter_font, font_face::style_regular, "sick, sad world..."));
@@ -182,6 +218,13 @@ viewer::~viewer()
     _render_target.reset();
     _text_renderer.reset();
     _frame_counter_text.reset();
+    _frame_pacer.reset();
+    _dynamic_resolution.reset();
+
+    if (_frame_capture) {
+        _frame_capture->flush(_context);
+        _frame_capture.reset();
+    }
 
     _context.reset();
     _device.reset();
@@ -247,6 +290,19 @@ viewer::main_viewport() const
     return _viewport;
 }
 
+viewport
+viewer::scene_viewport() const
+{
+    const math::vec2ui full_size = math::vec2ui(_viewport._dimensions) * _render_target->_viewport_scale;
+
+    if (_settings._dynamic_resolution) {
+        return viewport(math::vec2ui(0, 0), _dynamic_resolution->render_size(full_size));
+    }
+    else {
+        return viewport(math::vec2ui(0, 0), full_size);
+    }
+}
+
 const gl::frame_buffer_ptr&
 viewer::main_framebuffer() const
 {
@@ -290,55 +346,71 @@ viewer::frame_time_us() const
     return _frame_time_us;
 }
 
+const frame_pacer_ptr&
+viewer::frame_pacing() const
+{
+    return _frame_pacer;
+}
+
+const dynamic_resolution_ptr&
+viewer::resolution_scaling() const
+{
+    return _dynamic_resolution;
+}
+
 void
 viewer::swap_buffers(int interval)
 {
     _window->swap_buffers(interval);
+    _frame_pacer->present();
 }
 
 bool
 viewer::take_screenshot(const std::string& f) const
 {
-    if (!_render_target) {
-        glerr() << log::error 
-                << "viewer::take_screenshot(): only working if using anti aliasing and therefore a texture render target."
-                << log::end;
+    if (!_render_target || !_frame_capture) {
+        glerr() << log::error
+                << "viewer::take_screenshot(): no render target to capture (viewer not initialized)." << log::end;
         return false;
     }
 
-    size_t img_size =  _render_target->_color_buffer_resolved->descriptor()._size.x
-                     * _render_target->_color_buffer_resolved->descriptor()._size.y
-                     * size_of_format(_render_target->_color_buffer_resolved->format());
-    shared_ptr<uint8>   data(new uint8[img_size]);
+    const texture_2d_ptr& color_buffer = _render_target->_color_buffer_resolved;
 
-    if (!context()->retrieve_texture_data(_render_target->_color_buffer_resolved, 0, data.get())) {
+    if (!_frame_capture->capture(context(), _render_target->_framebuffer_resolved, 0,
+                                 math::vec2ui(scene_viewport()._dimensions), color_buffer->format(), f)) {
         glerr() << log::error 
-                << "viewer::take_screenshot(): unable to read back texture data." << log::end;
+                << "viewer::take_screenshot(): unable to read back color buffer." << log::end;
         return false;
     }
 
-#if 0
-    io::file_ptr of(new io::file());
+    return true;
+}
 
-    if (!of->open(f, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc, false)) {
-        glerr() << log::error 
-                << "viewer::take_screenshot(): error opening output file : " << f << log::end;
+bool
+viewer::begin_frame_sequence(const std::string&           f,
+                             frame_capture::sequence_mode m)
+{
+    if (!_render_target || !_frame_capture) {
+        glerr() << log::error
+                << "viewer::begin_frame_sequence(): no render target to capture (viewer not initialized)." << log::end;
         return false;
     }
-    if (of->write(data.get(), 0, img_size) != img_size) {
-        glerr() << log::error 
-                << "viewer::take_screenshot(): unable to write out texture data." << log::end;
-        return false;
+
+    return _frame_capture->begin_sequence(f, m);
+}
+
+void
+viewer::end_frame_sequence()
+{
+    if (_frame_capture) {
+        _frame_capture->end_sequence();
     }
-#else
-    fipImage of(FIT_BITMAP,
-                _render_target->_color_buffer_resolved->descriptor()._size.x,
-                _render_target->_color_buffer_resolved->descriptor()._size.y,
-                bit_per_pixel(_render_target->_color_buffer_resolved->format()));
-    memcpy(of.accessPixels(), data.get(), img_size);
-    of.save(f.c_str());
-#endif
-    return true;
+}
+
+const frame_capture_ptr&
+viewer::frame_capturing() const
+{
+    return _frame_capture;
 }
 
 void
@@ -430,6 +502,12 @@ viewer::send_render_pre_frame_update()
 {
     using namespace scm::math;
 
+    // wait for the frame limit before the input for the frame is sampled
+    if (_settings._frame_pacing && !_frame_pacer->frame_active()) {
+        _frame_pacer->max_frames_in_flight(_settings._max_frames_in_flight);
+        _frame_pacer->begin_frame(context());
+    }
+
     _device_space_navigator->update(); // update done directly (poll), callback of the device disabled!
 
     mat4f view_matrix =   inverse(_device_space_navigator->translation())
@@ -457,12 +535,30 @@ viewer::send_render_display()
     using namespace scm::gl;
     using namespace scm::math;
 
+    if (_settings._frame_pacing && !_frame_pacer->frame_active()) {
+        _frame_pacer->max_frames_in_flight(_settings._max_frames_in_flight);
+        _frame_pacer->begin_frame(context());
+    }
+
     _frame_timer.stop();
     _frame_timer.start();
 
     _frame_time_us = static_cast<float>(_frame_timer.last_time(time::time_io::usec));//static_cast<float>(scm::time::to_microseconds(_frame_timer.last_time()));
 
+    if (_settings._dynamic_resolution) {
+        _dynamic_resolution->target_time(_settings._dynamic_resolution_target_time);
+        _dynamic_resolution->scale_range(_settings._dynamic_resolution_min_scale, 1.0f);
+        _dynamic_resolution->update();
+    }
+
     if (_display_scene_func) {
+        const viewport scene_vp = scene_viewport();
+        const vec2f    uv_scale =   scene_vp._dimensions
+                                  / vec2f(_viewport._dimensions * static_cast<float>(_render_target->_viewport_scale));
+
+        if (_settings._dynamic_resolution) {
+            _dynamic_resolution->begin_frame(context());
+        }
 
         // clear
         clear_color();
@@ -475,7 +571,7 @@ viewer::send_render_display()
 
             // set the render target
             context()->set_frame_buffer(_render_target->_framebuffer_aa);
-            context()->set_viewport(viewport(vec2ui(0, 0), vec2ui(_viewport._dimensions) * _render_target->_viewport_scale));
+            context()->set_viewport(scene_vp);
             
             // client code
             _display_scene_func(context());
@@ -491,6 +587,7 @@ viewer::send_render_display()
 
             // set the render target
             context()->set_frame_buffer(_render_target->_framebuffer_resolved);
+            context()->set_viewport(scene_vp);
             {
                 // client code
                 _display_scene_func(context());
@@ -498,6 +595,16 @@ viewer::send_render_display()
         }
 
 
+        if (_settings._dynamic_resolution) {
+            _dynamic_resolution->end_frame();
+        }
+
+        if (_frame_capture->sequence_active()) {
+            const texture_2d_ptr& color_buffer = _render_target->_color_buffer_resolved;
+            _frame_capture->capture_sequence_frame(context(), _render_target->_framebuffer_resolved, 0,
+                                                   vec2ui(scene_vp._dimensions), color_buffer->format());
+        }
+
         if (_attributes._post_process_aa) {
             context()->set_default_frame_buffer();
             context()->set_viewport(_viewport);
@@ -506,6 +613,8 @@ viewer::send_render_display()
             context()->set_blend_state(_render_target->_no_blend);
             context()->set_rasterizer_state(_render_target->_cull_back);
 
+            _render_target->_post_process_aa_program->uniform("in_uv_scale", uv_scale);
+
             context()->bind_program(_render_target->_post_process_aa_program);
             context()->bind_texture(_render_target->_color_buffer_resolved, _render_target->_filter_linear, 0);
 
@@ -519,8 +628,13 @@ viewer::send_render_display()
             context()->set_blend_state(_render_target->_no_blend);
             context()->set_rasterizer_state(_render_target->_cull_back);
 
+            // upscaling of a lower dynamic resolution filters linearly
+            _render_target->_color_present_program->uniform("in_uv_scale", uv_scale);
+
             context()->bind_program(_render_target->_color_present_program);
-            context()->bind_texture(_render_target->_color_buffer_resolved, _render_target->_filter_nearest, 0);
+            context()->bind_texture(_render_target->_color_buffer_resolved,
+                                    (uv_scale.x < 1.0f || uv_scale.y < 1.0f) ? _render_target->_filter_linear_mip_nearest
+                                                                             : _render_target->_filter_nearest, 0);
 
             _render_target->_fs_geom->draw(context());
         }
@@ -553,6 +667,13 @@ viewer::send_render_display()
             output << std::fixed << "frame_time: ";
             _frame_timer.report(output);
             output << " fps: " << frame_fps;
+            if (_settings._frame_pacing) {
+                output << " motion-to-photon: " << _frame_pacer->average_motion_to_photon() * 1000.0 << "ms";
+            }
+            if (_settings._dynamic_resolution) {
+                output << " resolution: " << _dynamic_resolution->scale() * 100.0f << "% "
+                       << "(scene: " << _dynamic_resolution->gpu_time() << "ms)";
+            }
 
             _frame_counter_text->text_string(output.str());
             if (frame_time > 1000.0 / 50.0) {
@@ -567,6 +688,12 @@ viewer::send_render_display()
         }
     }
 
+    _frame_capture->update(context());
+
+    if (_frame_pacer->frame_active()) {
+        _frame_pacer->end_frame(context());
+    }
+
     if (!_settings._swap_explicit) {
         const int32 swap_interval = math::max(1, _settings._vsync_swap_interval);
         swap_buffers(_settings._vsync ? swap_interval : 0);
@@ -734,6 +861,7 @@ viewer::initialize_render_target()
         else {
             _render_target->_color_present_program->uniform("mvp",          make_ortho_matrix(0.0f, 1.0f, 0.0f, 1.0f, -1.0f, 1.0f));
             _render_target->_color_present_program->uniform("in_level",     0);
+            _render_target->_color_present_program->uniform("in_uv_scale",  vec2f(1.0f));
             _render_target->_color_present_program->uniform_sampler("in_texture", 0);
         }
     }
@@ -807,6 +935,7 @@ viewer::initialize_render_target()
             _render_target->_post_process_aa_program->uniform("mvp",            make_ortho_matrix(0.0f, 1.0f, 0.0f, 1.0f, -1.0f, 1.0f));
             //_render_target->_post_process_aa_program->uniform("in_vp_size",     vp_size);
             _render_target->_post_process_aa_program->uniform("in_vp_size_rec", vec2f(1.0) / vp_size);
+            _render_target->_post_process_aa_program->uniform("in_uv_scale",    vec2f(1.0f));
             _render_target->_post_process_aa_program->uniform_sampler("in_texture", 0);
 
         }
@@ -814,11 +943,13 @@ viewer::initialize_render_target()
         // state objects
         _render_target->_filter_nearest   = device()->create_sampler_state(FILTER_MIN_MAG_NEAREST, WRAP_CLAMP_TO_EDGE);
         _render_target->_filter_linear    = device()->create_sampler_state(FILTER_MIN_MAG_LINEAR, WRAP_CLAMP_TO_EDGE);
+        _render_target->_filter_linear_mip_nearest = device()->create_sampler_state(FILTER_MIN_MAG_LINEAR_MIP_NEAREST, WRAP_CLAMP_TO_EDGE);
         _render_target->_no_blend         = device()->create_blend_state(false, FUNC_ONE, FUNC_ZERO, FUNC_ONE, FUNC_ZERO);
         _render_target->_dstate_no_zwrite = device()->create_depth_stencil_state(false, false);
         _render_target->_cull_back        = device()->create_rasterizer_state(FILL_SOLID, CULL_BACK, ORIENT_CCW);
 
         if (   !_render_target->_filter_nearest
+            || !_render_target->_filter_linear_mip_nearest
             || !_render_target->_no_blend
             || !_render_target->_dstate_no_zwrite
             || !_render_target->_cull_back) {
@@ -19,6 +19,8 @@
 
 #include <scm/gl_util/font/font_fwd.h>
 #include <scm/gl_util/primitives/primitives_fwd.h>
+#include <scm/gl_util/utilities/utilities_fwd.h>
+#include <scm/gl_util/utilities/frame_capture.h>
 #include <scm/gl_util/viewer/camera.h>
 #include <scm/gl_core/window_management/wm_fwd.h>
 #include <scm/gl_core/window_management/surface.h>
@@ -84,6 +86,11 @@ public:
         unsigned    _clear_stencil;
         bool        _show_frame_times;
         bool        _full_screen;
+        bool        _frame_pacing;          // bound the frames queued ahead of the gpu
+        unsigned    _max_frames_in_flight;
+        bool        _dynamic_resolution;    // scale the scene resolution to meet a gpu time
+        double      _dynamic_resolution_target_time;   // ms, scene passes
+        float       _dynamic_resolution_min_scale;
     }; // struct viewer_settings
 
     typedef boost::function<void (const render_device_ptr&,
@@ -128,6 +135,8 @@ public:
     camera&                         main_camera();
 
     const viewport&                 main_viewport() const;
+    // viewport of the scene render target, scaled with the dynamic resolution
+    viewport                        scene_viewport() const;
     
     const gl::frame_buffer_ptr&     main_framebuffer() const;
 
@@ -140,10 +149,19 @@ public:
     void                            clear_depth_stencil() const;
 
     float                           frame_time_us() const;
+    const frame_pacer_ptr&          frame_pacing() const;
+    const dynamic_resolution_ptr&   resolution_scaling() const;
 
     void                            swap_buffers(int interval = 0);
 
+    // non-blocking, the image is read back and written during the following frames
     bool                            take_screenshot(const std::string& f) const;
+    // one image per frame of the scene render target until the sequence is ended, the
+    // image size follows the dynamic resolution
+    bool                            begin_frame_sequence(const std::string&          f,
+                                                         frame_capture::sequence_mode m = frame_capture::numbered_images);
+    void                            end_frame_sequence();
+    const frame_capture_ptr&        frame_capturing() const;
     
     // callbacks
     void                            render_update_func(const update_func& f);
@@ -226,6 +244,7 @@ protected:
         // state objects
         gl::sampler_state_ptr           _filter_nearest;
         gl::sampler_state_ptr           _filter_linear;
+        gl::sampler_state_ptr           _filter_linear_mip_nearest;
         gl::blend_state_ptr             _no_blend;
         gl::depth_stencil_state_ptr     _dstate_no_zwrite;
         gl::rasterizer_state_ptr        _cull_back;
@@ -238,6 +257,9 @@ protected:
 
     time::cpu_accum_timer           _frame_timer;
     float                           _frame_time_us;
+    frame_pacer_ptr                 _frame_pacer;
+    dynamic_resolution_ptr          _dynamic_resolution;
+    frame_capture_ptr               _frame_capture;
 
     gl::text_renderer_ptr           _text_renderer;
     gl::text_ptr                    _frame_counter_text;
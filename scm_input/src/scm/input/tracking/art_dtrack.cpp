@@ -4,14 +4,15 @@
 
 #include "art_dtrack.h"
 
+#include <boost/bind.hpp>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <cassert>
 
 #include <scm/log.h>
 
 #include <scm/core/math/math.h>
-#include <scm/core/utilities/foreach.h>
 
 #include <scm/input/tracking/target.h>
 #include <scm/input/tracking/detail/dtrack.h>
@@ -19,25 +20,32 @@
 namespace {
 
 const std::size_t   dtrack_default_udp_bufsize  = 10000;
+const std::size_t   dtrack_max_receive_timeout  = 100000; // us, bounds the shutdown delay
 
 } // namespace 
 
 namespace scm {
 namespace inp {
 
+const unsigned art_dtrack::max_bodies;
+
 art_dtrack::art_dtrack(std::size_t listening_port,
                        std::size_t timeout)
   : tracker(std::string("art_dtrack")),
     _dtrack(new DTrack),
     _listening_port(listening_port),
     _timeout(timeout),
+    _receive_running(false),
+    _received_count(0),
     _initialized(false)
 {
 }
 
 art_dtrack::~art_dtrack()
 {
-    shutdown();
+    if (_initialized) {
+        shutdown();
+    }
 }
 
 bool art_dtrack::initialize()
@@ -56,7 +64,7 @@ bool art_dtrack::initialize()
 
     // initialize init struct
     init_dtrack.udpport         = boost::numeric_cast<unsigned short>(_listening_port);
-    init_dtrack.udptimeout_us   = boost::numeric_cast<unsigned long>(_timeout);
+    init_dtrack.udptimeout_us   = boost::numeric_cast<unsigned long>(scm::math::min(_timeout, dtrack_max_receive_timeout));
     init_dtrack.udpbufsize      = boost::numeric_cast<int>(dtrack_default_udp_bufsize);
     init_dtrack.remote_port     = 0;
     strcpy(init_dtrack.remote_ip, "");
@@ -82,6 +90,13 @@ bool art_dtrack::initialize()
                    << "unable to enable cameras and calculation (error: '" << error_dtrack << "')" << log::end;
     }
 
+    // drop a sample left over from a previous session
+    _samples.consume();
+    _received_count.store(0);
+
+    _receive_running.store(true);
+    _receive_thread.reset(new boost::thread(boost::bind(&art_dtrack::receive_loop, this)));
+
     _initialized = true;
 
     return (true);
@@ -96,6 +111,13 @@ bool art_dtrack::shutdown()
         return (true);
     }
 
+    // stop the receive thread before closing the socket it reads from
+    _receive_running.store(false);
+    if (_receive_thread) {
+        _receive_thread->join();
+        _receive_thread.reset();
+    }
+
     // try to shutdown dtrack device
     int error_dtrack = 0;
     
@@ -116,52 +138,88 @@ bool art_dtrack::shutdown()
 
 void art_dtrack::update(target_container& targets)
 {
-    typedef target_container::value_type    val_type;
+    if (!_samples.consume()) {
+        return;
+    }
 
-    int                 error_dtrack        = 0;
-    unsigned long       frame_nr            = 0;
-    double              time_stamp          = 0.;
-    int                 num_cal_bodies      = 0;
-    int                 num_tracked_bodies  = 0;
-    unsigned            max_tracked_bodies  = 0;
-    int                 dummy               = 0;
+    const sample&               cur_sample = _samples.front();
+    target_container::iterator  target_it;
+
+    for (unsigned i = 0; i < cur_sample._body_count; ++i) {
+        const body& cur_body = cur_sample._bodies[i];
 
-    boost::scoped_array<dtrack_body_type>   bodies;
+        target_it = targets.find(cur_body._id + 1);
 
-    foreach (const val_type& tar, targets) {
-        max_tracked_bodies = scm::math::max(boost::numeric_cast<unsigned>(tar.first), max_tracked_bodies);
+        if (target_it != targets.end()) {
+            target_it->second.transform(cur_body._transform, cur_sample._receive_time);
+        }
     }
+}
 
-    bodies.reset(new dtrack_body_type[max_tracked_bodies]);
+std::size_t art_dtrack::listening_port() const
+{
+    return (_listening_port);
+}
 
-    // try to receive dtrack packet
-    error_dtrack = _dtrack->receive_udp_ascii(  &frame_nr,              &time_stamp,    &num_cal_bodies,
-                                                &num_tracked_bodies,    bodies.get(),   max_tracked_bodies,
-                                                &dummy,                 0,              0,
-                                                &dummy,                 0,              0,
-                                                &dummy,                 0,              0);
+std::size_t art_dtrack::timeout() const
+{
+    return (_timeout);
+}
 
-    if (error_dtrack != DTRACK_ERR_NONE) {
-        scm::err() << log::warning
-                   << "art_dtrack::update(): "
-                   << "unable to receive dtrack packet (error: '" << error_dtrack << "')" << log::end;
-        return;
-    }
+const art_dtrack::sample& art_dtrack::current_sample() const
+{
+    return (_samples.front());
+}
 
-    const unsigned              max_bodies = scm::math::min(max_tracked_bodies, boost::numeric_cast<unsigned>(num_tracked_bodies));
-    target_container::iterator  target_it;
+std::size_t art_dtrack::received_sample_count() const
+{
+    return (_received_count.load());
+}
+
+void art_dtrack::receive_loop()
+{
+    dtrack_body_type    bodies[max_bodies];
+    int                 last_error  = DTRACK_ERR_NONE;
 
-    scm::math::mat4f  track_to_opengl(scm::math::mat4f::identity());
+    scm::math::mat4f    track_to_opengl(scm::math::mat4f::identity());
     //scm::math::rotate(track_to_opengl, -180.0f, 0.f, 1.f, 0.f);
 
+    while (_receive_running.load()) {
+        unsigned long   frame_nr            = 0;
+        double          time_stamp          = 0.;
+        int             num_cal_bodies      = 0;
+        int             num_tracked_bodies  = 0;
+        int             dummy               = 0;
+
+        // wait for the next dtrack packet (at most the receive timeout)
+        const int error_dtrack = _dtrack->receive_udp_ascii(&frame_nr,              &time_stamp,    &num_cal_bodies,
+                                                            &num_tracked_bodies,    bodies,         max_bodies,
+                                                            &dummy,                 0,              0,
+                                                            &dummy,                 0,              0,
+                                                            &dummy,                 0,              0);
+
+        if (error_dtrack != DTRACK_ERR_NONE) {
+            // timeouts are expected while the tracking system is idle, report other errors once
+            if (error_dtrack != DTRACK_ERR_TIMEOUT && error_dtrack != last_error) {
+                scm::err() << log::warning
+                           << "art_dtrack::receive_loop(): "
+                           << "unable to receive dtrack packet (error: '" << error_dtrack << "')" << log::end;
+            }
+            last_error = error_dtrack;
+            continue;
+        }
+        last_error = DTRACK_ERR_NONE;
 
-    for (unsigned i = 0; i < max_bodies; ++i) {
-        target_it = targets.find(bodies[i].id + 1);
-        //console.get() << con::log_level(con::error) << bodies[i].id << std::endl;
+        sample& cur_sample = _samples.back();
 
-        if (target_it != targets.end()) {
+        cur_sample._frame        = frame_nr;
+        cur_sample._time_stamp   = time_stamp;
+        cur_sample._receive_time = clock_time();
+        cur_sample._body_count   = scm::math::min(max_bodies, boost::numeric_cast<unsigned>(num_tracked_bodies));
+
+        for (unsigned i = 0; i < cur_sample._body_count; ++i) {
             scm::math::vec4f    pos   = scm::math::vec4f(bodies[i].loc[0], bodies[i].loc[1],  bodies[i].loc[2], 1.0f);
-            scm::math::mat4f    ori   =scm:: math::mat4f(bodies[i].rot[0], bodies[i].rot[1], bodies[i].rot[2], 0.0f,   // 1st column
+            scm::math::mat4f    ori   = scm::math::mat4f(bodies[i].rot[0], bodies[i].rot[1], bodies[i].rot[2], 0.0f,   // 1st column
                                                          bodies[i].rot[3], bodies[i].rot[4], bodies[i].rot[5], 0.0f,   // 2nd column
                                                          bodies[i].rot[6], bodies[i].rot[7], bodies[i].rot[8], 0.0f,   // 3rd column
                                                          0.0f,             0.0f,             0.0f,             1.0f);  // 4th column
@@ -174,8 +232,13 @@ void art_dtrack::update(target_container& targets)
             ori.m14 = pos.z;
             ori.m15 = pos.w;
 
-            target_it->second.transform(ori);
+            cur_sample._bodies[i]._id        = static_cast<unsigned>(bodies[i].id);
+            cur_sample._bodies[i]._quality   = bodies[i].quality;
+            cur_sample._bodies[i]._transform = ori;
         }
+
+        _samples.publish();
+        _received_count.fetch_add(1);
     }
 }
 
@@ -7,20 +7,57 @@
 
 #include <cstddef>
 
+#include <boost/atomic.hpp>
 #include <boost/scoped_ptr.hpp>
 
+#include <scm/core/math.h>
+
 #include <scm/input/tracking/tracker.h>
+#include <scm/input/tracking/detail/triple_buffer.h>
 
 #include <scm/core/platform/platform.h>
 #include <scm/core/utilities/platform_warning_disable.h>
 
 class DTrack;
 
+namespace boost {
+class thread;
+} // namespace boost
+
 namespace scm {
 namespace inp {
 
+// art_dtrack
+//  - receives the ascii udp stream of an ART DTrack system on a dedicated thread, the
+//    receive thread parses the packets and publishes the latest sample through a lock free
+//    triple buffer
+//  - update() never blocks or allocates, it applies the latest sample (if a new one arrived)
+//    to the matching targets (target id = dtrack body id + 1)
+//  - the timeout (us) bounds a single receive wait of the thread, it is limited so that
+//    shutdown() does not stall
+//  - any process sending dtrack ascii packets to the listening port (e.g. a local udp
+//    sender replaying recorded frames) can stand in for the tracking system
 class __scm_export(input) art_dtrack : public tracker
 {
+public:
+    static const unsigned max_bodies = 64;
+
+    struct body {
+        unsigned                _id;            // dtrack body id
+        float                   _quality;
+        scm::math::mat4f        _transform;
+    }; // struct body
+
+    struct sample {
+        sample() : _frame(0), _time_stamp(-1.0), _receive_time(0.0), _body_count(0) {}
+
+        unsigned long           _frame;
+        double                  _time_stamp;    // dtrack time stamp (s), negative if not sent
+        double                  _receive_time;  // tracker::clock_time() at reception
+        unsigned                _body_count;
+        body                    _bodies[max_bodies];
+    }; // struct sample
+
 public:
     art_dtrack(std::size_t /*listening_port*/ = 5000,
                std::size_t /*timeout*/        = 1000000);
@@ -30,17 +67,28 @@ public:
     void                        update(target_container& /*targets*/);
     bool                        shutdown();
 
-    std::size_t                  listening_port() const;
-    std::size_t                  timeout() const;
+    std::size_t                 listening_port() const;
+    std::size_t                 timeout() const;
+
+    // the sample last taken by update()
+    const sample&               current_sample() const;
+    // number of samples received since initialize()
+    std::size_t                 received_sample_count() const;
 
 protected:
+    void                        receive_loop();
 
 private:
-    const boost::scoped_ptr<DTrack> _dtrack;
-    std::size_t                     _listening_port;
-    std::size_t                     _timeout;
+    const boost::scoped_ptr<DTrack>     _dtrack;
+    std::size_t                         _listening_port;
+    std::size_t                         _timeout;
+
+    detail::triple_buffer<sample>       _samples;
+    boost::scoped_ptr<boost::thread>    _receive_thread;
+    boost::atomic<bool>                 _receive_running;
+    boost::atomic<std::size_t>          _received_count;
 
-    bool                            _initialized;
+    bool                                _initialized;
 
 }; // class art_dtrack
 
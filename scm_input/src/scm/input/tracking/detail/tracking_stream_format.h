@@ -0,0 +1,41 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_INPUT_TRACKING_DETAIL_TRACKING_STREAM_FORMAT_H_INCLUDED
+#define SCM_INPUT_TRACKING_DETAIL_TRACKING_STREAM_FORMAT_H_INCLUDED
+
+#include <fstream>
+
+#include <scm/core/numeric_types.h>
+
+namespace scm {
+namespace inp {
+namespace detail {
+
+// recorded tracking stream files (tracking_recorder, tracking_replay)
+//  - header: magic (8 chars), version (uint32)
+//  - records until the end of the file, in time order:
+//      time (float64, seconds), target id (uint32), transform (16 float32, column major)
+const char          tracking_stream_magic[8] = {'S', 'C', 'M', 'T', 'R', 'A', 'C', 'K'};
+const scm::uint32   tracking_stream_version  = 1;
+
+template<typename value_type>
+inline bool
+write_stream_values(std::ofstream& out_file, const value_type* in_values, scm::size_t in_count)
+{
+    return !out_file.write(reinterpret_cast<const char*>(in_values), in_count * sizeof(value_type)).fail();
+}
+
+template<typename value_type>
+inline bool
+read_stream_values(std::ifstream& in_file, value_type* out_values, scm::size_t in_count)
+{
+    return !in_file.read(reinterpret_cast<char*>(out_values), in_count * sizeof(value_type)).fail();
+}
+
+} // namespace detail
+} // namespace inp
+} // namespace scm
+
+#endif // SCM_INPUT_TRACKING_DETAIL_TRACKING_STREAM_FORMAT_H_INCLUDED
@@ -0,0 +1,72 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_INPUT_TRACKING_DETAIL_TRIPLE_BUFFER_H_INCLUDED
+#define SCM_INPUT_TRACKING_DETAIL_TRIPLE_BUFFER_H_INCLUDED
+
+#include <boost/atomic.hpp>
+#include <boost/noncopyable.hpp>
+
+namespace scm {
+namespace inp {
+namespace detail {
+
+// triple_buffer
+//  - hands the latest value from one producer thread to one consumer thread without locks
+//  - the producer fills back() and publishes it, the consumer takes the latest published
+//    value with consume() and reads it through front(), neither side ever waits
+//  - values published before the consumer took them are overwritten (latest wins)
+//  - the slots are preallocated, publishing and consuming only exchange slot indices
+template<typename value_type>
+class triple_buffer : boost::noncopyable
+{
+public:
+    triple_buffer()
+      : _back(0)
+      , _middle(1)
+      , _front(2)
+    {
+    }
+
+    // producer side
+    value_type&         back()
+    {
+        return (_slots[_back]);
+    }
+    void                publish()
+    {
+        _back = _middle.exchange(_back | fresh_bit, boost::memory_order_acq_rel) & index_mask;
+    }
+
+    // consumer side, returns false if nothing was published since the last call
+    bool                consume()
+    {
+        if (!(_middle.load(boost::memory_order_relaxed) & fresh_bit)) {
+            return (false);
+        }
+        _front = _middle.exchange(_front, boost::memory_order_acq_rel) & index_mask;
+        return (true);
+    }
+    const value_type&   front() const
+    {
+        return (_slots[_front]);
+    }
+
+private:
+    static const unsigned   index_mask = 0x3u;
+    static const unsigned   fresh_bit  = 0x4u;
+
+    value_type              _slots[3];
+
+    unsigned                _back;      // owned by the producer
+    boost::atomic<unsigned> _middle;    // shared, slot index and fresh flag
+    unsigned                _front;     // owned by the consumer
+
+}; // class triple_buffer
+
+} // namespace detail
+} // namespace inp
+} // namespace scm
+
+#endif // SCM_INPUT_TRACKING_DETAIL_TRIPLE_BUFFER_H_INCLUDED
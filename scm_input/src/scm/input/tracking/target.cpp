@@ -5,14 +5,81 @@
 #include "target.h"
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <scm/input/tracking/tracker.h>
+
+namespace {
+
+// a gap this many times the sample interval restarts the smoothing filter
+const double filter_reset_gap_factor = 8.0;
+
+scm::math::vec3f
+pose_position(const scm::math::mat4f& m)
+{
+    return (scm::math::vec3f(m.m12, m.m13, m.m14));
+}
+
+scm::math::quatf
+pose_orientation(const scm::math::mat4f& m)
+{
+    return (scm::math::normalize(scm::math::quatf::from_matrix(m)));
+}
+
+scm::math::mat4f
+make_pose(const scm::math::vec3f&  p,
+          const scm::math::quatf&  q)
+{
+    scm::math::mat4f m = scm::math::normalize(q).to_matrix();
+
+    m.m12 = p.x;
+    m.m13 = p.y;
+    m.m14 = p.z;
+
+    return (m);
+}
+
+// rotation q scaled to u times its angle (extrapolates for u > 1)
+scm::math::quatf
+scale_rotation(const scm::math::quatf& q,
+               float                   u)
+{
+    using namespace scm::math;
+
+    // shortest arc
+    const quatf  s     = (q.w < 0.0f) ? quatf(-q.w, -q.x, -q.y, -q.z) : q;
+    const float  sin_h = std::sqrt(s.x * s.x + s.y * s.y + s.z * s.z);
+
+    if (sin_h < 1.0e-6f) {
+        return (normalize(quatf(1.0f, u * s.x, u * s.y, u * s.z)));
+    }
+
+    const float half_angle = std::atan2(sin_h, s.w) * u;
+    const float f          = std::sin(half_angle) / sin_h;
+
+    return (quatf(std::cos(half_angle), f * s.x, f * s.y, f * s.z));
+}
+
+} // namespace
 
 namespace scm {
 namespace inp {
 
+const unsigned target::max_history_size;
+
 target::target(std::size_t id)
   : _id(id),
-    _transform(scm::math::mat4f::identity())
+    _transform(scm::math::mat4f::identity()),
+    _history_head(0),
+    _history_size(0),
+    _prediction(prediction_none),
+    _prediction_smoothing(0.5f),
+    _prediction_max_interval(0.1),
+    _filter_interval(0.0)
 {
+    _filter_position[0]    = _filter_position[1]    = scm::math::vec3f(0.0f);
+    _filter_orientation[0] = _filter_orientation[1] = scm::math::quatf::identity();
 }
 
 target::~target()
@@ -21,14 +88,33 @@ target::~target()
 
 target::target(const target& ref)
   : _id(ref._id),
-    _transform(ref._transform)
+    _transform(ref._transform),
+    _history_head(ref._history_head),
+    _history_size(ref._history_size),
+    _prediction(ref._prediction),
+    _prediction_smoothing(ref._prediction_smoothing),
+    _prediction_max_interval(ref._prediction_max_interval),
+    _filter_interval(ref._filter_interval)
 {
+    std::copy(ref._history, ref._history + max_history_size, _history);
+    std::copy(ref._filter_position, ref._filter_position + 2, _filter_position);
+    std::copy(ref._filter_orientation, ref._filter_orientation + 2, _filter_orientation);
 }
 
 const target& target::operator=(const target& rhs)
 {
-    _id         = rhs._id;
-    _transform  = rhs._transform;
+    _id                      = rhs._id;
+    _transform               = rhs._transform;
+    _history_head            = rhs._history_head;
+    _history_size            = rhs._history_size;
+    _prediction              = rhs._prediction;
+    _prediction_smoothing    = rhs._prediction_smoothing;
+    _prediction_max_interval = rhs._prediction_max_interval;
+    _filter_interval         = rhs._filter_interval;
+
+    std::copy(rhs._history, rhs._history + max_history_size, _history);
+    std::copy(rhs._filter_position, rhs._filter_position + 2, _filter_position);
+    std::copy(rhs._filter_orientation, rhs._filter_orientation + 2, _filter_orientation);
 
     return (*this);
 }
@@ -37,6 +123,16 @@ void target::swap(target& ref)
 {
     std::swap(_id, ref._id);
     std::swap(_transform, ref._transform);
+    std::swap(_history_head, ref._history_head);
+    std::swap(_history_size, ref._history_size);
+    std::swap(_prediction, ref._prediction);
+    std::swap(_prediction_smoothing, ref._prediction_smoothing);
+    std::swap(_prediction_max_interval, ref._prediction_max_interval);
+    std::swap(_filter_interval, ref._filter_interval);
+
+    std::swap_ranges(_history, _history + max_history_size, ref._history);
+    std::swap_ranges(_filter_position, _filter_position + 2, ref._filter_position);
+    std::swap_ranges(_filter_orientation, _filter_orientation + 2, ref._filter_orientation);
 }
 
 std::size_t target::id() const
@@ -50,8 +146,162 @@ const scm::math::mat4f& target::transform() const
 }
 
 void target::transform(const scm::math::mat4f& trans)
+{
+    transform(trans, tracker::clock_time());
+}
+
+void target::transform(const scm::math::mat4f& trans,
+                       double                  time)
 {
     _transform  = trans;
+
+    pose p;
+    p._time      = time;
+    p._transform = trans;
+
+    update_filter(p);
+
+    _history_head            = (_history_head + 1) % max_history_size;
+    _history[_history_head]  = p;
+    _history_size            = scm::math::min(_history_size + 1, max_history_size);
+}
+
+double target::transform_time() const
+{
+    return (_history_size > 0 ? _history[_history_head]._time : 0.0);
+}
+
+unsigned target::history_size() const
+{
+    return (_history_size);
+}
+
+const target::pose& target::history(unsigned i) const
+{
+    assert(i < _history_size);
+    return (_history[(_history_head + max_history_size - i) % max_history_size]);
+}
+
+void target::clear_history()
+{
+    _history_size    = 0;
+    _filter_interval = 0.0;
+}
+
+void target::prediction(prediction_type type,
+                        float           smoothing,
+                        double          max_interval)
+{
+    _prediction              = type;
+    _prediction_smoothing    = scm::math::clamp(smoothing, 0.01f, 1.0f);
+    _prediction_max_interval = scm::math::max(0.0, max_interval);
+}
+
+target::prediction_type target::prediction() const
+{
+    return (_prediction);
+}
+
+float target::prediction_smoothing() const
+{
+    return (_prediction_smoothing);
+}
+
+double target::prediction_max_interval() const
+{
+    return (_prediction_max_interval);
+}
+
+scm::math::mat4f target::predicted_transform(double display_time) const
+{
+    using namespace scm::math;
+
+    if (_history_size < 2 || _prediction == prediction_none) {
+        return (_transform);
+    }
+
+    const pose&  cur_pose = history(0);
+    const double interval = clamp(display_time - cur_pose._time, 0.0, _prediction_max_interval);
+
+    switch (_prediction) {
+        case prediction_constant_velocity: {
+            const pose&  prev_pose = history(1);
+            const double dt        = cur_pose._time - prev_pose._time;
+
+            if (dt <= 0.0) {
+                return (_transform);
+            }
+            const float  u         = static_cast<float>(interval / dt);
+            const vec3f  cur_p     = pose_position(cur_pose._transform);
+            const quatf  cur_q     = pose_orientation(cur_pose._transform);
+            const vec3f  prev_p    = pose_position(prev_pose._transform);
+            const quatf  prev_q    = pose_orientation(prev_pose._transform);
+
+            return (make_pose(cur_p + (cur_p - prev_p) * u,
+                              scale_rotation(cur_q * conjugate(prev_q), u) * cur_q));
+        }
+        case prediction_double_exponential: {
+            if (_filter_interval <= 0.0) {
+                return (_transform);
+            }
+            // LaViola, double exponential smoothing based prediction
+            const float a = _prediction_smoothing;
+            const float k = static_cast<float>(interval / _filter_interval);
+            const float c = (a < 1.0f) ? a * k / (1.0f - a) : 0.0f;
+
+            const vec3f& sp  = _filter_position[0];
+            const vec3f& sp2 = _filter_position[1];
+            const quatf& sq  = _filter_orientation[0];
+            const quatf& sq2 = _filter_orientation[1];
+
+            return (make_pose(sp2 + (sp - sp2) * (2.0f + c),
+                              scale_rotation(sq * conjugate(sq2), 2.0f + c) * sq2));
+        }
+        default:
+            return (_transform);
+    }
+}
+
+void target::update_filter(const pose& p)
+{
+    using namespace scm::math;
+
+    const vec3f cur_p = pose_position(p._transform);
+    const quatf cur_q = pose_orientation(p._transform);
+
+    bool restart = (_history_size == 0);
+
+    if (!restart) {
+        const double dt = p._time - _history[_history_head]._time;
+
+        if (dt <= 0.0) {
+            restart = true;
+        }
+        else if (_filter_interval <= 0.0) {
+            _filter_interval = dt;
+        }
+        else if (dt > _filter_interval * filter_reset_gap_factor) {
+            // tracking gap, the smoothed state is stale
+            restart          = true;
+            _filter_interval = 0.0;
+        }
+        else {
+            _filter_interval = 0.9 * _filter_interval + 0.1 * dt;
+        }
+    }
+
+    if (restart) {
+        _filter_position[0]    = _filter_position[1]    = cur_p;
+        _filter_orientation[0] = _filter_orientation[1] = cur_q;
+        return;
+    }
+
+    const float a = _prediction_smoothing;
+
+    _filter_position[0]    = lerp(_filter_position[0], cur_p, a);
+    _filter_position[1]    = lerp(_filter_position[1], _filter_position[0], a);
+    _filter_orientation[0] = slerp(_filter_orientation[0], cur_q, a);
+    _filter_orientation[1] = slerp(_filter_orientation[1], _filter_orientation[0], a);
 }
 
 } // namespace inp
@@ -15,8 +15,35 @@
 namespace scm {
 namespace inp {
 
+// target
+//  - holds the latest transform of a tracked object and a short history of time stamped
+//    poses (times on tracker::clock_time())
+//  - predicted_transform() extrapolates the pose to an expected display time to hide the
+//    tracking and rendering latency:
+//      - prediction_none:               the latest transform
+//      - prediction_constant_velocity:  linear and angular velocity of the last two poses
+//      - prediction_double_exponential: double exponential smoothing of position and
+//        orientation (quaternion slerp), smoothing in (0, 1], 1 follows the samples directly
+//  - the prediction horizon is limited to max_interval seconds past the latest pose, so a
+//    target that lost tracking does not drift away
 class __scm_export(input) target
 {
+public:
+    enum prediction_type {
+        prediction_none                 = 0x00,
+        prediction_constant_velocity,
+        prediction_double_exponential
+    };
+
+    struct pose {
+        pose() : _time(0.0), _transform(scm::math::mat4f::identity()) {}
+
+        double                  _time;
+        scm::math::mat4f        _transform;
+    }; // struct pose
+
+    static const unsigned max_history_size = 16;
+
 public:
     target(std::size_t /*id*/);
     target(const target& /*ref*/);
@@ -28,11 +55,44 @@ public:
     std::size_t                 id() const;
     const scm::math::mat4f&     transform() const;
     void                        transform(const scm::math::mat4f& /*trans*/);
+    void                        transform(const scm::math::mat4f& /*trans*/,
+                                          double                  /*time*/);
+    double                      transform_time() const;
+
+    // pose history, 0 is the latest pose
+    unsigned                    history_size() const;
+    const pose&                 history(unsigned /*i*/) const;
+    void                        clear_history();
+
+    void                        prediction(prediction_type /*type*/,
+                                           float           /*smoothing*/    = 0.5f,
+                                           double          /*max_interval*/ = 0.1);
+    prediction_type             prediction() const;
+    float                       prediction_smoothing() const;
+    double                      prediction_max_interval() const;
+
+    scm::math::mat4f            predicted_transform(double /*display_time*/) const;
+
+protected:
+    void                        update_filter(const pose& /*p*/);
 
 protected:
     std::size_t                 _id;
     scm::math::mat4f            _transform;
 
+    pose                        _history[max_history_size];
+    unsigned                    _history_head;
+    unsigned                    _history_size;
+
+    prediction_type             _prediction;
+    float                       _prediction_smoothing;
+    double                      _prediction_max_interval;
+
+    // double exponential smoothing state
+    scm::math::vec3f            _filter_position[2];
+    scm::math::quatf            _filter_orientation[2];
+    double                      _filter_interval;       // smoothed sample interval
+
 private:
 
 }; // class target
@@ -3,7 +3,7 @@
 // Distributed under the Modified BSD License, see license.txt.
 
 #ifndef SCM_INPUT_TRACKER_H_INCLUDED
-#define SCM_INPUT_TRACKING_H_INCLUDED
+#define SCM_INPUT_TRACKER_H_INCLUDED
 
 #include <cstddef>
 #include <string>
@@ -34,6 +34,9 @@ public:
 
     const std::string&  name() const;
 
+    // monotonic clock for time stamping tracking samples (seconds)
+    static double       clock_time();
+
 protected:
 
 private:
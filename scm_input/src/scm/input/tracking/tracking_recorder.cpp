@@ -0,0 +1,113 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "tracking_recorder.h"
+
+#include <limits>
+
+#include <scm/log.h>
+
+#include <scm/input/tracking/target.h>
+#include <scm/input/tracking/detail/tracking_stream_format.h>
+
+namespace scm {
+namespace inp {
+
+tracking_recorder::tracking_recorder(const std::string& file_name)
+  : _file_name(file_name),
+    _record_count(0)
+{
+    _file.open(_file_name.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+
+    if (   !_file
+        || !detail::write_stream_values(_file, detail::tracking_stream_magic, 8)
+        || !detail::write_stream_values(_file, &detail::tracking_stream_version, 1)) {
+        scm::err() << log::error
+                   << "tracking_recorder::tracking_recorder(): "
+                   << "unable to open tracking stream file for writing ('" << _file_name << "')" << log::end;
+        _file.close();
+    }
+}
+
+tracking_recorder::~tracking_recorder()
+{
+    close();
+}
+
+bool tracking_recorder::is_open() const
+{
+    return (_file.is_open());
+}
+
+void tracking_recorder::close()
+{
+    if (_file.is_open()) {
+        _file.close();
+    }
+}
+
+void tracking_recorder::record(const tracker::target_container& targets)
+{
+    typedef std::map<std::size_t, double>   time_map;
+
+    for (tracker::target_container::const_iterator t = targets.begin(); t != targets.end(); ++t) {
+        const target& tar = t->second;
+
+        if (tar.history_size() == 0) {
+            continue;
+        }
+
+        time_map::iterator rt = _recorded_time.find(t->first);
+        if (rt == _recorded_time.end()) {
+            rt = _recorded_time.insert(time_map::value_type(t->first, -(std::numeric_limits<double>::max)())).first;
+        }
+
+        // poses added since the last call, written oldest first
+        unsigned new_poses = 0;
+        while (new_poses < tar.history_size() && tar.history(new_poses)._time > rt->second) {
+            ++new_poses;
+        }
+        for (unsigned i = new_poses; i > 0; --i) {
+            const target::pose& p = tar.history(i - 1);
+            record(t->first, p._time, p._transform);
+        }
+        rt->second = tar.transform_time();
+    }
+}
+
+void tracking_recorder::record(std::size_t             target_id,
+                               double                  time,
+                               const scm::math::mat4f& transform)
+{
+    if (!_file.is_open()) {
+        return;
+    }
+
+    const scm::uint32 id = static_cast<scm::uint32>(target_id);
+
+    if (   !detail::write_stream_values(_file, &time, 1)
+        || !detail::write_stream_values(_file, &id, 1)
+        || !detail::write_stream_values(_file, transform.data_array, 16)) {
+        scm::err() << log::error
+                   << "tracking_recorder::record(): "
+                   << "unable to write to tracking stream file ('" << _file_name << "')" << log::end;
+        _file.close();
+        return;
+    }
+
+    ++_record_count;
+}
+
+const std::string& tracking_recorder::file_name() const
+{
+    return (_file_name);
+}
+
+std::size_t tracking_recorder::record_count() const
+{
+    return (_record_count);
+}
+
+} // namespace inp
+} // namespace scm
@@ -0,0 +1,61 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_INPUT_TRACKING_RECORDER_H_INCLUDED
+#define SCM_INPUT_TRACKING_RECORDER_H_INCLUDED
+
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+#include <scm/core/math/math.h>
+
+#include <scm/input/tracking/tracker.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace inp {
+
+// tracking_recorder
+//  - writes the time stamped poses of tracked targets to a binary tracking stream file,
+//    tracking_replay plays such a file back in place of the tracking hardware
+//  - record(targets) after each tracker update appends the poses of the target histories
+//    not recorded before
+class __scm_export(input) tracking_recorder : boost::noncopyable
+{
+public:
+    tracking_recorder(const std::string& /*file_name*/);
+    virtual ~tracking_recorder();
+
+    bool                        is_open() const;
+    void                        close();
+
+    void                        record(const tracker::target_container& /*targets*/);
+    void                        record(std::size_t             /*target_id*/,
+                                       double                  /*time*/,
+                                       const scm::math::mat4f& /*transform*/);
+
+    const std::string&          file_name() const;
+    std::size_t                 record_count() const;
+
+private:
+    std::string                 _file_name;
+    std::ofstream               _file;
+
+    std::map<std::size_t, double>   _recorded_time;     // latest recorded pose per target
+    std::size_t                     _record_count;
+
+}; // class tracking_recorder
+
+} // namespace inp
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_INPUT_TRACKING_RECORDER_H_INCLUDED
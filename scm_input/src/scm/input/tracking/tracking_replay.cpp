@@ -0,0 +1,230 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#include "tracking_replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include <scm/log.h>
+
+#include <scm/input/tracking/target.h>
+#include <scm/input/tracking/detail/tracking_stream_format.h>
+
+namespace {
+
+const std::size_t stream_header_size = 8 + sizeof(scm::uint32);
+const std::size_t stream_record_size = sizeof(double) + sizeof(scm::uint32) + 16 * sizeof(float);
+
+bool
+record_time_less(const scm::inp::tracking_replay::record& lhs,
+                 const scm::inp::tracking_replay::record& rhs)
+{
+    return (lhs._time < rhs._time);
+}
+
+} // namespace
+
+namespace scm {
+namespace inp {
+
+tracking_replay::tracking_replay(const std::string& file_name,
+                                 bool               loop)
+  : tracker(std::string("tracking_replay")),
+    _file_name(file_name),
+    _loop(loop),
+    _next_record(0),
+    _time_offset(0.0),
+    _last_stream_time(0.0),
+    _initialized(false)
+{
+}
+
+tracking_replay::~tracking_replay()
+{
+}
+
+bool tracking_replay::initialize()
+{
+    if (_initialized) {
+        scm::err() << log::warning
+                   << "tracking_replay::initialize(): "
+                   << "allready initialized" << log::end;
+        return (true);
+    }
+
+    if (!load_stream(_file_name, _records)) {
+        return (false);
+    }
+
+    _next_record      = 0;
+    _time_offset      = clock_time() - stream_begin();
+    _last_stream_time = stream_begin();
+    _initialized      = true;
+
+    return (true);
+}
+
+void tracking_replay::update(target_container& targets)
+{
+    if (!_initialized || _records.empty()) {
+        return;
+    }
+
+    double stream_time = clock_time() - _time_offset;
+
+    if (_loop && stream_time > stream_end()) {
+        const double duration = stream_end() - stream_begin();
+
+        apply_records(targets, stream_end(), _time_offset);
+
+        if (duration > 0.0) {
+            // restart the recording, possibly skipping whole loops
+            const double loops = std::floor((stream_time - stream_begin()) / duration);
+
+            _time_offset  += loops * duration;
+            stream_time   -= loops * duration;
+            _next_record   = 0;
+        }
+    }
+
+    apply_records(targets, stream_time, _time_offset);
+}
+
+bool tracking_replay::shutdown()
+{
+    if (!_initialized) {
+        scm::err() << log::warning
+                   << "tracking_replay::shutdown(): "
+                   << "not initialized" << log::end;
+        return (true);
+    }
+
+    _records.clear();
+    _initialized = false;
+
+    return (true);
+}
+
+void tracking_replay::update(target_container& targets,
+                             double            stream_time)
+{
+    if (!_initialized || _records.empty()) {
+        return;
+    }
+
+    if (stream_time < _last_stream_time) {
+        _next_record = 0;
+    }
+
+    apply_records(targets, stream_time, 0.0);
+}
+
+const std::string& tracking_replay::file_name() const
+{
+    return (_file_name);
+}
+
+bool tracking_replay::loop() const
+{
+    return (_loop);
+}
+
+bool tracking_replay::finished() const
+{
+    return (!_loop && _next_record >= _records.size());
+}
+
+double tracking_replay::stream_begin() const
+{
+    return (_records.empty() ? 0.0 : _records.front()._time);
+}
+
+double tracking_replay::stream_end() const
+{
+    return (_records.empty() ? 0.0 : _records.back()._time);
+}
+
+const tracking_replay::record_array& tracking_replay::records() const
+{
+    return (_records);
+}
+
+bool tracking_replay::load_stream(const std::string& file_name,
+                                  record_array&      records)
+{
+    records.clear();
+
+    std::ifstream stream_file(file_name.c_str(), std::ios_base::in | std::ios_base::binary);
+
+    if (!stream_file) {
+        scm::err() << log::error
+                   << "tracking_replay::load_stream(): "
+                   << "unable to open tracking stream file ('" << file_name << "')" << log::end;
+        return (false);
+    }
+
+    char        magic[8];
+    scm::uint32 version = 0;
+
+    if (   !detail::read_stream_values(stream_file, magic, 8)
+        || !detail::read_stream_values(stream_file, &version, 1)
+        || 0 != std::memcmp(magic, detail::tracking_stream_magic, sizeof(detail::tracking_stream_magic))
+        || version != detail::tracking_stream_version) {
+        scm::err() << log::error
+                   << "tracking_replay::load_stream(): "
+                   << "not a tracking stream file or unsupported version ('" << file_name << "')" << log::end;
+        return (false);
+    }
+
+    stream_file.seekg(0, std::ios_base::end);
+    const std::size_t file_size = static_cast<std::size_t>(stream_file.tellg());
+    stream_file.seekg(static_cast<std::streamoff>(stream_header_size), std::ios_base::beg);
+
+    const std::size_t record_count = (file_size - stream_header_size) / stream_record_size;
+
+    records.resize(record_count);
+    for (std::size_t r = 0; r < record_count; ++r) {
+        record&     rec = records[r];
+        scm::uint32 id  = 0;
+
+        if (   !detail::read_stream_values(stream_file, &rec._time, 1)
+            || !detail::read_stream_values(stream_file, &id, 1)
+            || !detail::read_stream_values(stream_file, rec._transform.data_array, 16)) {
+            scm::err() << log::warning
+                       << "tracking_replay::load_stream(): "
+                       << "truncated tracking stream file, using the first " << r << " records ('" << file_name << "')" << log::end;
+            records.resize(r);
+            break;
+        }
+        rec._target_id = id;
+    }
+
+    // streams recorded from several trackers may interleave slightly out of order
+    std::stable_sort(records.begin(), records.end(), record_time_less);
+
+    return (true);
+}
+
+void tracking_replay::apply_records(target_container& targets,
+                                    double            stream_time,
+                                    double            time_offset)
+{
+    while (_next_record < _records.size() && _records[_next_record]._time <= stream_time) {
+        const record&               rec       = _records[_next_record];
+        target_container::iterator  target_it = targets.find(rec._target_id);
+
+        if (target_it != targets.end()) {
+            target_it->second.transform(rec._transform, rec._time + time_offset);
+        }
+        ++_next_record;
+    }
+
+    _last_stream_time = stream_time;
+}
+
+} // namespace inp
+} // namespace scm
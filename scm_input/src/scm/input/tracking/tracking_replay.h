@@ -0,0 +1,84 @@
+
+// Copyright (c) 2012 Christopher Lux <christopherlux@gmail.com>
+// Distributed under the Modified BSD License, see license.txt.
+
+#ifndef SCM_INPUT_TRACKING_REPLAY_H_INCLUDED
+#define SCM_INPUT_TRACKING_REPLAY_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <scm/core/math/math.h>
+
+#include <scm/input/tracking/tracker.h>
+
+#include <scm/core/platform/platform.h>
+#include <scm/core/utilities/platform_warning_disable.h>
+
+namespace scm {
+namespace inp {
+
+// tracking_replay
+//  - plays back a tracking stream file written by tracking_recorder in place of a tracker
+//  - update(targets) replays in real time from initialize() on, the recorded time stamps
+//    are moved onto tracker::clock_time() so pose prediction works as with live tracking
+//  - update(targets, stream_time) steps through the recording with the original time
+//    stamps, for measuring prediction error and jitter offline
+class __scm_export(input) tracking_replay : public tracker
+{
+public:
+    struct record {
+        double                  _time;
+        std::size_t             _target_id;
+        scm::math::mat4f        _transform;
+    }; // struct record
+    typedef std::vector<record> record_array;
+
+public:
+    tracking_replay(const std::string& /*file_name*/,
+                    bool               /*loop*/ = false);
+    virtual ~tracking_replay();
+
+    bool                        initialize();
+    void                        update(target_container& /*targets*/);
+    bool                        shutdown();
+
+    void                        update(target_container& /*targets*/,
+                                       double            /*stream_time*/);
+
+    const std::string&          file_name() const;
+    bool                        loop() const;
+    bool                        finished() const;
+
+    double                      stream_begin() const;
+    double                      stream_end() const;
+    const record_array&         records() const;
+
+    static bool                 load_stream(const std::string& /*file_name*/,
+                                            record_array&      /*records*/);
+
+private:
+    void                        apply_records(target_container& /*targets*/,
+                                              double            /*stream_time*/,
+                                              double            /*time_offset*/);
+
+private:
+    std::string                 _file_name;
+    bool                        _loop;
+
+    record_array                _records;
+    std::size_t                 _next_record;
+    double                      _time_offset;           // clock time - stream time
+    double                      _last_stream_time;
+
+    bool                        _initialized;
+
+}; // class tracking_replay
+
+} // namespace inp
+} // namespace scm
+
+#include <scm/core/utilities/platform_warning_enable.h>
+
+#endif // SCM_INPUT_TRACKING_REPLAY_H_INCLUDED